@@ -2,58 +2,87 @@
 #define APU_H
 
 #include <stdint.h>
+#include "noise_ch.h"
+#include "sqr_ch.h"
+#include "timer.h"
+#include "wave_ch.h"
+
+typedef struct gb gb_t;
 
 #define AUDIO_SAMPLE_RATE 48000
 #define AUDIO_SAMPLE_SIZE 1024
 
-void apu_reset(void);
-void apu_tick(unsigned int clock_step);
-void apu_change_speed(unsigned int new_speed);
-
-uint8_t apu_read_nr10(void);
-uint8_t apu_read_nr11(void);
-uint8_t apu_read_nr12(void);
-uint8_t apu_read_nr13(void);
-uint8_t apu_read_nr14(void);
-uint8_t apu_read_nr21(void);
-uint8_t apu_read_nr22(void);
-uint8_t apu_read_nr23(void);
-uint8_t apu_read_nr24(void);
-uint8_t apu_read_nr30(void);
-uint8_t apu_read_nr31(void);
-uint8_t apu_read_nr32(void);
-uint8_t apu_read_nr33(void);
-uint8_t apu_read_nr34(void);
-uint8_t apu_read_nr41(void);
-uint8_t apu_read_nr42(void);
-uint8_t apu_read_nr43(void);
-uint8_t apu_read_nr44(void);
-uint8_t apu_read_nr50(void);
-uint8_t apu_read_nr51(void);
-uint8_t apu_read_nr52(void);
-uint8_t apu_read_wave(int pos);
-
-void apu_write_nr10(uint8_t val);
-void apu_write_nr11(uint8_t val);
-void apu_write_nr12(uint8_t val);
-void apu_write_nr13(uint8_t val);
-void apu_write_nr14(uint8_t val);
-void apu_write_nr21(uint8_t val);
-void apu_write_nr22(uint8_t val);
-void apu_write_nr23(uint8_t val);
-void apu_write_nr24(uint8_t val);
-void apu_write_nr30(uint8_t val);
-void apu_write_nr31(uint8_t val);
-void apu_write_nr32(uint8_t val);
-void apu_write_nr33(uint8_t val);
-void apu_write_nr34(uint8_t val);
-void apu_write_nr41(uint8_t val);
-void apu_write_nr42(uint8_t val);
-void apu_write_nr43(uint8_t val);
-void apu_write_nr44(uint8_t val);
-void apu_write_nr50(uint8_t val);
-void apu_write_nr51(uint8_t val);
-void apu_write_nr52(uint8_t val);
-void apu_write_wave(int pos, uint8_t val);
+typedef struct {
+    /*** Registers ***/
+    /* 0xff24 (NR50): Vin sel and L/R Volume control (R/W) */
+    uint8_t vin_sel_vol_ctrl;
+    /* 0xff25 (NR51): Selection of Sound output terminal (R/W) */
+    uint8_t ch_out_sel;
+    /* 0xff26 (NR52): Sound on/off */
+    uint8_t sound_enabled;
+
+    /*** Internal data ***/
+    unsigned int speed;
+    int16_t left_vol;  /* left volume: 0 - 32767 */
+    int16_t right_vol; /* right volume: 0 - 32767 */
+    int16_t out_buf[AUDIO_SAMPLE_SIZE];
+    apu_timer_t frame_sequencer;
+    apu_timer_t output_timer;
+    sqr_ch_t channel1;
+    sqr_ch_t channel2;
+    wave_ch_t channel3;
+    noise_ch_t channel4;
+} apu_t;
+
+void apu_reset(gb_t *gb);
+/* Any number of cycles, with every sequencer step and sample on its cycle. */
+void apu_tick(gb_t *gb, unsigned int clock_step);
+void apu_change_speed(gb_t *gb, unsigned int new_speed);
+
+uint8_t apu_read_nr10(gb_t *gb);
+uint8_t apu_read_nr11(gb_t *gb);
+uint8_t apu_read_nr12(gb_t *gb);
+uint8_t apu_read_nr13(gb_t *gb);
+uint8_t apu_read_nr14(gb_t *gb);
+uint8_t apu_read_nr21(gb_t *gb);
+uint8_t apu_read_nr22(gb_t *gb);
+uint8_t apu_read_nr23(gb_t *gb);
+uint8_t apu_read_nr24(gb_t *gb);
+uint8_t apu_read_nr30(gb_t *gb);
+uint8_t apu_read_nr31(gb_t *gb);
+uint8_t apu_read_nr32(gb_t *gb);
+uint8_t apu_read_nr33(gb_t *gb);
+uint8_t apu_read_nr34(gb_t *gb);
+uint8_t apu_read_nr41(gb_t *gb);
+uint8_t apu_read_nr42(gb_t *gb);
+uint8_t apu_read_nr43(gb_t *gb);
+uint8_t apu_read_nr44(gb_t *gb);
+uint8_t apu_read_nr50(gb_t *gb);
+uint8_t apu_read_nr51(gb_t *gb);
+uint8_t apu_read_nr52(gb_t *gb);
+uint8_t apu_read_wave(gb_t *gb, int pos);
+
+void apu_write_nr10(gb_t *gb, uint8_t val);
+void apu_write_nr11(gb_t *gb, uint8_t val);
+void apu_write_nr12(gb_t *gb, uint8_t val);
+void apu_write_nr13(gb_t *gb, uint8_t val);
+void apu_write_nr14(gb_t *gb, uint8_t val);
+void apu_write_nr21(gb_t *gb, uint8_t val);
+void apu_write_nr22(gb_t *gb, uint8_t val);
+void apu_write_nr23(gb_t *gb, uint8_t val);
+void apu_write_nr24(gb_t *gb, uint8_t val);
+void apu_write_nr30(gb_t *gb, uint8_t val);
+void apu_write_nr31(gb_t *gb, uint8_t val);
+void apu_write_nr32(gb_t *gb, uint8_t val);
+void apu_write_nr33(gb_t *gb, uint8_t val);
+void apu_write_nr34(gb_t *gb, uint8_t val);
+void apu_write_nr41(gb_t *gb, uint8_t val);
+void apu_write_nr42(gb_t *gb, uint8_t val);
+void apu_write_nr43(gb_t *gb, uint8_t val);
+void apu_write_nr44(gb_t *gb, uint8_t val);
+void apu_write_nr50(gb_t *gb, uint8_t val);
+void apu_write_nr51(gb_t *gb, uint8_t val);
+void apu_write_nr52(gb_t *gb, uint8_t val);
+void apu_write_wave(gb_t *gb, int pos, uint8_t val);
 
 #endif /* APU_H */
@@ -1,8 +1,5 @@
 #include "noise_ch.h"
 #include <string.h>
-#include "timer.h"
-
-extern apu_timer_t frame_sequencer;
 
 static uint8_t divisor[] = { 8, 16, 32, 48, 64, 80, 96, 112 };
 
@@ -14,19 +11,22 @@ void noise_ch_reset(noise_ch_t *c)
 void noise_ch_tick(noise_ch_t *c, int clock_step)
 {
     c->timer -= clock_step;
+    if (c->timer > 0)
+        return;
+    /* The LFSR shifts every period the step ends, the last sets the output. */
+    uint32_t lfsr = c->lfsr;
     while (c->timer <= 0) {
         c->timer += divisor[c->div_ratio] << c->shift_clock;
-        uint32_t lfsr = c->lfsr;
         uint32_t xor_result = (lfsr & 1) ^ ((lfsr >> 1) & 1);
         lfsr = (lfsr >> 1) | (xor_result << 14);
         if (c->width_mode)
             lfsr = (lfsr & ~0x40) | (xor_result << 6);
-        c->lfsr = lfsr;
-        if (c->enabled && c->env.dac_enabled && !(lfsr & 1))
-            c->out_volume = c->env.volume;
-        else
-            c->out_volume = 0;
     }
+    c->lfsr = lfsr;
+    if (c->enabled && c->env.dac_enabled && !(lfsr & 1))
+        c->out_volume = c->env.volume;
+    else
+        c->out_volume = 0;
 }
 
 bool noise_ch_status(noise_ch_t *c)
@@ -88,13 +88,13 @@ uint8_t noise_ch_read_reg4(noise_ch_t *c)
     return c->length.enabled | 0xbf;
 }
 
-static void noise_ch_trigger(noise_ch_t *c)
+static void noise_ch_trigger(noise_ch_t *c, unsigned int fs_clock)
 {
     if (c->env.dac_enabled)
         c->enabled = true;
     if (c->length.counter == 0) {
         c->length.counter = 64;
-        if (frame_sequencer.out_clock & 1)
+        if (fs_clock & 1)
             noise_ch_length_counter(c);
     }
     c->lfsr = 0x7fff;
@@ -102,14 +102,14 @@ static void noise_ch_trigger(noise_ch_t *c)
     volume_envelope_trigger(&c->env);
 }
 
-void noise_ch_write_reg4(noise_ch_t *c, uint8_t val)
+void noise_ch_write_reg4(noise_ch_t *c, uint8_t val, unsigned int fs_clock)
 {
     uint8_t old_length_en = c->length.enabled;
     c->length.enabled = val & 0x40;
-    if (!old_length_en && frame_sequencer.out_clock & 1) {
+    if (!old_length_en && fs_clock & 1) {
         noise_ch_length_counter(c);
     }
     if (val & 0x80) {
-        noise_ch_trigger(c);
+        noise_ch_trigger(c, fs_clock);
     }
 }
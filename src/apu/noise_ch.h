@@ -34,6 +34,6 @@ uint8_t noise_ch_read_reg4(noise_ch_t *c);
 void noise_ch_write_reg1(noise_ch_t *c, uint8_t val);
 void noise_ch_write_reg2(noise_ch_t *c, uint8_t val);
 void noise_ch_write_reg3(noise_ch_t *c, uint8_t val);
-void noise_ch_write_reg4(noise_ch_t *c, uint8_t val);
+void noise_ch_write_reg4(noise_ch_t *c, uint8_t val, unsigned int fs_clock);
 
 #endif /* NOISE_CH */
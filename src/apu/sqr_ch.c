@@ -1,9 +1,5 @@
 #include "sqr_ch.h"
 #include <string.h>
-#include "timer.h"
-
-extern apu_timer_t frame_sequencer;
-extern uint8_t sound_enabled;
 
 static uint8_t duty_table[4][8] = {
     {0, 0, 0, 0, 0, 0, 0, 1}, /* 12.5% */
@@ -20,9 +16,12 @@ void sqr_ch_reset(sqr_ch_t *c)
 void sqr_ch_tick(sqr_ch_t *c, int clock_step)
 {
     c->timer -= clock_step;
-    while (c->timer <= 0) {
-        c->timer += (2048 - c->frequency) * 4;
-        c->wave_ptr = (c->wave_ptr + 1) & 0x7;
+    if (c->timer <= 0) {
+        /* Every period the step ends, at once. */
+        int period = (2048 - (int)c->frequency) * 4;
+        int n = -c->timer / period + 1;
+        c->timer += n * period;
+        c->wave_ptr = (c->wave_ptr + (unsigned int)n) & 0x7;
     }
 }
 
@@ -101,7 +100,7 @@ uint8_t sqr_ch_read_reg1(sqr_ch_t *c)
     return (c->wave_duty << 6) | 0x3f;
 }
 
-void sqr_ch_write_reg1(sqr_ch_t *c, uint8_t val)
+void sqr_ch_write_reg1(sqr_ch_t *c, uint8_t val, bool sound_enabled)
 {
     if (sound_enabled)
         c->wave_duty = val >> 6;
@@ -145,13 +144,13 @@ static void sqr_ch_sweep_init(sqr_ch_t *c)
     }
 }
 
-static void sqr_ch_trigger(sqr_ch_t *c)
+static void sqr_ch_trigger(sqr_ch_t *c, unsigned int fs_clock)
 {
     if (c->env.dac_enabled)
         c->enabled = true;
     if (c->length.counter == 0) {
         c->length.counter = 64;
-        if (frame_sequencer.out_clock & 1)
+        if (fs_clock & 1)
             sqr_ch_length_counter(c);
     }
     c->timer = 6 + (2048 - c->frequency) * 4;
@@ -160,15 +159,15 @@ static void sqr_ch_trigger(sqr_ch_t *c)
     sqr_ch_sweep_init(c);
 }
 
-void sqr_ch_write_reg4(sqr_ch_t *c, uint8_t val)
+void sqr_ch_write_reg4(sqr_ch_t *c, uint8_t val, unsigned int fs_clock)
 {
     uint8_t old_length_en = c->length.enabled;
     c->length.enabled = val & 0x40;
-    if (!old_length_en && frame_sequencer.out_clock & 1) {
+    if (!old_length_en && fs_clock & 1) {
         sqr_ch_length_counter(c);
     }
     c->frequency = ((val & 0x7) << 8) | (c->frequency & 0xff);
     if (val & 0x80) {
-        sqr_ch_trigger(c);
+        sqr_ch_trigger(c, fs_clock);
     }
 }
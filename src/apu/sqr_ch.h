@@ -43,9 +43,9 @@ uint8_t sqr_ch_read_reg3(sqr_ch_t *c);
 uint8_t sqr_ch_read_reg4(sqr_ch_t *c);
 
 void sqr_ch_write_reg0(sqr_ch_t *c, uint8_t val);
-void sqr_ch_write_reg1(sqr_ch_t *c, uint8_t val);
+void sqr_ch_write_reg1(sqr_ch_t *c, uint8_t val, bool sound_enabled);
 void sqr_ch_write_reg2(sqr_ch_t *c, uint8_t val);
 void sqr_ch_write_reg3(sqr_ch_t *c, uint8_t val);
-void sqr_ch_write_reg4(sqr_ch_t *c, uint8_t val);
+void sqr_ch_write_reg4(sqr_ch_t *c, uint8_t val, unsigned int fs_clock);
 
 #endif /* SQR_CH */
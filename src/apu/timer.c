@@ -12,12 +12,17 @@ void apu_timer_init(apu_timer_t *t, unsigned int freq, unsigned int sum,
     t->out_clock = 0;
 }
 
-void apu_timer_tick(apu_timer_t *t, unsigned int cycles)
+void apu_timer_tick(gb_t *gb, apu_timer_t *t, unsigned int cycles)
 {
     t->in_clock += cycles;
-    if (t->in_clock >= t->freq) {
+    while (t->in_clock >= t->freq) {
         t->in_clock -= t->freq;
-        t->cb(t->out_clock);
+        t->cb(gb, t->out_clock);
         t->out_clock = (t->out_clock + t->sum) & t->mask;
     }
 }
+
+unsigned int apu_timer_next_event(const apu_timer_t *t)
+{
+    return t->in_clock < t->freq ? t->freq - t->in_clock : 0;
+}
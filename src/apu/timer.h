@@ -1,7 +1,9 @@
 #ifndef APU_TIMER_H
 #define APU_TIMER_H
 
-typedef void (*apu_timer_cb_f)(unsigned int clock);
+typedef struct gb gb_t;
+
+typedef void (*apu_timer_cb_f)(gb_t *gb, unsigned int clock);
 
 typedef struct {
     unsigned int freq;
@@ -14,6 +16,9 @@ typedef struct {
 
 void apu_timer_init(apu_timer_t *t, unsigned int freq, unsigned int sum,
                     unsigned int mask, apu_timer_cb_f cb);
-void apu_timer_tick(apu_timer_t *t, unsigned int cycles);
+/* Fires the callback as many times as the cycles reach freq. */
+void apu_timer_tick(gb_t *gb, apu_timer_t *t, unsigned int cycles);
+/* Cycles until the timer fires. */
+unsigned int apu_timer_next_event(const apu_timer_t *t);
 
 #endif /* APU_TIMER_H */
@@ -1,8 +1,5 @@
 #include "wave_ch.h"
 #include <string.h>
-#include "timer.h"
-
-extern apu_timer_t frame_sequencer;
 
 void wave_ch_reset(wave_ch_t *c)
 {
@@ -12,9 +9,12 @@ void wave_ch_reset(wave_ch_t *c)
 void wave_ch_tick(wave_ch_t *c, int clock_step)
 {
     c->timer -= clock_step;
-    while (c->timer <= 0) {
-        c->timer += (2048 - c->frequency) * 2;
-        c->position = (c->position + 1) & 0x1f;
+    if (c->timer <= 0) {
+        /* Every period the step ends, at once, the last sets the output. */
+        int period = (2048 - (int)c->frequency) * 2;
+        int n = -c->timer / period + 1;
+        c->timer += n * period;
+        c->position = (c->position + n) & 0x1f;
         if (c->volume) {
             uint8_t out = c->wave_ram[c->position / 2];
             if (!(c->position & 1)) {
@@ -94,12 +94,12 @@ uint8_t wave_ch_read_reg4(wave_ch_t *c)
     return c->length.enabled | 0xbf;
 }
 
-void wave_ch_write_reg4(wave_ch_t *c, uint8_t val)
+void wave_ch_write_reg4(wave_ch_t *c, uint8_t val, unsigned int fs_clock)
 {
     bool old_length_en = c->length.enabled;
     c->frequency = ((val & 0x7) << 8) | (c->frequency & 0xff);
     c->length.enabled = val & 0x40;
-    if (!old_length_en && frame_sequencer.out_clock & 1) {
+    if (!old_length_en && fs_clock & 1) {
         wave_ch_length_counter(c);
     }
     if (val & 0x80) {
@@ -109,7 +109,7 @@ void wave_ch_write_reg4(wave_ch_t *c, uint8_t val)
         c->timer = 6 + (2048 - c->frequency) * 2;
         if (c->length.counter == 0) {
             c->length.counter = 0x100;
-            if (frame_sequencer.out_clock & 1)
+            if (fs_clock & 1)
                 wave_ch_length_counter(c);
         }
     }
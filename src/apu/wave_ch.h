@@ -36,7 +36,7 @@ void wave_ch_write_reg0(wave_ch_t *c, uint8_t val);
 void wave_ch_write_reg1(wave_ch_t *c, uint8_t val);
 void wave_ch_write_reg2(wave_ch_t *c, uint8_t val);
 void wave_ch_write_reg3(wave_ch_t *c, uint8_t val);
-void wave_ch_write_reg4(wave_ch_t *c, uint8_t val);
+void wave_ch_write_reg4(wave_ch_t *c, uint8_t val, unsigned int fs_clock);
 void wave_ram_write(wave_ch_t *c, int pos, uint8_t val);
 
 #endif /* WAVE_CH */
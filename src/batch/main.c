@@ -0,0 +1,204 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch/manifest.h"
+#include "batch/pool.h"
+#include "gb.h"
+
+typedef struct {
+    uint64_t hash;
+    uint64_t cycles;
+    uint64_t wall_ns;
+    int status;
+} batch_result_t;
+
+typedef struct {
+    batch_manifest_t manifest;
+    gb_t **roms;   /* One instance per ROM, only used as a ROM source. */
+    gb_t **gbs;    /* One instance per worker, reused by all its jobs. */
+    batch_result_t *results;
+} batch_t;
+
+static unsigned int threads = 0;
+static const char *manifest_path = NULL;
+static const char *results_path = NULL;
+
+static uint64_t batch_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t batch_run(gb_t *gb, const batch_job_t *job)
+{
+    uint64_t cycles = 0;
+    unsigned int frame = 0;
+    size_t next = 0;
+    while (frame < job->frames) {
+        /* Run up to the next joypad change in one go. */
+        while (next < job->input_count && job->inputs[next].frame <= frame) {
+            keys_set_held(gb, job->inputs[next++].keys);
+        }
+        unsigned int until = job->frames;
+        if (next < job->input_count && job->inputs[next].frame < until)
+            until = job->inputs[next].frame;
+        cycles += gb_run_frames(gb, until - frame);
+        frame = until;
+    }
+    return cycles;
+}
+
+static void batch_work(unsigned int worker, size_t index, void *data)
+{
+    batch_t *b = data;
+    const batch_job_t *job = &b->manifest.jobs[index];
+    batch_result_t *res = &b->results[index];
+    gb_t *rom = b->roms[job->rom];
+    gb_t **gb = &b->gbs[worker];
+    uint64_t start = batch_now_ns();
+    res->status = -1;
+    if (rom == NULL)
+        return;
+    if (*gb == NULL) {
+        *gb = gb_create_shared(rom);
+        if (*gb == NULL)
+            return;
+    } else if (gb_load_shared(*gb, rom) < 0) {
+        return;
+    }
+    if (job->movie != NULL && gb_movie_play(*gb, job->movie) < 0)
+        return;
+    res->cycles = batch_run(*gb, job);
+    gb_movie_stop(*gb);
+    res->hash = gb_frame_hash(*gb);
+    res->wall_ns = batch_now_ns() - start;
+    res->status = 0;
+}
+
+static int batch_write_results(batch_t *b, FILE *f)
+{
+    fprintf(f, "# job\trom\tframes\thash\tcycles\twall_us\tstatus\n");
+    for (size_t i = 0; i < b->manifest.job_count; ++i) {
+        const batch_job_t *job = &b->manifest.jobs[i];
+        const batch_result_t *res = &b->results[i];
+        fprintf(f, "%zu\t%s\t%u\t%016" PRIx64 "\t%" PRIu64 "\t%" PRIu64
+                   "\t%s\n",
+                i, b->manifest.roms[job->rom], job->frames, res->hash,
+                res->cycles, res->wall_ns / 1000,
+                res->status == 0 ? "ok" : "error");
+    }
+    return ferror(f) ? -1 : 0;
+}
+
+static void batch_load_roms(batch_t *b)
+{
+    b->roms = calloc(b->manifest.rom_count, sizeof(gb_t *));
+    for (size_t i = 0; i < b->manifest.rom_count; ++i) {
+        b->roms[i] = gb_create(b->manifest.roms[i]);
+        if (b->roms[i] == NULL) {
+            fprintf(stderr, "ERROR: could not load %s\n",
+                    b->manifest.roms[i]);
+            continue;
+        }
+        /* Jobs never run on it, so there is nothing worth saving. */
+        cart_detach_save(&b->roms[i]->cart);
+    }
+}
+
+static void batch_free(batch_t *b)
+{
+    for (size_t i = 0; i < threads; ++i) {
+        if (b->gbs[i] != NULL)
+            gb_destroy(b->gbs[i]);
+    }
+    for (size_t i = 0; i < b->manifest.rom_count; ++i) {
+        if (b->roms[i] != NULL)
+            gb_destroy(b->roms[i]);
+    }
+    free(b->gbs);
+    free(b->roms);
+    free(b->results);
+    batch_manifest_free(&b->manifest);
+}
+
+static int parse_args(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "j:h")) != -1) {
+        switch (opt) {
+            case 'j':
+                threads = strtoul(optarg, NULL, 10);
+                if (threads < 1) {
+                    fprintf(stderr, "Invalid thread count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            default:
+                return -1;
+        }
+    }
+    if (argc - optind != 2) {
+        return -1;
+    }
+    manifest_path = argv[optind];
+    results_path = argv[optind + 1];
+    return 0;
+}
+
+static void print_help(char **argv)
+{
+    fprintf(stderr,
+            "Usage: %s [options] manifest results\n"
+            "Options:\n"
+            "  -h\t\tPrint help and exit\n"
+            "  -j <threads>\tNumber of worker threads (default: one per "
+            "core)\n",
+            argv[0]);
+}
+
+int main(int argc, char *argv[])
+{
+    if (parse_args(argc, argv) < 0) {
+        print_help(argv);
+        exit(EXIT_FAILURE);
+    }
+    if (threads == 0)
+        threads = pool_default_threads();
+    batch_t b;
+    if (batch_manifest_load(&b.manifest, manifest_path) < 0)
+        exit(EXIT_FAILURE);
+    FILE *out = fopen(results_path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "ERROR: could not open %s\n", results_path);
+        batch_manifest_free(&b.manifest);
+        exit(EXIT_FAILURE);
+    }
+    if (threads > b.manifest.job_count && b.manifest.job_count > 0)
+        threads = b.manifest.job_count;
+    b.gbs = calloc(threads, sizeof(gb_t *));
+    b.results = calloc(b.manifest.job_count, sizeof(batch_result_t));
+    /* Jobs of a ROM that fails to load are reported, the rest still run. */
+    batch_load_roms(&b);
+    uint64_t start = batch_now_ns();
+    int ret = pool_run(threads, b.manifest.job_count, batch_work, &b);
+    double wall = (batch_now_ns() - start) / 1e9;
+    uint64_t frames = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < b.manifest.job_count; ++i) {
+        if (b.results[i].status == 0)
+            frames += b.manifest.jobs[i].frames;
+        else
+            ++failed;
+    }
+    fprintf(stderr, "%zu jobs (%zu failed), %u threads, %.3f s, %.0f fps\n",
+            b.manifest.job_count, failed, threads, wall,
+            wall > 0 ? frames / wall : 0);
+    if (batch_write_results(&b, out) < 0)
+        ret = -1;
+    fclose(out);
+    batch_free(&b);
+    return ret == 0 && failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
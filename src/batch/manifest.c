@@ -0,0 +1,170 @@
+#include "batch/manifest.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "keys.h"
+
+#define BATCH_DELIM " \t\r\n"
+
+static int batch_parse_uint(const char *str, unsigned int *val)
+{
+    char *end;
+    errno = 0;
+    unsigned long v = strtoul(str, &end, 0);
+    if (errno != 0 || *end != '\0' || str[0] == '-' || v > UINT_MAX)
+        return -1;
+    *val = (unsigned int)v;
+    return 0;
+}
+
+/* Cut comments, returning the first token of the line or NULL. */
+static char *batch_first_token(char *line, char **save)
+{
+    char *comment = strchr(line, '#');
+    if (comment != NULL)
+        *comment = '\0';
+    return strtok_r(line, BATCH_DELIM, save);
+}
+
+static int batch_parse_key(const char *name)
+{
+    for (int k = 0; k < KEY_MAX; ++k) {
+        if (strcasecmp(name, key_str(k)) == 0)
+            return k;
+    }
+    return -1;
+}
+
+static int batch_input_load(batch_job_t *job)
+{
+    FILE *f = fopen(job->input_path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s\n", job->input_path);
+        return -1;
+    }
+    char magic[4];
+    if (fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+        memcmp(magic, "GBMV", sizeof(magic)) == 0) {
+        fclose(f);
+        job->movie = movie_load(job->input_path);
+        return job->movie != NULL ? 0 : -1;
+    }
+    rewind(f);
+    char *line = NULL;
+    size_t line_size = 0, capacity = 0;
+    unsigned int lineno = 0;
+    int ret = 0;
+    while (getline(&line, &line_size, f) >= 0) {
+        char *save, *tok = batch_first_token(line, &save);
+        ++lineno;
+        if (tok == NULL)
+            continue;
+        batch_input_t in = {0, 0};
+        if (batch_parse_uint(tok, &in.frame) < 0 ||
+            (job->input_count > 0 &&
+             in.frame < job->inputs[job->input_count - 1].frame)) {
+            fprintf(stderr, "%s:%u: invalid frame: %s\n", job->input_path,
+                    lineno, tok);
+            ret = -1;
+            break;
+        }
+        while ((tok = strtok_r(NULL, BATCH_DELIM, &save)) != NULL) {
+            int key = batch_parse_key(tok);
+            if (key < 0) {
+                fprintf(stderr, "%s:%u: unknown key: %s\n", job->input_path,
+                        lineno, tok);
+                ret = -1;
+                break;
+            }
+            in.keys |= 1 << key;
+        }
+        if (ret < 0)
+            break;
+        if (job->input_count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            job->inputs = realloc(job->inputs, capacity * sizeof(in));
+        }
+        job->inputs[job->input_count++] = in;
+    }
+    free(line);
+    fclose(f);
+    return ret;
+}
+
+static size_t batch_add_rom(batch_manifest_t *m, const char *path)
+{
+    for (size_t i = 0; i < m->rom_count; ++i) {
+        if (strcmp(m->roms[i], path) == 0)
+            return i;
+    }
+    m->roms = realloc(m->roms, (m->rom_count + 1) * sizeof(char *));
+    m->roms[m->rom_count] = strdup(path);
+    return m->rom_count++;
+}
+
+int batch_manifest_load(batch_manifest_t *m, const char *path)
+{
+    memset(m, 0, sizeof(*m));
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s\n", path);
+        return -1;
+    }
+    char *line = NULL;
+    size_t line_size = 0, capacity = 0;
+    unsigned int lineno = 0;
+    int ret = 0;
+    while (getline(&line, &line_size, f) >= 0) {
+        char *save, *rom = batch_first_token(line, &save);
+        ++lineno;
+        if (rom == NULL)
+            continue;
+        char *frames = strtok_r(NULL, BATCH_DELIM, &save);
+        char *input = strtok_r(NULL, BATCH_DELIM, &save);
+        batch_job_t job = {0};
+        if (frames == NULL || batch_parse_uint(frames, &job.frames) < 0 ||
+            strtok_r(NULL, BATCH_DELIM, &save) != NULL) {
+            fprintf(stderr, "%s:%u: expected <rom> <frames> [input]\n", path,
+                    lineno);
+            ret = -1;
+            break;
+        }
+        job.rom = batch_add_rom(m, rom);
+        if (input != NULL) {
+            job.input_path = strdup(input);
+            if (batch_input_load(&job) < 0) {
+                free(job.input_path);
+                free(job.inputs);
+                ret = -1;
+                break;
+            }
+        }
+        if (m->job_count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            m->jobs = realloc(m->jobs, capacity * sizeof(job));
+        }
+        m->jobs[m->job_count++] = job;
+    }
+    free(line);
+    fclose(f);
+    if (ret < 0)
+        batch_manifest_free(m);
+    return ret;
+}
+
+void batch_manifest_free(batch_manifest_t *m)
+{
+    for (size_t i = 0; i < m->job_count; ++i) {
+        free(m->jobs[i].input_path);
+        free(m->jobs[i].inputs);
+        movie_destroy(m->jobs[i].movie);
+    }
+    for (size_t i = 0; i < m->rom_count; ++i)
+        free(m->roms[i]);
+    free(m->jobs);
+    free(m->roms);
+    memset(m, 0, sizeof(*m));
+}
@@ -0,0 +1,44 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "movie.h"
+
+/* Keys held from frame on, bit n set when key_e n is pressed. */
+typedef struct {
+    unsigned int frame;
+    uint8_t keys;
+} batch_input_t;
+
+typedef struct {
+    size_t rom;         /* Index in batch_manifest_t.roms. */
+    unsigned int frames;
+    char *input_path;   /* NULL when the job has no input script. */
+    batch_input_t *inputs;
+    size_t input_count;
+    movie_t *movie;     /* Set instead of inputs when given a movie file. */
+} batch_job_t;
+
+typedef struct {
+    batch_job_t *jobs;
+    size_t job_count;
+    char **roms; /* Unique ROM paths, so each one is loaded only once. */
+    size_t rom_count;
+} batch_manifest_t;
+
+/**
+ * Load a job manifest, one job per line:
+ *
+ *     <rom path> <frames> [input script]
+ *
+ * An input script has one "<frame> [key ...]" line per change of the joypad,
+ * in frame order, listing the keys held from that frame on. Key names are
+ * the ones of key_str(), case insensitive. A movie recorded by gusgb -r may
+ * be given instead of an input script. In both files blank lines and
+ * anything after a '#' are ignored, and paths may not contain spaces.
+ */
+int batch_manifest_load(batch_manifest_t *m, const char *path);
+void batch_manifest_free(batch_manifest_t *m);
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,137 @@
+#include "batch/pool.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Jobs [next, end) still owned by a worker. Both are only changed with the
+ * lock held, but thieves peek at them without it to pick a victim.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t end;
+} __attribute__((aligned(64))) pool_slice_t;
+
+typedef struct {
+    pool_slice_t *slices;
+    unsigned int threads;
+    pool_work_f work;
+    void *data;
+} pool_t;
+
+typedef struct {
+    pool_t *pool;
+    unsigned int id;
+    pthread_t thread;
+} pool_worker_t;
+
+static int pool_take(pool_slice_t *s, size_t *job)
+{
+    int ret = -1;
+    pthread_mutex_lock(&s->lock);
+    if (s->next < s->end) {
+        *job = s->next;
+        __atomic_store_n(&s->next, s->next + 1, __ATOMIC_RELAXED);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return ret;
+}
+
+static int pool_steal(pool_t *pool, unsigned int id)
+{
+    /* Look for the biggest victim, a stale view is good enough for that. */
+    unsigned int victim = id;
+    size_t best = 0;
+    for (unsigned int i = 0; i < pool->threads; ++i) {
+        pool_slice_t *s = &pool->slices[i];
+        size_t next = __atomic_load_n(&s->next, __ATOMIC_RELAXED);
+        size_t end = __atomic_load_n(&s->end, __ATOMIC_RELAXED);
+        if (i != id && next < end && end - next > best) {
+            best = end - next;
+            victim = i;
+        }
+    }
+    if (victim == id)
+        return -1;
+    /* Take the upper half, rounded up so a last job can be stolen too. */
+    pool_slice_t *v = &pool->slices[victim];
+    pthread_mutex_lock(&v->lock);
+    size_t end = v->end;
+    size_t next = v->next + (v->end - v->next) / 2;
+    __atomic_store_n(&v->end, next, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&v->lock);
+    pool_slice_t *own = &pool->slices[id];
+    pthread_mutex_lock(&own->lock);
+    __atomic_store_n(&own->next, next, __ATOMIC_RELAXED);
+    __atomic_store_n(&own->end, end, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&own->lock);
+    return 0;
+}
+
+static void *pool_worker(void *arg)
+{
+    pool_worker_t *w = arg;
+    pool_t *pool = w->pool;
+    pool_slice_t *own = &pool->slices[w->id];
+    size_t job;
+    for (;;) {
+        if (pool_take(own, &job) == 0) {
+            pool->work(w->id, job, pool->data);
+        } else if (pool_steal(pool, w->id) < 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int pool_run(unsigned int threads, size_t jobs, pool_work_f work, void *data)
+{
+    if (threads == 0)
+        threads = 1;
+    pool_t pool = {
+        .slices = aligned_alloc(64, threads * sizeof(pool_slice_t)),
+        .threads = threads,
+        .work = work,
+        .data = data,
+    };
+    pool_worker_t *workers = calloc(threads, sizeof(pool_worker_t));
+    if (pool.slices == NULL || workers == NULL) {
+        free(pool.slices);
+        free(workers);
+        return -1;
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        pool_slice_t *s = &pool.slices[i];
+        pthread_mutex_init(&s->lock, NULL);
+        s->next = jobs * i / threads;
+        s->end = jobs * (i + 1) / threads;
+    }
+    unsigned int started = 0;
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers[i].pool = &pool;
+        workers[i].id = i;
+        if (pthread_create(&workers[i].thread, NULL, pool_worker,
+                           &workers[i]) != 0) {
+            fprintf(stderr, "ERROR: could not start worker %u\n", i);
+            break;
+        }
+        ++started;
+    }
+    /* Slices of workers that failed to start are stolen by the others. */
+    for (unsigned int i = 0; i < started; ++i)
+        pthread_join(workers[i].thread, NULL);
+    for (unsigned int i = 0; i < threads; ++i)
+        pthread_mutex_destroy(&pool.slices[i].lock);
+    free(pool.slices);
+    free(workers);
+    return started > 0 ? 0 : -1;
+}
+
+unsigned int pool_default_threads(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned int)n : 1;
+}
@@ -0,0 +1,22 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/* Run job number job on worker number worker. */
+typedef void (*pool_work_f)(unsigned int worker, size_t job, void *data);
+
+/**
+ * Run jobs 0 to jobs - 1 on the given number of threads and wait for them.
+ *
+ * Every worker starts with a contiguous slice of the jobs and takes them in
+ * order. Once its slice is exhausted it steals the upper half of the biggest
+ * remaining slice, so uneven jobs keep every thread busy until the end.
+ * Returns -1 if no thread could be started.
+ */
+int pool_run(unsigned int threads, size_t jobs, pool_work_f work, void *data);
+
+/* Number of online processors, at least 1. */
+unsigned int pool_default_threads(void);
+
+#endif /* POOL_H */
@@ -7,9 +7,6 @@
 
 #define ROM_OFFSET_TITLE 0x134
 
-bool is_cgb;
-cart_t CART;
-
 const char *g_rom_types[256] = {
     [CART_ROM_ONLY] = "ROM ONLY",
     [CART_MBC1] = "MBC1",
@@ -109,68 +106,74 @@ static bool cart_has_rtc(uint8_t cart_type)
     }
 }
 
-static int cart_load_header(void)
+static int cart_load_header(cart_t *cart)
 {
-    if (CART.rom.size < sizeof(cart_header_t)) {
+    if (cart->rom.size < sizeof(cart_header_t)) {
         fprintf(stderr, "ERROR: rom too small!\n");
         return -1;
     }
     /* Copy header pointer. */
-    cart_header_t *header = (cart_header_t *)&CART.rom.bytes[ROM_OFFSET_TITLE];
-    CART.rom.header = header;
-    is_cgb = CART.rom.header->cgb & 0x80;
-    printf("Game title: %.15s\n", header->title);
-    printf("CGB: 0x%.2x (%s)\n", CART.rom.header->cgb,
-           cart_is_cgb() ? "true" : "false");
+    cart_header_t *header =
+        (cart_header_t *)&cart->rom.bytes[ROM_OFFSET_TITLE];
+    cart->rom.header = header;
+    cart->cgb = cart->rom.header->cgb & 0x80;
     /* Get cart type. */
-    CART.type = header->cart_type;
-    printf("Cartridge type: %s\n", g_rom_types[CART.type]);
-    int ret = cart_get_mbc(CART.type, &CART.mbc);
+    cart->type = header->cart_type;
+    int ret = cart_get_mbc(cart->type, &cart->mbc);
     if (ret != 0) {
-        fprintf(stderr, "Cartridge type not supported!\n");
+        fprintf(stderr, "Cartridge type not supported: 0x%.2x\n",
+                cart->type);
         return -1;
     }
     /* Get ROM size. */
     unsigned int rom_size_tmp = 0x8000 << header->rom_size;
-    CART.rom.max_bank = (1 << header->rom_size) * 2;
-    printf("ROM size: %uKB, banks: %u\n", rom_size_tmp / 1024,
-           CART.rom.max_bank);
-    if (CART.rom.size != rom_size_tmp) {
+    cart->rom.max_bank = (1 << header->rom_size) * 2;
+    if (cart->rom.size != rom_size_tmp) {
         fprintf(stderr, "ROM file size does not equal header ROM size!\n");
         return -1;
     }
     /* Get RAM size. */
     switch (header->ram_size) {
         case 0:
-            CART.ram.size = 0;
-            CART.ram.max_bank = 1;
+            cart->ram.size = 0;
+            cart->ram.max_bank = 1;
             break;
         case 1:
-            CART.ram.size = 2 * 1024;
-            CART.ram.max_bank = 1;
+            cart->ram.size = 2 * 1024;
+            cart->ram.max_bank = 1;
             break;
         case 2:
-            CART.ram.size = 8 * 1024;
-            CART.ram.max_bank = 1;
+            cart->ram.size = 8 * 1024;
+            cart->ram.max_bank = 1;
             break;
         case 3:
-            CART.ram.size = 32 * 1024;
-            CART.ram.max_bank = 4;
+            cart->ram.size = 32 * 1024;
+            cart->ram.max_bank = 4;
             break;
         case 4:
-            CART.ram.size = 128 * 1024;
-            CART.ram.max_bank = 16;
+            cart->ram.size = 128 * 1024;
+            cart->ram.max_bank = 16;
             break;
         case 5:
-            CART.ram.size = 64 * 1024;
-            CART.ram.max_bank = 8;
+            cart->ram.size = 64 * 1024;
+            cart->ram.max_bank = 8;
             break;
     }
-    printf("RAM size: %luKB, banks: %u\n", CART.ram.size / 1024,
-           CART.ram.max_bank);
     return 0;
 }
 
+static void cart_print_header(cart_t *cart)
+{
+    printf("Game title: %.15s\n", cart->rom.header->title);
+    printf("CGB: 0x%.2x (%s)\n", cart->rom.header->cgb,
+           cart_is_cgb(cart) ? "true" : "false");
+    printf("Cartridge type: %s\n", g_rom_types[cart->type]);
+    printf("ROM size: %luKB, banks: %u\n", cart->rom.size / 1024,
+           cart->rom.max_bank);
+    printf("RAM size: %luKB, banks: %u\n", cart->ram.size / 1024,
+           cart->ram.max_bank);
+}
+
 static char *card_get_ram_path(const char *rom_path)
 {
     size_t rom_path_len = strlen(rom_path);
@@ -191,62 +194,88 @@ static char *card_get_ram_path(const char *rom_path)
     return ram_path;
 }
 
-static int cart_ram_init(FILE *ram_save_file)
+static int cart_ram_init(cart_t *cart, FILE *ram_save_file)
 {
-    CART.ram.bytes = malloc(CART.ram.size);
-    CART.ram.offset = 0x0000;
+    /* Whole pages even for 2KB carts, so any bank offset is in range. */
+    unsigned int banks = cart->ram.max_bank;
+    for (unsigned int i = 0; i < banks; ++i)
+        cart->ram.banks[i] = page_create(CART_RAM_BANK_SIZE);
+    cart->ram.offset = 0x0000;
     if (ram_save_file) {
-        printf("Loading cartridge RAM from file: %s\n", CART.ram.path);
-        size_t rv;
-        rv = fread(CART.ram.bytes, 1, CART.ram.size, ram_save_file);
-        if (rv != CART.ram.size) {
-            perror("fread ram:");
-            return -1;
+        printf("Loading cartridge RAM from file: %s\n", cart->ram.path);
+        for (unsigned int i = 0; i < banks; ++i) {
+            size_t size = cart_ram_bank_size(cart, i);
+            size_t rv = fread(cart->ram.banks[i]->bytes, 1, size,
+                              ram_save_file);
+            if (rv != size) {
+                perror("fread ram:");
+                return -1;
+            }
         }
-    } else {
-        memset(CART.ram.bytes, 0, CART.ram.size);
     }
-    CART.ram.enabled = false;
+    cart->ram.enabled = false;
     /* Init RTC if present. */
-    if (cart_has_rtc(CART.type)) {
-        if (mbc3_rtc_load(ram_save_file) < 0) {
+    if (cart_has_rtc(cart->type)) {
+        if (mbc3_rtc_load(cart, ram_save_file) < 0) {
             return -1;
         }
     }
     return 0;
 }
 
-static void cart_ram_save(void)
+static int cart_ram_write(cart_t *cart, FILE *f)
 {
-    if (cart_has_battery(CART.type) && CART.ram.path != NULL) {
-        FILE *f = fopen(CART.ram.path, "w");
+    for (unsigned int i = 0; i < CART_RAM_MAX_BANKS; ++i) {
+        size_t size = cart_ram_bank_size(cart, i);
+        if (size > 0 && fwrite(cart->ram.banks[i]->bytes, 1, size, f) != size)
+            return -1;
+    }
+    return 0;
+}
+
+static void cart_ram_save(cart_t *cart)
+{
+    if (cart_has_battery(cart->type) && cart->ram.path != NULL) {
+        FILE *f = fopen(cart->ram.path, "w");
         if (f == NULL) {
-            fprintf(stderr, "ERROR: Could not open %s\n", CART.ram.path);
+            fprintf(stderr, "ERROR: Could not open %s\n", cart->ram.path);
             return;
         }
-        size_t rv = fwrite(CART.ram.bytes, 1, CART.ram.size, f);
-        if (rv != CART.ram.size) {
+        if (cart_ram_write(cart, f) < 0) {
             fprintf(stderr, "ERROR: Could not save cartridge RAM to %s\n",
-                    CART.ram.path);
+                    cart->ram.path);
             fclose(f);
             return;
         }
-        printf("Cartridge RAM saved to file: %s\n", CART.ram.path);
-        if (cart_has_rtc(CART.type)) {
-            mbc3_rtc_save(f);
+        printf("Cartridge RAM saved to file: %s\n", cart->ram.path);
+        if (cart_has_rtc(cart->type)) {
+            mbc3_rtc_save(cart, f);
         }
         fclose(f);
     }
 }
 
-static void cart_destroy(void)
+static void cart_rom_release(cart_rom_image_t *image)
+{
+    if (image != NULL && atomic_fetch_sub(&image->refs, 1) == 1) {
+        cart_rom_jit_t *jit = atomic_load(&image->jit);
+        if (jit != NULL)
+            jit->free(jit);
+        free(image->code);
+        free(image);
+    }
+}
+
+static void cart_destroy(cart_t *cart)
 {
-    free(CART.ram.path);
-    free(CART.rom.bytes);
-    free(CART.ram.bytes);
+    free(cart->ram.path);
+    cart_rom_release(cart->rom.image);
+    for (unsigned int i = 0; i < CART_RAM_MAX_BANKS; ++i)
+        page_unref(cart->ram.banks[i]);
+    memset(cart, 0, sizeof(*cart));
 }
 
-int cart_load(const char *path)
+int cart_load(cart_t *cart, const char *path)
 {
     FILE *file = fopen(path, "rb");
     if (file == NULL) {
@@ -257,71 +286,135 @@ int cart_load(const char *path)
     size_t size = (size_t)ftell(file);
     rewind(file);
     /* Init ROM. */
-    CART.rom.size = size;
-    CART.rom.bytes = malloc(size);
-    CART.rom.offset = 0x4000;
+    cart_rom_image_t *image = malloc(sizeof(*image) + size);
+    atomic_init(&image->refs, 1);
+    atomic_init(&image->idle_off, false);
+    atomic_init(&image->bulk_off, false);
+    atomic_init(&image->jit_off, false);
+    atomic_init(&image->jit, NULL);
+    image->size = size;
+    /* Only the pages holding decoded code are ever touched. */
+    image->code = calloc(size, sizeof(*image->code));
+    if (image->code == NULL) {
+        fprintf(stderr, "ERROR: calloc\n");
+        fclose(file);
+        free(image);
+        return -1;
+    }
+    cart->rom.image = image;
+    cart->rom.size = size;
+    cart->rom.bytes = image->bytes;
+    cart->rom.offset = 0x4000;
     /* Read rom to memory. */
-    size_t read_size = fread(CART.rom.bytes, 1, size, file);
+    size_t read_size = fread(cart->rom.bytes, 1, size, file);
     fclose(file);
     if (read_size != size) {
         fprintf(stderr, "ERROR: fread\n");
+        cart_rom_release(image);
         return -1;
     }
     /* Read ROM header. */
-    int ret = cart_load_header();
+    int ret = cart_load_header(cart);
     if (ret < 0) {
-        cart_destroy();
+        cart_destroy(cart);
         return -1;
     }
-    CART.ram.path = card_get_ram_path(path);
-    FILE *ram_save_file = fopen(CART.ram.path, "r");
+    cart_print_header(cart);
+    cart->ram.path = card_get_ram_path(path);
+    FILE *ram_save_file = fopen(cart->ram.path, "r");
     /* Init RAM. */
-    ret = cart_ram_init(ram_save_file);
+    ret = cart_ram_init(cart, ram_save_file);
     if (ret < 0) {
         if (ram_save_file)
             fclose(ram_save_file);
-        cart_destroy();
+        cart_destroy(cart);
         return -1;
     }
     if (ram_save_file)
         fclose(ram_save_file);
     /* Init MBC. */
-    CART.mbc.init();
+    cart->mbc.init(cart);
     return 0;
 }
 
-void cart_unload(void)
+int cart_load_shared(cart_t *cart, const cart_t *src)
+{
+    /* Reuse the ROM image of src, RAM starts empty and is never saved. */
+    cart_rom_image_t *image = src->rom.image;
+    atomic_fetch_add(&image->refs, 1);
+    cart->rom.image = image;
+    cart->rom.size = image->size;
+    cart->rom.bytes = image->bytes;
+    cart->rom.offset = 0x4000;
+    int ret = cart_load_header(cart);
+    if (ret < 0) {
+        cart_destroy(cart);
+        return -1;
+    }
+    cart->ram.path = NULL;
+    ret = cart_ram_init(cart, NULL);
+    if (ret < 0) {
+        cart_destroy(cart);
+        return -1;
+    }
+    cart->mbc.init(cart);
+    return 0;
+}
+
+void cart_reset(cart_t *cart)
+{
+    cart->mbc.mode = 0;
+    cart->rom.offset = 0x4000;
+    cart->ram.offset = 0x0000;
+    cart->ram.enabled = false;
+    cart->mbc.init(cart);
+}
+
+void cart_fork(cart_t *cart, const cart_t *src)
+{
+    *cart = *src;
+    atomic_fetch_add(&cart->rom.image->refs, 1);
+    for (unsigned int i = 0; i < CART_RAM_MAX_BANKS; ++i) {
+        if (src->ram.banks[i] != NULL)
+            page_ref(src->ram.banks[i]);
+    }
+    cart->ram.path = NULL;
+}
+
+void cart_unload(cart_t *cart)
 {
-    cart_ram_save();
-    cart_destroy();
+    cart_ram_save(cart);
+    cart_destroy(cart);
 }
 
-uint8_t cart_read_rom0(uint16_t addr)
+void cart_detach_save(cart_t *cart)
 {
-    return CART.rom.bytes[addr];
+    /* Keep the loaded RAM contents, but never write them back. */
+    free(cart->ram.path);
+    cart->ram.path = NULL;
 }
 
-uint8_t cart_read_rom1(uint16_t addr)
+uint8_t cart_read_rom0(cart_t *cart, uint16_t addr)
 {
-    return CART.rom.bytes[CART.rom.offset + (addr & 0x3fff)];
+    return cart->rom.bytes[addr];
 }
 
-void cart_write_mbc(uint16_t addr, uint8_t val)
+uint8_t cart_read_rom1(cart_t *cart, uint16_t addr)
 {
-    CART.mbc.write(addr, val);
+    return cart->rom.bytes[cart->rom.offset + (addr & 0x3fff)];
 }
 
-uint8_t cart_read_ram(uint16_t addr)
+void cart_write_mbc(cart_t *cart, uint16_t addr, uint8_t val)
 {
-    return CART.mbc.ram_read(addr);
+    cart->mbc.write(cart, addr, val);
 }
 
-void cart_write_ram(uint16_t addr, uint8_t val)
+uint8_t cart_read_ram(cart_t *cart, uint16_t addr)
 {
-    CART.mbc.ram_write(addr, val);
+    return cart->mbc.ram_read(cart, addr);
 }
 
-inline bool cart_is_cgb(void)
+void cart_write_ram(cart_t *cart, uint16_t addr, uint8_t val)
 {
-    return is_cgb;
+    cart->mbc.ram_write(cart, addr, val);
 }
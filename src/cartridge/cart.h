@@ -1,10 +1,18 @@
 #ifndef __CART_H__
 #define __CART_H__
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include "mbc3.h"
+#include "../page.h"
+
+typedef struct cart cart_t;
+
+#define CART_RAM_BANK_SIZE 0x2000
+#define CART_RAM_MAX_BANKS 16
 
 typedef enum {
     CART_ROM_ONLY = 0x00,
@@ -55,7 +63,25 @@ typedef struct {
     uint8_t checksum_l;   /* 0x14f: checksum low */
 } cart_header_t;
 
+/* Code compiled from the ROM, see cpu_jit.h, freed with the image. */
+typedef struct cart_rom_jit {
+    void (*free)(struct cart_rom_jit *jit);
+} cart_rom_jit_t;
+
+/* ROM file contents. Read-only, so instances running the same game share it. */
 typedef struct {
+    atomic_uint refs; /* Number of carts using this image. */
+    size_t size;
+    _Atomic uint32_t *code; /* Instructions decoded by the CPU, by offset. */
+    atomic_bool idle_off;   /* Idle loops of the game are not skipped. */
+    atomic_bool bulk_off;   /* Nor its copy loops run in bulk. */
+    atomic_bool jit_off;    /* Nor its code compiled. */
+    _Atomic(cart_rom_jit_t *) jit; /* Made by the first instance to run it. */
+    uint8_t bytes[];
+} cart_rom_image_t;
+
+typedef struct {
+    cart_rom_image_t *image;
     uint8_t *bytes;
     size_t size;
     cart_header_t *header;
@@ -64,7 +90,7 @@ typedef struct {
 } cart_rom_t;
 
 typedef struct {
-    uint8_t *bytes;
+    page_t *banks[CART_RAM_MAX_BANKS]; /* max_bank pages of 8KB. */
     size_t size;
     unsigned int offset;
     unsigned int max_bank;
@@ -72,32 +98,80 @@ typedef struct {
     bool enabled;
 } cart_ram_t;
 
-typedef void (*mbc_init_f)(void);
-typedef void (*mbc_write_f)(uint16_t addr, uint8_t val);
-typedef uint8_t (*mbc_ram_read_f)(uint16_t addr);
-typedef void (*mbc_ram_write_f)(uint16_t addr, uint8_t val);
+typedef void (*mbc_init_f)(cart_t *cart);
+typedef void (*mbc_write_f)(cart_t *cart, uint16_t addr, uint8_t val);
+typedef uint8_t (*mbc_ram_read_f)(cart_t *cart, uint16_t addr);
+typedef void (*mbc_ram_write_f)(cart_t *cart, uint16_t addr, uint8_t val);
 
 typedef struct {
     mbc_init_f init;
     mbc_write_f write;
     mbc_ram_read_f ram_read;
     mbc_ram_write_f ram_write;
+    uint32_t rom_bank;
+    uint32_t ram_bank;
+    uint8_t mode;  /* MBC1: ROM/RAM banking mode. */
+    uint8_t latch; /* MBC3: last value written to the latch register. */
+    rtc_t rtc;     /* MBC3: real time clock. */
 } cart_mbc_t;
 
-typedef struct {
+struct cart {
     cart_type_e type;
+    bool cgb;
     cart_rom_t rom;
     cart_ram_t ram;
     cart_mbc_t mbc;
-} cart_t;
-
-int cart_load(const char *path);
-void cart_unload(void);
-uint8_t cart_read_rom0(uint16_t addr);
-uint8_t cart_read_rom1(uint16_t addr);
-void cart_write_mbc(uint16_t addr, uint8_t val);
-uint8_t cart_read_ram(uint16_t addr);
-void cart_write_ram(uint16_t addr, uint8_t val);
-extern bool cart_is_cgb(void);
+};
+
+int cart_load(cart_t *cart, const char *path);
+int cart_load_shared(cart_t *cart, const cart_t *src);
+/* Put the MBC back in its power on state. RAM contents are kept. */
+void cart_reset(cart_t *cart);
+/* Copy src, sharing its ROM and RAM pages. The copy is never saved. */
+void cart_fork(cart_t *cart, const cart_t *src);
+void cart_unload(cart_t *cart);
+void cart_detach_save(cart_t *cart);
+uint8_t cart_read_rom0(cart_t *cart, uint16_t addr);
+uint8_t cart_read_rom1(cart_t *cart, uint16_t addr);
+void cart_write_mbc(cart_t *cart, uint16_t addr, uint8_t val);
+uint8_t cart_read_ram(cart_t *cart, uint16_t addr);
+void cart_write_ram(cart_t *cart, uint16_t addr, uint8_t val);
+
+static inline bool cart_is_cgb(const cart_t *cart)
+{
+    return cart->cgb;
+}
+
+/**
+ * Hot paths taking the model as a constant bool cgb are forced inline into
+ * one DMG and one CGB entry point, picked by function pointer at load, so
+ * their model checks fold away.
+ */
+#if defined(__GNUC__)
+#define CART_MODEL_INLINE static inline __attribute__((always_inline))
+#else
+#define CART_MODEL_INLINE static inline
+#endif
+
+/* Bytes of RAM in the given bank: less than a page for 2KB carts. */
+static inline size_t cart_ram_bank_size(const cart_t *cart, unsigned int bank)
+{
+    size_t start = (size_t)bank * CART_RAM_BANK_SIZE;
+    if (start >= cart->ram.size)
+        return 0;
+    size_t left = cart->ram.size - start;
+    return left < CART_RAM_BANK_SIZE ? left : CART_RAM_BANK_SIZE;
+}
+
+/* Access to the selected RAM bank, for the MBCs. */
+static inline uint8_t cart_ram_get(cart_t *cart, uint16_t addr)
+{
+    return cart->ram.banks[cart->ram.offset >> 13]->bytes[addr & 0x1fff];
+}
+
+static inline void cart_ram_set(cart_t *cart, uint16_t addr, uint8_t val)
+{
+    page_write(&cart->ram.banks[cart->ram.offset >> 13])[addr & 0x1fff] = val;
+}
 
 #endif /* __CART_H__ */
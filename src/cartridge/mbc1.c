@@ -1,61 +1,58 @@
 #include "mbc1.h"
 #include "cart.h"
 
-static uint32_t rom_bank;
-static uint32_t ram_bank;
-static uint8_t mode;
-extern cart_t CART;
-
-void mbc1_init(void)
+void mbc1_init(cart_t *cart)
 {
-    rom_bank = 1;
-    ram_bank = 0;
-    mode = 0;
+    cart->mbc.rom_bank = 1;
+    cart->mbc.ram_bank = 0;
+    cart->mbc.mode = 0;
 }
 
-void mbc1_write(uint16_t addr, uint8_t val)
+void mbc1_write(cart_t *cart, uint16_t addr, uint8_t val)
 {
     if (addr <= 0x1fff) {
         /* Enable/disable external RAM. */
-        CART.ram.enabled = (val & 0x0f) == 0x0a;
+        cart->ram.enabled = (val & 0x0f) == 0x0a;
     } else if (addr <= 0x3fff) {
         /* Switch between banks 1-31 (value 0 is seen as 1). */
         uint8_t bankl = val & 0x1f;
         if (bankl == 0)
             bankl = 1;
-        if (mode == 0) {
-            rom_bank = (uint8_t)((rom_bank & 0x60) | bankl);
+        if (cart->mbc.mode == 0) {
+            cart->mbc.rom_bank =
+                (uint8_t)((cart->mbc.rom_bank & 0x60) | bankl);
         } else {
-            rom_bank = bankl;
+            cart->mbc.rom_bank = bankl;
         }
-        CART.rom.offset = (rom_bank % CART.rom.max_bank) << 14;
+        cart->rom.offset = (cart->mbc.rom_bank % cart->rom.max_bank) << 14;
     } else if (addr <= 0x5fff) {
-        if (mode) {
+        if (cart->mbc.mode) {
             /* RAM mode: switch RAM bank 0-3. */
-            ram_bank = val & 3;
-            CART.ram.offset = (ram_bank % CART.ram.max_bank) << 13;
+            cart->mbc.ram_bank = val & 3;
+            cart->ram.offset = (cart->mbc.ram_bank % cart->ram.max_bank) << 13;
         } else {
             /* ROM mode (high 2 bits): switch ROM bank "set" {1-31}-{97-127}. */
-            rom_bank = (rom_bank & 0x1f) | ((val & 3) << 5);
-            CART.rom.offset = (rom_bank % CART.rom.max_bank) << 14;
+            cart->mbc.rom_bank =
+                (cart->mbc.rom_bank & 0x1f) | ((val & 3) << 5);
+            cart->rom.offset = (cart->mbc.rom_bank % cart->rom.max_bank) << 14;
         }
     } else {
-        mode = val & 1;
+        cart->mbc.mode = val & 1;
     }
 }
 
-uint8_t mbc1_ram_read(uint16_t addr)
+uint8_t mbc1_ram_read(cart_t *cart, uint16_t addr)
 {
-    if (CART.ram.enabled) {
-        return CART.ram.bytes[CART.ram.offset + (addr & 0x1fff)];
+    if (cart->ram.enabled) {
+        return cart_ram_get(cart, addr);
     } else {
         return 0xff;
     }
 }
 
-void mbc1_ram_write(uint16_t addr, uint8_t val)
+void mbc1_ram_write(cart_t *cart, uint16_t addr, uint8_t val)
 {
-    if (CART.ram.enabled) {
-        CART.ram.bytes[CART.ram.offset + (addr & 0x1fff)] = val;
+    if (cart->ram.enabled) {
+        cart_ram_set(cart, addr, val);
     }
 }
@@ -3,9 +3,11 @@
 
 #include <stdint.h>
 
-void mbc1_init(void);
-void mbc1_write(uint16_t addr, uint8_t val);
-uint8_t mbc1_ram_read(uint16_t addr);
-void mbc1_ram_write(uint16_t addr, uint8_t val);
+typedef struct cart cart_t;
+
+void mbc1_init(cart_t *cart);
+void mbc1_write(cart_t *cart, uint16_t addr, uint8_t val);
+uint8_t mbc1_ram_read(cart_t *cart, uint16_t addr);
+void mbc1_ram_write(cart_t *cart, uint16_t addr, uint8_t val);
 
 #endif /* __MBC1_H__ */
@@ -6,42 +6,38 @@
 #define HOUR_SECS (60 * 60)
 #define DAY_SECS (60 * 60 * 24)
 
-static uint32_t rom_bank;
-static uint32_t ram_bank;
-static rtc_t rtc;
-
-extern cart_t CART;
-
-void mbc3_init(void)
+void mbc3_init(cart_t *cart)
 {
-    rom_bank = 1;
-    ram_bank = 0;
+    cart->mbc.rom_bank = 1;
+    cart->mbc.ram_bank = 0;
+    cart->mbc.latch = 0xff;
 }
 
-int mbc3_rtc_load(FILE *file)
+int mbc3_rtc_load(cart_t *cart, FILE *file)
 {
+    rtc_t *rtc = &cart->mbc.rtc;
     if (file) {
-        int rv = fread(&rtc, 1, sizeof(rtc), file);
-        if (rv != sizeof(rtc)) {
+        int rv = fread(rtc, 1, sizeof(*rtc), file);
+        if (rv != sizeof(*rtc)) {
             fprintf(stderr, "RTC not present in save file\n");
             return -1;
         }
     } else {
-        memset(&rtc.time, 0, sizeof(rtc.time));
-        memset(&rtc.latched_time, 0, sizeof(rtc.latched_time));
-        rtc.time_last = time(NULL);
+        memset(&rtc->time, 0, sizeof(rtc->time));
+        memset(&rtc->latched_time, 0, sizeof(rtc->latched_time));
+        rtc->time_last = time(NULL);
     }
     printf("RTC current: ");
-    rtc_print(&rtc.time);
+    rtc_print(&rtc->time);
     printf("RTC latched: ");
-    rtc_print(&rtc.latched_time);
+    rtc_print(&rtc->latched_time);
     return 0;
 }
 
-int mbc3_rtc_save(FILE *file)
+int mbc3_rtc_save(cart_t *cart, FILE *file)
 {
-    int rv = fwrite(&rtc, 1, sizeof(rtc), file);
-    if (rv != sizeof(rtc)) {
+    int rv = fwrite(&cart->mbc.rtc, 1, sizeof(rtc_t), file);
+    if (rv != sizeof(rtc_t)) {
         fprintf(stderr, "Could not save RTC to save file\n");
         return -1;
     }
@@ -70,44 +66,45 @@ void mbc3_rtc_update(rtc_time_t *time, time_t diff)
     time->sec = new_time % 60;
 }
 
-void mbc3_write(uint16_t addr, uint8_t val)
+void mbc3_write(cart_t *cart, uint16_t addr, uint8_t val)
 {
     if (addr <= 0x1fff) {
         /* Enable/disable external RAM. */
-        CART.ram.enabled = (val & 0x0f) == 0x0a ? true : false;
+        cart->ram.enabled = (val & 0x0f) == 0x0a ? true : false;
     } else if (addr <= 0x3fff) {
         /* Select ROM bank (value 0 is seen as 1). */
         uint8_t bank = val & 0x7f;
-        rom_bank = bank == 0 ? 1 : bank;
-        CART.rom.offset = (rom_bank % CART.rom.max_bank) << 14;
+        cart->mbc.rom_bank = bank == 0 ? 1 : bank;
+        cart->rom.offset = (cart->mbc.rom_bank % cart->rom.max_bank) << 14;
     } else if (addr <= 0x5fff) {
         /* Select RAM bank. */
-        ram_bank = val;
-        CART.ram.offset = (ram_bank % CART.ram.max_bank) << 13;
+        cart->mbc.ram_bank = val;
+        cart->ram.offset = (cart->mbc.ram_bank % cart->ram.max_bank) << 13;
     } else {
-        if (CART.ram.enabled) {
+        if (cart->ram.enabled) {
             /* Latch Clock Data. */
-            static uint8_t last = 0xff;
-            if ((rtc.time.reg[4] & 0x40) == 0 && last == 0 && val == 1) {
+            rtc_t *rtc = &cart->mbc.rtc;
+            if ((rtc->time.reg[4] & 0x40) == 0 && cart->mbc.latch == 0 &&
+                val == 1) {
                 time_t now = time(NULL);
-                time_t time_diff = now - rtc.time_last;
-                mbc3_rtc_update(&rtc.time, time_diff);
-                rtc.time_last = now;
-                rtc.latched_time = rtc.time;
+                time_t time_diff = now - rtc->time_last;
+                mbc3_rtc_update(&rtc->time, time_diff);
+                rtc->time_last = now;
+                rtc->latched_time = rtc->time;
             }
-            last = val;
+            cart->mbc.latch = val;
         }
     }
 }
 
-uint8_t mbc3_ram_read(uint16_t addr)
+uint8_t mbc3_ram_read(cart_t *cart, uint16_t addr)
 {
-    if (CART.ram.enabled) {
-        uint8_t bank = ram_bank;
+    if (cart->ram.enabled) {
+        uint8_t bank = cart->mbc.ram_bank;
         if (bank <= 7) {
-            return CART.ram.bytes[CART.ram.offset + (addr & 0x1fff)];
+            return cart_ram_get(cart, addr);
         } else if (bank <= 0x0c) {
-            return rtc.latched_time.reg[bank - 8];
+            return cart->mbc.rtc.latched_time.reg[bank - 8];
         } else {
             return 0xff;
         }
@@ -116,19 +113,20 @@ uint8_t mbc3_ram_read(uint16_t addr)
     }
 }
 
-void mbc3_ram_write(uint16_t addr, uint8_t val)
+void mbc3_ram_write(cart_t *cart, uint16_t addr, uint8_t val)
 {
-    if (CART.ram.enabled) {
-        uint8_t bank = ram_bank;
+    if (cart->ram.enabled) {
+        uint8_t bank = cart->mbc.ram_bank;
         if (bank <= 7) {
-            CART.ram.bytes[CART.ram.offset + (addr & 0x1fff)] = val;
+            cart_ram_set(cart, addr, val);
         } else if (bank <= 0x0c) {
-            if (rtc.time.reg[4] & 0x40 || (bank == 0x0c && val & 0x40)) {
+            rtc_t *rtc = &cart->mbc.rtc;
+            if (rtc->time.reg[4] & 0x40 || (bank == 0x0c && val & 0x40)) {
                 /* The Halt Flag is supposed to be set before writing to the RTC
                  * registers. */
-                rtc.time.reg[bank - 8] = val;
+                rtc->time.reg[bank - 8] = val;
                 if ((val & 0x40) == 0) {
-                    rtc.time_last = time(NULL);
+                    rtc->time_last = time(NULL);
                 }
             }
         }
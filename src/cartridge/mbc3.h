@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <time.h>
 
+typedef struct cart cart_t;
+
 typedef struct {
     union {
         uint32_t reg[5];
@@ -26,12 +28,12 @@ typedef struct {
     time_t time_last;
 } rtc_t;
 
-void mbc3_init(void);
-void mbc3_write(uint16_t addr, uint8_t val);
-uint8_t mbc3_ram_read(uint16_t addr);
-void mbc3_ram_write(uint16_t addr, uint8_t val);
+void mbc3_init(cart_t *cart);
+void mbc3_write(cart_t *cart, uint16_t addr, uint8_t val);
+uint8_t mbc3_ram_read(cart_t *cart, uint16_t addr);
+void mbc3_ram_write(cart_t *cart, uint16_t addr, uint8_t val);
 void mbc3_rtc_update(rtc_time_t *time, time_t diff);
-int mbc3_rtc_load(FILE *file);
-int mbc3_rtc_save(FILE *file);
+int mbc3_rtc_load(cart_t *cart, FILE *file);
+int mbc3_rtc_save(cart_t *cart, FILE *file);
 
 #endif /* __MBC3_H__ */
@@ -3,9 +3,11 @@
 
 #include <stdint.h>
 
-void mbc5_init(void);
-void mbc5_write(uint16_t addr, uint8_t val);
-uint8_t mbc5_ram_read(uint16_t addr);
-void mbc5_ram_write(uint16_t addr, uint8_t val);
+typedef struct cart cart_t;
+
+void mbc5_init(cart_t *cart);
+void mbc5_write(cart_t *cart, uint16_t addr, uint8_t val);
+uint8_t mbc5_ram_read(cart_t *cart, uint16_t addr);
+void mbc5_ram_write(cart_t *cart, uint16_t addr, uint8_t val);
 
 #endif /* MBC5_H */
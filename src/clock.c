@@ -1,25 +1,124 @@
 #include "clock.h"
+#include <limits.h>
+#include <string.h>
+#include "apu/apu.h"
+#include "gb.h"
+#include "gpu.h"
+#include "interrupt.h"
 #include "timer.h"
 
-static unsigned int step;
+void clock_reset(gb_t *gb)
+{
+    memset(&gb->clock, 0, sizeof(gb->clock));
+    gb->clock.end = UINT64_MAX;
+    timer_reset(gb);
+}
+
+inline void clock_step(gb_t *gb, unsigned int cycles)
+{
+    gb->clock.step += cycles;
+}
+
+inline unsigned int clock_get_step(gb_t *gb)
+{
+    return gb->clock.step;
+}
+
+inline void clock_clear(gb_t *gb)
+{
+    gb->clock.step = 0;
+}
+
+inline uint64_t clock_now(gb_t *gb)
+{
+    return gb->clock.cycles + gb->clock.step;
+}
+
+/* Due times of the events, with the PPU and APU caught up. */
+static void clock_schedule(gb_t *gb)
+{
+    gb_clock_t *clock = &gb->clock;
+    uint64_t now = clock->cycles;
+    clock->at[CLOCK_EVENT_PPU] = now + gpu_next_event(gb);
+    clock->at[CLOCK_EVENT_OAM_DMA] = now + gpu_oam_dma_next_event(gb);
+    clock->at[CLOCK_EVENT_TIMER] = now + timer_next_event(gb);
+    interrupt_pending(gb, INTERRUPT_PENDING_TIMER,
+                      clock->at[CLOCK_EVENT_TIMER] <= now + CLOCK_STEP_MAX);
+    clock->next = clock->at[0];
+    for (unsigned int i = 1; i < CLOCK_EVENTS; ++i) {
+        if (clock->at[i] < clock->next)
+            clock->next = clock->at[i];
+    }
+}
+
+bool clock_commit(gb_t *gb)
+{
+    gb_clock_t *clock = &gb->clock;
+    clock->cycles += clock->step;
+    clock->step = 0;
+    if (clock->cycles + CLOCK_STEP_MAX < clock->next)
+        return false;
+    clock_flush(gb);
+    return true;
+}
+
+void clock_sync(gb_t *gb)
+{
+    gb_clock_t *clock = &gb->clock;
+    unsigned int pending = (unsigned int)(clock->cycles - clock->synced);
+    clock->synced = clock->cycles;
+    /* Accesses may move the events: due until found again. */
+    for (unsigned int i = 0; i < CLOCK_EVENTS; ++i)
+        clock->at[i] = clock->cycles;
+    clock->next = clock->cycles;
+    interrupt_pending(gb, INTERRUPT_PENDING_TIMER, true);
+    if (pending > 0) {
+        apu_tick(gb, pending);
+        gpu_tick(gb, pending);
+    }
+}
+
+void clock_flush(gb_t *gb)
+{
+    clock_sync(gb);
+    timer_sync(gb);
+    clock_schedule(gb);
+}
+
+/* Cycles from the step to cycle at. */
+static unsigned int clock_left(gb_t *gb, uint64_t at)
+{
+    uint64_t now = clock_now(gb);
+    if (at <= now)
+        return 0;
+    return at - now < UINT_MAX ? (unsigned int)(at - now) : UINT_MAX;
+}
 
-void clock_reset(void)
+unsigned int clock_next_event(gb_t *gb)
 {
-    timer_reset();
+    gb_clock_t *clock = &gb->clock;
+    return clock_left(gb, clock->next < clock->end ? clock->next : clock->end);
 }
 
-inline void clock_step(unsigned int cycles)
+unsigned int clock_until(gb_t *gb, clock_event_e event)
 {
-    timer_step(cycles);
-    step += cycles;
+    return clock_left(gb, gb->clock.at[event]);
 }
 
-inline unsigned int clock_get_step(void)
+void clock_skip(gb_t *gb, unsigned int cycles)
 {
-    return step;
+    gb->clock.step += cycles;
+    /* The step may now reach the timer event. */
+    interrupt_pending(gb, INTERRUPT_PENDING_TIMER, true);
 }
 
-inline void clock_clear(void)
+unsigned int clock_idle(gb_t *gb)
 {
-    step = 0;
+    unsigned int next = clock_next_event(gb);
+    /* Leave this instruction's 4 cycles and the step reaching the event. */
+    if (next <= 8)
+        return 0;
+    unsigned int cycles = ((next + 3) & ~3u) - 8;
+    clock_skip(gb, cycles);
+    return cycles;
 }
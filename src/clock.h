@@ -1,9 +1,79 @@
 #ifndef CLOCK_H
 #define CLOCK_H
 
-void clock_reset(void);
-extern void clock_step(unsigned int cycles);
-extern unsigned int clock_get_step(void);
-extern void clock_clear(void);
+typedef struct gb gb_t;
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Most cycles an instruction takes, with the interrupt dispatch after it. */
+#define CLOCK_STEP_MAX 48
+
+/* Sources of events, each due at a cycle of the count. */
+typedef enum {
+    CLOCK_EVENT_PPU,     /* Mode or line change. */
+    CLOCK_EVENT_OAM_DMA, /* Due every instruction while OAM DMA runs. */
+    CLOCK_EVENT_TIMER,   /* TIMA overflow. */
+    CLOCK_EVENTS,
+} clock_event_e;
+
+/**
+ * No device sees every cycle. The timer is brought up to date when the CPU
+ * accesses it or IF, or its overflow may be due. The PPU and APU see whole
+ * instructions: the cycles of those run before the earliest event add up, and
+ * they take them all at once. The events are found again each time they do.
+ * The APU has none, it places its samples and sequencer steps itself.
+ */
+typedef struct {
+    uint64_t cycles;   /* Since reset, to the start of this instruction. */
+    unsigned int step; /* Cycles elapsed in the current instruction. */
+    uint64_t synced;   /* Cycles the PPU and APU have seen. */
+    uint64_t at[CLOCK_EVENTS]; /* Cycle each event is due at. */
+    uint64_t next;             /* Earliest of them. */
+    uint64_t end; /* Cycle the current run stops at, skips stay short of it. */
+} gb_clock_t;
+
+void clock_reset(gb_t *gb);
+extern void clock_step(gb_t *gb, unsigned int cycles);
+extern unsigned int clock_get_step(gb_t *gb);
+extern void clock_clear(gb_t *gb);
+/* Cycles since reset, with the step. */
+extern uint64_t clock_now(gb_t *gb);
+
+/**
+ * End an instruction: its step goes to the count, and if an event may come
+ * within the next one the PPU and APU catch up and the events are found
+ * again. Returns true if they were.
+ */
+bool clock_commit(gb_t *gb);
+
+/**
+ * Tick the PPU and APU up to the start of this instruction, before the CPU
+ * accesses them. The events are due until the next commit finds them again.
+ */
+void clock_sync(gb_t *gb);
+
+/**
+ * Same at the end of an instruction, with the timer brought up to date and
+ * the events found again at once.
+ */
+void clock_flush(gb_t *gb);
+
+/**
+ * Cycles the step can grow by before reaching a timer or PPU event, or the
+ * end of the run.
+ */
+unsigned int clock_next_event(gb_t *gb);
+/* Same for one event. */
+unsigned int clock_until(gb_t *gb, clock_event_e event);
+/* Add cycles to the step at once, fewer than clock_next_event(). */
+void clock_skip(gb_t *gb, unsigned int cycles);
+
+/**
+ * Called at the start of an instruction that idles the CPU: skip ahead to the
+ * 4 cycle step before the next timer or PPU event, or the end of the run, so
+ * that step and the event run as usual. Returns the cycles added to the step.
+ */
+unsigned int clock_idle(gb_t *gb);
 
 #endif /* CLOCK_H */
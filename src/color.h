@@ -1,10 +1,13 @@
 #ifndef COLOR_H
 #define COLOR_H
 
-#include <SDL2/SDL.h>
+#include <stdint.h>
 
+#define COLOR_ALPHA_OPAQUE 0xff
+
+/* Pixel laid out as a native endian ARGB8888 word. */
 typedef struct {
-#if (SDL_BYTE_ORDER == SDL_BIG_ENDIAN)
+#if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
     uint8_t a, r, g, b;
 #else
     uint8_t b, g, r, a;
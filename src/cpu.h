@@ -6,6 +6,8 @@
 #include <stdint.h>
 #include "gpu.h"
 
+typedef struct gb gb_t;
+
 /**
  * References:
  *
@@ -39,14 +41,6 @@
 
 #define FLAG_ANY (FLAG_C | FLAG_H | FLAG_N | FLAG_Z)
 
-#define FLAG_IS_SET(flag) (uint8_t)(CPU.reg.f & flag)
-#define FLAG_SET(x) (CPU.reg.f |= (x))
-#define FLAG_CLEAR(x) (CPU.reg.f &= (uint8_t)(~(x)))
-#define FLAG_SET_ZERO(value) \
-    (CPU.reg.f = (uint8_t)((CPU.reg.f & 0x7f) | (((value)&1) << 7)))
-#define FLAG_SET_CARRY(value) \
-    (CPU.reg.f = (uint8_t)((CPU.reg.f & 0xef) | (((value)&1) << 4)))
-
 /**
  * Z80 registers struct.
  */
@@ -95,21 +89,139 @@ typedef struct {
     uint16_t pc;
 } cpu_registers_t;
 
+/**
+ * The flags are kept apart and only put together into F when it is read, so
+ * an instruction stores what it computed instead of updating F bit by bit:
+ * Z is set when z is 0, as it holds the result,
+ * N is set when n is not 0,
+ * H is bit 4 of h, which holds operands ^ result for arithmetic,
+ * C is bit 0 of c.
+ * F in reg is only up to date where documented.
+ *
+ * Building with CPU_EAGER_FLAGS keeps F itself up to date instead, for
+ * gb_bench to compare.
+ */
+#ifdef CPU_EAGER_FLAGS
+typedef struct {
+    uint8_t f;
+} cpu_flags_t;
+#else
+typedef struct {
+    uint8_t z;
+    uint8_t n;
+    uint8_t h;
+    uint8_t c;
+} cpu_flags_t;
+#endif
+
 typedef struct {
     cpu_registers_t reg;
+    cpu_flags_t flags;
     bool halt;
     bool halt_bug;
+    bool stop; /* Halted by STOP, only a button press wakes it. */
 #ifdef DEBUG
     uint16_t last_pc;
 #endif
 } cpu_t;
 
-int cpu_init(const char *rom_path);
-void cpu_finish(void);
-void cpu_reset(void);
-void cpu_execute(uint8_t opcode);
-void cpu_emulate_cycle(void);
-void cpu_halted(void);
-void cpu_dump(void);
+/* Set the flags in mask from what they are computed from, as above. */
+static inline void cpu_flags_store(cpu_flags_t *flags, uint8_t mask, uint8_t z,
+                                   uint8_t n, uint8_t h, uint8_t c)
+{
+#ifdef CPU_EAGER_FLAGS
+    uint8_t f = (uint8_t)((z == 0) << 7 | (n != 0) << 6 | (h & 0x10) << 1 |
+                          (c & 1) << 4);
+    flags->f = (uint8_t)((flags->f & ~mask) | (f & mask));
+#else
+    if (mask & FLAG_Z)
+        flags->z = z;
+    if (mask & FLAG_N)
+        flags->n = n;
+    if (mask & FLAG_H)
+        flags->h = h;
+    if (mask & FLAG_C)
+        flags->c = c;
+#endif
+}
+
+/* Set the flags given in mask to their value in f. */
+static inline void cpu_flags_write(cpu_flags_t *flags, uint8_t mask, uint8_t f)
+{
+    cpu_flags_store(flags, mask, !(f & FLAG_Z), f & FLAG_N,
+                    f & FLAG_H ? 0x10 : 0, f & FLAG_C ? 1 : 0);
+}
+
+/* Whether flag is set. */
+static inline bool cpu_flags_test(const cpu_flags_t *flags, uint8_t flag)
+{
+#ifdef CPU_EAGER_FLAGS
+    return flags->f & flag;
+#else
+    switch (flag) {
+        case FLAG_Z:
+            return flags->z == 0;
+        case FLAG_N:
+            return flags->n != 0;
+        case FLAG_H:
+            return flags->h >> 4 & 1;
+        default:
+            return flags->c & 1;
+    }
+#endif
+}
+
+/* F from the flags. */
+static inline uint8_t cpu_get_f(const cpu_t *cpu)
+{
+#ifdef CPU_EAGER_FLAGS
+    return cpu->flags.f;
+#else
+    return (uint8_t)((cpu->flags.z == 0) << 7 | (cpu->flags.n != 0) << 6 |
+                     (cpu->flags.h & 0x10) << 1 | (cpu->flags.c & 1) << 4);
+#endif
+}
+
+/* The flags from F. */
+static inline void cpu_set_f(cpu_t *cpu, uint8_t f)
+{
+    cpu_flags_write(&cpu->flags, FLAG_ANY, f);
+}
+
+/* Flag helpers, they operate on the flags of the "cpu" in scope. */
+#define FLAG_IS_SET(flag) cpu_flags_test(&cpu->flags, (flag))
+#define FLAG_SET(x) cpu_flags_write(&cpu->flags, (x), (x))
+#define FLAG_CLEAR(x) cpu_flags_write(&cpu->flags, (x), 0)
+#define FLAG_SET_ZERO(value) FLAG_SET_IF(FLAG_Z, (value)&1)
+#define FLAG_SET_CARRY(value) FLAG_SET_IF(FLAG_C, (value)&1)
+#define FLAG_SET_IF(flag, set) \
+    cpu_flags_write(&cpu->flags, (flag), (set) ? (flag) : 0)
+
+int cpu_init(gb_t *gb, const char *rom_path);
+int cpu_init_shared(gb_t *gb, const gb_t *src);
+void cpu_finish(gb_t *gb);
+void cpu_reset(gb_t *gb);
+/**
+ * Execute opcode, its operand is fetched from PC. The flags are taken from F
+ * before and put back in F after, for tests.
+ */
+void cpu_execute(gb_t *gb, uint8_t opcode);
+/**
+ * Fetch and execute instructions, each with the interrupt dispatch after it,
+ * until budget cycles elapsed, after at least one, or a frame ended. Returns
+ * the cycles run. The registers are held apart meanwhile: gb->cpu is up to
+ * date again on return, and when the code of other files needs it.
+ */
+uint64_t cpu_execute_loop(gb_t *gb, uint64_t budget);
+void cpu_emulate_cycle(gb_t *gb);
+/**
+ * Run instructions for at least budget cycles, or up to the end of a frame.
+ * Skips over idle and copy loops stop short of the budget, so only the last
+ * instruction and an interrupt dispatch after it may overshoot. The PPU and
+ * APU only catch up when an event may be near, or before the CPU accesses
+ * them, and have seen every cycle on return. Returns the cycles run.
+ */
+uint64_t cpu_run(gb_t *gb, uint64_t budget);
+void cpu_dump(gb_t *gb);
 
 #endif /* CPU_H */
@@ -0,0 +1,310 @@
+#include "cpu_bulk.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "cartridge/cart.h"
+#include "clock.h"
+#include "cpu_ops.h"
+#include "gb.h"
+#include "mmu.h"
+
+/* How a loop loads A before storing it. */
+enum {
+    LOAD_NONE,
+    LOAD_MEM,
+    LOAD_IMM,
+    LOAD_ZERO, /* XOR A, which also clears C. */
+};
+
+#define PAIR_NONE 0xff
+
+/* Cycles of each opcode, with its jump taken. */
+#define X(op, name, kind, jump, cycles, taken, flags, text) [op] = taken,
+static const uint8_t op_cycles[256] = {CPU_OPS(X)};
+#undef X
+
+void cpu_bulk_reset(gb_t *gb)
+{
+    memset(&gb->bulk, 0, sizeof(gb->bulk));
+}
+
+static uint16_t *pair(cpu_registers_t *reg, unsigned int i)
+{
+    switch (i) {
+        case 0:
+            return &reg->bc;
+        case 1:
+            return &reg->de;
+        default:
+            return &reg->hl;
+    }
+}
+
+/* B to L, numbered as in opcodes. */
+static uint8_t *reg8(cpu_registers_t *reg, unsigned int r)
+{
+    switch (r) {
+        case 0:
+            return &reg->b;
+        case 1:
+            return &reg->c;
+        case 2:
+            return &reg->d;
+        case 3:
+            return &reg->e;
+        case 4:
+            return &reg->h;
+        default:
+            return &reg->l;
+    }
+}
+
+/* Check the loop of len bytes at code against the shape in cpu_bulk.h. */
+static bool cpu_bulk_body(cpu_bulk_t *b, const uint8_t *code, unsigned int len)
+{
+    int delta[3] = {0, 0, 0}; /* Pair changes so far. */
+    unsigned int i = 0;
+    bool stored = false;
+    b->load = LOAD_NONE;
+    b->src = PAIR_NONE;
+    b->cycles = 0;
+    /* Loads, the store and the pointer and wide counter steps. */
+    while (i < len) {
+        uint8_t op = code[i];
+        unsigned int p = (op >> 4) & 3; /* For BC and DE. */
+        bool load = false, store = false;
+        int step = 0;
+        unsigned int n = 1;
+        switch (op) {
+            case 0x0a: /* LD A,(BC) */
+            case 0x1a: /* LD A,(DE) */
+                load = true;
+                break;
+            case 0x2a: /* LD A,(HL+) */
+            case 0x3a: /* LD A,(HL-) */
+            case 0x7e: /* LD A,(HL) */
+                load = true;
+                p = 2;
+                step = op == 0x2a ? 1 : op == 0x3a ? -1 : 0;
+                break;
+            case 0x02: /* LD (BC),A */
+            case 0x12: /* LD (DE),A */
+                store = true;
+                break;
+            case 0x22: /* LD (HL+),A */
+            case 0x32: /* LD (HL-),A */
+            case 0x77: /* LD (HL),A */
+                store = true;
+                p = 2;
+                step = op == 0x22 ? 1 : op == 0x32 ? -1 : 0;
+                break;
+            case 0x3e: /* LD A,n */
+                if (i + 2 > len)
+                    return false;
+                b->value = code[i + 1];
+                n = 2;
+                break;
+            case 0xaf: /* XOR A */
+                b->value = 0;
+                break;
+            case 0x03: /* INC rr */
+            case 0x13:
+            case 0x23:
+                step = 1;
+                break;
+            case 0x0b: /* DEC rr */
+            case 0x1b:
+            case 0x2b:
+                step = -1;
+                break;
+            default:
+                n = 0;
+        }
+        if (n == 0)
+            break;
+        if (op == 0x3e || op == 0xaf) {
+            if (stored || b->load != LOAD_NONE)
+                return false;
+            b->load = op == 0xaf ? LOAD_ZERO : LOAD_IMM;
+        }
+        if (load) {
+            if (stored || b->load != LOAD_NONE)
+                return false;
+            b->load = LOAD_MEM;
+            b->src = p;
+            b->src_off = delta[p];
+        }
+        if (store) {
+            if (stored || p == b->src)
+                return false;
+            stored = true;
+            b->dst = p;
+            b->dst_off = delta[p];
+        }
+        if (step != 0)
+            delta[p] += step;
+        b->cycles += op_cycles[op];
+        i += n;
+    }
+    /* The counter test, then the jump. */
+    unsigned int tail = len - i;
+    if (!stored || tail < 3)
+        return false;
+    uint8_t op = code[i];
+    if ((op & 0xc7) == 0x05 && op < 0x30) {
+        /* DEC r, A is left alone. */
+        b->wide = false;
+        b->counter = op >> 3;
+        b->cycles += op_cycles[op];
+        i += 1;
+    } else if (tail >= 4 && op >= 0x78 && op < 0x7e &&
+               (code[i + 1] ^ op ^ 0xc8) == 1) {
+        /* LD A,hi; OR lo, or the other way round. */
+        b->wide = true;
+        b->counter = (op & 7) >> 1;
+        if (delta[b->counter] != -1 || b->load == LOAD_NONE)
+            return false;
+        delta[b->counter] = 0;
+        b->cycles += op_cycles[op] + op_cycles[code[i + 1]];
+        i += 2;
+    } else {
+        return false;
+    }
+    if (!(code[i] == 0x20 && i + 2 == len) &&
+        !(code[i] == 0xc2 && i + 3 == len))
+        return false;
+    b->cycles += op_cycles[code[i]];
+    /* Pointers move by one byte, nothing else moves. */
+    unsigned int counter = b->wide ? b->counter : b->counter >> 1;
+    for (unsigned int p = 0; p < 3; ++p) {
+        bool used = p == b->dst || p == b->src;
+        if (used && delta[p] != 1 && delta[p] != -1)
+            return false;
+        if (!used && delta[p] != 0)
+            return false;
+        if (used && p == counter)
+            return false;
+    }
+    b->dst_step = (int8_t)delta[b->dst];
+    if (b->load == LOAD_MEM)
+        b->src_step = (int8_t)delta[b->src];
+    return true;
+}
+
+/**
+ * Most iterations, up to count, whose accesses from addr by step stay in one
+ * region, and that region's bytes from addr.
+ */
+static uint8_t *cpu_bulk_span(gb_t *gb, uint16_t addr, int step, bool write,
+                              unsigned int *count)
+{
+    uint16_t lo, hi;
+    uint8_t *bytes = mmu_bulk(gb, addr, write, &lo, &hi);
+    if (bytes == NULL)
+        return NULL;
+    unsigned int room = step > 0 ? hi - addr + 1u : addr - lo + 1u;
+    if (room < *count)
+        *count = room;
+    return bytes + (addr - lo);
+}
+
+/* Move count bytes, in the order the loop would. */
+static void cpu_bulk_move(uint8_t *dst, int dst_step, const uint8_t *src,
+                          int src_step, unsigned int count)
+{
+    const uint8_t *src_lo = src_step > 0 ? src : src - (count - 1);
+    uint8_t *dst_lo = dst_step > 0 ? dst : dst - (count - 1);
+    bool apart = src_lo + count <= dst_lo || dst_lo + count <= src_lo;
+    if (src_step == dst_step && apart) {
+        memcpy(dst_lo, src_lo, count);
+        return;
+    }
+    for (unsigned int k = 0; k < count; ++k) {
+        *dst = *src;
+        dst += dst_step;
+        src += src_step;
+    }
+}
+
+bool cpu_bulk_loop(gb_t *gb, uint16_t end)
+{
+    cpu_bulk_t *b = &gb->bulk;
+    cpu_registers_t *reg = &gb->cpu.reg;
+    uint16_t head = reg->pc;
+    /* Short loops in one ROM area only. */
+    if (end - head > CPU_BULK_BODY || end > 0x8000 ||
+        (head ^ (end - 1)) & 0x4000)
+        return false;
+    const cart_rom_image_t *image = gb->cart.rom.image;
+    unsigned int bank = head < 0x4000 ? 0 : gb->cart.rom.offset >> 14;
+    if (b->end != end || b->head != head || b->bank != bank) {
+        size_t offset =
+            head < 0x4000 ? head : gb->cart.rom.offset + (head & 0x3fff);
+        b->head = head;
+        b->end = end;
+        b->bank = bank;
+        b->bulk = offset + (end - head) <= image->size &&
+                  cpu_bulk_body(b, &image->bytes[offset], end - head);
+    }
+    if (!b->bulk)
+        return false;
+    if (atomic_load_explicit(&image->bulk_off, memory_order_relaxed))
+        return true;
+    /* A pending interrupt is taken after this jump. */
+    if (gb->intr.ime && gb->intr.enable & gb->intr.flag)
+        return true;
+    /* Whole iterations before the event, the last one runs as usual. */
+    unsigned int left;
+    if (b->wide)
+        left = *pair(reg, b->counter);
+    else
+        left = *reg8(reg, b->counter);
+    unsigned int next = clock_next_event(gb);
+    unsigned int count = next > 0 ? (next - 1) / b->cycles : 0;
+    if (count > left - 1)
+        count = left - 1;
+    uint16_t dst_addr = (uint16_t)(*pair(reg, b->dst) + b->dst_off);
+    uint8_t *dst = NULL;
+    const uint8_t *src = NULL;
+    /* The destination first, as writing may copy a shared page the source
+     * is in. */
+    if (count > 0)
+        dst = cpu_bulk_span(gb, dst_addr, b->dst_step, true, &count);
+    if (dst != NULL && count > 0 && b->load == LOAD_MEM) {
+        uint16_t src_addr = (uint16_t)(*pair(reg, b->src) + b->src_off);
+        src = cpu_bulk_span(gb, src_addr, b->src_step, false, &count);
+        if (src == NULL)
+            return true;
+    }
+    if (dst == NULL || count == 0)
+        return true;
+    /* The accesses, then the state after the last iteration moved. */
+    uint8_t a = reg->a;
+    if (b->load == LOAD_MEM) {
+        cpu_bulk_move(dst, b->dst_step, src, b->src_step, count);
+        a = src[b->src_step * (int)(count - 1)];
+        *pair(reg, b->src) += (uint16_t)(b->src_step * (int)count);
+    } else {
+        if (b->load != LOAD_NONE)
+            a = b->load == LOAD_IMM ? b->value : 0;
+        memset(b->dst_step > 0 ? dst : dst - (count - 1), a, count);
+    }
+    *pair(reg, b->dst) += (uint16_t)(b->dst_step * (int)count);
+    if (b->wide) {
+        uint16_t *counter = pair(reg, b->counter);
+        *counter = (uint16_t)(*counter - count);
+        reg->a = (uint8_t)(*counter >> 8 | *counter);
+        cpu_flags_write(&gb->cpu.flags, FLAG_ANY, 0);
+    } else {
+        uint8_t *counter = reg8(reg, b->counter);
+        *counter = (uint8_t)(*counter - count);
+        reg->a = a;
+        uint8_t f = FLAG_N | ((*counter & 0x0f) == 0x0f ? FLAG_H : 0);
+        uint8_t mask = FLAG_Z | FLAG_N | FLAG_H;
+        if (b->load == LOAD_ZERO)
+            mask |= FLAG_C;
+        cpu_flags_write(&gb->cpu.flags, mask, f);
+    }
+    clock_skip(gb, count * b->cycles);
+    b->bytes += count;
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef CPU_BULK_H
+#define CPU_BULK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Copy and fill loops.
+ *
+ * Loops moving one byte per iteration, such as
+ *
+ *     copy: ld a, (hl+)
+ *           ld (de), a
+ *           inc de
+ *           dec bc
+ *           ld a, b
+ *           or c
+ *           jr nz, copy
+ *
+ * or "ld (hl+), a; dec b; jr nz", are recognized when their jump back is
+ * taken. The iterations left before the next timer or PPU event, but
+ * the last one, are then run at once over ROM, VRAM, WRAM or HRAM for the
+ * cycles they would have taken. Loops reaching any other memory, or VRAM
+ * while the PPU holds it, run as usual.
+ *
+ * The loop is a load into A, from memory, an immediate or XOR A, a store of
+ * A, increments or decrements of the pointers, and a counter tested by
+ * "dec r" or "dec rr; ld a, hi; or lo" before a JR NZ or JP NZ.
+ */
+
+#define CPU_BULK_BODY 12 /* Longest loop looked at, in bytes. */
+
+typedef struct gb gb_t;
+
+typedef struct {
+    /* Loop analyzed last, end is 0 for none. */
+    uint16_t head;
+    uint16_t end; /* Address after the jump back. */
+    unsigned int bank;
+    bool bulk; /* It has a known shape, described below. */
+    uint8_t load;  /* How A is loaded. */
+    uint8_t value; /* Immediate loaded. */
+    /* Register pairs, 0 for BC to 2 for HL, the pointers step by 1 or -1. */
+    uint8_t src;
+    int8_t src_off; /* Offset of the access from the pair at the head. */
+    int8_t src_step;
+    uint8_t dst;
+    int8_t dst_off;
+    int8_t dst_step;
+    uint8_t counter; /* B to L as in opcodes, or a pair if wide. */
+    bool wide;
+    unsigned int cycles; /* Per iteration. */
+    uint64_t bytes; /* Bytes moved in bulk since reset. */
+} cpu_bulk_t;
+
+void cpu_bulk_reset(gb_t *gb);
+
+/**
+ * Called when a jump from the instruction ending at end went back to PC.
+ * Returns true if it closed a copy or fill loop.
+ */
+bool cpu_bulk_loop(gb_t *gb, uint16_t end);
+
+#endif /* CPU_BULK_H */
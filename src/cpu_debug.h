@@ -2,7 +2,13 @@
 #define CPU_DEBUG_H_
 
 #include <stdint.h>
+#include "cpu.h"
 
-void cpu_debug(uint8_t opcode);
+/**
+ * Print the registers and the instruction about to run, fetched as insn with
+ * its operand: length bytes before PC, with text from cpu_ops.h.
+ */
+void cpu_debug(const cpu_t *cpu, uint32_t insn, unsigned int length,
+               const char *text);
 
 #endif /* CPU_DEBUG_H_ */
@@ -1,8 +0,0 @@
-#ifndef CPU_EXT_OPS_H
-#define CPU_EXT_OPS_H
-
-#include <stdint.h>
-
-void cb_n(uint8_t val);
-
-#endif /* CPU_EXT_OPS_H */
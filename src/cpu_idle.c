@@ -0,0 +1,271 @@
+#include "cpu_idle.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "cartridge/cart.h"
+#include "clock.h"
+#include "gb.h"
+#include "interrupt.h"
+
+/* Memory read kinds, by where the address comes from. */
+enum {
+    READ_HL = 1,
+    READ_BC,
+    READ_DE,
+    READ_C,   /* $ff00 + C */
+    READ_N8,  /* $ff00 + n */
+    READ_N16, /* nn */
+};
+
+void cpu_idle_reset(gb_t *gb)
+{
+    memset(&gb->idle, 0, sizeof(gb->idle));
+}
+
+/**
+ * Length of the instruction at p if an idle loop may hold it: no write, no
+ * stack, no interrupt control and no branch but the jump back, flagged in
+ * branch. Its memory read, if any, goes to read. Returns 0 otherwise.
+ */
+static unsigned int cpu_idle_op(const uint8_t *p, cpu_idle_read_t *read,
+                                bool *branch)
+{
+    uint8_t op = p[0];
+    read->kind = 0;
+    *branch = false;
+    switch (op) {
+        case 0x00: /* NOP */
+        case 0x07: /* RLCA */
+        case 0x0f: /* RRCA */
+        case 0x17: /* RLA */
+        case 0x1f: /* RRA */
+        case 0x27: /* DAA */
+        case 0x2f: /* CPL */
+        case 0x37: /* SCF */
+        case 0x3f: /* CCF */
+        case 0xf9: /* LD SP,HL */
+            return 1;
+        case 0x0a: /* LD A,(BC) */
+            read->kind = READ_BC;
+            return 1;
+        case 0x1a: /* LD A,(DE) */
+            read->kind = READ_DE;
+            return 1;
+        case 0xf2: /* LD A,(C) */
+            read->kind = READ_C;
+            return 1;
+        case 0xf0: /* LDH A,(n) */
+            read->kind = READ_N8;
+            read->addr = 0xff00 | p[1];
+            return 2;
+        case 0xfa: /* LD A,(nn) */
+            read->kind = READ_N16;
+            read->addr = (uint16_t)(p[2] << 8 | p[1]);
+            return 3;
+        case 0xf8: /* LD HL,SP+n */
+            return 2;
+        case 0xcb:
+            if ((p[1] & 0x07) != 0x06)
+                return 2;
+            /* Of the (HL) ones only BIT does not write. */
+            if ((p[1] & 0xc0) != 0x40)
+                return 0;
+            read->kind = READ_HL;
+            return 2;
+        case 0x18: /* JR n */
+        case 0x20: /* JR cc,n */
+        case 0x28:
+        case 0x30:
+        case 0x38:
+            *branch = true;
+            return 2;
+        case 0xc3: /* JP nn */
+        case 0xc2: /* JP cc,nn */
+        case 0xca:
+        case 0xd2:
+        case 0xda:
+            *branch = true;
+            return 3;
+    }
+    switch (op & 0xcf) {
+        case 0x01: /* LD rr,nn */
+            return 3;
+        case 0x03: /* INC rr */
+        case 0x09: /* ADD HL,rr */
+        case 0x0b: /* DEC rr */
+            return 1;
+    }
+    unsigned int dst = (op >> 3) & 7, src = op & 7;
+    switch (op & 0xc7) {
+        case 0x04: /* INC r */
+        case 0x05: /* DEC r */
+            return dst != 6 ? 1 : 0;
+        case 0x06: /* LD r,n */
+            return dst != 6 ? 2 : 0;
+        case 0xc6: /* ALU A,n */
+            return 2;
+    }
+    if (op >= 0x40 && op < 0xc0) {
+        /* LD r,r and ALU A,r, HALT and stores excluded. */
+        if (op < 0x80 && dst == 6)
+            return 0;
+        if (src == 6)
+            read->kind = READ_HL;
+        return 1;
+    }
+    return 0;
+}
+
+/* Check the loop from head to end, a ROM offset, and note its reads. */
+static bool cpu_idle_body(gb_t *gb, size_t offset)
+{
+    cpu_idle_t *idle = &gb->idle;
+    const cart_rom_image_t *image = gb->cart.rom.image;
+    unsigned int len = idle->end - idle->head;
+    if (offset + len > image->size)
+        return false;
+    const uint8_t *code = &image->bytes[offset];
+    idle->reads = 0;
+    for (unsigned int i = 0; i < len;) {
+        cpu_idle_read_t read;
+        bool branch;
+        unsigned int n = cpu_idle_op(&code[i], &read, &branch);
+        if (n == 0 || i + n > len || branch != (i + n == len))
+            return false;
+        if (read.kind != 0) {
+            if (idle->reads == CPU_IDLE_READS)
+                return false;
+            idle->read[idle->reads++] = read;
+        }
+        i += n;
+    }
+    return true;
+}
+
+/**
+ * Whether a read of addr returns the same until the next event. Cartridge
+ * RAM may be the RTC, the timer and sound registers change on their own.
+ */
+static bool cpu_idle_stable(uint16_t addr)
+{
+    if (addr >= 0xa000 && addr < 0xc000)
+        return false;
+    if (addr >= 0xff04 && addr < 0xff08)
+        return false;
+    if (addr >= 0xff10 && addr < 0xff40)
+        return false;
+    return true;
+}
+
+static bool cpu_idle_reads_stable(gb_t *gb)
+{
+    const cpu_idle_t *idle = &gb->idle;
+    const cpu_registers_t *reg = &gb->cpu.reg;
+    for (unsigned int i = 0; i < idle->reads; ++i) {
+        uint16_t addr = idle->read[i].addr;
+        switch (idle->read[i].kind) {
+            case READ_HL:
+                addr = reg->hl;
+                break;
+            case READ_BC:
+                addr = reg->bc;
+                break;
+            case READ_DE:
+                addr = reg->de;
+                break;
+            case READ_C:
+                addr = 0xff00 | reg->c;
+                break;
+        }
+        if (!cpu_idle_stable(addr))
+            return false;
+    }
+    return true;
+}
+
+/* Cycles to the next event which may change what a loop reads. */
+static unsigned int cpu_idle_next_change(gb_t *gb)
+{
+    unsigned int next = clock_until(gb, CLOCK_EVENT_PPU);
+    unsigned int dma = clock_until(gb, CLOCK_EVENT_OAM_DMA);
+    unsigned int timer = clock_until(gb, CLOCK_EVENT_TIMER);
+    if (dma < next)
+        next = dma;
+    return timer < next ? timer : next;
+}
+
+static void cpu_idle_report(cpu_idle_t *idle, uint64_t cycles)
+{
+    for (unsigned int i = 0; i < idle->count; ++i) {
+        cpu_idle_loop_t *loop = &idle->loops[i];
+        if (loop->pc == idle->head && loop->bank == idle->bank) {
+            loop->cycles += cycles;
+            return;
+        }
+    }
+    if (idle->count < CPU_IDLE_LOOPS) {
+        cpu_idle_loop_t *loop = &idle->loops[idle->count++];
+        loop->bank = idle->bank;
+        loop->pc = idle->head;
+        loop->cycles = cycles;
+    }
+}
+
+void cpu_idle_loop(gb_t *gb, uint16_t end)
+{
+    cpu_idle_t *idle = &gb->idle;
+    uint16_t head = gb->cpu.reg.pc;
+    /* Short loops in one ROM area only. */
+    if (end - head > CPU_IDLE_BODY || end > 0x8000 ||
+        (head ^ (end - 1)) & 0x4000)
+        return;
+    const cart_rom_image_t *image = gb->cart.rom.image;
+    if (atomic_load_explicit(&image->idle_off, memory_order_relaxed))
+        return;
+    unsigned int bank = head < 0x4000 ? 0 : gb->cart.rom.offset >> 14;
+    if (idle->end != end || idle->head != head || idle->bank != bank) {
+        idle->head = head;
+        idle->end = end;
+        idle->bank = bank;
+        idle->idle = cpu_idle_body(
+            gb, head < 0x4000 ? head : gb->cart.rom.offset + (head & 0x3fff));
+        idle->cycles = 0;
+    } else if (idle->idle) {
+        uint8_t f = cpu_get_f(&gb->cpu);
+        unsigned int cycles = (unsigned int)(clock_now(gb) - idle->clk);
+        if (f != idle->f || memcmp(&idle->reg, &gb->cpu.reg, sizeof(idle->reg)))
+            idle->cycles = 0;
+        else if (cycles != idle->cycles)
+            idle->cycles = cycles;
+        else if (cycles >= idle->next)
+            ; /* An event came after the reads, they may be stale. */
+        else if (!cpu_idle_reads_stable(gb))
+            idle->idle = false;
+        else if (!gb->intr.ime || !(gb->intr.enable & gb->intr.flag)) {
+            /* Whole iterations, all before the event. */
+            unsigned int next = clock_next_event(gb);
+            unsigned int count = next > 0 ? (next - 1) / cycles : 0;
+            if (count > 0) {
+                clock_skip(gb, count * cycles);
+                cpu_idle_report(idle, (uint64_t)count * cycles);
+            }
+        }
+    }
+    if (!idle->idle)
+        return;
+    idle->reg = gb->cpu.reg;
+    idle->f = cpu_get_f(&gb->cpu);
+    idle->clk = clock_now(gb);
+    idle->next = cpu_idle_next_change(gb);
+}
+
+void cpu_idle_dump(gb_t *gb)
+{
+    const cpu_idle_t *idle = &gb->idle;
+    printf("Idle loops:\n");
+    for (unsigned int i = 0; i < idle->count; ++i) {
+        const cpu_idle_loop_t *loop = &idle->loops[i];
+        printf("%02x:%04x %llu cycles skipped\n", loop->bank, loop->pc,
+               (unsigned long long)loop->cycles);
+    }
+}
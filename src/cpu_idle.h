@@ -0,0 +1,77 @@
+#ifndef CPU_IDLE_H
+#define CPU_IDLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cpu.h"
+
+/**
+ * Idle loop skipping.
+ *
+ * An idle loop is a short loop in ROM, with a jump back as its only branch,
+ * that writes nothing and only reads memory which cannot change before the
+ * next timer or PPU event, such as LY, STAT, IF or a WRAM flag set by an
+ * interrupt handler:
+ *
+ *     wait: ldh a, ($44)
+ *           cp $90
+ *           jr nz, wait
+ *
+ * Once two iterations in a row leave the registers as they found them and
+ * take the same cycles, with no PPU or timer event during the second, every
+ * further iteration up to the next event does too, so they are skipped in one
+ * go and the event runs as usual.
+ */
+
+#define CPU_IDLE_BODY 16  /* Longest loop looked at, in bytes. */
+#define CPU_IDLE_READS 4  /* Most memory reads in an idle loop. */
+#define CPU_IDLE_LOOPS 16 /* Idle loops reported per instance. */
+
+typedef struct gb gb_t;
+
+/* An idle loop found since reset. */
+typedef struct {
+    unsigned int bank; /* ROM bank of the loop, 0 below $4000. */
+    uint16_t pc;       /* Address of its first instruction. */
+    uint64_t cycles;   /* Cycles skipped in it. */
+} cpu_idle_loop_t;
+
+/* A memory read of a loop: kind and, for immediates, the address. */
+typedef struct {
+    uint8_t kind;
+    uint16_t addr;
+} cpu_idle_read_t;
+
+typedef struct {
+    /* Loop watched, end is 0 for none. */
+    uint16_t head;
+    uint16_t end; /* Address after the jump back. */
+    unsigned int bank;
+    bool idle; /* The body qualifies. */
+    unsigned int reads;
+    cpu_idle_read_t read[CPU_IDLE_READS];
+    /* State at the head after the last iteration. */
+    cpu_registers_t reg;
+    uint8_t f;
+    uint64_t clk;        /* Clock cycles at the last jump back. */
+    unsigned int next;   /* Cycles to the next PPU or timer event. */
+    unsigned int cycles; /* Cycles of the last iteration, 0 if unknown. */
+    /* Report. */
+    cpu_idle_loop_t loops[CPU_IDLE_LOOPS];
+    unsigned int count;
+} cpu_idle_t;
+
+void cpu_idle_reset(gb_t *gb);
+
+/* Stop watching the current loop, as when the CPU left it for a while. */
+static inline void cpu_idle_forget(cpu_idle_t *idle)
+{
+    idle->end = 0;
+}
+
+/* Called when a jump from the instruction ending at end went back to PC. */
+void cpu_idle_loop(gb_t *gb, uint16_t end);
+
+void cpu_idle_dump(gb_t *gb);
+
+#endif /* CPU_IDLE_H */
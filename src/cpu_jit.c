@@ -0,0 +1,1778 @@
+#include "cpu_jit.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "cartridge/cart.h"
+#include "clock.h"
+#include "cpu.h"
+#include "cpu_bulk.h"
+#include "cpu_idle.h"
+#include "cpu_ops.h"
+#include "gb.h"
+#include "interrupt.h"
+#include "mmu.h"
+
+#ifndef __x86_64__
+#error "CPU_JIT needs an x86-64 host"
+#endif
+
+#define CPU_JIT_CODE_SIZE (64u << 20) /* Reserved, touched as it fills. */
+#define CPU_JIT_BLOCK_SIZE (64u << 10) /* More than a block takes. */
+#define CPU_JIT_BLOCK_MAX 64           /* Instructions in a block. */
+#define CPU_JIT_STUBS (6 * CPU_JIT_BLOCK_MAX)
+/* Entry of an offset no block starts at. 0 is for one not tried yet. */
+#define CPU_JIT_NONE 1
+
+/*************** Tables. ***************/
+
+#define X(op, name, kind, jump, cycles, taken, flags, text) \
+    [op] = CPU_OP_LENGTH_##kind,
+static const uint8_t op_length[256] = {CPU_OPS(X)};
+#undef X
+
+#define X(op, name, kind, jump, cycles, taken, flags, text) [op] = cycles,
+static const uint8_t op_cycles[256] = {CPU_OPS(X)};
+static const uint8_t cb_cycles[256] = {CPU_CB_OPS(X)};
+#undef X
+
+#define X(op, name, kind, jump, cycles, taken, flags, text) [op] = taken,
+static const uint8_t op_taken[256] = {CPU_OPS(X)};
+#undef X
+
+/*************** The cache. ***************/
+
+/* Functions compiled code calls, by slot. */
+enum {
+    SLOT_READ_BYTE,
+    SLOT_WRITE_BYTE,
+    SLOT_READ_WORD,
+    SLOT_WRITE_WORD,
+    SLOT_INTERRUPT_STEP,
+    SLOT_SET_MASTER,
+    SLOT_FLUSH,
+    SLOT_JUMP_BACK,
+    SLOTS,
+};
+
+/*
+ * The code starts with a table from the x86 flags, as LAHF puts them in AH,
+ * to Z, H and C, then the slots, then the routines blocks share.
+ */
+#define CODE_FLAGS 0
+#define CODE_SLOT(i) (256 + 8 * (i))
+#define CODE_ROUTINES CODE_SLOT(SLOTS)
+
+typedef struct {
+    cart_rom_jit_t base; /* First, for cart_rom_release(). */
+    atomic_flag lock;    /* Held while compiling. */
+    /* Code position of the block at each ROM offset, or 0 or CPU_JIT_NONE. */
+    _Atomic uint32_t *entries;
+    size_t size;
+    uint8_t *code;
+    size_t used;
+    /* Positions of the routines. */
+    size_t enter;
+    size_t exit;
+    size_t dispatch;
+    size_t tail;
+    size_t pend;
+    size_t read8;
+    size_t write8;
+    size_t read16;
+    size_t write16;
+} cpu_jit_t;
+
+/* What compiled code keeps between calls, passed to enter. */
+typedef struct {
+    _Atomic uint32_t *entries;
+    size_t size;
+    uint8_t f;
+} cpu_jit_ctx_t;
+
+/* Run the block at code until cycle end, or the end of a frame. */
+typedef uint64_t (*cpu_jit_enter_f)(gb_t *gb, uint64_t end, const uint8_t *code,
+                                    cpu_jit_ctx_t *ctx);
+
+/*
+ * The stack frame of enter, at RSP in blocks. LIMIT is the cycle count from
+ * which an instruction may not simply go on: the earlier of END and the
+ * point where the commit flushes the clock. 0 has the next one check.
+ */
+enum {
+    FRAME_LIMIT = 0,
+    FRAME_END = 8,
+    FRAME_START = 16,
+    FRAME_CTX = 24,
+    FRAME_ENTRIES = 32,
+    FRAME_SIZE = 40,
+    FRAME_FRAMES = 48,
+    FRAME_BYTES = 56,
+};
+
+/*************** x86-64 encoding. ***************/
+
+/*
+ * Registers by number. AH to BH are apart as they take no REX prefix.
+ *
+ * Compiled code keeps gb in R15, A in R14, BC in RBX, DE in R12, HL in R13
+ * and F in RBP, each zero-extended. SP and PC stay in gb->cpu.
+ */
+enum {
+    RAX,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+    AH = 0x14,
+    CH,
+    DH,
+    BH,
+};
+#define EXT(n) (0x40 | (n)) /* Opcode extension in the reg field. */
+#define NOREG (-1)
+#define RIP 0x20 /* Base of an operand at a position of the code. */
+
+/* Operand flags. */
+#define X_W 1  /* 64 bits. */
+#define X_16 2 /* 16 bits. */
+#define X_8 4  /* 8 bits, SPL to DIL for 4 to 7. */
+
+/* Group 1 operations, as in /digit. */
+enum { ADD, OR, ADC, SBB, AND, SUB, XOR, CMP };
+/* Group 2 ones. */
+enum { ROL, ROR, RCL, RCR, SHL, SHR, SAR = 7 };
+/* Conditions. */
+enum { CC_B = 2, CC_AE, CC_E, CC_NE, CC_BE, CC_A };
+
+typedef struct {
+    int base;
+    int index;
+    int scale; /* Of the index, as a shift. */
+    int64_t disp; /* Position of the code for RIP. */
+} mem_t;
+
+#define M(base, disp) (&(mem_t){(base), NOREG, 0, (disp)})
+#define MX(base, index, scale, disp) \
+    (&(mem_t){(base), (index), (scale), (disp)})
+#define MG(field) M(R15, offsetof(gb_t, field))
+#define MF(slot) M(RSP, (slot))
+#define MC(pos) M(RIP, (int64_t)(pos))
+
+typedef struct {
+    uint8_t *code;
+    size_t pos;
+} emit_t;
+
+static void x_byte(emit_t *e, uint8_t b)
+{
+    e->code[e->pos++] = b;
+}
+
+static void x_imm(emit_t *e, uint64_t imm, unsigned int size)
+{
+    for (unsigned int i = 0; i < size; ++i)
+        x_byte(e, (uint8_t)(imm >> 8 * i));
+}
+
+/* Whether a register operand needs a REX prefix, or forbids one. */
+static void x_reg(int r, unsigned int flags, unsigned int bit,
+                  unsigned int *rex, bool *high)
+{
+    if (r & 0x40)
+        return;
+    if (r & 0x10)
+        *high = true;
+    else if (r & 8)
+        *rex |= 0x40 | bit;
+    else if (flags & X_8 && r >= 4)
+        *rex |= 0x40;
+}
+
+/*
+ * Emit op, of one to three bytes, with reg in the ModRM reg field and either
+ * the register rm or, if m is not NULL, the memory operand m, then imm.
+ */
+static void x_op(emit_t *e, unsigned int flags, uint32_t op, int reg, int rm,
+                 const mem_t *m, uint64_t imm, unsigned int imm_size)
+{
+    unsigned int rex = flags & X_W ? 0x48 : 0;
+    bool high = false;
+    x_reg(reg, flags, 4, &rex, &high);
+    if (m == NULL) {
+        x_reg(rm, flags, 1, &rex, &high);
+    } else {
+        if (m->base != RIP && m->base & 8)
+            rex |= 0x41;
+        if (m->index != NOREG && m->index & 8)
+            rex |= 0x42;
+    }
+    assert(!(rex && high));
+    if (flags & X_16)
+        x_byte(e, 0x66);
+    if (rex)
+        x_byte(e, (uint8_t)rex);
+    if (op > 0xffff)
+        x_byte(e, (uint8_t)(op >> 16));
+    if (op > 0xff)
+        x_byte(e, (uint8_t)(op >> 8));
+    x_byte(e, (uint8_t)op);
+    unsigned int r = reg & 7;
+    if (m == NULL) {
+        x_byte(e, (uint8_t)(0xc0 | r << 3 | (rm & 7)));
+    } else if (m->base == RIP) {
+        x_byte(e, (uint8_t)(r << 3 | 5));
+        int64_t rel = m->disp - (int64_t)(e->pos + 4 + imm_size);
+        x_imm(e, (uint64_t)rel, 4);
+    } else {
+        unsigned int b = m->base & 7;
+        unsigned int mod = 2;
+        if (m->disp == 0 && b != 5)
+            mod = 0;
+        else if (m->disp >= -128 && m->disp < 128)
+            mod = 1;
+        if (m->index != NOREG || b == 4) {
+            unsigned int index = m->index != NOREG ? m->index & 7 : 4;
+            x_byte(e, (uint8_t)(mod << 6 | r << 3 | 4));
+            x_byte(e, (uint8_t)(m->scale << 6 | index << 3 | b));
+        } else {
+            x_byte(e, (uint8_t)(mod << 6 | r << 3 | b));
+        }
+        if (mod == 1)
+            x_byte(e, (uint8_t)m->disp);
+        else if (mod == 2)
+            x_imm(e, (uint64_t)m->disp, 4);
+    }
+    x_imm(e, imm, imm_size);
+}
+
+/* Size of an immediate of an operation on flags' width, at most 4. */
+static unsigned int x_imm_size(unsigned int flags)
+{
+    return flags & X_8 ? 1 : flags & X_16 ? 2 : 4;
+}
+
+static void mov_rr(emit_t *e, unsigned int flags, int dst, int src)
+{
+    x_op(e, flags, flags & X_8 ? 0x88 : 0x89, src, dst, NULL, 0, 0);
+}
+
+static void mov_rm(emit_t *e, unsigned int flags, int dst, const mem_t *m)
+{
+    x_op(e, flags, flags & X_8 ? 0x8a : 0x8b, dst, 0, m, 0, 0);
+}
+
+static void mov_mr(emit_t *e, unsigned int flags, const mem_t *m, int src)
+{
+    x_op(e, flags, flags & X_8 ? 0x88 : 0x89, src, 0, m, 0, 0);
+}
+
+static void mov_ri(emit_t *e, int dst, uint32_t imm)
+{
+    x_op(e, 0, 0xc7, EXT(0), dst, NULL, imm, 4);
+}
+
+static void mov_mi(emit_t *e, unsigned int flags, const mem_t *m, uint32_t imm)
+{
+    x_op(e, flags, flags & X_8 ? 0xc6 : 0xc7, EXT(0), 0, m, imm,
+         x_imm_size(flags));
+}
+
+/* MOVZX from a byte, or a word with X_16, in a register. */
+static void movzx_rr(emit_t *e, unsigned int flags, int dst, int src)
+{
+    x_op(e, flags & X_8, flags & X_16 ? 0x0fb7 : 0x0fb6, dst, src, NULL, 0,
+         0);
+}
+
+static void movzx_rm(emit_t *e, unsigned int flags, int dst, const mem_t *m)
+{
+    x_op(e, 0, flags & X_16 ? 0x0fb7 : 0x0fb6, dst, 0, m, 0, 0);
+}
+
+static void alu_rr(emit_t *e, unsigned int flags, int op, int dst, int src)
+{
+    x_op(e, flags, (uint32_t)(op * 8 + (flags & X_8 ? 0 : 1)), src, dst, NULL,
+         0, 0);
+}
+
+static void alu_rm(emit_t *e, unsigned int flags, int op, int dst,
+                   const mem_t *m)
+{
+    x_op(e, flags, (uint32_t)(op * 8 + (flags & X_8 ? 2 : 3)), dst, 0, m, 0,
+         0);
+}
+
+static void alu_mr(emit_t *e, unsigned int flags, int op, const mem_t *m,
+                   int src)
+{
+    x_op(e, flags, (uint32_t)(op * 8 + (flags & X_8 ? 0 : 1)), src, 0, m, 0,
+         0);
+}
+
+static void alu_ri(emit_t *e, unsigned int flags, int op, int dst, int32_t imm)
+{
+    if (flags & X_8)
+        x_op(e, flags, 0x80, EXT(op), dst, NULL, (uint64_t)imm, 1);
+    else if (imm >= -128 && imm < 128)
+        x_op(e, flags, 0x83, EXT(op), dst, NULL, (uint64_t)imm, 1);
+    else
+        x_op(e, flags, 0x81, EXT(op), dst, NULL, (uint64_t)imm,
+             x_imm_size(flags));
+}
+
+static void alu_mi(emit_t *e, unsigned int flags, int op, const mem_t *m,
+                   int32_t imm)
+{
+    if (flags & X_8)
+        x_op(e, flags, 0x80, EXT(op), 0, m, (uint64_t)imm, 1);
+    else if (imm >= -128 && imm < 128)
+        x_op(e, flags, 0x83, EXT(op), 0, m, (uint64_t)imm, 1);
+    else
+        x_op(e, flags, 0x81, EXT(op), 0, m, (uint64_t)imm, x_imm_size(flags));
+}
+
+static void shift_ri(emit_t *e, unsigned int flags, int op, int dst,
+                     unsigned int n)
+{
+    if (n == 1)
+        x_op(e, flags, flags & X_8 ? 0xd0 : 0xd1, EXT(op), dst, NULL, 0, 0);
+    else
+        x_op(e, flags, flags & X_8 ? 0xc0 : 0xc1, EXT(op), dst, NULL, n, 1);
+}
+
+static void test_ri(emit_t *e, unsigned int flags, int dst, uint32_t imm)
+{
+    x_op(e, flags, flags & X_8 ? 0xf6 : 0xf7, EXT(0), dst, NULL, imm,
+         x_imm_size(flags));
+}
+
+static void test_rr(emit_t *e, unsigned int flags, int a, int b)
+{
+    x_op(e, flags, flags & X_8 ? 0x84 : 0x85, b, a, NULL, 0, 0);
+}
+
+/* INC or DEC, 0 or 1, of a register or memory. */
+static void incdec_r(emit_t *e, unsigned int flags, int dec, int dst)
+{
+    x_op(e, flags, 0xff, EXT(dec), dst, NULL, 0, 0);
+}
+
+static void incdec_m(emit_t *e, unsigned int flags, int dec, const mem_t *m)
+{
+    x_op(e, flags, 0xff, EXT(dec), 0, m, 0, 0);
+}
+
+static void setcc(emit_t *e, int cc, int dst)
+{
+    x_op(e, X_8, (uint32_t)(0x0f90 + cc), EXT(0), dst, NULL, 0, 0);
+}
+
+/* BT with an immediate, to load a flag bit into CF. */
+static void bt_ri(emit_t *e, int dst, unsigned int bit)
+{
+    x_op(e, 0, 0x0fba, EXT(4), dst, NULL, bit, 1);
+}
+
+static void lea(emit_t *e, unsigned int flags, int dst, const mem_t *m)
+{
+    x_op(e, flags, 0x8d, dst, 0, m, 0, 0);
+}
+
+static void lahf(emit_t *e)
+{
+    x_byte(e, 0x9f);
+}
+
+static void push(emit_t *e, int r)
+{
+    if (r & 8)
+        x_byte(e, 0x41);
+    x_byte(e, (uint8_t)(0x50 | (r & 7)));
+}
+
+static void pop(emit_t *e, int r)
+{
+    if (r & 8)
+        x_byte(e, 0x41);
+    x_byte(e, (uint8_t)(0x58 | (r & 7)));
+}
+
+static void ret(emit_t *e)
+{
+    x_byte(e, 0xc3);
+}
+
+/* Point the rel32 at to position to. */
+static void patch(emit_t *e, size_t at, size_t to)
+{
+    int32_t rel = (int32_t)((int64_t)to - (int64_t)(at + 4));
+    memcpy(&e->code[at], &rel, sizeof(rel));
+}
+
+/* Jumps with their target left to patch(), returning where it goes. */
+static size_t jcc(emit_t *e, int cc)
+{
+    x_byte(e, 0x0f);
+    x_byte(e, (uint8_t)(0x80 | cc));
+    x_imm(e, 0, 4);
+    return e->pos - 4;
+}
+
+static size_t jmp(emit_t *e)
+{
+    x_byte(e, 0xe9);
+    x_imm(e, 0, 4);
+    return e->pos - 4;
+}
+
+static void jcc_to(emit_t *e, int cc, size_t to)
+{
+    patch(e, jcc(e, cc), to);
+}
+
+static void jmp_to(emit_t *e, size_t to)
+{
+    patch(e, jmp(e), to);
+}
+
+static void call_to(emit_t *e, size_t to)
+{
+    x_byte(e, 0xe8);
+    x_imm(e, 0, 4);
+    patch(e, e->pos - 4, to);
+}
+
+static void call_slot(emit_t *e, int slot)
+{
+    x_op(e, 0, 0xff, EXT(2), 0, MC(CODE_SLOT(slot)), 0, 0);
+}
+
+/*************** Routines. ***************/
+
+/* The skips of jump_back() in cpu_opcodes.c, with F passed apart. */
+static uint8_t cpu_jit_jump_back(gb_t *gb, uint16_t end, uint8_t f)
+{
+    cpu_set_f(&gb->cpu, f);
+    if (!cpu_bulk_loop(gb, end))
+        cpu_idle_loop(gb, end);
+    return cpu_get_f(&gb->cpu);
+}
+
+static void spill(emit_t *e)
+{
+    mov_mr(e, X_8, MG(cpu.reg.a), R14);
+    mov_mr(e, X_16, MG(cpu.reg.bc), RBX);
+    mov_mr(e, X_16, MG(cpu.reg.de), R12);
+    mov_mr(e, X_16, MG(cpu.reg.hl), R13);
+}
+
+static void reload(emit_t *e)
+{
+    movzx_rm(e, 0, R14, MG(cpu.reg.a));
+    movzx_rm(e, X_16, RBX, MG(cpu.reg.bc));
+    movzx_rm(e, X_16, R12, MG(cpu.reg.de));
+    movzx_rm(e, X_16, R13, MG(cpu.reg.hl));
+}
+
+/*
+ * The end of clock_commit() and the checks after it, once the cycles went to
+ * the count, with the frame at RSP + frame. EAX is 1 if the run stops, else
+ * 0 with LIMIT up to date.
+ */
+static void emit_tail(emit_t *e, int frame)
+{
+    mov_rm(e, X_W, RAX, MG(clock.cycles));
+    alu_ri(e, X_W, ADD, RAX, CLOCK_STEP_MAX);
+    alu_rm(e, X_W, CMP, RAX, MG(clock.next));
+    size_t flushed = jcc(e, CC_B);
+    mov_rr(e, X_W, RDI, R15);
+    call_slot(e, SLOT_FLUSH);
+    patch(e, flushed, e->pos);
+    mov_rm(e, 0, RAX, MG(gpu.frames));
+    alu_rm(e, 0, CMP, RAX, MF(frame + FRAME_FRAMES));
+    size_t frame_end = jcc(e, CC_NE);
+    mov_rm(e, X_W, RAX, MG(clock.cycles));
+    alu_rm(e, X_W, CMP, RAX, MF(frame + FRAME_END));
+    size_t budget_end = jcc(e, CC_AE);
+    /* LIMIT = min(max(next - CLOCK_STEP_MAX, 0), END) */
+    mov_rm(e, X_W, RCX, MG(clock.next));
+    alu_ri(e, X_W, SUB, RCX, CLOCK_STEP_MAX);
+    size_t positive = jcc(e, CC_AE);
+    alu_rr(e, 0, XOR, RCX, RCX);
+    patch(e, positive, e->pos);
+    alu_rm(e, X_W, CMP, RCX, MF(frame + FRAME_END));
+    size_t below = jcc(e, CC_BE);
+    mov_rm(e, X_W, RCX, MF(frame + FRAME_END));
+    patch(e, below, e->pos);
+    mov_mr(e, X_W, MF(frame + FRAME_LIMIT), RCX);
+    alu_rr(e, 0, XOR, RAX, RAX);
+    size_t done = jmp(e);
+    patch(e, frame_end, e->pos);
+    patch(e, budget_end, e->pos);
+    mov_ri(e, RAX, 1);
+    patch(e, done, e->pos);
+}
+
+/* Bank of WRAM at ESI, C000 to DFFF, in RCX, with ESI the offset in it. */
+static void emit_wram(emit_t *e)
+{
+    movzx_rm(e, 0, RCX, MG(mmu.wram_bank));
+    alu_ri(e, 0, CMP, RCX, 1);
+    alu_ri(e, 0, ADC, RCX, 0);
+    mov_rr(e, 0, RDX, RSI);
+    shift_ri(e, 0, SHR, RDX, 12);
+    alu_ri(e, 0, AND, RDX, 1);
+    x_op(e, 0, 0xf7, EXT(3), RDX, NULL, 0, 0); /* neg edx */
+    alu_rr(e, 0, AND, RCX, RDX);
+    mov_rm(e, X_W, RCX, MX(R15, RCX, 3, offsetof(gb_t, mmu.wram)));
+    alu_ri(e, 0, AND, RSI, 0x0fff);
+}
+
+/*
+ * The call to the MMU of an access not made in place. R8D holds the cycles
+ * of the instruction before it, which the step gets for the call.
+ */
+static void emit_slow(emit_t *e, int slot, unsigned int cycles)
+{
+    alu_mr(e, 0, ADD, MG(clock.step), R8);
+    push(e, R8);
+    mov_rr(e, X_W, RDI, R15);
+    call_slot(e, slot);
+    pop(e, R8);
+    alu_ri(e, 0, ADD, R8, (int32_t)cycles);
+    alu_mr(e, 0, SUB, MG(clock.step), R8);
+    /* It may have synced the clock. */
+    mov_mi(e, X_W, MF(8 + FRAME_LIMIT), 0);
+}
+
+/*
+ * read8 and read16: the byte or word at ESI in EAX. write8 and write16: EDX
+ * at ESI. The cycles before the access in R8D. ROM, WRAM and HRAM are
+ * accessed in place, words only within one area.
+ */
+static void routine_read8(emit_t *e)
+{
+    alu_ri(e, 0, CMP, RSI, 0xff80);
+    size_t high = jcc(e, CC_AE);
+    lea(e, 0, RAX, M(RSI, -0xc000));
+    alu_ri(e, 0, CMP, RAX, 0x2000);
+    size_t wram = jcc(e, CC_B);
+    alu_ri(e, 0, CMP, RSI, 0x4000);
+    size_t rom0 = jcc(e, CC_B);
+    alu_ri(e, 0, CMP, RSI, 0x8000);
+    size_t rom1 = jcc(e, CC_B);
+    size_t slow = e->pos;
+    emit_slow(e, SLOT_READ_BYTE, 4);
+    movzx_rr(e, 0, RAX, RAX);
+    ret(e);
+    patch(e, high, e->pos);
+    alu_ri(e, 0, CMP, RSI, 0xffff);
+    jcc_to(e, CC_E, slow);
+    movzx_rm(e, 0, RAX, MX(R15, RSI, 0, offsetof(gb_t, mmu.zram) - 0xff80));
+    ret(e);
+    patch(e, wram, e->pos);
+    emit_wram(e);
+    movzx_rm(e, 0, RAX, MX(RCX, RSI, 0, offsetof(page_t, bytes)));
+    ret(e);
+    patch(e, rom1, e->pos);
+    alu_ri(e, 0, AND, RSI, 0x3fff);
+    mov_rm(e, 0, RCX, MG(cart.rom.offset));
+    alu_rr(e, X_W, ADD, RSI, RCX);
+    patch(e, rom0, e->pos);
+    mov_rm(e, X_W, RCX, MG(cart.rom.bytes));
+    movzx_rm(e, 0, RAX, MX(RCX, RSI, 0, 0));
+    ret(e);
+}
+
+static void routine_write8(emit_t *e)
+{
+    alu_ri(e, 0, CMP, RSI, 0xff80);
+    size_t high = jcc(e, CC_AE);
+    lea(e, 0, RAX, M(RSI, -0xc000));
+    alu_ri(e, 0, CMP, RAX, 0x2000);
+    size_t wram = jcc(e, CC_B);
+    size_t slow = e->pos;
+    emit_slow(e, SLOT_WRITE_BYTE, 4);
+    ret(e);
+    patch(e, high, e->pos);
+    alu_ri(e, 0, CMP, RSI, 0xffff);
+    jcc_to(e, CC_E, slow);
+    mov_mr(e, X_8, MX(R15, RSI, 0, offsetof(gb_t, mmu.zram) - 0xff80), RDX);
+    ret(e);
+    patch(e, wram, e->pos);
+    mov_rr(e, 0, R9, RDX);
+    emit_wram(e);
+    /* Shared pages are copied by the MMU. */
+    alu_mi(e, 0, CMP, M(RCX, offsetof(page_t, refs)), 1);
+    size_t shared = jcc(e, CC_NE);
+    mov_mr(e, X_8, MX(RCX, RSI, 0, offsetof(page_t, bytes)), R9);
+    ret(e);
+    patch(e, shared, e->pos);
+    /* Back to the address and value. */
+    lea(e, 0, RAX, M(RAX, 0xc000));
+    mov_rr(e, 0, RSI, RAX);
+    mov_rr(e, 0, RDX, R9);
+    jmp_to(e, slow);
+}
+
+/* Jump to wram if the word at ESI is in one area of WRAM, or high in HRAM. */
+static void emit_word_area(emit_t *e, size_t *high, size_t *wram)
+{
+    alu_ri(e, 0, CMP, RSI, 0xff80);
+    size_t io = jcc(e, CC_B);
+    alu_ri(e, 0, CMP, RSI, 0xfffe);
+    *high = jcc(e, CC_B);
+    patch(e, io, e->pos);
+    lea(e, 0, RAX, M(RSI, -0xc000));
+    alu_ri(e, 0, CMP, RAX, 0x2000);
+    size_t out = jcc(e, CC_AE);
+    mov_rr(e, 0, RCX, RSI);
+    alu_ri(e, 0, AND, RCX, 0x0fff);
+    alu_ri(e, 0, CMP, RCX, 0x0fff);
+    *wram = jcc(e, CC_NE);
+    patch(e, out, e->pos);
+}
+
+static void routine_read16(emit_t *e)
+{
+    size_t high, wram;
+    emit_word_area(e, &high, &wram);
+    emit_slow(e, SLOT_READ_WORD, 8);
+    movzx_rr(e, X_16, RAX, RAX);
+    ret(e);
+    patch(e, high, e->pos);
+    movzx_rm(e, X_16, RAX,
+             MX(R15, RSI, 0, offsetof(gb_t, mmu.zram) - 0xff80));
+    ret(e);
+    patch(e, wram, e->pos);
+    emit_wram(e);
+    movzx_rm(e, X_16, RAX, MX(RCX, RSI, 0, offsetof(page_t, bytes)));
+    ret(e);
+}
+
+static void routine_write16(emit_t *e)
+{
+    size_t high, wram;
+    emit_word_area(e, &high, &wram);
+    size_t slow = e->pos;
+    emit_slow(e, SLOT_WRITE_WORD, 8);
+    ret(e);
+    patch(e, high, e->pos);
+    mov_mr(e, X_16, MX(R15, RSI, 0, offsetof(gb_t, mmu.zram) - 0xff80), RDX);
+    ret(e);
+    patch(e, wram, e->pos);
+    mov_rr(e, 0, R9, RDX);
+    emit_wram(e);
+    alu_mi(e, 0, CMP, M(RCX, offsetof(page_t, refs)), 1);
+    size_t shared = jcc(e, CC_NE);
+    mov_mr(e, X_16, MX(RCX, RSI, 0, offsetof(page_t, bytes)), R9);
+    ret(e);
+    patch(e, shared, e->pos);
+    lea(e, 0, RAX, M(RAX, 0xc000));
+    mov_rr(e, 0, RSI, RAX);
+    mov_rr(e, 0, RDX, R9);
+    jmp_to(e, slow);
+}
+
+/* The flags table and slots, then the routines. */
+static void cpu_jit_routines(cpu_jit_t *jit)
+{
+    emit_t e = {jit->code, 0};
+    for (unsigned int ah = 0; ah < 256; ++ah) {
+        x_byte(&e, (uint8_t)((ah & 0x40 ? FLAG_Z : 0) |
+                             (ah & 0x10 ? FLAG_H : 0) |
+                             (ah & 0x01 ? FLAG_C : 0)));
+    }
+    void *slots[SLOTS] = {
+        [SLOT_READ_BYTE] = (void *)mmu_read_byte,
+        [SLOT_WRITE_BYTE] = (void *)mmu_write_byte,
+        [SLOT_READ_WORD] = (void *)mmu_read_word,
+        [SLOT_WRITE_WORD] = (void *)mmu_write_word,
+        [SLOT_INTERRUPT_STEP] = (void *)interrupt_step,
+        [SLOT_SET_MASTER] = (void *)interrupt_set_master,
+        [SLOT_FLUSH] = (void *)clock_flush,
+        [SLOT_JUMP_BACK] = (void *)cpu_jit_jump_back,
+    };
+    memcpy(&e.code[e.pos], slots, sizeof(slots));
+    e.pos += sizeof(slots);
+
+    /* enter(gb, end, code, ctx) */
+    jit->enter = e.pos;
+    push(&e, RBX);
+    push(&e, RBP);
+    push(&e, R12);
+    push(&e, R13);
+    push(&e, R14);
+    push(&e, R15);
+    alu_ri(&e, X_W, SUB, RSP, FRAME_BYTES);
+    mov_rr(&e, X_W, R15, RDI);
+    mov_mr(&e, X_W, MF(FRAME_CTX), RCX);
+    mov_rm(&e, X_W, RAX, M(RCX, offsetof(cpu_jit_ctx_t, entries)));
+    mov_mr(&e, X_W, MF(FRAME_ENTRIES), RAX);
+    mov_rm(&e, X_W, RAX, M(RCX, offsetof(cpu_jit_ctx_t, size)));
+    mov_mr(&e, X_W, MF(FRAME_SIZE), RAX);
+    mov_rm(&e, 0, RAX, MG(gpu.frames));
+    mov_mr(&e, 0, MF(FRAME_FRAMES), RAX);
+    mov_rm(&e, X_W, RAX, MG(clock.cycles));
+    mov_mr(&e, X_W, MF(FRAME_START), RAX);
+    mov_mr(&e, X_W, MF(FRAME_END), RSI);
+    mov_mi(&e, X_W, MF(FRAME_LIMIT), 0);
+    mov_mi(&e, 0, MG(clock.step), 0);
+    reload(&e);
+    movzx_rm(&e, 0, RBP, M(RCX, offsetof(cpu_jit_ctx_t, f)));
+    x_op(&e, 0, 0xff, EXT(4), RDX, NULL, 0, 0); /* jmp rdx */
+
+    /* exit: back to the caller with PC stored, returning the cycles run. */
+    jit->exit = e.pos;
+    spill(&e);
+    mov_rm(&e, X_W, RCX, MF(FRAME_CTX));
+    mov_mr(&e, X_8, M(RCX, offsetof(cpu_jit_ctx_t, f)), RBP);
+    mov_rm(&e, X_W, RAX, MG(clock.cycles));
+    alu_rm(&e, X_W, SUB, RAX, MF(FRAME_START));
+    alu_ri(&e, X_W, ADD, RSP, FRAME_BYTES);
+    pop(&e, R15);
+    pop(&e, R14);
+    pop(&e, R13);
+    pop(&e, R12);
+    pop(&e, RBP);
+    pop(&e, RBX);
+    ret(&e);
+
+    /* dispatch: run the block at PC, exit if there is none yet. */
+    jit->dispatch = e.pos;
+    movzx_rm(&e, X_16, RAX, MG(cpu.reg.pc));
+    alu_ri(&e, 0, CMP, RAX, 0x4000);
+    size_t bank0 = jcc(&e, CC_B);
+    alu_ri(&e, 0, CMP, RAX, 0x8000);
+    size_t ram = jcc(&e, CC_AE);
+    mov_rm(&e, 0, RCX, MG(cart.rom.offset));
+    alu_ri(&e, 0, CMP, RCX, 0x4000);
+    size_t mirror = jcc(&e, CC_B);
+    alu_ri(&e, 0, AND, RAX, 0x3fff);
+    alu_rr(&e, X_W, ADD, RAX, RCX);
+    patch(&e, bank0, e.pos);
+    alu_rm(&e, X_W, CMP, RAX, MF(FRAME_SIZE));
+    size_t beyond = jcc(&e, CC_AE);
+    mov_rm(&e, X_W, RCX, MF(FRAME_ENTRIES));
+    mov_rm(&e, 0, RAX, MX(RCX, RAX, 2, 0));
+    alu_ri(&e, 0, CMP, RAX, CPU_JIT_NONE);
+    size_t none = jcc(&e, CC_BE);
+    lea(&e, X_W, RCX, MC(0));
+    alu_rr(&e, X_W, ADD, RAX, RCX);
+    x_op(&e, 0, 0xff, EXT(4), RAX, NULL, 0, 0); /* jmp rax */
+    patch(&e, ram, e.pos);
+    patch(&e, mirror, e.pos);
+    patch(&e, beyond, e.pos);
+    patch(&e, none, e.pos);
+    jmp_to(&e, jit->exit);
+
+    /* tail: emit_tail() for a block. */
+    jit->tail = e.pos;
+    alu_ri(&e, X_W, SUB, RSP, 8);
+    emit_tail(&e, 16);
+    alu_ri(&e, X_W, ADD, RSP, 8);
+    ret(&e);
+
+    /*
+     * pend: interrupt_step() after an instruction, then its commit and
+     * tail. ECX is the PC to store, above 0xffff if already stored, EDX the
+     * cycles not in the step. EAX is 1 to stop, 2 to go on at PC, where an
+     * interrupt went, or 0 to go on with the block.
+     */
+    jit->pend = e.pos;
+    alu_ri(&e, X_W, SUB, RSP, 24);
+    mov_mr(&e, 0, MF(0), RCX);
+    alu_ri(&e, 0, CMP, RCX, 0xffff);
+    size_t stored = jcc(&e, CC_A);
+    mov_mr(&e, X_16, MG(cpu.reg.pc), RCX);
+    patch(&e, stored, e.pos);
+    alu_mr(&e, 0, ADD, MG(clock.step), RDX);
+    mov_rr(&e, X_W, RDI, R15);
+    call_slot(&e, SLOT_INTERRUPT_STEP);
+    mov_rm(&e, 0, RAX, MG(clock.step));
+    mov_mi(&e, 0, MG(clock.step), 0);
+    alu_mr(&e, X_W, ADD, MG(clock.cycles), RAX);
+    emit_tail(&e, 32);
+    test_rr(&e, 0, RAX, RAX);
+    size_t stop = jcc(&e, CC_NE);
+    mov_rm(&e, 0, RCX, MF(0));
+    alu_ri(&e, 0, CMP, RCX, 0xffff);
+    size_t moved = jcc(&e, CC_A);
+    x_op(&e, X_16, 0x39, RCX, 0, MG(cpu.reg.pc), 0, 0); /* cmp [pc], cx */
+    size_t same = jcc(&e, CC_E);
+    patch(&e, moved, e.pos);
+    mov_ri(&e, RAX, 2);
+    patch(&e, same, e.pos);
+    patch(&e, stop, e.pos);
+    alu_ri(&e, X_W, ADD, RSP, 24);
+    ret(&e);
+
+    jit->read8 = e.pos;
+    routine_read8(&e);
+    jit->write8 = e.pos;
+    routine_write8(&e);
+    jit->read16 = e.pos;
+    routine_read16(&e);
+    jit->write16 = e.pos;
+    routine_write16(&e);
+    jit->used = e.pos;
+}
+
+/*************** Blocks. ***************/
+
+/* Ways out of an instruction, emitted after the block. */
+enum { STUB_PEND, STUB_TAIL, STUB_BANK };
+
+typedef struct {
+    int kind;
+    size_t at;   /* Jump to the stub. */
+    size_t cont; /* Where the block goes on. */
+    uint32_t pc; /* To store, above 0xffff if stored. */
+    unsigned int cycles;
+} stub_t;
+
+typedef struct {
+    cpu_jit_t *jit;
+    emit_t e;
+    int64_t bank;  /* ROM offset of the switchable bank, -1 for bank 0. */
+    uint8_t op;    /* Of the instruction, then its operand. */
+    uint16_t imm;
+    uint16_t next; /* PC after it. */
+    /* Cycles of the instruction not in the step: the step holds those
+     * added by calls, which may be more than counted here if dyn. */
+    unsigned int p;
+    bool dyn;
+    bool wrote; /* It may have switched banks. */
+    stub_t stubs[CPU_JIT_STUBS];
+    unsigned int nstubs;
+} block_t;
+
+static void stub_add(block_t *b, int kind, size_t at, size_t cont, uint32_t pc)
+{
+    assert(b->nstubs < CPU_JIT_STUBS);
+    b->stubs[b->nstubs++] = (stub_t){kind, at, cont, pc, b->p};
+}
+
+/*
+ * The end of an instruction as in CPU_LOOP: the interrupt dispatch if
+ * pending, the commit and the checks, done by the stubs when the count
+ * reaches LIMIT. At the end of a block PC is stored and the next one runs.
+ */
+static void emit_epilogue(block_t *b, bool end)
+{
+    emit_t *e = &b->e;
+    uint32_t pc = end ? 0x10000 : b->next;
+    alu_mi(e, X_8, CMP, MG(intr.pending), 0);
+    size_t pend = jcc(e, CC_NE);
+    if (b->dyn) {
+        mov_rm(e, 0, RAX, MG(clock.step));
+        mov_mi(e, 0, MG(clock.step), 0);
+        alu_ri(e, 0, ADD, RAX, (int32_t)b->p);
+        alu_mr(e, X_W, ADD, MG(clock.cycles), RAX);
+    } else {
+        alu_mi(e, X_W, ADD, MG(clock.cycles), (int32_t)b->p);
+    }
+    mov_rm(e, X_W, RAX, MG(clock.cycles));
+    alu_rm(e, X_W, CMP, RAX, MF(FRAME_LIMIT));
+    size_t tail = jcc(e, CC_AE);
+    stub_add(b, STUB_PEND, pend, e->pos, pc);
+    stub_add(b, STUB_TAIL, tail, e->pos, pc);
+    if (end) {
+        jmp_to(e, b->jit->dispatch);
+    } else if (b->wrote && b->bank >= 0) {
+        alu_mi(e, 0, CMP, MG(cart.rom.offset), (int32_t)b->bank);
+        stub_add(b, STUB_BANK, jcc(e, CC_NE), 0, pc);
+    }
+}
+
+static void emit_stubs(block_t *b)
+{
+    emit_t *e = &b->e;
+    cpu_jit_t *jit = b->jit;
+    for (unsigned int i = 0; i < b->nstubs; ++i) {
+        const stub_t *s = &b->stubs[i];
+        patch(e, s->at, e->pos);
+        switch (s->kind) {
+            case STUB_PEND:
+                mov_ri(e, RCX, s->pc);
+                mov_ri(e, RDX, s->cycles);
+                call_to(e, jit->pend);
+                alu_ri(e, 0, CMP, RAX, 1);
+                jcc_to(e, CC_E, jit->exit);
+                jcc_to(e, CC_A, jit->dispatch);
+                jmp_to(e, s->cont);
+                break;
+            case STUB_TAIL:
+                call_to(e, jit->tail);
+                test_rr(e, 0, RAX, RAX);
+                jcc_to(e, CC_E, s->cont);
+                if (s->pc <= 0xffff)
+                    mov_mi(e, X_16, MG(cpu.reg.pc), s->pc);
+                jmp_to(e, jit->exit);
+                break;
+            default:
+                mov_mi(e, X_16, MG(cpu.reg.pc), s->pc);
+                jmp_to(e, jit->dispatch);
+                break;
+        }
+    }
+}
+
+/* Calls to the read and write routines, address in ESI, value in EDX. */
+static void emit_access(block_t *b, size_t routine, unsigned int cycles)
+{
+    mov_ri(&b->e, R8, b->p);
+    call_to(&b->e, routine);
+    b->p += cycles;
+    b->dyn = true;
+}
+
+static void emit_read8(block_t *b)
+{
+    emit_access(b, b->jit->read8, 4);
+}
+
+static void emit_write8(block_t *b)
+{
+    emit_access(b, b->jit->write8, 4);
+    b->wrote = true;
+}
+
+/* A call to C with the step up to date. */
+static void emit_call(block_t *b, int slot)
+{
+    emit_t *e = &b->e;
+    alu_mi(e, 0, ADD, MG(clock.step), (int32_t)b->p);
+    mov_rr(e, X_W, RDI, R15);
+    call_slot(e, slot);
+    alu_mi(e, 0, SUB, MG(clock.step), (int32_t)b->p);
+}
+
+/* B, C, D, E, H, L or A, numbered as in opcodes, into or from dst. */
+static void get8(emit_t *e, unsigned int r, int dst)
+{
+    switch (r) {
+        case 0:
+            movzx_rr(e, 0, dst, BH);
+            break;
+        case 1:
+            movzx_rr(e, X_8, dst, RBX);
+            break;
+        case 2:
+        case 4:
+            mov_rr(e, 0, dst, r == 2 ? R12 : R13);
+            shift_ri(e, 0, SHR, dst, 8);
+            break;
+        case 3:
+        case 5:
+            movzx_rr(e, X_8, dst, r == 3 ? R12 : R13);
+            break;
+        default:
+            mov_rr(e, 0, dst, R14);
+            break;
+    }
+}
+
+static void put8(emit_t *e, unsigned int r, int src)
+{
+    switch (r) {
+        case 0:
+            mov_rr(e, X_8, BH, src);
+            break;
+        case 1:
+            mov_rr(e, X_8, RBX, src);
+            break;
+        case 2:
+        case 4:
+            shift_ri(e, X_16, ROR, r == 2 ? R12 : R13, 8);
+            mov_rr(e, X_8, r == 2 ? R12 : R13, src);
+            shift_ri(e, X_16, ROR, r == 2 ? R12 : R13, 8);
+            break;
+        case 3:
+        case 5:
+            mov_rr(e, X_8, r == 3 ? R12 : R13, src);
+            break;
+        default:
+            movzx_rr(e, X_8, R14, src);
+            break;
+    }
+}
+
+/* BC, DE, HL in host registers. */
+static int pair(unsigned int i)
+{
+    return i == 0 ? RBX : i == 1 ? R12 : R13;
+}
+
+/* Z, H and C from AH after LAHF, in ECX. */
+static void flags_lahf(block_t *b)
+{
+    emit_t *e = &b->e;
+    movzx_rr(e, 0, RCX, AH);
+    lea(e, X_W, RDX, MC(CODE_FLAGS));
+    movzx_rm(e, 0, RCX, MX(RDX, RCX, 0, 0));
+}
+
+/* F from Z of the result in R14D, with extra flags set. */
+static void flags_logic(emit_t *e, int32_t extra)
+{
+    alu_rr(e, 0, XOR, RBP, RBP);
+    test_rr(e, 0, R14, R14);
+    setcc(e, CC_E, RBP);
+    shift_ri(e, 0, SHL, RBP, 7);
+    if (extra)
+        alu_ri(e, 0, OR, RBP, extra);
+}
+
+/* F from CF, and Z from AL unless for RLCA and the like. */
+static void flags_shift(emit_t *e, bool z)
+{
+    setcc(e, CC_B, RCX);
+    movzx_rr(e, X_8, RBP, RCX);
+    shift_ri(e, 0, SHL, RBP, 4);
+    if (z) {
+        test_rr(e, X_8, RAX, RAX);
+        setcc(e, CC_E, RCX);
+        movzx_rr(e, X_8, RCX, RCX);
+        shift_ri(e, 0, SHL, RCX, 7);
+        alu_rr(e, 0, OR, RBP, RCX);
+    }
+}
+
+/* The 8-bit ALU operations, as in opcodes 0x80 to 0xbf, on A and ECX. */
+static void emit_alu(block_t *b, unsigned int op)
+{
+    static const int x86[8] = {ADD, ADC, SUB, SBB, AND, XOR, OR, CMP};
+    emit_t *e = &b->e;
+    switch (op) {
+        case 4:
+            alu_rr(e, 0, AND, R14, RCX);
+            flags_logic(e, FLAG_H);
+            return;
+        case 5:
+        case 6:
+            alu_rr(e, 0, x86[op], R14, RCX);
+            flags_logic(e, 0);
+            return;
+    }
+    mov_rr(e, 0, RAX, R14);
+    if (op == 1 || op == 3)
+        bt_ri(e, RBP, 4);
+    alu_rr(e, X_8, x86[op], RAX, RCX);
+    lahf(e);
+    if (op != 7)
+        movzx_rr(e, X_8, R14, RAX);
+    flags_lahf(b);
+    mov_rr(e, 0, RBP, RCX);
+    if (op >= 2)
+        alu_ri(e, 0, OR, RBP, FLAG_N);
+}
+
+/* INC or DEC of AL, leaving C alone. */
+static void emit_incdec(block_t *b, bool dec)
+{
+    emit_t *e = &b->e;
+    alu_ri(e, X_8, dec ? SUB : ADD, RAX, 1);
+    lahf(e);
+    mov_rr(e, 0, RSI, RAX);
+    flags_lahf(b);
+    alu_ri(e, 0, AND, RCX, FLAG_Z | FLAG_H);
+    alu_ri(e, 0, AND, RBP, FLAG_C);
+    alu_rr(e, 0, OR, RBP, RCX);
+    if (dec)
+        alu_ri(e, 0, OR, RBP, FLAG_N);
+    mov_rr(e, 0, RAX, RSI);
+}
+
+/* The rotations and shifts of CB 0x00 to 0x3f, on AL. */
+static void emit_shift(emit_t *e, unsigned int n, bool z)
+{
+    static const int x86[8] = {ROL, ROR, RCL, RCR, SHL, SAR, ROL, SHR};
+    if (n == 2 || n == 3)
+        bt_ri(e, RBP, 4);
+    shift_ri(e, X_8, x86[n], RAX, n == 6 ? 4 : 1);
+    if (n == 6)
+        test_rr(e, X_8, RAX, RAX); /* SWAP leaves C clear. */
+    flags_shift(e, z);
+}
+
+static void emit_cb(block_t *b, uint8_t cb)
+{
+    emit_t *e = &b->e;
+    unsigned int r = cb & 7;
+    unsigned int n = cb >> 3 & 7;
+    if (r == 6) {
+        mov_rr(e, 0, RSI, R13);
+        emit_read8(b);
+    } else {
+        get8(e, r, RAX);
+    }
+    switch (cb >> 6) {
+        case 0:
+            emit_shift(e, n, true);
+            break;
+        case 1:
+            test_ri(e, X_8, RAX, 1u << n);
+            setcc(e, CC_E, RCX);
+            movzx_rr(e, X_8, RCX, RCX);
+            shift_ri(e, 0, SHL, RCX, 7);
+            alu_ri(e, 0, AND, RBP, FLAG_C);
+            alu_ri(e, 0, OR, RBP, FLAG_H);
+            alu_rr(e, 0, OR, RBP, RCX);
+            return;
+        case 2:
+            alu_ri(e, 0, AND, RAX, (int32_t)~(1u << n));
+            break;
+        default:
+            alu_ri(e, 0, OR, RAX, (int32_t)(1u << n));
+            break;
+    }
+    if (r == 6) {
+        mov_rr(e, 0, RDX, RAX);
+        mov_rr(e, 0, RSI, R13);
+        emit_write8(b);
+    } else {
+        put8(e, r, RAX);
+    }
+}
+
+/* Store the new PC, dynamic if pc is above 0xffff, and end the block. */
+static void emit_jump(block_t *b, uint32_t pc)
+{
+    emit_t *e = &b->e;
+    if (pc <= 0xffff) {
+        mov_mi(e, X_16, MG(cpu.reg.pc), pc);
+        /* A jump back may close a loop, see jump_back(). */
+        if (pc < b->next) {
+            alu_mi(e, 0, ADD, MG(clock.step), (int32_t)b->p);
+            spill(e);
+            mov_rr(e, X_W, RDI, R15);
+            mov_ri(e, RSI, b->next);
+            mov_rr(e, 0, RDX, RBP);
+            call_slot(e, SLOT_JUMP_BACK);
+            movzx_rr(e, X_8, RBP, RAX);
+            reload(e);
+            alu_mi(e, 0, SUB, MG(clock.step), (int32_t)b->p);
+            mov_mi(e, X_W, MF(FRAME_LIMIT), 0);
+            b->dyn = true;
+        }
+    }
+    assert(b->p == op_taken[b->op]);
+    emit_epilogue(b, true);
+}
+
+/* SP - 2 into SP and ESI. */
+static void emit_sp_dec(block_t *b)
+{
+    alu_mi(&b->e, X_16, SUB, MG(cpu.reg.sp), 2);
+    movzx_rm(&b->e, X_16, RSI, MG(cpu.reg.sp));
+    b->p += 4;
+}
+
+/* Pop into EAX. */
+static void emit_pop(block_t *b)
+{
+    movzx_rm(&b->e, X_16, RSI, MG(cpu.reg.sp));
+    emit_access(b, b->jit->read16, 8);
+    alu_mi(&b->e, X_16, ADD, MG(cpu.reg.sp), 2);
+}
+
+/* Push of PC after the instruction, then a jump to pc. */
+static void emit_call_to(block_t *b, uint16_t pc)
+{
+    emit_sp_dec(b);
+    mov_ri(&b->e, RDX, b->next);
+    emit_access(b, b->jit->write16, 8);
+    b->wrote = true;
+    emit_jump(b, pc);
+}
+
+/* The taken half of a conditional instruction, with the flag tested. */
+static size_t emit_condition(block_t *b)
+{
+    unsigned int cc = b->op >> 3 & 3;
+    test_ri(&b->e, 0, RBP, cc < 2 ? FLAG_Z : FLAG_C);
+    /* Skipped over when the condition fails. */
+    return jcc(&b->e, cc & 1 ? CC_E : CC_NE);
+}
+
+static void emit_not_taken(block_t *b, size_t skip, unsigned int p, bool dyn,
+                           bool wrote)
+{
+    patch(&b->e, skip, b->e.pos);
+    b->p = p;
+    b->dyn = dyn;
+    b->wrote = wrote;
+}
+
+/* The body of the instruction. Returns true if it ended the block. */
+static bool emit_insn(block_t *b)
+{
+    emit_t *e = &b->e;
+    uint8_t op = b->op;
+    uint16_t imm = b->imm;
+    unsigned int r = op >> 3 & 7;
+    unsigned int p = b->p;
+    bool dyn = b->dyn;
+    bool wrote = b->wrote;
+    size_t skip;
+    if (op >= 0x40 && op < 0x80) {
+        /* LD r, r' */
+        if ((op & 7) == 6) {
+            mov_rr(e, 0, RSI, R13);
+            emit_read8(b);
+            put8(e, r, RAX);
+        } else if (r == 6) {
+            get8(e, op & 7, RDX);
+            mov_rr(e, 0, RSI, R13);
+            emit_write8(b);
+        } else if (r != (op & 7u)) {
+            get8(e, op & 7, RAX);
+            put8(e, r, RAX);
+        }
+        return false;
+    }
+    if (op >= 0x80 && op < 0xc0) {
+        if ((op & 7) == 6) {
+            mov_rr(e, 0, RSI, R13);
+            emit_read8(b);
+            mov_rr(e, 0, RCX, RAX);
+        } else {
+            get8(e, op & 7, RCX);
+        }
+        emit_alu(b, r);
+        return false;
+    }
+    switch (op) {
+        case 0x00:
+            return false;
+        case 0x01:
+        case 0x11:
+        case 0x21:
+            mov_ri(e, pair(op >> 4), imm);
+            return false;
+        case 0x31:
+            mov_mi(e, X_16, MG(cpu.reg.sp), imm);
+            return false;
+        case 0x02:
+        case 0x12:
+            mov_rr(e, 0, RSI, pair(op >> 4));
+            mov_rr(e, 0, RDX, R14);
+            emit_write8(b);
+            return false;
+        case 0x22:
+        case 0x32:
+            mov_rr(e, 0, RSI, R13);
+            incdec_r(e, X_16, op == 0x32, R13);
+            mov_rr(e, 0, RDX, R14);
+            emit_write8(b);
+            return false;
+        case 0x0a:
+        case 0x1a:
+            mov_rr(e, 0, RSI, pair(op >> 4));
+            emit_read8(b);
+            mov_rr(e, 0, R14, RAX);
+            return false;
+        case 0x2a:
+        case 0x3a:
+            mov_rr(e, 0, RSI, R13);
+            incdec_r(e, X_16, op == 0x3a, R13);
+            emit_read8(b);
+            mov_rr(e, 0, R14, RAX);
+            return false;
+        case 0x03:
+        case 0x13:
+        case 0x23:
+        case 0x0b:
+        case 0x1b:
+        case 0x2b:
+            incdec_r(e, X_16, op & 8 ? 1 : 0, pair(op >> 4));
+            b->p += 4;
+            return false;
+        case 0x33:
+        case 0x3b:
+            incdec_m(e, X_16, op & 8 ? 1 : 0, MG(cpu.reg.sp));
+            b->p += 4;
+            return false;
+        case 0x09:
+        case 0x19:
+        case 0x29:
+        case 0x39:
+            /* H from bit 12 and C from bit 16 of the sum. */
+            if (op == 0x39)
+                movzx_rm(e, X_16, RCX, MG(cpu.reg.sp));
+            else
+                mov_rr(e, 0, RCX, pair(op >> 4));
+            mov_rr(e, 0, RAX, R13);
+            alu_rr(e, 0, ADD, RAX, RCX);
+            mov_rr(e, 0, RDX, R13);
+            alu_rr(e, 0, XOR, RDX, RCX);
+            alu_rr(e, 0, XOR, RDX, RAX);
+            shift_ri(e, 0, SHR, RDX, 7);
+            alu_ri(e, 0, AND, RDX, FLAG_H);
+            alu_ri(e, 0, AND, RBP, FLAG_Z);
+            alu_rr(e, 0, OR, RBP, RDX);
+            mov_rr(e, 0, RDX, RAX);
+            shift_ri(e, 0, SHR, RDX, 12);
+            alu_ri(e, 0, AND, RDX, FLAG_C);
+            alu_rr(e, 0, OR, RBP, RDX);
+            movzx_rr(e, X_16, R13, RAX);
+            b->p += 4;
+            return false;
+        case 0x04:
+        case 0x0c:
+        case 0x14:
+        case 0x1c:
+        case 0x24:
+        case 0x2c:
+        case 0x3c:
+        case 0x05:
+        case 0x0d:
+        case 0x15:
+        case 0x1d:
+        case 0x25:
+        case 0x2d:
+        case 0x3d:
+            get8(e, r, RAX);
+            emit_incdec(b, op & 1);
+            put8(e, r, RAX);
+            return false;
+        case 0x34:
+        case 0x35:
+            mov_rr(e, 0, RSI, R13);
+            emit_read8(b);
+            emit_incdec(b, op & 1);
+            mov_rr(e, 0, RDX, RAX);
+            mov_rr(e, 0, RSI, R13);
+            emit_write8(b);
+            return false;
+        case 0x06:
+        case 0x0e:
+        case 0x16:
+        case 0x1e:
+        case 0x26:
+        case 0x2e:
+        case 0x3e:
+            mov_ri(e, RAX, imm);
+            put8(e, r, RAX);
+            return false;
+        case 0x36:
+            mov_rr(e, 0, RSI, R13);
+            mov_ri(e, RDX, imm);
+            emit_write8(b);
+            return false;
+        case 0x07:
+        case 0x0f:
+        case 0x17:
+        case 0x1f:
+            /* RLCA, RRCA, RLA and RRA: as the CB ones, with Z clear. */
+            mov_rr(e, 0, RAX, R14);
+            emit_shift(e, r, false);
+            movzx_rr(e, X_8, R14, RAX);
+            return false;
+        case 0x08:
+            movzx_rm(e, X_16, RDX, MG(cpu.reg.sp));
+            mov_ri(e, RSI, imm);
+            emit_access(b, b->jit->write16, 8);
+            b->wrote = true;
+            return false;
+        case 0x2f:
+            alu_ri(e, 0, XOR, R14, 0xff);
+            alu_ri(e, 0, OR, RBP, FLAG_N | FLAG_H);
+            return false;
+        case 0x37:
+            alu_ri(e, 0, AND, RBP, FLAG_Z);
+            alu_ri(e, 0, OR, RBP, FLAG_C);
+            return false;
+        case 0x3f:
+            alu_ri(e, 0, AND, RBP, FLAG_Z | FLAG_C);
+            alu_ri(e, 0, XOR, RBP, FLAG_C);
+            return false;
+        case 0x18:
+            b->p += 4;
+            emit_jump(b, (uint16_t)(b->next + (int8_t)imm));
+            return true;
+        case 0x20:
+        case 0x28:
+        case 0x30:
+        case 0x38:
+            skip = emit_condition(b);
+            b->p += 4;
+            emit_jump(b, (uint16_t)(b->next + (int8_t)imm));
+            emit_not_taken(b, skip, p, dyn, wrote);
+            return false;
+        case 0xc3:
+            b->p += 4;
+            emit_jump(b, imm);
+            return true;
+        case 0xc2:
+        case 0xca:
+        case 0xd2:
+        case 0xda:
+            skip = emit_condition(b);
+            b->p += 4;
+            emit_jump(b, imm);
+            emit_not_taken(b, skip, p, dyn, wrote);
+            return false;
+        case 0xe9:
+            mov_mr(e, X_16, MG(cpu.reg.pc), R13);
+            emit_jump(b, 0x10000);
+            return true;
+        case 0xcd:
+            emit_call_to(b, imm);
+            return true;
+        case 0xc4:
+        case 0xcc:
+        case 0xd4:
+        case 0xdc:
+            skip = emit_condition(b);
+            emit_call_to(b, imm);
+            emit_not_taken(b, skip, p, dyn, wrote);
+            return false;
+        case 0xc7:
+        case 0xcf:
+        case 0xd7:
+        case 0xdf:
+        case 0xe7:
+        case 0xef:
+        case 0xf7:
+        case 0xff:
+            emit_call_to(b, op & 0x38);
+            return true;
+        case 0xc9:
+        case 0xd9:
+            emit_pop(b);
+            mov_mr(e, X_16, MG(cpu.reg.pc), RAX);
+            b->p += 4;
+            /* RETI enables interrupts once PC is set. */
+            if (op == 0xd9) {
+                mov_ri(e, RSI, 1);
+                emit_call(b, SLOT_SET_MASTER);
+            }
+            emit_jump(b, 0x10000);
+            return true;
+        case 0xc0:
+        case 0xc8:
+        case 0xd0:
+        case 0xd8:
+            skip = emit_condition(b);
+            emit_pop(b);
+            mov_mr(e, X_16, MG(cpu.reg.pc), RAX);
+            b->p += 8;
+            emit_jump(b, 0x10000);
+            emit_not_taken(b, skip, p + 4, dyn, wrote);
+            return false;
+        case 0xc1:
+        case 0xd1:
+        case 0xe1:
+            emit_pop(b);
+            movzx_rr(e, X_16, pair(op >> 4 & 3), RAX);
+            return false;
+        case 0xf1:
+            emit_pop(b);
+            movzx_rr(e, X_8, RBP, RAX);
+            alu_ri(e, 0, AND, RBP, 0xf0);
+            shift_ri(e, 0, SHR, RAX, 8);
+            mov_rr(e, 0, R14, RAX);
+            return false;
+        case 0xc5:
+        case 0xd5:
+        case 0xe5:
+        case 0xf5:
+            emit_sp_dec(b);
+            if (op == 0xf5) {
+                mov_rr(e, 0, RDX, R14);
+                shift_ri(e, 0, SHL, RDX, 8);
+                alu_rr(e, 0, OR, RDX, RBP);
+            } else {
+                mov_rr(e, 0, RDX, pair(op >> 4 & 3));
+            }
+            emit_access(b, b->jit->write16, 8);
+            b->wrote = true;
+            return false;
+        case 0xc6:
+        case 0xce:
+        case 0xd6:
+        case 0xde:
+        case 0xe6:
+        case 0xee:
+        case 0xf6:
+        case 0xfe:
+            mov_ri(e, RCX, imm);
+            emit_alu(b, r);
+            return false;
+        case 0xcb:
+            emit_cb(b, (uint8_t)imm);
+            return false;
+        case 0xe0:
+        case 0xf0:
+        case 0xea:
+        case 0xfa: {
+            uint16_t addr = op & 0x0f ? imm : (uint16_t)(0xff00 | imm);
+            if (addr >= 0xff80 && addr < 0xffff) {
+                /* HRAM is known at compile time, no call. */
+                const mem_t *m = M(R15, offsetof(gb_t, mmu.zram) +
+                                            (addr & 0x7f));
+                if (op & 0x10)
+                    movzx_rm(e, 0, R14, m);
+                else
+                    mov_mr(e, X_8, m, R14);
+                b->p += 4;
+            } else if (op & 0x10) {
+                mov_ri(e, RSI, addr);
+                emit_read8(b);
+                mov_rr(e, 0, R14, RAX);
+            } else {
+                mov_ri(e, RSI, addr);
+                mov_rr(e, 0, RDX, R14);
+                emit_write8(b);
+            }
+            return false;
+        }
+        case 0xe2:
+        case 0xf2:
+            movzx_rr(e, X_8, RSI, RBX);
+            alu_ri(e, 0, OR, RSI, 0xff00);
+            if (op == 0xf2) {
+                emit_read8(b);
+                mov_rr(e, 0, R14, RAX);
+            } else {
+                mov_rr(e, 0, RDX, R14);
+                emit_write8(b);
+            }
+            return false;
+        case 0xe8:
+        case 0xf8:
+            /* H and C from the low byte, added unsigned. */
+            movzx_rm(e, X_16, RSI, MG(cpu.reg.sp));
+            mov_rr(e, 0, RAX, RSI);
+            alu_ri(e, X_8, ADD, RAX, (int8_t)imm);
+            lahf(e);
+            alu_ri(e, 0, ADD, RSI, (int8_t)imm);
+            flags_lahf(b);
+            alu_ri(e, 0, AND, RCX, FLAG_H | FLAG_C);
+            mov_rr(e, 0, RBP, RCX);
+            if (op == 0xe8) {
+                mov_mr(e, X_16, MG(cpu.reg.sp), RSI);
+                b->p += 8;
+            } else {
+                movzx_rr(e, X_16, R13, RSI);
+                b->p += 4;
+            }
+            return false;
+        case 0xf9:
+            mov_mr(e, X_16, MG(cpu.reg.sp), R13);
+            b->p += 4;
+            return false;
+        case 0xf3:
+        case 0xfb:
+            mov_ri(e, RSI, op == 0xfb);
+            emit_call(b, SLOT_SET_MASTER);
+            return false;
+    }
+    abort();
+}
+
+/* Whether the instruction at offset compiles, within the bank up to end. */
+static bool cpu_jit_compiles(const cart_rom_image_t *image, size_t offset,
+                             size_t end)
+{
+    uint8_t op = image->bytes[offset];
+    if (offset + op_length[op] > end)
+        return false;
+    switch (op) {
+        /* Those the interpreter keeps, HALT and STOP for how they wait. */
+        case 0x10:
+        case 0x27:
+        case 0x76:
+        case 0xd3:
+        case 0xdb:
+        case 0xdd:
+        case 0xe3:
+        case 0xe4:
+        case 0xeb:
+        case 0xec:
+        case 0xed:
+        case 0xf4:
+        case 0xfc:
+        case 0xfd:
+            return false;
+    }
+    return true;
+}
+
+/* Compile the block at offset, reached at pc. Returns its entry. */
+static uint32_t cpu_jit_block(cpu_jit_t *jit, const cart_rom_image_t *image,
+                              uint16_t pc, size_t offset)
+{
+    block_t b;
+    size_t end = (offset | 0x3fff) + 1;
+    if (end > image->size)
+        end = image->size;
+    b.jit = jit;
+    b.e = (emit_t){jit->code, jit->used};
+    b.bank = pc < 0x4000 ? -1 : (int64_t)(offset & ~(size_t)0x3fff);
+    b.nstubs = 0;
+    size_t start = b.e.pos;
+    for (unsigned int count = 1;; ++count) {
+        if (!cpu_jit_compiles(image, offset, end))
+            break;
+        const uint8_t *bytes = &image->bytes[offset];
+        unsigned int length = op_length[bytes[0]];
+        b.op = bytes[0];
+        b.imm = length == 3 ? (uint16_t)(bytes[1] | bytes[2] << 8) : bytes[1];
+        b.next = (uint16_t)(pc + length);
+        b.p = 4 * length;
+        b.dyn = false;
+        b.wrote = false;
+        if (emit_insn(&b))
+            break;
+        assert(b.p == (b.op == 0xcb ? cb_cycles[b.imm & 0xff]
+                                    : op_cycles[b.op]));
+        offset += length;
+        pc = b.next;
+        if (count == CPU_JIT_BLOCK_MAX ||
+            !cpu_jit_compiles(image, offset, end)) {
+            mov_mi(&b.e, X_16, MG(cpu.reg.pc), pc);
+            emit_epilogue(&b, true);
+            break;
+        }
+        emit_epilogue(&b, false);
+    }
+    if (b.e.pos == start)
+        return CPU_JIT_NONE;
+    emit_stubs(&b);
+    assert(b.e.pos - start < CPU_JIT_BLOCK_SIZE);
+    jit->used = b.e.pos;
+    return (uint32_t)start;
+}
+
+/* The entry at offset, compiling its block the first time. */
+static uint32_t cpu_jit_compile(cpu_jit_t *jit, const cart_rom_image_t *image,
+                                uint16_t pc, size_t offset)
+{
+    while (atomic_flag_test_and_set_explicit(&jit->lock, memory_order_acquire))
+        ;
+    uint32_t entry =
+        atomic_load_explicit(&jit->entries[offset], memory_order_relaxed);
+    if (entry == 0) {
+        entry = CPU_JIT_NONE;
+        /* Once the code is full, the rest is interpreted. */
+        if (CPU_JIT_CODE_SIZE - jit->used >= CPU_JIT_BLOCK_SIZE)
+            entry = cpu_jit_block(jit, image, pc, offset);
+        atomic_store_explicit(&jit->entries[offset], entry,
+                              memory_order_release);
+    }
+    atomic_flag_clear_explicit(&jit->lock, memory_order_release);
+    return entry;
+}
+
+static void cpu_jit_free(cart_rom_jit_t *base)
+{
+    cpu_jit_t *jit = (cpu_jit_t *)base;
+    if (jit->code != NULL)
+        munmap(jit->code, CPU_JIT_CODE_SIZE);
+    free(jit->entries);
+    free(jit);
+}
+
+static cpu_jit_t *cpu_jit_create(size_t size)
+{
+    cpu_jit_t *jit = calloc(1, sizeof(*jit));
+    if (jit == NULL) {
+        fprintf(stderr, "ERROR: calloc\n");
+        return NULL;
+    }
+    jit->base.free = cpu_jit_free;
+    atomic_flag_clear(&jit->lock);
+    jit->size = size;
+    jit->entries = calloc(size, sizeof(*jit->entries));
+    if (jit->entries == NULL) {
+        fprintf(stderr, "ERROR: calloc\n");
+        cpu_jit_free(&jit->base);
+        return NULL;
+    }
+    void *code = mmap(NULL, CPU_JIT_CODE_SIZE,
+                      PROT_READ | PROT_WRITE | PROT_EXEC,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (code == MAP_FAILED) {
+        fprintf(stderr, "ERROR: mmap of code, running interpreted\n");
+        cpu_jit_free(&jit->base);
+        return NULL;
+    }
+    jit->code = code;
+    cpu_jit_routines(jit);
+    return jit;
+}
+
+/* The cache of the image, made by the first instance to need it. */
+static cpu_jit_t *cpu_jit_get(cart_rom_image_t *image)
+{
+    cart_rom_jit_t *jit =
+        atomic_load_explicit(&image->jit, memory_order_acquire);
+    if (jit != NULL)
+        return (cpu_jit_t *)jit;
+    cpu_jit_t *created = cpu_jit_create(image->size);
+    if (created == NULL) {
+        atomic_store(&image->jit_off, true);
+        return NULL;
+    }
+    if (!atomic_compare_exchange_strong(&image->jit, &jit, &created->base)) {
+        cpu_jit_free(&created->base);
+        return (cpu_jit_t *)jit;
+    }
+    return created;
+}
+
+bool cpu_jit_enabled(gb_t *gb)
+{
+    const cart_rom_image_t *image = gb->cart.rom.image;
+    return image != NULL &&
+           !atomic_load_explicit(&image->jit_off, memory_order_relaxed);
+}
+
+uint64_t cpu_jit_run(gb_t *gb, uint64_t budget)
+{
+    cart_rom_image_t *image = gb->cart.rom.image;
+    uint16_t pc = gb->cpu.reg.pc;
+    size_t offset = pc;
+    /* Blocks of the switchable bank hold its PCs, not those of bank 0. */
+    if (pc >= 0x8000 || (pc >= 0x4000 && gb->cart.rom.offset < 0x4000))
+        return 0;
+    if (pc >= 0x4000)
+        offset = gb->cart.rom.offset + (pc & 0x3fff);
+    if (offset >= image->size)
+        return 0;
+    cpu_jit_t *jit = cpu_jit_get(image);
+    if (jit == NULL)
+        return 0;
+    uint32_t entry =
+        atomic_load_explicit(&jit->entries[offset], memory_order_acquire);
+    if (entry == 0)
+        entry = cpu_jit_compile(jit, image, pc, offset);
+    if (entry == CPU_JIT_NONE)
+        return 0;
+    uint64_t cycles = gb->clock.cycles;
+    uint64_t end =
+        budget < UINT64_MAX - cycles ? cycles + budget : UINT64_MAX;
+    cpu_jit_ctx_t ctx = {jit->entries, jit->size, cpu_get_f(&gb->cpu)};
+    cpu_jit_enter_f enter = (cpu_jit_enter_f)(jit->code + jit->enter);
+    cycles = enter(gb, end, jit->code + entry, &ctx);
+    cpu_set_f(&gb->cpu, ctx.f);
+    return cycles;
+}
@@ -0,0 +1,35 @@
+#ifndef CPU_JIT_H
+#define CPU_JIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Recompiler of ROM code to x86-64, in builds with CPU_JIT.
+ *
+ * Basic blocks of ROM are compiled the first time PC reaches them, keyed by
+ * ROM offset as the decoded instructions are, so bank switches need no
+ * invalidation, and shared by every instance running the game. A, BC, DE, HL
+ * and F live in host registers meanwhile. Accesses to WRAM, HRAM and ROM are
+ * made in place, the others go through the MMU.
+ *
+ * Each instruction ends as in the interpreter: the interrupt dispatch if one
+ * may be due, the commit to the clock, and a return to the caller at the end
+ * of a frame or of the budget. Blocks run straight into each other. Code out
+ * of ROM, which may change, and the instructions the interpreter keeps to
+ * itself (HALT, STOP, DAA and undefined ones) are left to cpu_execute_loop().
+ */
+
+typedef struct gb gb_t;
+
+/* Whether ROM code of the game may be compiled, see gb_set_jit(). */
+bool cpu_jit_enabled(gb_t *gb);
+
+/**
+ * Run compiled code from PC for budget cycles, or up to the end of a frame,
+ * as cpu_execute_loop() would. Returns the cycles run, 0 if PC is in no
+ * block that compiles.
+ */
+uint64_t cpu_jit_run(gb_t *gb, uint64_t budget);
+
+#endif /* CPU_JIT_H */
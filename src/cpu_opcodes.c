@@ -1,14 +1,20 @@
 #include "cpu_opcodes.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include "cartridge/cart.h"
 #include "clock.h"
 #include "cpu.h"
-#include "cpu_utils.h"
+#include "cpu_bulk.h"
+#include "cpu_idle.h"
+#ifdef CPU_JIT
+#include "cpu_jit.h"
+#endif
+#include "cpu_ops.h"
+#include "gb.h"
 #include "interrupt.h"
+#include "cpu_debug.h"
 #include "mmu.h"
 
-extern cpu_t CPU;
-
 /*************** Helper funcions. ***************/
 
 /**
@@ -20,17 +26,12 @@ extern cpu_t CPU;
  * H - Set if carry from bit 3.
  * C - Not affected.
  */
-static uint8_t inc_n(uint8_t value)
+static uint8_t inc_n(cpu_t *cpu, uint8_t value)
 {
-    if ((value & 0x0f) == 0x0f) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    ++value;
-    FLAG_SET_ZERO(!value);
-    FLAG_CLEAR(FLAG_N);
-    return value;
+    uint8_t result = (uint8_t)(value + 1);
+    cpu_flags_store(&cpu->flags, FLAG_Z | FLAG_N | FLAG_H, result, 0,
+                    value ^ result, 0);
+    return result;
 }
 
 /**
@@ -42,17 +43,12 @@ static uint8_t inc_n(uint8_t value)
  * H - Set if no borrow from bit 4.
  * C - Not affected.
  */
-static uint8_t dec_n(uint8_t value)
+static uint8_t dec_n(cpu_t *cpu, uint8_t value)
 {
-    if (value & 0x0f) {
-        FLAG_CLEAR(FLAG_H);
-    } else {
-        FLAG_SET(FLAG_H);
-    }
-    --value;
-    FLAG_SET_ZERO(!value);
-    FLAG_SET(FLAG_N);
-    return value;
+    uint8_t result = (uint8_t)(value - 1);
+    cpu_flags_store(&cpu->flags, FLAG_Z | FLAG_N | FLAG_H, result, 1,
+                    value ^ result, 0);
+    return result;
 }
 
 /**
@@ -63,23 +59,12 @@ static uint8_t dec_n(uint8_t value)
  * H - Set if carry from bit 3.
  * C - Set if carry from bit 7.
  */
-static uint8_t add8(uint8_t val1, uint8_t val2)
+static uint8_t add8(cpu_t *cpu, uint8_t val1, uint8_t val2)
 {
-    uint32_t result32 = (uint32_t)(val1 + val2);
-    uint8_t result8 = (uint8_t)(result32 & 0xff);
-    FLAG_CLEAR(FLAG_N);
-    if (((val1 & 0x0f) + (val2 & 0x0f)) > 0x0f) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    if (result32 & 0xff00) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
-    FLAG_SET_ZERO(!result8);
-    return result8;
+    unsigned int result = (unsigned int)(val1 + val2);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, (uint8_t)result, 0,
+                    (uint8_t)(val1 ^ val2 ^ result), (uint8_t)(result >> 8));
+    return (uint8_t)result;
 }
 
 /**
@@ -90,23 +75,15 @@ static uint8_t add8(uint8_t val1, uint8_t val2)
  * H - Set if carry from bit 11.
  * C - Set if carry from bit 15.
  */
-static uint16_t add16(uint16_t val1, uint16_t val2)
+static uint16_t add16(gb_t *gb, cpu_t *cpu, uint16_t val1, uint16_t val2)
 {
-    uint32_t result = (uint32_t)(val1 + val2);
-    FLAG_CLEAR(FLAG_N);
-    if (((val1 & 0x0fff) + (val2 & 0x0fff)) > 0x0fff) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    if (result & 0xffff0000) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
-    clock_step(4);
+    unsigned int result = (unsigned int)(val1 + val2);
+    cpu_flags_store(&cpu->flags, FLAG_N | FLAG_H | FLAG_C, 0, 0,
+                    (uint8_t)((val1 ^ val2 ^ result) >> 8),
+                    (uint8_t)(result >> 16));
+    clock_step(gb, 4);
     /* Zero flag is not updated. */
-    return (uint16_t)(result & 0xffff);
+    return (uint16_t)result;
 }
 
 /**
@@ -117,24 +94,13 @@ static uint16_t add16(uint16_t val1, uint16_t val2)
  * H - Set if carry from bit 3.
  * C - Set if carry from bit 7.
  */
-static void adc(uint8_t val)
+static void adc(cpu_t *cpu, uint8_t val)
 {
-    uint8_t carry = FLAG_IS_SET(FLAG_C) >> 4;
-    uint32_t result32 = (uint32_t)(CPU.reg.a + val + carry);
-    uint8_t result8 = (uint8_t)(result32 & 0xff);
-    FLAG_CLEAR(FLAG_N);
-    if (((CPU.reg.a & 0x0f) + (val & 0x0f) + carry) > 0x0f) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    if (result32 & 0xff00) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
-    FLAG_SET_ZERO(!result8);
-    CPU.reg.a = result8;
+    unsigned int a = cpu->reg.a;
+    unsigned int result = a + val + FLAG_IS_SET(FLAG_C);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, (uint8_t)result, 0,
+                    (uint8_t)(a ^ val ^ result), (uint8_t)(result >> 8));
+    cpu->reg.a = (uint8_t)result;
 }
 
 /**
@@ -145,21 +111,13 @@ static void adc(uint8_t val)
  * H - Set if borrow from bit 4.
  * C - Set if borrow.
  */
-static void sub(uint8_t val)
+static void sub(cpu_t *cpu, uint8_t val)
 {
-    FLAG_SET(FLAG_N);
-    if (((val & 0x0f) > (CPU.reg.a & 0x0f))) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    if (val > CPU.reg.a) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
-    CPU.reg.a = (uint8_t)(CPU.reg.a - val);
-    FLAG_SET_ZERO(!CPU.reg.a);
+    unsigned int a = cpu->reg.a;
+    unsigned int result = a - val;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, (uint8_t)result, 1,
+                    (uint8_t)(a ^ val ^ result), (uint8_t)(result >> 8));
+    cpu->reg.a = (uint8_t)result;
 }
 
 /**
@@ -170,23 +128,13 @@ static void sub(uint8_t val)
  * H - Set if borrow from bit 4.
  * C - Set if borrow.
  */
-static void sbc(uint8_t val)
+static void sbc(cpu_t *cpu, uint8_t val)
 {
-    FLAG_SET(FLAG_N);
-    uint8_t carry = FLAG_IS_SET(FLAG_C) >> 4;
-    if (((val & 0x0f) + carry > (CPU.reg.a & 0x0f))) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    int nc = val + carry;
-    if (nc > CPU.reg.a) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
-    CPU.reg.a -= nc;
-    FLAG_SET_ZERO(!CPU.reg.a);
+    unsigned int a = cpu->reg.a;
+    unsigned int result = a - val - FLAG_IS_SET(FLAG_C);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, (uint8_t)result, 1,
+                    (uint8_t)(a ^ val ^ result), (uint8_t)(result >> 8));
+    cpu->reg.a = (uint8_t)result;
 }
 
 /**
@@ -197,12 +145,10 @@ static void sbc(uint8_t val)
  * H - Set.
  * C - Reset.
  */
-static void and8(uint8_t val)
+static void and8(cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.a &= val;
-    FLAG_SET_ZERO(!CPU.reg.a);
-    FLAG_CLEAR(FLAG_N | FLAG_C);
-    FLAG_SET(FLAG_H);
+    cpu->reg.a &= val;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, cpu->reg.a, 0, 0x10, 0);
 }
 
 /**
@@ -213,11 +159,10 @@ static void and8(uint8_t val)
  * H - Reset.
  * C - Reset.
  */
-static void xor8(uint8_t val)
+static void xor8(cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.a ^= val;
-    FLAG_SET_ZERO(!CPU.reg.a);
-    FLAG_CLEAR(FLAG_N | FLAG_H | FLAG_C);
+    cpu->reg.a ^= val;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, cpu->reg.a, 0, 0, 0);
 }
 
 /**
@@ -228,11 +173,10 @@ static void xor8(uint8_t val)
  * H - Reset.
  * C - Reset.
  */
-static void or8(uint8_t val)
+static void or8(cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.a |= val;
-    FLAG_SET_ZERO(!CPU.reg.a);
-    FLAG_CLEAR(FLAG_N | FLAG_H | FLAG_C);
+    cpu->reg.a |= val;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, cpu->reg.a, 0, 0, 0);
 }
 
 /**
@@ -243,322 +187,451 @@ static void or8(uint8_t val)
  * H - Set if borrow from bit 4.
  * C - Set for borrow. (Set if A < n.)
  */
-static void cp(uint8_t val)
+static void cp(cpu_t *cpu, uint8_t val)
 {
-    uint16_t result = (uint16_t)(CPU.reg.a - val);
-    FLAG_SET_ZERO(!result);
-    FLAG_SET(FLAG_N);
-    if (((val & 0x0f) > (CPU.reg.a & 0x0f))) {
-        FLAG_SET(FLAG_H);
-    } else {
-        FLAG_CLEAR(FLAG_H);
-    }
-    if (val > CPU.reg.a) {
-        FLAG_SET(FLAG_C);
-    } else {
-        FLAG_CLEAR(FLAG_C);
-    }
+    unsigned int a = cpu->reg.a;
+    unsigned int result = a - val;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, (uint8_t)result, 1,
+                    (uint8_t)(a ^ val ^ result), (uint8_t)(result >> 8));
 }
 
 /**
  * Update 16-bit register. Also take care of clock increase.
  */
-static inline void reg16_set(uint16_t *reg, uint16_t val)
+static inline void reg16_set(gb_t *gb, uint16_t *reg, uint16_t val)
 {
     *reg = val;
-    clock_step(4);
+    clock_step(gb, 4);
 }
 
 /**
  * Increment and update 16-bit register. Also take care of clock increase.
  */
-static inline void reg16_inc(uint16_t *reg, uint16_t val)
+static inline void reg16_inc(gb_t *gb, uint16_t *reg, uint16_t val)
 {
     *reg += val;
-    clock_step(4);
+    clock_step(gb, 4);
+}
+
+/*
+ * A taken jump from the instruction ending at end, which may close a loop.
+ * The skips look at gb->cpu, and only a bulk loop changes it.
+ */
+static void jump_back(gb_t *gb, cpu_t *cpu, uint16_t end)
+{
+    if (cpu->reg.pc >= end)
+        return;
+    gb->cpu = *cpu;
+    if (cpu_bulk_loop(gb, end))
+        *cpu = gb->cpu;
+    else
+        cpu_idle_loop(gb, end);
+}
+
+/* Rotate value left. Old bit 7 to Carry flag. */
+static uint8_t rlc(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value >> 7;
+    value = (uint8_t)(value << 1 | carry);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+/* Rotate value right. Old bit 0 to Carry flag. */
+static uint8_t rrc(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value & 1;
+    value = (uint8_t)(value << 7 | value >> 1);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+/* Rotate value left through Carry flag. */
+static uint8_t rl(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value >> 7;
+    value = (uint8_t)(value << 1 | FLAG_IS_SET(FLAG_C));
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+/* Rotate value right through Carry flag. */
+static uint8_t rr(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value & 1;
+    value = (uint8_t)(FLAG_IS_SET(FLAG_C) << 7 | value >> 1);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+/* Shift value left into Carry. */
+static uint8_t sla(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value >> 7;
+    value = (uint8_t)(value << 1);
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+/* Shift value right into Carry flag. */
+static uint8_t sra(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value & 1;
+    value = (uint8_t)((value & 0x80) | (value >> 1));
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+static uint8_t swap(cpu_t *cpu, uint8_t value)
+{
+    value = (uint8_t)(((value & 0x0f) << 4) | ((value & 0xf0) >> 4));
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, 0);
+    return value;
+}
+
+/* Shift value right into Carry flag. MSB set to 0. */
+static uint8_t srl(cpu_t *cpu, uint8_t value)
+{
+    uint8_t carry = value & 1;
+    value >>= 1;
+    cpu_flags_store(&cpu->flags, FLAG_ANY, value, 0, 0, carry);
+    return value;
+}
+
+static void bit(cpu_t *cpu, uint8_t bit, uint8_t value)
+{
+    cpu_flags_store(&cpu->flags, FLAG_Z | FLAG_N | FLAG_H, value & bit, 0,
+                    0x10, 0);
+}
+
+static uint8_t res(uint8_t bit, uint8_t value)
+{
+    return (uint8_t)(value & ~bit);
+}
+
+static uint8_t set(uint8_t bit, uint8_t value)
+{
+    return (uint8_t)(value | bit);
 }
 
 /* Push to stack. */
-void push(uint16_t val)
+static void stack_push(gb_t *gb, cpu_t *cpu, uint16_t val)
 {
-    reg16_inc(&CPU.reg.sp, -2);
-    mmu_write_word(CPU.reg.sp, val);
+    reg16_inc(gb, &cpu->reg.sp, -2);
+    mmu_write_word(gb, cpu->reg.sp, val);
 }
 
 /* Pop from stack. */
-uint16_t pop(void)
+static uint16_t stack_pop(gb_t *gb, cpu_t *cpu)
 {
-    uint16_t val = mmu_read_word(CPU.reg.sp);
-    CPU.reg.sp = (uint16_t)(CPU.reg.sp + 2);
+    uint16_t val = mmu_read_word(gb, cpu->reg.sp);
+    cpu->reg.sp = (uint16_t)(cpu->reg.sp + 2);
     return val;
 }
 
+/* The same on gb->cpu, for interrupt dispatch. */
+void push(gb_t *gb, uint16_t val)
+{
+    stack_push(gb, &gb->cpu, val);
+}
+
+uint16_t pop(gb_t *gb)
+{
+    return stack_pop(gb, &gb->cpu);
+}
+
 /* Function for undefined instructions. */
-void undefined(void)
+static void undefined(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.pc--;
-    uint8_t opcode = mmu_read_byte(CPU.reg.pc);
+    cpu->reg.pc--;
+    uint8_t opcode = mmu_read_byte(gb, cpu->reg.pc);
     printf("ERROR: undefined instruction 0x%02x!\n", opcode);
     exit(EXIT_FAILURE);
 }
 
 /*************** Opcodes implementation. ***************/
 
+/* All handlers take the same arguments, whether they use them or not. */
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
 /* 0x00: No operation. */
-void nop(void)
+static void nop(gb_t *gb, cpu_t *cpu)
 {
 }
 
+/* 0x40, 0x49, 0x52, 0x5b, 0x64, 0x6d and 0x7f: Copy a register to itself. */
+#define ld_b_b nop
+#define ld_c_c nop
+#define ld_d_d nop
+#define ld_e_e nop
+#define ld_h_h nop
+#define ld_l_l nop
+#define ld_a_a nop
+
 /* 0x01: Load 16-bit immediate into BC. */
-void ld_bc_nn(uint16_t value)
+static void ld_bc_nn(gb_t *gb, cpu_t *cpu, uint16_t value)
 {
-    CPU.reg.bc = value;
+    cpu->reg.bc = value;
 }
 
 /* 0x02: Save A to address pointed by BC. */
-void ld_bcp_a(void)
+static void ld_bcp_a(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.bc, CPU.reg.a);
+    mmu_write_byte(gb, cpu->reg.bc, cpu->reg.a);
 }
 
 /* 0x03: Increment 16-bit BC. */
-void inc_bc(void)
+static void inc_bc(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.bc, 1);
+    reg16_inc(gb, &cpu->reg.bc, 1);
 }
 
 /* 0x04: Increment B. */
-void inc_b(void)
+static void inc_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = inc_n(CPU.reg.b);
+    cpu->reg.b = inc_n(cpu, cpu->reg.b);
 }
 
 /* 0x05: Decrement B. */
-void dec_b(void)
+static void dec_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = dec_n(CPU.reg.b);
+    cpu->reg.b = dec_n(cpu, cpu->reg.b);
 }
 
 /* 0x06: Load 8-bit immediate into B. */
-void ld_b_n(uint8_t val)
+static void ld_b_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.b = val;
+    cpu->reg.b = val;
 }
 
 /* 0x07: Rotate A left. Old bit 7 to Carry flag. */
-void rlca(void)
+static void rlca(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t a = CPU.reg.a;
+    uint8_t a = cpu->reg.a;
     FLAG_SET_CARRY((a & 0x80) >> 7);
     FLAG_CLEAR(FLAG_Z | FLAG_N | FLAG_H);
-    CPU.reg.a = (a << 1) | (a >> 7);
+    cpu->reg.a = (a << 1) | (a >> 7);
 }
 
 /* 0x08: Save SP to given address. */
-void ld_nnp_sp(uint16_t addr)
+static void ld_nnp_sp(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
-    mmu_write_word(addr, CPU.reg.sp);
+    mmu_write_word(gb, addr, cpu->reg.sp);
 }
 
 /* 0x09: Add 16-bit BC to HL. */
-void add_hl_bc(void)
+static void add_hl_bc(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.hl = add16(CPU.reg.hl, CPU.reg.bc);
+    cpu->reg.hl = add16(gb, cpu, cpu->reg.hl, cpu->reg.bc);
 }
 
 /* 0x0a: Put value pointed by BC into A. */
-void ld_a_bcp(void)
+static void ld_a_bcp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = mmu_read_byte(CPU.reg.bc);
+    cpu->reg.a = mmu_read_byte(gb, cpu->reg.bc);
 }
 
 /* 0x0b: Decrement BC. */
-void dec_bc(void)
+static void dec_bc(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.bc, -1);
+    reg16_inc(gb, &cpu->reg.bc, -1);
 }
 
 /* 0x0c: Increment C. */
-void inc_c(void)
+static void inc_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = inc_n(CPU.reg.c);
+    cpu->reg.c = inc_n(cpu, cpu->reg.c);
 }
 
 /* 0x0d: Decrement C. */
-void dec_c(void)
+static void dec_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = dec_n(CPU.reg.c);
+    cpu->reg.c = dec_n(cpu, cpu->reg.c);
 }
 
 /* 0x0e: Load 8-bit immediate into C. */
-void ld_c_n(uint8_t val)
+static void ld_c_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.c = val;
+    cpu->reg.c = val;
 }
 
 /* 0x0f: Rotate A right. Old bit 0 to Carry flag. */
-void rrca(void)
+static void rrca(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t a = CPU.reg.a;
+    uint8_t a = cpu->reg.a;
     FLAG_SET_CARRY(a);
     FLAG_CLEAR(FLAG_Z | FLAG_N | FLAG_H);
-    CPU.reg.a = (a << 7) | (a >> 1);
+    cpu->reg.a = (a << 7) | (a >> 1);
 }
 
 /* 0x10: The STOP command halts the GameBoy processor and screen until any
- * button is pressed. */
-void stop(void)
+ * button is pressed. The screen keeps running here. */
+static void stop(gb_t *gb, cpu_t *cpu)
 {
-    mmu_stop();
-    printf("Received STOP command!\n");
+    /* Unless a CGB speed switch was armed, which it performs. */
+    if (mmu_stop(gb))
+        return;
+    /* Idle like HALT, with PC on the opcode until woken. */
+    cpu->halt = true;
+    cpu->halt_bug = false;
+    cpu->stop = true;
+    interrupt_pending(gb, INTERRUPT_PENDING_STOP, true);
+    cpu->reg.pc--;
 }
 
 /* 0x11: Load 16-bit immediate into DE. */
-void ld_de_nn(uint16_t value)
+static void ld_de_nn(gb_t *gb, cpu_t *cpu, uint16_t value)
 {
-    CPU.reg.de = value;
+    cpu->reg.de = value;
 }
 
 /* 0x12: Save A to address pointed by DE. */
-void ld_dep_a(void)
+static void ld_dep_a(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.de, CPU.reg.a);
+    mmu_write_byte(gb, cpu->reg.de, cpu->reg.a);
 }
 
 /* 0x13: Increment 16-bit DE. */
-void inc_de(void)
+static void inc_de(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.de, 1);
+    reg16_inc(gb, &cpu->reg.de, 1);
 }
 
 /* 0x14: Increment D. */
-void inc_d(void)
+static void inc_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = inc_n(CPU.reg.d);
+    cpu->reg.d = inc_n(cpu, cpu->reg.d);
 }
 
 /* 0x15: Decrement D. */
-void dec_d(void)
+static void dec_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = dec_n(CPU.reg.d);
+    cpu->reg.d = dec_n(cpu, cpu->reg.d);
 }
 
 /* 0x16: Load 8-bit immediate into D. */
-void ld_d_n(uint8_t val)
+static void ld_d_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.d = val;
+    cpu->reg.d = val;
 }
 
 /* 0x17: Rotate A left through Carry flag. */
-void rla(void)
+static void rla(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t old_carry = (uint8_t)(FLAG_IS_SET(FLAG_C) >> 4);
-    uint8_t a = CPU.reg.a;
+    uint8_t old_carry = FLAG_IS_SET(FLAG_C);
+    uint8_t a = cpu->reg.a;
     FLAG_SET_CARRY((a & 0x80) >> 7);
     FLAG_CLEAR(FLAG_Z | FLAG_N | FLAG_H);
-    CPU.reg.a = (a << 1) | old_carry;
+    cpu->reg.a = (a << 1) | old_carry;
 }
 
 /* 0x18: Relative jump by signed immediate. */
-void jr_n(uint8_t val)
+static void jr_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    reg16_inc(&CPU.reg.pc, (int8_t)val);
+    uint16_t end = cpu->reg.pc;
+    reg16_inc(gb, &cpu->reg.pc, (int8_t)val);
+    jump_back(gb, cpu, end);
 }
 
 /* 0x19: Add 16-bit DE to HL. */
-void add_hl_de(void)
+static void add_hl_de(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.hl = add16(CPU.reg.hl, CPU.reg.de);
+    cpu->reg.hl = add16(gb, cpu, cpu->reg.hl, cpu->reg.de);
 }
 
 /* 0x1a: Put value pointed by DE into A. */
-void ld_a_dep(void)
+static void ld_a_dep(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = mmu_read_byte(CPU.reg.de);
+    cpu->reg.a = mmu_read_byte(gb, cpu->reg.de);
 }
 
 /* 0x1b: Decrement DE. */
-void dec_de(void)
+static void dec_de(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.de, -1);
+    reg16_inc(gb, &cpu->reg.de, -1);
 }
 
 /* 0x1c: Increment E. */
-void inc_e(void)
+static void inc_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = inc_n(CPU.reg.e);
+    cpu->reg.e = inc_n(cpu, cpu->reg.e);
 }
 
 /* 0x1d: Decrement E. */
-void dec_e(void)
+static void dec_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = dec_n(CPU.reg.e);
+    cpu->reg.e = dec_n(cpu, cpu->reg.e);
 }
 
 /* 0x1e: Load 8-bit immediate into E. */
-void ld_e_n(uint8_t val)
+static void ld_e_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.e = val;
+    cpu->reg.e = val;
 }
 
 /* 0x1f: Rotate A right through Carry flag. */
-void rra(void)
+static void rra(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t old_carry = (uint8_t)(FLAG_IS_SET(FLAG_C) << 3);
-    uint8_t a = CPU.reg.a;
+    uint8_t old_carry = (uint8_t)(FLAG_IS_SET(FLAG_C) << 7);
+    uint8_t a = cpu->reg.a;
     FLAG_SET_CARRY(a);
     FLAG_CLEAR(FLAG_N | FLAG_Z | FLAG_H);
-    CPU.reg.a = old_carry | a >> 1;
+    cpu->reg.a = old_carry | a >> 1;
 }
 
 /* 0x20: Jump if Z flag is not set. */
-void jr_nz_n(uint8_t val)
+static void jr_nz_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     if (!FLAG_IS_SET(FLAG_Z)) {
-        reg16_inc(&CPU.reg.pc, (int8_t)val);
+        uint16_t end = cpu->reg.pc;
+        reg16_inc(gb, &cpu->reg.pc, (int8_t)val);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0x21: Load 16-bit immediate into HL. */
-void ld_hl_nn(uint16_t value)
+static void ld_hl_nn(gb_t *gb, cpu_t *cpu, uint16_t value)
 {
-    CPU.reg.hl = value;
+    cpu->reg.hl = value;
 }
 
 /* 0x22: Put A into memory address HL and increment HL. */
-void ldi_hlp_a(void)
+static void ldi_hlp_a(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl++, CPU.reg.a);
+    mmu_write_byte(gb, cpu->reg.hl++, cpu->reg.a);
 }
 
 /* 0x23: Increment 16-bit HL. */
-void inc_hl(void)
+static void inc_hl(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.hl, 1);
+    reg16_inc(gb, &cpu->reg.hl, 1);
 }
 
 /* 0x24: Increment H. */
-void inc_h(void)
+static void inc_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = inc_n(CPU.reg.h);
+    cpu->reg.h = inc_n(cpu, cpu->reg.h);
 }
 
 /* 0x25: Decrement H. */
-void dec_h(void)
+static void dec_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = dec_n(CPU.reg.h);
+    cpu->reg.h = dec_n(cpu, cpu->reg.h);
 }
 
 /* 0x26: Load 8-bit immediate into H. */
-void ld_h_n(uint8_t val)
+static void ld_h_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.h = val;
+    cpu->reg.h = val;
 }
 
 /* 0x27: Adjust A for BCD addition. */
-void daa(void)
+static void daa(gb_t *gb, cpu_t *cpu)
 {
-    uint16_t s = CPU.reg.a;
+    uint16_t s = cpu->reg.a;
 
     if (FLAG_IS_SET(FLAG_N)) {
         if (FLAG_IS_SET(FLAG_H))
@@ -572,1289 +645,3205 @@ void daa(void)
             s = (uint16_t)(s + 0x60);
     }
 
-    CPU.reg.a = (uint8_t)s;
+    cpu->reg.a = (uint8_t)s;
     FLAG_CLEAR(FLAG_H);
-    FLAG_SET_ZERO(!CPU.reg.a);
+    FLAG_SET_ZERO(!cpu->reg.a);
     if (s >= 0x100)
         FLAG_SET(FLAG_C);
 }
 
 /* 0x28: Jump if Z flag is set. */
-void jr_z_n(uint8_t val)
+static void jr_z_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     if (FLAG_IS_SET(FLAG_Z)) {
-        reg16_inc(&CPU.reg.pc, (int8_t)val);
+        uint16_t end = cpu->reg.pc;
+        reg16_inc(gb, &cpu->reg.pc, (int8_t)val);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0x29: Add 16-bit HL to HL. */
-void add_hl_hl(void)
+static void add_hl_hl(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.hl = add16(CPU.reg.hl, CPU.reg.hl);
+    cpu->reg.hl = add16(gb, cpu, cpu->reg.hl, cpu->reg.hl);
 }
 
 /* 0x2a: Put value at address HL into A and increment HL. */
-void ldi_a_hlp(void)
+static void ldi_a_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = mmu_read_byte(CPU.reg.hl++);
+    cpu->reg.a = mmu_read_byte(gb, cpu->reg.hl++);
 }
 
 /* 0x2b: Decrement HL. */
-void dec_hl(void)
+static void dec_hl(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.hl, -1);
+    reg16_inc(gb, &cpu->reg.hl, -1);
 }
 
 /* 0x2c: Increment L. */
-void inc_l(void)
+static void inc_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = inc_n(CPU.reg.l);
+    cpu->reg.l = inc_n(cpu, cpu->reg.l);
 }
 
 /* 0x2d: Decrement L. */
-void dec_l(void)
+static void dec_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = dec_n(CPU.reg.l);
+    cpu->reg.l = dec_n(cpu, cpu->reg.l);
 }
 
 /* 0x2e: Load 8-bit immediate into L. */
-void ld_l_n(uint8_t val)
+static void ld_l_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.l = val;
+    cpu->reg.l = val;
 }
 
 /* 0x2f: Complement A register. */
-void cpl(void)
+static void cpl(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = (uint8_t)(~CPU.reg.a);
+    cpu->reg.a = (uint8_t)(~cpu->reg.a);
     FLAG_SET(FLAG_N | FLAG_H);
 }
 
 /* 0x30: Jump if C flag is not set. */
-void jr_nc_n(uint8_t val)
+static void jr_nc_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     if (!FLAG_IS_SET(FLAG_C)) {
-        reg16_inc(&CPU.reg.pc, (int8_t)val);
+        uint16_t end = cpu->reg.pc;
+        reg16_inc(gb, &cpu->reg.pc, (int8_t)val);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0x31: Load 16-bit immediate into SP */
-void ld_sp_nn(uint16_t value)
+static void ld_sp_nn(gb_t *gb, cpu_t *cpu, uint16_t value)
 {
-    CPU.reg.sp = value;
+    cpu->reg.sp = value;
 }
 
 /* 0x32: Put A into memory address HL and decrement HL. */
-void ldd_hlp_a(void)
+static void ldd_hlp_a(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl--, CPU.reg.a);
+    mmu_write_byte(gb, cpu->reg.hl--, cpu->reg.a);
 }
 
 /* 0x33: Increment 16-bit SP. */
-void inc_sp(void)
+static void inc_sp(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.sp, 1);
+    reg16_inc(gb, &cpu->reg.sp, 1);
 }
 
 /* 0x34: Increment value pointed by HL. */
-void inc_hlp(void)
+static void inc_hlp(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t val = mmu_read_byte(CPU.reg.hl);
-    mmu_write_byte(CPU.reg.hl, inc_n(val));
+    uint8_t val = mmu_read_byte(gb, cpu->reg.hl);
+    mmu_write_byte(gb, cpu->reg.hl, inc_n(cpu, val));
 }
 
 /* 0x35: Decrement value pointed by HL. */
-void dec_hlp(void)
+static void dec_hlp(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t val = mmu_read_byte(CPU.reg.hl);
-    mmu_write_byte(CPU.reg.hl, dec_n(val));
+    uint8_t val = mmu_read_byte(gb, cpu->reg.hl);
+    mmu_write_byte(gb, cpu->reg.hl, dec_n(cpu, val));
 }
 
 /* 0x36: Load 8-bit immediate into address pointed by HL. */
-void ld_hlp_n(uint8_t val)
+static void ld_hlp_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    mmu_write_byte(CPU.reg.hl, val);
+    mmu_write_byte(gb, cpu->reg.hl, val);
 }
 
 /* 0x37: Set carry flag. */
-void scf(void)
+static void scf(gb_t *gb, cpu_t *cpu)
 {
     FLAG_SET(FLAG_C);
     FLAG_CLEAR(FLAG_N | FLAG_H);
 }
 
 /* 0x38: Jump if C flag is set. */
-void jr_c_n(uint8_t val)
+static void jr_c_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     if (FLAG_IS_SET(FLAG_C)) {
-        reg16_inc(&CPU.reg.pc, (int8_t)val);
+        uint16_t end = cpu->reg.pc;
+        reg16_inc(gb, &cpu->reg.pc, (int8_t)val);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0x39: Add 16-bit SP to HL. */
-void add_hl_sp(void)
+static void add_hl_sp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.hl = add16(CPU.reg.hl, CPU.reg.sp);
+    cpu->reg.hl = add16(gb, cpu, cpu->reg.hl, cpu->reg.sp);
 }
 
 /* 0x3a: Put value at address HL into A and decrement HL. */
-void ldd_a_hlp(void)
+static void ldd_a_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = mmu_read_byte(CPU.reg.hl--);
+    cpu->reg.a = mmu_read_byte(gb, cpu->reg.hl--);
 }
 
 /* 0x3b: Decrement SP. */
-void dec_sp(void)
+static void dec_sp(gb_t *gb, cpu_t *cpu)
 {
-    reg16_inc(&CPU.reg.sp, -1);
+    reg16_inc(gb, &cpu->reg.sp, -1);
 }
 
 /* 0x3c: Increment A. */
-void inc_a(void)
+static void inc_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = inc_n(CPU.reg.a);
+    cpu->reg.a = inc_n(cpu, cpu->reg.a);
 }
 
 /* 0x3d: Decrement A. */
-void dec_a(void)
+static void dec_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = dec_n(CPU.reg.a);
+    cpu->reg.a = dec_n(cpu, cpu->reg.a);
 }
 
 /* 0x3e: Put value into A. */
-void ld_a_n(uint8_t val)
+static void ld_a_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.a = val;
+    cpu->reg.a = val;
 }
 
 /* 0x3f: Complement carry flag. */
-void ccf(void)
+static void ccf(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.f ^= FLAG_C;
+    FLAG_SET_CARRY(!FLAG_IS_SET(FLAG_C));
     FLAG_CLEAR(FLAG_N | FLAG_H);
 }
 
 /* 0x41: Copy C to B. */
-void ld_b_c(void)
+static void ld_b_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.c;
+    cpu->reg.b = cpu->reg.c;
 }
 
 /* 0x42: Copy D to B. */
-void ld_b_d(void)
+static void ld_b_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.d;
+    cpu->reg.b = cpu->reg.d;
 }
 
 /* 0x43: Copy E to B. */
-void ld_b_e(void)
+static void ld_b_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.e;
+    cpu->reg.b = cpu->reg.e;
 }
 
 /* 0x44: Copy H to B. */
-void ld_b_h(void)
+static void ld_b_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.h;
+    cpu->reg.b = cpu->reg.h;
 }
 
 /* 0x45: Copy L to B. */
-void ld_b_l(void)
+static void ld_b_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.l;
+    cpu->reg.b = cpu->reg.l;
 }
 
 /* 0x46: Copy value pointed by HL into B. */
-void ld_b_hlp(void)
+static void ld_b_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.b = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x47: Copy A to B. */
-void ld_b_a(void)
+static void ld_b_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.b = CPU.reg.a;
+    cpu->reg.b = cpu->reg.a;
 }
 
 /* 0x48: Copy B to C. */
-void ld_c_b(void)
+static void ld_c_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.b;
+    cpu->reg.c = cpu->reg.b;
 }
 
 /* 0x4a: Copy D to C. */
-void ld_c_d(void)
+static void ld_c_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.d;
+    cpu->reg.c = cpu->reg.d;
 }
 
 /* 0x4b: Copy E to C. */
-void ld_c_e(void)
+static void ld_c_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.e;
+    cpu->reg.c = cpu->reg.e;
 }
 
 /* 0x4c: Copy H to C. */
-void ld_c_h(void)
+static void ld_c_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.h;
+    cpu->reg.c = cpu->reg.h;
 }
 
 /* 0x4d: Copy L to C. */
-void ld_c_l(void)
+static void ld_c_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.l;
+    cpu->reg.c = cpu->reg.l;
 }
 
 /* 0x4e: Copy value pointed by HL into C. */
-void ld_c_hlp(void)
+static void ld_c_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.c = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x4f: Copy A to C. */
-void ld_c_a(void)
+static void ld_c_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.c = CPU.reg.a;
+    cpu->reg.c = cpu->reg.a;
 }
 
 /* 0x50: Copy B to D. */
-void ld_d_b(void)
+static void ld_d_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.b;
+    cpu->reg.d = cpu->reg.b;
 }
 
 /* 0x51: Copy C to D. */
-void ld_d_c(void)
+static void ld_d_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.c;
+    cpu->reg.d = cpu->reg.c;
 }
 
 /* 0x53: Copy E to D. */
-void ld_d_e(void)
+static void ld_d_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.e;
+    cpu->reg.d = cpu->reg.e;
 }
 
 /* 0x54: Copy H to D. */
-void ld_d_h(void)
+static void ld_d_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.h;
+    cpu->reg.d = cpu->reg.h;
 }
 
 /* 0x55: Copy L to D. */
-void ld_d_l(void)
+static void ld_d_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.l;
+    cpu->reg.d = cpu->reg.l;
 }
 
 /* 0x56: Copy value pointed by HL into D. */
-void ld_d_hlp(void)
+static void ld_d_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.d = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x57: Copy A to D. */
-void ld_d_a(void)
+static void ld_d_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.d = CPU.reg.a;
+    cpu->reg.d = cpu->reg.a;
 }
 
 /* 0x58: Copy B to E. */
-void ld_e_b(void)
+static void ld_e_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.b;
+    cpu->reg.e = cpu->reg.b;
 }
 
 /* 0x59: Copy C to E. */
-void ld_e_c(void)
+static void ld_e_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.c;
+    cpu->reg.e = cpu->reg.c;
 }
 
 /* 0x5a: Copy D to E. */
-void ld_e_d(void)
+static void ld_e_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.d;
+    cpu->reg.e = cpu->reg.d;
 }
 
 /* 0x5c: Copy H to E. */
-void ld_e_h(void)
+static void ld_e_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.h;
+    cpu->reg.e = cpu->reg.h;
 }
 
 /* 0x5d: Copy L to E. */
-void ld_e_l(void)
+static void ld_e_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.l;
+    cpu->reg.e = cpu->reg.l;
 }
 
 /* 0x5e: Copy value pointed by HL into E. */
-void ld_e_hlp(void)
+static void ld_e_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.e = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x5f: Copy A to E. */
-void ld_e_a(void)
+static void ld_e_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.e = CPU.reg.a;
+    cpu->reg.e = cpu->reg.a;
 }
 
 /* 0x60: Copy B to H. */
-void ld_h_b(void)
+static void ld_h_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.b;
+    cpu->reg.h = cpu->reg.b;
 }
 
 /* 0x61: Copy C to H. */
-void ld_h_c(void)
+static void ld_h_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.c;
+    cpu->reg.h = cpu->reg.c;
 }
 
 /* 0x62: Copy D to H. */
-void ld_h_d(void)
+static void ld_h_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.d;
+    cpu->reg.h = cpu->reg.d;
 }
 
 /* 0x63: Copy E to H. */
-void ld_h_e(void)
+static void ld_h_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.e;
+    cpu->reg.h = cpu->reg.e;
 }
 
 /* 0x65: Copy L to H. */
-void ld_h_l(void)
+static void ld_h_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.l;
+    cpu->reg.h = cpu->reg.l;
 }
 
 /* 0x66: Copy value pointed by HL into H. */
-void ld_h_hlp(void)
+static void ld_h_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.h = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x67: Copy A to H. */
-void ld_h_a(void)
+static void ld_h_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.h = CPU.reg.a;
+    cpu->reg.h = cpu->reg.a;
 }
 
 /* 0x68: Copy B to L. */
-void ld_l_b(void)
+static void ld_l_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.b;
+    cpu->reg.l = cpu->reg.b;
 }
 
 /* 0x69: Copy C to L. */
-void ld_l_c(void)
+static void ld_l_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.c;
+    cpu->reg.l = cpu->reg.c;
 }
 
 /* 0x6a: Copy D to L. */
-void ld_l_d(void)
+static void ld_l_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.d;
+    cpu->reg.l = cpu->reg.d;
 }
 
 /* 0x6b: Copy E to L. */
-void ld_l_e(void)
+static void ld_l_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.e;
+    cpu->reg.l = cpu->reg.e;
 }
 
 /* 0x6c: Copy H to L. */
-void ld_l_h(void)
+static void ld_l_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.h;
+    cpu->reg.l = cpu->reg.h;
 }
 
 /* 0x6e: Copy value pointed by HL into L. */
-void ld_l_hlp(void)
+static void ld_l_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.l = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x6f: Copy A to L. */
-void ld_l_a(void)
+static void ld_l_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.l = CPU.reg.a;
+    cpu->reg.l = cpu->reg.a;
 }
 
 /* 0x70: Save B to address pointed by HL. */
-void ld_hlp_b(void)
+static void ld_hlp_b(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.b);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.b);
 }
 
 /* 0x71: Save C to address pointed by HL. */
-void ld_hlp_c(void)
+static void ld_hlp_c(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.c);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.c);
 }
 
 /* 0x72: Save D to address pointed by HL. */
-void ld_hlp_d(void)
+static void ld_hlp_d(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.d);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.d);
 }
 
 /* 0x73: Save E to address pointed by HL. */
-void ld_hlp_e(void)
+static void ld_hlp_e(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.e);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.e);
 }
 
 /* 0x74: Save H to address pointed by HL. */
-void ld_hlp_h(void)
+static void ld_hlp_h(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.h);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.h);
 }
 
 /* 0x75: Save L to address pointed by HL. */
-void ld_hlp_l(void)
+static void ld_hlp_l(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.l);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.l);
 }
 
 /* 0x76: Power down CPU until an interrupt occurs. */
-void halt(void)
+static void halt(gb_t *gb, cpu_t *cpu)
 {
-    if (CPU.halt) {
-        cpu_halted();
+    /* PC stays on HALT, see cpu_fetch_next(). */
+    cpu->halt = true;
+    cpu->reg.pc--;
+    if (interrupt_get_enable(gb) & interrupt_get_flag(gb) & 0x1f) {
+        cpu->halt_bug = true;
     } else {
-        /* HALT instruction will be executed repeatedly. */
-        CPU.halt = true;
-        CPU.reg.pc--;
-        if (interrupt_get_enable() & interrupt_get_flag() & 0x1f) {
-            CPU.halt_bug = true;
-        } else {
-            CPU.halt_bug = false;
-        }
+        cpu->halt_bug = false;
     }
 }
 
 /* 0x77: Save A to address pointed by HL. */
-void ld_hlp_a(void)
+static void ld_hlp_a(gb_t *gb, cpu_t *cpu)
 {
-    mmu_write_byte(CPU.reg.hl, CPU.reg.a);
+    mmu_write_byte(gb, cpu->reg.hl, cpu->reg.a);
 }
 
 /* 0x78: Copy B to A. */
-void ld_a_b(void)
+static void ld_a_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.b;
+    cpu->reg.a = cpu->reg.b;
 }
 
 /* 0x79: Copy C to A. */
-void ld_a_c(void)
+static void ld_a_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.c;
+    cpu->reg.a = cpu->reg.c;
 }
 
 /* 0x7a: Copy D to A. */
-void ld_a_d(void)
+static void ld_a_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.d;
+    cpu->reg.a = cpu->reg.d;
 }
 
 /* 0x7b: Copy E to A. */
-void ld_a_e(void)
+static void ld_a_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.e;
+    cpu->reg.a = cpu->reg.e;
 }
 
 /* 0x7c: Copy H to A. */
-void ld_a_h(void)
+static void ld_a_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.h;
+    cpu->reg.a = cpu->reg.h;
 }
 
 /* 0x7d: Copy L to A. */
-void ld_a_l(void)
+static void ld_a_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = CPU.reg.l;
+    cpu->reg.a = cpu->reg.l;
 }
 
 /* 0x7e: Copy value pointed by HL into A. */
-void ld_a_hlp(void)
+static void ld_a_hlp(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = mmu_read_byte(CPU.reg.hl);
+    cpu->reg.a = mmu_read_byte(gb, cpu->reg.hl);
 }
 
 /* 0x80: Add B to A. */
-void add_a_b(void)
+static void add_a_b(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.b);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.b);
 }
 
 /* 0x81: Add C to A. */
-void add_a_c(void)
+static void add_a_c(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.c);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.c);
 }
 
 /* 0x82: Add D to A. */
-void add_a_d(void)
+static void add_a_d(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.d);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.d);
 }
 
 /* 0x83: Add E to A. */
-void add_a_e(void)
+static void add_a_e(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.e);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.e);
 }
 
 /* 0x84: Add H to A. */
-void add_a_h(void)
+static void add_a_h(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.h);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.h);
 }
 
 /* 0x85: Add L to A. */
-void add_a_l(void)
+static void add_a_l(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.l);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.l);
 }
 
 /* 0x86: Add value pointed by HL to A. */
-void add_a_hlp(void)
+static void add_a_hlp(gb_t *gb, cpu_t *cpu)
 {
-    uint8_t val = mmu_read_byte(CPU.reg.hl);
-    CPU.reg.a = add8(CPU.reg.a, val);
+    uint8_t val = mmu_read_byte(gb, cpu->reg.hl);
+    cpu->reg.a = add8(cpu, cpu->reg.a, val);
 }
 
 /* 0x87: Add A to A. */
-void add_a_a(void)
+static void add_a_a(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.a = add8(CPU.reg.a, CPU.reg.a);
+    cpu->reg.a = add8(cpu, cpu->reg.a, cpu->reg.a);
 }
 
 /* 0x88: Add B and carry flag to A. */
-void adc_b(void)
+static void adc_b(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.b);
+    adc(cpu, cpu->reg.b);
 }
 
 /* 0x89: Add C and carry flag to A. */
-void adc_c(void)
+static void adc_c(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.c);
+    adc(cpu, cpu->reg.c);
 }
 
 /* 0x8a: Add D and carry flag to A. */
-void adc_d(void)
+static void adc_d(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.d);
+    adc(cpu, cpu->reg.d);
 }
 
 /* 0x8b: Add E and carry flag to A. */
-void adc_e(void)
+static void adc_e(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.e);
+    adc(cpu, cpu->reg.e);
 }
 
 /* 0x8c: Add H and carry flag to A. */
-void adc_h(void)
+static void adc_h(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.h);
+    adc(cpu, cpu->reg.h);
 }
 
 /* 0x8d: Add L and carry flag to A. */
-void adc_l(void)
+static void adc_l(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.l);
+    adc(cpu, cpu->reg.l);
 }
 
 /* 0x8e: Add (HL) and carry flag to A. */
-void adc_hlp(void)
+static void adc_hlp(gb_t *gb, cpu_t *cpu)
 {
-    adc(mmu_read_byte(CPU.reg.hl));
+    adc(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0x8f: Add A and carry flag to A. */
-void adc_a(void)
+static void adc_a(gb_t *gb, cpu_t *cpu)
 {
-    adc(CPU.reg.a);
+    adc(cpu, cpu->reg.a);
 }
 
 /* 0x90: Subtract B from A. */
-void sub_b(void)
+static void sub_b(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.b);
+    sub(cpu, cpu->reg.b);
 }
 
 /* 0x91: Subtract C from A. */
-void sub_c(void)
+static void sub_c(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.c);
+    sub(cpu, cpu->reg.c);
 }
 
 /* 0x92: Subtract D from A. */
-void sub_d(void)
+static void sub_d(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.d);
+    sub(cpu, cpu->reg.d);
 }
 
 /* 0x93: Subtract E from A. */
-void sub_e(void)
+static void sub_e(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.e);
+    sub(cpu, cpu->reg.e);
 }
 
 /* 0x94: Subtract H from A. */
-void sub_h(void)
+static void sub_h(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.h);
+    sub(cpu, cpu->reg.h);
 }
 
 /* 0x95: Subtract L from A. */
-void sub_l(void)
+static void sub_l(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.l);
+    sub(cpu, cpu->reg.l);
 }
 
 /* 0x96: Subtract (HL) from A. */
-void sub_hlp(void)
+static void sub_hlp(gb_t *gb, cpu_t *cpu)
 {
-    sub(mmu_read_byte(CPU.reg.hl));
+    sub(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0x97: Subtract A from A. */
-void sub_a(void)
+static void sub_a(gb_t *gb, cpu_t *cpu)
 {
-    sub(CPU.reg.a);
+    sub(cpu, cpu->reg.a);
 }
 
 /* 0x98: Subtract B and carry flag from A. */
-void sbc_b(void)
+static void sbc_b(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.b);
+    sbc(cpu, cpu->reg.b);
 }
 
 /* 0x99: Subtract C and carry flag from A. */
-void sbc_c(void)
+static void sbc_c(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.c);
+    sbc(cpu, cpu->reg.c);
 }
 
 /* 0x9a: Subtract D and carry flag from A. */
-void sbc_d(void)
+static void sbc_d(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.d);
+    sbc(cpu, cpu->reg.d);
 }
 
 /* 0x9b: Subtract E and carry flag from A. */
-void sbc_e(void)
+static void sbc_e(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.e);
+    sbc(cpu, cpu->reg.e);
 }
 
 /* 0x9c: Subtract H and carry flag from A. */
-void sbc_h(void)
+static void sbc_h(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.h);
+    sbc(cpu, cpu->reg.h);
 }
 
 /* 0x9d: Subtract L and carry flag from A. */
-void sbc_l(void)
+static void sbc_l(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.l);
+    sbc(cpu, cpu->reg.l);
 }
 
 /* 0x9e: Subtract (HL) and carry flag from A. */
-void sbc_hlp(void)
+static void sbc_hlp(gb_t *gb, cpu_t *cpu)
 {
-    sbc(mmu_read_byte(CPU.reg.hl));
+    sbc(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0x9f: Subtract A and carry flag from A. */
-void sbc_a(void)
+static void sbc_a(gb_t *gb, cpu_t *cpu)
 {
-    sbc(CPU.reg.a);
+    sbc(cpu, cpu->reg.a);
 }
 
 /* 0xa0: Bitwise AND B against A. */
-void and_b(void)
+static void and_b(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.b);
+    and8(cpu, cpu->reg.b);
 }
 
 /* 0xa1: Bitwise AND C against A. */
-void and_c(void)
+static void and_c(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.c);
+    and8(cpu, cpu->reg.c);
 }
 
 /* 0xa2: Bitwise AND D against A. */
-void and_d(void)
+static void and_d(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.d);
+    and8(cpu, cpu->reg.d);
 }
 
 /* 0xa3: Bitwise AND E against A. */
-void and_e(void)
+static void and_e(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.e);
+    and8(cpu, cpu->reg.e);
 }
 
 /* 0xa4: Bitwise AND H against A. */
-void and_h(void)
+static void and_h(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.h);
+    and8(cpu, cpu->reg.h);
 }
 
 /* 0xa5: Bitwise AND L against A. */
-void and_l(void)
+static void and_l(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.l);
+    and8(cpu, cpu->reg.l);
 }
 
 /* 0xa6: Bitwise AND (HL) against A. */
-void and_hlp(void)
+static void and_hlp(gb_t *gb, cpu_t *cpu)
 {
-    and8(mmu_read_byte(CPU.reg.hl));
+    and8(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0xa7: Bitwise AND A against A. */
-void and_a(void)
+static void and_a(gb_t *gb, cpu_t *cpu)
 {
-    and8(CPU.reg.a);
+    and8(cpu, cpu->reg.a);
 }
 
 /* 0xa8: Bitwise XOR B against A. */
-void xor_b(void)
+static void xor_b(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.b);
+    xor8(cpu, cpu->reg.b);
 }
 
 /* 0xa9: Bitwise XOR C against A. */
-void xor_c(void)
+static void xor_c(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.c);
+    xor8(cpu, cpu->reg.c);
 }
 
 /* 0xaa: Bitwise XOR D against A. */
-void xor_d(void)
+static void xor_d(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.d);
+    xor8(cpu, cpu->reg.d);
 }
 
 /* 0xab: Bitwise XOR E against A. */
-void xor_e(void)
+static void xor_e(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.e);
+    xor8(cpu, cpu->reg.e);
 }
 
 /* 0xac: Bitwise XOR H against A. */
-void xor_h(void)
+static void xor_h(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.h);
+    xor8(cpu, cpu->reg.h);
 }
 
 /* 0xad: Bitwise XOR L against A. */
-void xor_l(void)
+static void xor_l(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.l);
+    xor8(cpu, cpu->reg.l);
 }
 
 /* 0xae: Bitwise XOR (HL) against A. */
-void xor_hlp(void)
+static void xor_hlp(gb_t *gb, cpu_t *cpu)
 {
-    xor8(mmu_read_byte(CPU.reg.hl));
+    xor8(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0xaf: Bitwise XOR A against A. */
-void xor_a(void)
+static void xor_a(gb_t *gb, cpu_t *cpu)
 {
-    xor8(CPU.reg.a);
+    xor8(cpu, cpu->reg.a);
 }
 
 /* 0xb0: Bitwise OR B against A. */
-void or_b(void)
+static void or_b(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.b);
+    or8(cpu, cpu->reg.b);
 }
 
 /* 0xb1: Bitwise OR C against A. */
-void or_c(void)
+static void or_c(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.c);
+    or8(cpu, cpu->reg.c);
 }
 
 /* 0xb2: Bitwise OR D against A. */
-void or_d(void)
+static void or_d(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.d);
+    or8(cpu, cpu->reg.d);
 }
 
 /* 0xb3: Bitwise OR E against A. */
-void or_e(void)
+static void or_e(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.e);
+    or8(cpu, cpu->reg.e);
 }
 
 /* 0xb4: Bitwise OR H against A. */
-void or_h(void)
+static void or_h(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.h);
+    or8(cpu, cpu->reg.h);
 }
 
 /* 0xb5: Bitwise OR L against A. */
-void or_l(void)
+static void or_l(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.l);
+    or8(cpu, cpu->reg.l);
 }
 
 /* 0xb6: Bitwise OR (HL) against A. */
-void or_hlp(void)
+static void or_hlp(gb_t *gb, cpu_t *cpu)
 {
-    or8(mmu_read_byte(CPU.reg.hl));
+    or8(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0xb7: Bitwise OR A against A. */
-void or_a(void)
+static void or_a(gb_t *gb, cpu_t *cpu)
 {
-    or8(CPU.reg.a);
+    or8(cpu, cpu->reg.a);
 }
 
 /* 0xb8: Compare A with B. */
-void cp_b(void)
+static void cp_b(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.b);
+    cp(cpu, cpu->reg.b);
 }
 
 /* 0xb9: Compare A with C. */
-void cp_c(void)
+static void cp_c(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.c);
+    cp(cpu, cpu->reg.c);
 }
 
 /* 0xba: Compare A with D. */
-void cp_d(void)
+static void cp_d(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.d);
+    cp(cpu, cpu->reg.d);
 }
 
 /* 0xbb: Compare A with E. */
-void cp_e(void)
+static void cp_e(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.e);
+    cp(cpu, cpu->reg.e);
 }
 
 /* 0xbc: Compare A with H. */
-void cp_h(void)
+static void cp_h(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.h);
+    cp(cpu, cpu->reg.h);
 }
 
 /* 0xbd: Compare A with L. */
-void cp_l(void)
+static void cp_l(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.l);
+    cp(cpu, cpu->reg.l);
 }
 
 /* 0xbe: Compare A with (HL). */
-void cp_hlp(void)
+static void cp_hlp(gb_t *gb, cpu_t *cpu)
 {
-    cp(mmu_read_byte(CPU.reg.hl));
+    cp(cpu, mmu_read_byte(gb, cpu->reg.hl));
 }
 
 /* 0xbf: Compare A with A. */
-void cp_a(void)
+static void cp_a(gb_t *gb, cpu_t *cpu)
 {
-    cp(CPU.reg.a);
+    cp(cpu, cpu->reg.a);
 }
 
 /* 0xc0: Return if Z flag is not set. */
-void ret_nz(void)
+static void ret_nz(gb_t *gb, cpu_t *cpu)
 {
     if (!FLAG_IS_SET(FLAG_Z)) {
-        reg16_set(&CPU.reg.pc, pop());
+        reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
     }
-    clock_step(4);
+    clock_step(gb, 4);
 }
 
 /* 0xc1: Pop two bytes off stack into register pair nn. */
-void pop_bc(void)
+static void pop_bc(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.bc = pop();
+    cpu->reg.bc = stack_pop(gb, cpu);
 }
 
 /* 0xc2: Jump to address. */
-void jp_nz_nn(uint16_t addr)
+static void jp_nz_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (!FLAG_IS_SET(FLAG_Z)) {
-        reg16_set(&CPU.reg.pc, addr);
+        uint16_t end = cpu->reg.pc;
+        reg16_set(gb, &cpu->reg.pc, addr);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0xc3: Jump to address. */
-void jp_nn(uint16_t addr)
+static void jp_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
-    reg16_set(&CPU.reg.pc, addr);
+    uint16_t end = cpu->reg.pc;
+    reg16_set(gb, &cpu->reg.pc, addr);
+    jump_back(gb, cpu, end);
 }
 
 /* 0xc4: Push PC to stack and Jump to address. */
-void call_nz_nn(uint16_t addr)
+static void call_nz_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (!FLAG_IS_SET(FLAG_Z)) {
-        push(CPU.reg.pc);
-        CPU.reg.pc = addr;
+        stack_push(gb, cpu, cpu->reg.pc);
+        cpu->reg.pc = addr;
     }
 }
 
 /* 0xc5: Push BC to stack. */
-void push_bc(void)
+static void push_bc(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.bc);
+    stack_push(gb, cpu, cpu->reg.bc);
 }
 
 /* 0xc6: Add 8-bit immediate to A. */
-void add_a_n(uint8_t val)
+static void add_a_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    CPU.reg.a = add8(CPU.reg.a, val);
+    cpu->reg.a = add8(cpu, cpu->reg.a, val);
 }
 
 /* 0xc7: Call routine at address 0x0000. */
-void rst_00(void)
+static void rst_00(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0000;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0000;
 }
 
 /* 0xc8: Return if Z flag is set. */
-void ret_z(void)
+static void ret_z(gb_t *gb, cpu_t *cpu)
 {
     if (FLAG_IS_SET(FLAG_Z)) {
-        reg16_set(&CPU.reg.pc, pop());
+        reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
     }
-    clock_step(4);
+    clock_step(gb, 4);
 }
 
 /* 0xc9: Return if Z flag is set. */
-void ret(void)
+static void ret(gb_t *gb, cpu_t *cpu)
 {
-    reg16_set(&CPU.reg.pc, pop());
+    reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
 }
 
 /* 0xca: Jump to address. */
-void jp_z_nn(uint16_t addr)
+static void jp_z_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (FLAG_IS_SET(FLAG_Z)) {
-        reg16_set(&CPU.reg.pc, addr);
+        uint16_t end = cpu->reg.pc;
+        reg16_set(gb, &cpu->reg.pc, addr);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0xcc: Push PC to stack and Jump to address. */
-void call_z_nn(uint16_t addr)
+static void call_z_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (FLAG_IS_SET(FLAG_Z)) {
-        push(CPU.reg.pc);
-        CPU.reg.pc = addr;
+        stack_push(gb, cpu, cpu->reg.pc);
+        cpu->reg.pc = addr;
     }
 }
 
 /* 0xcd: Push PC to stack and Jump to address. */
-void call_nn(uint16_t addr)
+static void call_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = addr;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = addr;
 }
 
 /* 0xce: Add immediate 8-bit value and carry flag to A. */
-void adc_n(uint8_t n)
+static void adc_n(gb_t *gb, cpu_t *cpu, uint8_t n)
 {
-    adc(n);
+    adc(cpu, n);
 }
 
 /* 0xcf: Call routine at address 0x0008. */
-void rst_08(void)
+static void rst_08(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0008;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0008;
 }
 
 /* 0xd0: Return if C flag is not set. */
-void ret_nc(void)
+static void ret_nc(gb_t *gb, cpu_t *cpu)
 {
     if (!FLAG_IS_SET(FLAG_C)) {
-        reg16_set(&CPU.reg.pc, pop());
+        reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
     }
-    clock_step(4);
+    clock_step(gb, 4);
 }
 
 /* 0xd1: Pop two bytes off stack into register pair nn. */
-void pop_de(void)
+static void pop_de(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.de = pop();
+    cpu->reg.de = stack_pop(gb, cpu);
 }
 
 /* 0xd2: Jump to address. */
-void jp_nc_nn(uint16_t addr)
+static void jp_nc_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (!FLAG_IS_SET(FLAG_C)) {
-        reg16_set(&CPU.reg.pc, addr);
+        uint16_t end = cpu->reg.pc;
+        reg16_set(gb, &cpu->reg.pc, addr);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0xd4: Push PC to stack and Jump to address. */
-void call_nc_nn(uint16_t addr)
+static void call_nc_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (!FLAG_IS_SET(FLAG_C)) {
-        push(CPU.reg.pc);
-        CPU.reg.pc = addr;
+        stack_push(gb, cpu, cpu->reg.pc);
+        cpu->reg.pc = addr;
     }
 }
 
 /* 0xd5: Push DE to stack. */
-void push_de(void)
+static void push_de(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.de);
+    stack_push(gb, cpu, cpu->reg.de);
 }
 
 /* 0xd6: Subtract n from A. */
-void sub_n(uint8_t val)
+static void sub_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    sub(val);
+    sub(cpu, val);
 }
 
 /* 0xd7: Call routine at address 0x0010. */
-void rst_10(void)
+static void rst_10(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0010;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0010;
 }
 
 /* 0xd8: Return if C flag is set. */
-void ret_c(void)
+static void ret_c(gb_t *gb, cpu_t *cpu)
 {
     if (FLAG_IS_SET(FLAG_C)) {
-        reg16_set(&CPU.reg.pc, pop());
+        reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
     }
-    clock_step(4);
+    clock_step(gb, 4);
 }
 
 /* 0xd9: Pop two bytes from stack, jump to that address then enable interrupts.
  */
-void reti(void)
+static void reti(gb_t *gb, cpu_t *cpu)
 {
-    reg16_set(&CPU.reg.pc, pop());
-    interrupt_set_master(true);
+    reg16_set(gb, &cpu->reg.pc, stack_pop(gb, cpu));
+    interrupt_set_master(gb, true);
 }
 
 /* 0xda: Jump to address. */
-void jp_c_nn(uint16_t addr)
+static void jp_c_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (FLAG_IS_SET(FLAG_C)) {
-        reg16_set(&CPU.reg.pc, addr);
+        uint16_t end = cpu->reg.pc;
+        reg16_set(gb, &cpu->reg.pc, addr);
+        jump_back(gb, cpu, end);
     }
 }
 
 /* 0xdc: Push PC to stack and Jump to address. */
-void call_c_nn(uint16_t addr)
+static void call_c_nn(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
     if (FLAG_IS_SET(FLAG_C)) {
-        push(CPU.reg.pc);
-        CPU.reg.pc = addr;
+        stack_push(gb, cpu, cpu->reg.pc);
+        cpu->reg.pc = addr;
     }
 }
 
 /* 0xde: Subtract n and carry flag from A. */
-void sbc_n(uint8_t val)
+static void sbc_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    sbc(val);
+    sbc(cpu, val);
 }
 
 /* 0xdf: Call routine at address 0x0018. */
-void rst_18(void)
+static void rst_18(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0018;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0018;
 }
 
 /* 0xe0: Put A into memory address $FF00+n. */
-void ldh_n_a(uint8_t val)
+static void ldh_n_a(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     uint16_t addr = (uint16_t)(0xff00 + val);
-    mmu_write_byte(addr, CPU.reg.a);
+    mmu_write_byte(gb, addr, cpu->reg.a);
 }
 
 /* 0xe1: Pop two bytes off stack into register pair nn. */
-void pop_hl(void)
+static void pop_hl(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.hl = pop();
+    cpu->reg.hl = stack_pop(gb, cpu);
 }
 
 /* 0xe2: Put A into address $FF00 + register C. */
-void ld_cp_a(void)
+static void ld_cp_a(gb_t *gb, cpu_t *cpu)
 {
-    uint16_t addr = (uint16_t)(0xff00 + CPU.reg.c);
-    mmu_write_byte(addr, CPU.reg.a);
+    uint16_t addr = (uint16_t)(0xff00 + cpu->reg.c);
+    mmu_write_byte(gb, addr, cpu->reg.a);
 }
 
 /* 0xe5: Push HL to stack. */
-void push_hl(void)
+static void push_hl(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.hl);
+    stack_push(gb, cpu, cpu->reg.hl);
 }
 
 /* 0xe6: Bitwise AND n against A. */
-void and_n(uint8_t val)
+static void and_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    and8(val);
+    and8(cpu, val);
 }
 
 /* 0xe7: Call routine at address 0x0020. */
-void rst_20(void)
+static void rst_20(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0020;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0020;
 }
 
 /* 0xe8: Add n to Stack Pointer (SP). */
-void add_sp_n(uint8_t val)
+static void add_sp_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    if (((CPU.reg.sp & 0xff) + (val & 0xff)) > 0xff) {
+    if (((cpu->reg.sp & 0xff) + (val & 0xff)) > 0xff) {
         FLAG_SET(FLAG_C);
     } else {
         FLAG_CLEAR(FLAG_C);
     }
-    if (((CPU.reg.sp & 0x0f) + (val & 0x0f)) > 0x0f) {
+    if (((cpu->reg.sp & 0x0f) + (val & 0x0f)) > 0x0f) {
         FLAG_SET(FLAG_H);
     } else {
         FLAG_CLEAR(FLAG_H);
     }
     FLAG_CLEAR(FLAG_Z | FLAG_N);
-    CPU.reg.sp = (uint16_t)(CPU.reg.sp + (int8_t)val);
-    clock_step(8);
+    cpu->reg.sp = (uint16_t)(cpu->reg.sp + (int8_t)val);
+    clock_step(gb, 8);
 }
 
 /* 0xe9: Jump to address. */
-void jp_hl(void)
+static void jp_hl(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.pc = CPU.reg.hl;
+    cpu->reg.pc = cpu->reg.hl;
 }
 
 /* 0xea: Save A at given 16-bit address. */
-void ld_nnp_a(uint16_t addr)
+static void ld_nnp_a(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
-    mmu_write_byte(addr, CPU.reg.a);
+    mmu_write_byte(gb, addr, cpu->reg.a);
 }
 
 /* 0xee: Bitwise XOR n against A. */
-void xor_n(uint8_t val)
+static void xor_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    xor8(val);
+    xor8(cpu, val);
 }
 
 /* 0xef: Call routine at address 0x0028. */
-void rst_28(void)
+static void rst_28(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0028;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0028;
 }
 
 /* 0xf0: Put memory address $FF00+n into A. */
-void ldh_a_n(uint8_t val)
+static void ldh_a_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
     uint16_t addr = (uint16_t)(0xff00 + val);
-    CPU.reg.a = mmu_read_byte(addr);
+    cpu->reg.a = mmu_read_byte(gb, addr);
 }
 
 /* 0xf1: Pop two bytes off stack into register pair nn. */
-void pop_af(void)
+static void pop_af(gb_t *gb, cpu_t *cpu)
 {
-    CPU.reg.af = pop() & 0xfff0;
+    uint16_t af = stack_pop(gb, cpu);
+    cpu->reg.a = (uint8_t)(af >> 8);
+    cpu_set_f(cpu, (uint8_t)af);
 }
 
 /* 0xf2: Put value at address $FF00 + register C into A. */
-void ld_a_cp(void)
+static void ld_a_cp(gb_t *gb, cpu_t *cpu)
 {
-    uint16_t addr = (uint16_t)(0xff00 + CPU.reg.c);
-    CPU.reg.a = mmu_read_byte(addr);
+    uint16_t addr = (uint16_t)(0xff00 + cpu->reg.c);
+    cpu->reg.a = mmu_read_byte(gb, addr);
 }
 
 /* 0xf3: This instruction disables interrupts after the next instruction is
  * executed.
  */
-void di(void)
+static void di(gb_t *gb, cpu_t *cpu)
 {
-    interrupt_set_master(false);
+    interrupt_set_master(gb, false);
 }
 
 /* 0xf5: Push AF to stack. */
-void push_af(void)
+static void push_af(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.af);
+    stack_push(gb, cpu, (uint16_t)(cpu->reg.a << 8 | cpu_get_f(cpu)));
 }
 
 /* 0xf6: Bitwise OR n against A. */
-void or_n(uint8_t val)
+static void or_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    or8(val);
+    or8(cpu, val);
 }
 
 /* 0xf7: Call routine at address 0x0030. */
-void rst_30(void)
+static void rst_30(gb_t *gb, cpu_t *cpu)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0030;
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0030;
 }
 
 /* 0xf8: Put SP + n effective address into HL. */
-void ldhl_sp_n(uint8_t val)
+static void ldhl_sp_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    if (((CPU.reg.sp & 0xff) + (val & 0xff)) > 0xff) {
+    if (((cpu->reg.sp & 0xff) + (val & 0xff)) > 0xff) {
         FLAG_SET(FLAG_C);
     } else {
         FLAG_CLEAR(FLAG_C);
     }
-    if (((CPU.reg.sp & 0x0f) + (val & 0x0f)) > 0x0f) {
+    if (((cpu->reg.sp & 0x0f) + (val & 0x0f)) > 0x0f) {
         FLAG_SET(FLAG_H);
     } else {
         FLAG_CLEAR(FLAG_H);
     }
     FLAG_CLEAR(FLAG_Z | FLAG_N);
-    CPU.reg.hl = (uint16_t)(CPU.reg.sp + (int8_t)val);
-    clock_step(4);
+    cpu->reg.hl = (uint16_t)(cpu->reg.sp + (int8_t)val);
+    clock_step(gb, 4);
 }
 
 /* 0xf9: Put HL into Stack Pointer (SP). */
-void ld_sp_hl(void)
+static void ld_sp_hl(gb_t *gb, cpu_t *cpu)
 {
-    reg16_set(&CPU.reg.sp, CPU.reg.hl);
+    reg16_set(gb, &cpu->reg.sp, cpu->reg.hl);
 }
 
 /* 0xfa: Copy value pointed by addr into A. */
-void ld_a_nnp(uint16_t addr)
+static void ld_a_nnp(gb_t *gb, cpu_t *cpu, uint16_t addr)
 {
-    CPU.reg.a = mmu_read_byte(addr);
+    cpu->reg.a = mmu_read_byte(gb, addr);
 }
 
 /* 0xfb: This instruction enables interrupts after the next instruction is
  * executed.
  */
-void ei(void)
+static void ei(gb_t *gb, cpu_t *cpu)
 {
-    interrupt_set_master(true);
+    interrupt_set_master(gb, true);
 }
 
 /* 0xfe: Compare A with n. */
-void cp_n(uint8_t val)
+static void cp_n(gb_t *gb, cpu_t *cpu, uint8_t val)
 {
-    cp(val);
+    cp(cpu, val);
 }
 
 /* 0xff: Call routine at address 0x0038. */
-void rst_38(void)
+static void rst_38(gb_t *gb, cpu_t *cpu)
+{
+    stack_push(gb, cpu, cpu->reg.pc);
+    cpu->reg.pc = 0x0038;
+}
+
+/*************** Extended operations. ***************/
+
+/* 0x00: Rotate B with carry. */
+static void rlc_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = rlc(cpu, cpu->reg.b);
+}
+
+/* 0x01: Rotate C with carry. */
+static void rlc_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = rlc(cpu, cpu->reg.c);
+}
+
+/* 0x02: Rotate D with carry. */
+static void rlc_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = rlc(cpu, cpu->reg.d);
+}
+
+/* 0x03: Rotate E with carry. */
+static void rlc_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = rlc(cpu, cpu->reg.e);
+}
+
+/* 0x04: Rotate H with carry. */
+static void rlc_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = rlc(cpu, cpu->reg.h);
+}
+
+/* 0x05: Rotate L with carry. */
+static void rlc_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = rlc(cpu, cpu->reg.l);
+}
+
+/* 0x06: Rotate (HL) with carry. */
+static void rlc_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = rlc(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x07: Rotate A with carry. */
+static void rlc_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = rlc(cpu, cpu->reg.a);
+}
+
+/* 0x08: Rotate B with carry. */
+static void rrc_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = rrc(cpu, cpu->reg.b);
+}
+
+/* 0x09: Rotate C with carry. */
+static void rrc_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = rrc(cpu, cpu->reg.c);
+}
+
+/* 0x0a: Rotate D with carry. */
+static void rrc_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = rrc(cpu, cpu->reg.d);
+}
+
+/* 0x0b: Rotate E with carry. */
+static void rrc_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = rrc(cpu, cpu->reg.e);
+}
+
+/* 0x0c: Rotate H with carry. */
+static void rrc_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = rrc(cpu, cpu->reg.h);
+}
+
+/* 0x0d: Rotate L with carry. */
+static void rrc_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = rrc(cpu, cpu->reg.l);
+}
+
+/* 0x0e: Rotate (HL) with carry. */
+static void rrc_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = rrc(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x0f: Rotate A with carry. */
+static void rrc_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = rrc(cpu, cpu->reg.a);
+}
+
+/* 0x10: Rotate B left through Carry flag. */
+static void rl_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = rl(cpu, cpu->reg.b);
+}
+
+/* 0x11: Rotate C left through Carry flag. */
+static void rl_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = rl(cpu, cpu->reg.c);
+}
+
+/* 0x12: Rotate D left through Carry flag. */
+static void rl_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = rl(cpu, cpu->reg.d);
+}
+
+/* 0x13: Rotate E left through Carry flag. */
+static void rl_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = rl(cpu, cpu->reg.e);
+}
+
+/* 0x14: Rotate H left through Carry flag. */
+static void rl_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = rl(cpu, cpu->reg.h);
+}
+
+/* 0x15: Rotate L left through Carry flag. */
+static void rl_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = rl(cpu, cpu->reg.l);
+}
+
+/* 0x16: Rotate (HL) with carry. */
+static void rl_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = rl(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x17: Rotate A left through Carry flag. */
+static void rl_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = rl(cpu, cpu->reg.a);
+}
+
+/* 0x18: Rotate B right through carry flag. */
+static void rr_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = rr(cpu, cpu->reg.b);
+}
+
+/* 0x19: Rotate C right through carry flag. */
+static void rr_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = rr(cpu, cpu->reg.c);
+}
+
+/* 0x1a: Rotate D right through carry flag. */
+static void rr_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = rr(cpu, cpu->reg.d);
+}
+
+/* 0x1b: Rotate E right through carry flag. */
+static void rr_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = rr(cpu, cpu->reg.e);
+}
+
+/* 0x1c: Rotate H right through carry flag. */
+static void rr_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = rr(cpu, cpu->reg.h);
+}
+
+/* 0x1d: Rotate L right through carry flag. */
+static void rr_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = rr(cpu, cpu->reg.l);
+}
+
+/* 0x1e: Rotate (HL) right through carry flag. */
+static void rr_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = rr(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x1f: Rotate A right through carry flag. */
+static void rr_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = rr(cpu, cpu->reg.a);
+}
+
+/* 0x20: Shift B left into Carry flag. */
+static void sla_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = sla(cpu, cpu->reg.b);
+}
+
+/* 0x21: Shift C left into Carry flag. */
+static void sla_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = sla(cpu, cpu->reg.c);
+}
+
+/* 0x22: Shift D left into Carry flag. */
+static void sla_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = sla(cpu, cpu->reg.d);
+}
+
+/* 0x23: Shift E left into Carry flag. */
+static void sla_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = sla(cpu, cpu->reg.e);
+}
+
+/* 0x24: Shift H left into Carry flag. */
+static void sla_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = sla(cpu, cpu->reg.h);
+}
+
+/* 0x25: Shift L left into Carry flag. */
+static void sla_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = sla(cpu, cpu->reg.l);
+}
+
+/* 0x26: Shift (HL) with carry. */
+static void sla_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = sla(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x27: Shift A left into Carry flag. */
+static void sla_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = sla(cpu, cpu->reg.a);
+}
+
+/* 0x28: Shift B right into Carry flag. */
+static void sra_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = sra(cpu, cpu->reg.b);
+}
+
+/* 0x29: Shift C right into Carry flag. */
+static void sra_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = sra(cpu, cpu->reg.c);
+}
+
+/* 0x2a: Shift D right into Carry flag. */
+static void sra_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = sra(cpu, cpu->reg.d);
+}
+
+/* 0x2b: Shift E right into Carry flag. */
+static void sra_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = sra(cpu, cpu->reg.e);
+}
+
+/* 0x2c: Shift H right into Carry flag. */
+static void sra_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = sra(cpu, cpu->reg.h);
+}
+
+/* 0x2d: Shift L right into Carry flag. */
+static void sra_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = sra(cpu, cpu->reg.l);
+}
+
+/* 0x2e: Shift (HL) right into Carry flag. */
+static void sra_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = sra(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x2f: Shift A right into Carry flag. */
+static void sra_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = sra(cpu, cpu->reg.a);
+}
+
+/* 0x30: Swap upper & lower nibbles of n. */
+static void swap_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = swap(cpu, cpu->reg.b);
+}
+
+/* 0x31: Swap upper & lower nibbles of n. */
+static void swap_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = swap(cpu, cpu->reg.c);
+}
+
+/* 0x32: Swap upper & lower nibbles of n. */
+static void swap_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = swap(cpu, cpu->reg.d);
+}
+
+/* 0x33: Swap upper & lower nibbles of n. */
+static void swap_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = swap(cpu, cpu->reg.e);
+}
+
+/* 0x34: Swap upper & lower nibbles of n. */
+static void swap_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = swap(cpu, cpu->reg.h);
+}
+
+/* 0x35: Swap upper & lower nibbles of n. */
+static void swap_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = swap(cpu, cpu->reg.l);
+}
+
+/* 0x36: Swap upper & lower nibbles of n. */
+static void swap_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = swap(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x37: Swap upper & lower nibbles of n. */
+static void swap_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = swap(cpu, cpu->reg.a);
+}
+
+/* 0x38: Shift B right into Carry flag. */
+static void srl_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = srl(cpu, cpu->reg.b);
+}
+
+/* 0x39: Shift C right into Carry flag. */
+static void srl_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = srl(cpu, cpu->reg.c);
+}
+
+/* 0x3a: Shift D right into Carry flag. */
+static void srl_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = srl(cpu, cpu->reg.d);
+}
+
+/* 0x3b: Shift E right into Carry flag. */
+static void srl_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = srl(cpu, cpu->reg.e);
+}
+
+/* 0x3c: Shift H right into Carry flag. */
+static void srl_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = srl(cpu, cpu->reg.h);
+}
+
+/* 0x3d: Shift L right into Carry flag. */
+static void srl_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = srl(cpu, cpu->reg.l);
+}
+
+/* 0x3e: Shift (HL) right into Carry flag. */
+static void srl_hlp(gb_t *gb, cpu_t *cpu)
+{
+    uint8_t val = srl(cpu, mmu_read_byte(gb, cpu->reg.hl));
+    mmu_write_byte(gb, cpu->reg.hl, val);
+}
+
+/* 0x3f: Shift A right into Carry flag. */
+static void srl_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = srl(cpu, cpu->reg.a);
+}
+
+/* 0x40: Test bit in register. */
+static void bit_0_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.b);
+}
+
+/* 0x41: Test bit in register. */
+static void bit_0_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.c);
+}
+
+/* 0x42: Test bit in register. */
+static void bit_0_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.d);
+}
+
+/* 0x43: Test bit in register. */
+static void bit_0_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.e);
+}
+
+/* 0x44: Test bit in register. */
+static void bit_0_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.h);
+}
+
+/* 0x45: Test bit in register. */
+static void bit_0_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.l);
+}
+
+/* 0x46: Test bit in register. */
+static void bit_0_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x47: Test bit in register. */
+static void bit_0_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 0, cpu->reg.a);
+}
+
+/* 0x48: Test bit in register. */
+static void bit_1_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.b);
+}
+
+/* 0x49: Test bit in register. */
+static void bit_1_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.c);
+}
+
+/* 0x4a: Test bit in register. */
+static void bit_1_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.d);
+}
+
+/* 0x4b: Test bit in register. */
+static void bit_1_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.e);
+}
+
+/* 0x4c: Test bit in register. */
+static void bit_1_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.h);
+}
+
+/* 0x4d: Test bit in register. */
+static void bit_1_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.l);
+}
+
+/* 0x4e: Test bit in register. */
+static void bit_1_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x4f: Test bit in register. */
+static void bit_1_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 1, cpu->reg.a);
+}
+
+/* 0x50: Test bit in register. */
+static void bit_2_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.b);
+}
+
+/* 0x51: Test bit in register. */
+static void bit_2_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.c);
+}
+
+/* 0x52: Test bit in register. */
+static void bit_2_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.d);
+}
+
+/* 0x53: Test bit in register. */
+static void bit_2_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.e);
+}
+
+/* 0x54: Test bit in register. */
+static void bit_2_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.h);
+}
+
+/* 0x55: Test bit in register. */
+static void bit_2_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.l);
+}
+
+/* 0x56: Test bit in register. */
+static void bit_2_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x57: Test bit in register. */
+static void bit_2_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 2, cpu->reg.a);
+}
+
+/* 0x58: Test bit in register. */
+static void bit_3_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.b);
+}
+
+/* 0x59: Test bit in register. */
+static void bit_3_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.c);
+}
+
+/* 0x5a: Test bit in register. */
+static void bit_3_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.d);
+}
+
+/* 0x5b: Test bit in register. */
+static void bit_3_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.e);
+}
+
+/* 0x5c: Test bit in register. */
+static void bit_3_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.h);
+}
+
+/* 0x5d: Test bit in register. */
+static void bit_3_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.l);
+}
+
+/* 0x5e: Test bit in register. */
+static void bit_3_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x5f: Test bit in register. */
+static void bit_3_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 3, cpu->reg.a);
+}
+
+/* 0x60: Test bit in register. */
+static void bit_4_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.b);
+}
+
+/* 0x61: Test bit in register. */
+static void bit_4_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.c);
+}
+
+/* 0x62: Test bit in register. */
+static void bit_4_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.d);
+}
+
+/* 0x63: Test bit in register. */
+static void bit_4_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.e);
+}
+
+/* 0x64: Test bit in register. */
+static void bit_4_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.h);
+}
+
+/* 0x65: Test bit in register. */
+static void bit_4_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.l);
+}
+
+/* 0x66: Test bit in register. */
+static void bit_4_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x67: Test bit in register. */
+static void bit_4_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 4, cpu->reg.a);
+}
+
+/* 0x68: Test bit in register. */
+static void bit_5_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.b);
+}
+
+/* 0x69: Test bit in register. */
+static void bit_5_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.c);
+}
+
+/* 0x6a: Test bit in register. */
+static void bit_5_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.d);
+}
+
+/* 0x6b: Test bit in register. */
+static void bit_5_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.e);
+}
+
+/* 0x6c: Test bit in register. */
+static void bit_5_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.h);
+}
+
+/* 0x6d: Test bit in register. */
+static void bit_5_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.l);
+}
+
+/* 0x6e: Test bit in register. */
+static void bit_5_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x6f: Test bit in register. */
+static void bit_5_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 5, cpu->reg.a);
+}
+
+/* 0x70: Test bit in register. */
+static void bit_6_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.b);
+}
+
+/* 0x71: Test bit in register. */
+static void bit_6_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.c);
+}
+
+/* 0x72: Test bit in register. */
+static void bit_6_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.d);
+}
+
+/* 0x73: Test bit in register. */
+static void bit_6_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.e);
+}
+
+/* 0x74: Test bit in register. */
+static void bit_6_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.h);
+}
+
+/* 0x75: Test bit in register. */
+static void bit_6_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.l);
+}
+
+/* 0x76: Test bit in register. */
+static void bit_6_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x77: Test bit in register. */
+static void bit_6_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 6, cpu->reg.a);
+}
+
+/* 0x78: Test bit in register. */
+static void bit_7_b(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.b);
+}
+
+/* 0x79: Test bit in register. */
+static void bit_7_c(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.c);
+}
+
+/* 0x7a: Test bit in register. */
+static void bit_7_d(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.d);
+}
+
+/* 0x7b: Test bit in register. */
+static void bit_7_e(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.e);
+}
+
+/* 0x7c: Test bit in register. */
+static void bit_7_h(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.h);
+}
+
+/* 0x7d: Test bit in register. */
+static void bit_7_l(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.l);
+}
+
+/* 0x7e: Test bit in register. */
+static void bit_7_hlp(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, mmu_read_byte(gb, cpu->reg.hl));
+}
+
+/* 0x7f: Test bit in register. */
+static void bit_7_a(gb_t *gb, cpu_t *cpu)
+{
+    bit(cpu, 1 << 7, cpu->reg.a);
+}
+
+/* 0x80: Reset bit in register. */
+static void res_0_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 0, cpu->reg.b);
+}
+
+/* 0x81: Reset bit in register. */
+static void res_0_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 0, cpu->reg.c);
+}
+
+/* 0x82: Reset bit in register. */
+static void res_0_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 0, cpu->reg.d);
+}
+
+/* 0x83: Reset bit in register. */
+static void res_0_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 0, cpu->reg.e);
+}
+
+/* 0x84: Reset bit in register. */
+static void res_0_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 0, cpu->reg.h);
+}
+
+/* 0x85: Reset bit in register. */
+static void res_0_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 0, cpu->reg.l);
+}
+
+/* 0x86: Reset bit in register. */
+static void res_0_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 0, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0x87: Reset bit in register. */
+static void res_0_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 0, cpu->reg.a);
+}
+
+/* 0x88: Reset bit in register. */
+static void res_1_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 1, cpu->reg.b);
+}
+
+/* 0x89: Reset bit in register. */
+static void res_1_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 1, cpu->reg.c);
+}
+
+/* 0x8a: Reset bit in register. */
+static void res_1_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 1, cpu->reg.d);
+}
+
+/* 0x8b: Reset bit in register. */
+static void res_1_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 1, cpu->reg.e);
+}
+
+/* 0x8c: Reset bit in register. */
+static void res_1_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 1, cpu->reg.h);
+}
+
+/* 0x8d: Reset bit in register. */
+static void res_1_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 1, cpu->reg.l);
+}
+
+/* 0x8e: Reset bit in register. */
+static void res_1_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 1, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0x8f: Reset bit in register. */
+static void res_1_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 1, cpu->reg.a);
+}
+
+/* 0x90: Reset bit in register. */
+static void res_2_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 2, cpu->reg.b);
+}
+
+/* 0x91: Reset bit in register. */
+static void res_2_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 2, cpu->reg.c);
+}
+
+/* 0x92: Reset bit in register. */
+static void res_2_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 2, cpu->reg.d);
+}
+
+/* 0x93: Reset bit in register. */
+static void res_2_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 2, cpu->reg.e);
+}
+
+/* 0x94: Reset bit in register. */
+static void res_2_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 2, cpu->reg.h);
+}
+
+/* 0x95: Reset bit in register. */
+static void res_2_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 2, cpu->reg.l);
+}
+
+/* 0x96: Reset bit in register. */
+static void res_2_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 2, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0x97: Reset bit in register. */
+static void res_2_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 2, cpu->reg.a);
+}
+
+/* 0x98: Reset bit in register. */
+static void res_3_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 3, cpu->reg.b);
+}
+
+/* 0x99: Reset bit in register. */
+static void res_3_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 3, cpu->reg.c);
+}
+
+/* 0x9a: Reset bit in register. */
+static void res_3_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 3, cpu->reg.d);
+}
+
+/* 0x9b: Reset bit in register. */
+static void res_3_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 3, cpu->reg.e);
+}
+
+/* 0x9c: Reset bit in register. */
+static void res_3_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 3, cpu->reg.h);
+}
+
+/* 0x9d: Reset bit in register. */
+static void res_3_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 3, cpu->reg.l);
+}
+
+/* 0x9e: Reset bit in register. */
+static void res_3_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 3, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0x9f: Reset bit in register. */
+static void res_3_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 3, cpu->reg.a);
+}
+
+/* 0xa0: Reset bit in register. */
+static void res_4_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 4, cpu->reg.b);
+}
+
+/* 0xa1: Reset bit in register. */
+static void res_4_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 4, cpu->reg.c);
+}
+
+/* 0xa2: Reset bit in register. */
+static void res_4_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 4, cpu->reg.d);
+}
+
+/* 0xa3: Reset bit in register. */
+static void res_4_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 4, cpu->reg.e);
+}
+
+/* 0xa4: Reset bit in register. */
+static void res_4_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 4, cpu->reg.h);
+}
+
+/* 0xa5: Reset bit in register. */
+static void res_4_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 4, cpu->reg.l);
+}
+
+/* 0xa6: Reset bit in register. */
+static void res_4_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 4, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xa7: Reset bit in register. */
+static void res_4_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 4, cpu->reg.a);
+}
+
+/* 0xa8: Reset bit in register. */
+static void res_5_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 5, cpu->reg.b);
+}
+
+/* 0xa9: Reset bit in register. */
+static void res_5_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 5, cpu->reg.c);
+}
+
+/* 0xaa: Reset bit in register. */
+static void res_5_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 5, cpu->reg.d);
+}
+
+/* 0xab: Reset bit in register. */
+static void res_5_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 5, cpu->reg.e);
+}
+
+/* 0xac: Reset bit in register. */
+static void res_5_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 5, cpu->reg.h);
+}
+
+/* 0xad: Reset bit in register. */
+static void res_5_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 5, cpu->reg.l);
+}
+
+/* 0xae: Reset bit in register. */
+static void res_5_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 5, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xaf: Reset bit in register. */
+static void res_5_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 5, cpu->reg.a);
+}
+
+/* 0xb0: Reset bit in register. */
+static void res_6_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 6, cpu->reg.b);
+}
+
+/* 0xb1: Reset bit in register. */
+static void res_6_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 6, cpu->reg.c);
+}
+
+/* 0xb2: Reset bit in register. */
+static void res_6_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 6, cpu->reg.d);
+}
+
+/* 0xb3: Reset bit in register. */
+static void res_6_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 6, cpu->reg.e);
+}
+
+/* 0xb4: Reset bit in register. */
+static void res_6_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 6, cpu->reg.h);
+}
+
+/* 0xb5: Reset bit in register. */
+static void res_6_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 6, cpu->reg.l);
+}
+
+/* 0xb6: Reset bit in register. */
+static void res_6_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 6, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xb7: Reset bit in register. */
+static void res_6_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 6, cpu->reg.a);
+}
+
+/* 0xb8: Reset bit in register. */
+static void res_7_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = res(1 << 7, cpu->reg.b);
+}
+
+/* 0xb9: Reset bit in register. */
+static void res_7_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = res(1 << 7, cpu->reg.c);
+}
+
+/* 0xba: Reset bit in register. */
+static void res_7_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = res(1 << 7, cpu->reg.d);
+}
+
+/* 0xbb: Reset bit in register. */
+static void res_7_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = res(1 << 7, cpu->reg.e);
+}
+
+/* 0xbc: Reset bit in register. */
+static void res_7_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = res(1 << 7, cpu->reg.h);
+}
+
+/* 0xbd: Reset bit in register. */
+static void res_7_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = res(1 << 7, cpu->reg.l);
+}
+
+/* 0xbe: Reset bit in register. */
+static void res_7_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   res(1 << 7, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xbf: Reset bit in register. */
+static void res_7_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = res(1 << 7, cpu->reg.a);
+}
+
+/* 0xc0: Reset bit in register. */
+static void set_0_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 0, cpu->reg.b);
+}
+
+/* 0xc1: Reset bit in register. */
+static void set_0_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 0, cpu->reg.c);
+}
+
+/* 0xc2: Reset bit in register. */
+static void set_0_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 0, cpu->reg.d);
+}
+
+/* 0xc3: Reset bit in register. */
+static void set_0_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 0, cpu->reg.e);
+}
+
+/* 0xc4: Reset bit in register. */
+static void set_0_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 0, cpu->reg.h);
+}
+
+/* 0xc5: Reset bit in register. */
+static void set_0_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 0, cpu->reg.l);
+}
+
+/* 0xc6: Reset bit in register. */
+static void set_0_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 0, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xc7: Reset bit in register. */
+static void set_0_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 0, cpu->reg.a);
+}
+
+/* 0xc8: Reset bit in register. */
+static void set_1_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 1, cpu->reg.b);
+}
+
+/* 0xc9: Reset bit in register. */
+static void set_1_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 1, cpu->reg.c);
+}
+
+/* 0xca: Reset bit in register. */
+static void set_1_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 1, cpu->reg.d);
+}
+
+/* 0xcb: Reset bit in register. */
+static void set_1_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 1, cpu->reg.e);
+}
+
+/* 0xcc: Reset bit in register. */
+static void set_1_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 1, cpu->reg.h);
+}
+
+/* 0xcd: Reset bit in register. */
+static void set_1_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 1, cpu->reg.l);
+}
+
+/* 0xce: Reset bit in register. */
+static void set_1_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 1, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xcf: Reset bit in register. */
+static void set_1_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 1, cpu->reg.a);
+}
+
+/* 0xd0: Reset bit in register. */
+static void set_2_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 2, cpu->reg.b);
+}
+
+/* 0xd1: Reset bit in register. */
+static void set_2_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 2, cpu->reg.c);
+}
+
+/* 0xd2: Reset bit in register. */
+static void set_2_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 2, cpu->reg.d);
+}
+
+/* 0xd3: Reset bit in register. */
+static void set_2_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 2, cpu->reg.e);
+}
+
+/* 0xd4: Reset bit in register. */
+static void set_2_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 2, cpu->reg.h);
+}
+
+/* 0xd5: Reset bit in register. */
+static void set_2_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 2, cpu->reg.l);
+}
+
+/* 0xd6: Reset bit in register. */
+static void set_2_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 2, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xd7: Reset bit in register. */
+static void set_2_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 2, cpu->reg.a);
+}
+
+/* 0xd8: Reset bit in register. */
+static void set_3_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 3, cpu->reg.b);
+}
+
+/* 0xd9: Reset bit in register. */
+static void set_3_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 3, cpu->reg.c);
+}
+
+/* 0xda: Reset bit in register. */
+static void set_3_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 3, cpu->reg.d);
+}
+
+/* 0xdb: Reset bit in register. */
+static void set_3_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 3, cpu->reg.e);
+}
+
+/* 0xdc: Reset bit in register. */
+static void set_3_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 3, cpu->reg.h);
+}
+
+/* 0xdd: Reset bit in register. */
+static void set_3_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 3, cpu->reg.l);
+}
+
+/* 0xde: Reset bit in register. */
+static void set_3_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 3, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xdf: Reset bit in register. */
+static void set_3_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 3, cpu->reg.a);
+}
+
+/* 0xe0: Reset bit in register. */
+static void set_4_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 4, cpu->reg.b);
+}
+
+/* 0xe1: Reset bit in register. */
+static void set_4_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 4, cpu->reg.c);
+}
+
+/* 0xe2: Reset bit in register. */
+static void set_4_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 4, cpu->reg.d);
+}
+
+/* 0xe3: Reset bit in register. */
+static void set_4_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 4, cpu->reg.e);
+}
+
+/* 0xe4: Reset bit in register. */
+static void set_4_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 4, cpu->reg.h);
+}
+
+/* 0xe5: Reset bit in register. */
+static void set_4_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 4, cpu->reg.l);
+}
+
+/* 0xe6: Reset bit in register. */
+static void set_4_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 4, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xe7: Reset bit in register. */
+static void set_4_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 4, cpu->reg.a);
+}
+
+/* 0xe8: Reset bit in register. */
+static void set_5_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 5, cpu->reg.b);
+}
+
+/* 0xe9: Reset bit in register. */
+static void set_5_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 5, cpu->reg.c);
+}
+
+/* 0xea: Reset bit in register. */
+static void set_5_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 5, cpu->reg.d);
+}
+
+/* 0xeb: Reset bit in register. */
+static void set_5_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 5, cpu->reg.e);
+}
+
+/* 0xec: Reset bit in register. */
+static void set_5_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 5, cpu->reg.h);
+}
+
+/* 0xed: Reset bit in register. */
+static void set_5_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 5, cpu->reg.l);
+}
+
+/* 0xee: Reset bit in register. */
+static void set_5_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 5, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xef: Reset bit in register. */
+static void set_5_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 5, cpu->reg.a);
+}
+
+/* 0xf0: Reset bit in register. */
+static void set_6_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 6, cpu->reg.b);
+}
+
+/* 0xf1: Reset bit in register. */
+static void set_6_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 6, cpu->reg.c);
+}
+
+/* 0xf2: Reset bit in register. */
+static void set_6_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 6, cpu->reg.d);
+}
+
+/* 0xf3: Reset bit in register. */
+static void set_6_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 6, cpu->reg.e);
+}
+
+/* 0xf4: Reset bit in register. */
+static void set_6_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 6, cpu->reg.h);
+}
+
+/* 0xf5: Reset bit in register. */
+static void set_6_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 6, cpu->reg.l);
+}
+
+/* 0xf6: Reset bit in register. */
+static void set_6_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 6, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xf7: Reset bit in register. */
+static void set_6_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 6, cpu->reg.a);
+}
+
+/* 0xf8: Reset bit in register. */
+static void set_7_b(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.b = set(1 << 7, cpu->reg.b);
+}
+
+/* 0xf9: Reset bit in register. */
+static void set_7_c(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.c = set(1 << 7, cpu->reg.c);
+}
+
+/* 0xfa: Reset bit in register. */
+static void set_7_d(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.d = set(1 << 7, cpu->reg.d);
+}
+
+/* 0xfb: Reset bit in register. */
+static void set_7_e(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.e = set(1 << 7, cpu->reg.e);
+}
+
+/* 0xfc: Reset bit in register. */
+static void set_7_h(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.h = set(1 << 7, cpu->reg.h);
+}
+
+/* 0xfd: Reset bit in register. */
+static void set_7_l(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.l = set(1 << 7, cpu->reg.l);
+}
+
+/* 0xfe: Reset bit in register. */
+static void set_7_hlp(gb_t *gb, cpu_t *cpu)
+{
+    mmu_write_byte(gb, cpu->reg.hl,
+                   set(1 << 7, mmu_read_byte(gb, cpu->reg.hl)));
+}
+
+/* 0xff: Reset bit in register. */
+static void set_7_a(gb_t *gb, cpu_t *cpu)
+{
+    cpu->reg.a = set(1 << 7, cpu->reg.a);
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+/*************** Fetch and dispatch. ***************/
+
+#define OP_LENGTH 0x03 /* Instruction length in bytes. */
+#define OP_JUMP 0x04   /* May not fall through, so ends a basic block. */
+
+#define X(op, name, kind, jump, cycles, taken, flags, text) \
+    [op] = CPU_OP_LENGTH_##kind | (jump ? OP_JUMP : 0),
+static const uint8_t op_info[256] = {CPU_OPS(X)};
+#undef X
+
+/*
+ * A fetched instruction: opcode in bits 0-7, operand in bits 8-23 and, for
+ * decoded ROM, length in bits 24-31. The operand of 0xcb is the CB opcode.
+ */
+#define INSN_N8(insn) ((uint8_t)((insn) >> 8))
+#define INSN_N16(insn) ((uint16_t)((insn) >> 8))
+#define INSN_LENGTH(insn) ((insn) >> 24)
+/* Decoded ROM entry of an instruction that crosses the end of a bank. */
+#define INSN_UNCACHED 0xff000000u
+
+static inline uint8_t cpu_fetch_byte(gb_t *gb, cpu_t *cpu)
+{
+    return mmu_read_byte(gb, cpu->reg.pc++);
+}
+
+static inline uint16_t cpu_fetch_word(gb_t *gb, cpu_t *cpu)
+{
+    uint16_t word = mmu_read_word(gb, cpu->reg.pc);
+    cpu->reg.pc += 2;
+    return word;
+}
+
+/* Fetch the operand of opcode through the MMU. */
+static uint32_t cpu_fetch_operand(gb_t *gb, cpu_t *cpu, uint8_t opcode)
+{
+    switch (op_info[opcode] & OP_LENGTH) {
+        case 2:
+            return (uint32_t)cpu_fetch_byte(gb, cpu) << 8 | opcode;
+        case 3:
+            return (uint32_t)cpu_fetch_word(gb, cpu) << 8 | opcode;
+        default:
+            return opcode;
+    }
+}
+
+/*
+ * Decode the basic block starting at offset of the ROM image, up to the end
+ * of its bank or the first block already decoded. Returns its first entry.
+ */
+static uint32_t cpu_decode_block(cart_rom_image_t *image, size_t offset)
+{
+    size_t end = (offset | 0x3fff) + 1;
+    if (end > image->size)
+        end = image->size;
+    uint32_t first = 0;
+    while (offset < end) {
+        const uint8_t *bytes = &image->bytes[offset];
+        unsigned int length = op_info[bytes[0]] & OP_LENGTH;
+        uint32_t insn = (uint32_t)length << 24 | bytes[0];
+        if (offset + length > end) {
+            insn = INSN_UNCACHED;
+        } else if (length == 2) {
+            insn |= (uint32_t)bytes[1] << 8;
+        } else if (length == 3) {
+            insn |= (uint32_t)(bytes[1] | bytes[2] << 8) << 8;
+        }
+        /* Every cart of the image decodes the same. */
+        atomic_store_explicit(&image->code[offset], insn,
+                              memory_order_relaxed);
+        if (first == 0)
+            first = insn;
+        if (insn == INSN_UNCACHED || op_info[bytes[0]] & OP_JUMP)
+            break;
+        offset += length;
+        if (offset < end && atomic_load_explicit(&image->code[offset],
+                                                 memory_order_relaxed))
+            break;
+    }
+    return first;
+}
+
+/*
+ * Fetch the instruction at PC from the decoded ROM, keyed by ROM offset so
+ * bank switches need no invalidation. Code outside ROM and instructions that
+ * cross a bank return 0, to be fetched through the MMU.
+ */
+static inline uint32_t cpu_fetch_rom(gb_t *gb, cpu_t *cpu)
+{
+    uint16_t pc = cpu->reg.pc;
+    if (pc >= 0x8000)
+        return 0;
+    cart_rom_image_t *image = gb->cart.rom.image;
+    size_t offset = pc < 0x4000 ? pc : gb->cart.rom.offset + (pc & 0x3fff);
+    if (offset >= image->size)
+        return 0;
+    uint32_t insn =
+        atomic_load_explicit(&image->code[offset], memory_order_relaxed);
+    if (insn == 0)
+        insn = cpu_decode_block(image, offset);
+    if (insn == INSN_UNCACHED)
+        return 0;
+    /* Same cycles as fetching through the MMU. */
+    for (unsigned int i = INSN_LENGTH(insn); i > 0; --i)
+        clock_step(gb, 4);
+    cpu->reg.pc = (uint16_t)(pc + INSN_LENGTH(insn));
+    return insn;
+}
+
+/*
+ * Fetch the instruction at PC, or return false when halted: then the CPU only
+ * idles, with PC on the HALT or STOP opcode.
+ */
+static bool cpu_fetch_next(gb_t *gb, cpu_t *cpu, uint32_t *insn)
+{
+    if (cpu->halt && !cpu->halt_bug) {
+        /* Nothing happens until an event raises an interrupt: skip to it,
+         * then go on as if HALT was executed again. */
+        gb->cpu = *cpu;
+        if (!interrupt_wake_pending(gb))
+            clock_idle(gb);
+        clock_step(gb, 4);
+        return false;
+    }
+    *insn = cpu_fetch_rom(gb, cpu);
+    if (*insn == 0)
+        *insn = cpu_fetch_operand(gb, cpu, cpu_fetch_byte(gb, cpu));
+    if (cpu->halt && (uint8_t)*insn == 0x76) {
+        /* Halt bug, the byte after HALT is read twice. */
+        uint8_t opcode = cpu_fetch_byte(gb, cpu);
+        cpu->reg.pc--;
+        cpu->halt = false;
+        cpu->halt_bug = false;
+        *insn = cpu_fetch_operand(gb, cpu, opcode);
+    }
+    return true;
+}
+
+/*
+ * With GCC labels as values each opcode jumps straight to its handler through
+ * a table, CB opcodes through a second one, and the handlers are inlined at
+ * their labels. Building with CPU_SWITCH_DISPATCH uses two plain switches.
+ */
+#if defined(__GNUC__) && !defined(CPU_SWITCH_DISPATCH)
+#define CPU_THREADED_DISPATCH
+#endif
+
+#ifdef CPU_THREADED_DISPATCH
+#define OP(n) op_##n
+#define CB(n) cb_##n
+#define DISPATCH_CB(opcode) goto *cb_ops[opcode]
+#define ROW(p, r)                                                        \
+    &&p##r##0, &&p##r##1, &&p##r##2, &&p##r##3, &&p##r##4, &&p##r##5, \
+    &&p##r##6, &&p##r##7, &&p##r##8, &&p##r##9, &&p##r##a, &&p##r##b, \
+    &&p##r##c, &&p##r##d, &&p##r##e, &&p##r##f
+#define DISPATCH_TABLES                                                     \
+    static const void *const ops[256] = {                                   \
+        ROW(op_, 0x0), ROW(op_, 0x1), ROW(op_, 0x2), ROW(op_, 0x3),         \
+        ROW(op_, 0x4), ROW(op_, 0x5), ROW(op_, 0x6), ROW(op_, 0x7),         \
+        ROW(op_, 0x8), ROW(op_, 0x9), ROW(op_, 0xa), ROW(op_, 0xb),         \
+        ROW(op_, 0xc), ROW(op_, 0xd), ROW(op_, 0xe), ROW(op_, 0xf)};        \
+    static const void *const cb_ops[256] = {                                \
+        ROW(cb_, 0x0), ROW(cb_, 0x1), ROW(cb_, 0x2), ROW(cb_, 0x3),         \
+        ROW(cb_, 0x4), ROW(cb_, 0x5), ROW(cb_, 0x6), ROW(cb_, 0x7),         \
+        ROW(cb_, 0x8), ROW(cb_, 0x9), ROW(cb_, 0xa), ROW(cb_, 0xb),         \
+        ROW(cb_, 0xc), ROW(cb_, 0xd), ROW(cb_, 0xe), ROW(cb_, 0xf)};
+#define DISPATCH_BEGIN(insn) goto *ops[(insn) & 0xff];
+#define DISPATCH_CB_BEGIN(insn)
+#define DISPATCH_END
+#else
+#define OP(n) case n
+#define CB(n) case n
+#define DISPATCH_CB(opcode) break
+#define DISPATCH_TABLES
+#define DISPATCH_BEGIN(insn) switch ((insn) & 0xff) {
+#define DISPATCH_CB_BEGIN(insn) \
+    }                           \
+    switch (INSN_N8(insn)) {
+#define DISPATCH_END }
+#endif
+
+/* Call a handler with the operand of its kind. */
+#define CALL_NONE(name) name(gb, &cpu)
+#define CALL_N8(name) name(gb, &cpu, INSN_N8(insn))
+#define CALL_N16(name) name(gb, &cpu, INSN_N16(insn))
+#define CALL_E8(name) name(gb, &cpu, INSN_N8(insn))
+#define CALL_CB(name) DISPATCH_CB(INSN_N8(insn))
+#define CALL_UD(name) name(gb, &cpu)
+
+/* Trace an instruction of its kind, CB ones once the CB opcode is known. */
+#define TRACE_NONE(text) cpu_debug(&cpu, insn, CPU_OP_LENGTH_NONE, text)
+#define TRACE_N8(text) cpu_debug(&cpu, insn, CPU_OP_LENGTH_N8, text)
+#define TRACE_N16(text) cpu_debug(&cpu, insn, CPU_OP_LENGTH_N16, text)
+#define TRACE_E8(text) cpu_debug(&cpu, insn, CPU_OP_LENGTH_E8, text)
+#define TRACE_CB(text)
+#define TRACE_UD(text) cpu_debug(&cpu, insn, CPU_OP_LENGTH_UD, text)
+
+/* Each handler at its label. */
+#define X_OP(op, name, kind, jump, cycles, taken, flags, text) \
+    OP(op):                                                     \
+        CALL_##kind(name);                                      \
+        goto next;
+#define X_CB(op, name, kind, jump, cycles, taken, flags, text) \
+    CB(op):                                                     \
+        name(gb, &cpu);                                         \
+        goto next;
+
+/* The same, printing each instruction first. */
+#define X_OP_TRACED(op, name, kind, jump, cycles, taken, flags, text) \
+    OP(op):                                                            \
+        TRACE_##kind(text);                                            \
+        CALL_##kind(name);                                             \
+        goto next;
+#define X_CB_TRACED(op, name, kind, jump, cycles, taken, flags, text)   \
+    CB(op):                                                              \
+        cpu_debug(&cpu, insn, CPU_OP_LENGTH_CB, text);                   \
+        name(gb, &cpu);                                                  \
+        goto next;
+
+/*
+ * The body of cpu_loop() with the tables expanded by op_x and cb_x. The
+ * registers are copied to cpu and the handlers, inlined, work on it, so GCC
+ * keeps them in host registers. They go back to gb->cpu only where code out
+ * of this file uses them: around an interrupt, the skips in jump_back(), a
+ * halted CPU and on return. Devices never look at them. The loop also ends
+ * once until holds after an instruction.
+ */
+#define CPU_LOOP(op_x, cb_x, until)                            \
+    DISPATCH_TABLES                                            \
+    cpu_t cpu = gb->cpu;                                       \
+    unsigned int frames = gb->gpu.frames;                      \
+    uint64_t elapsed = 0;                                      \
+    uint32_t insn;                                             \
+    if (opcode >= 0) {                                         \
+        insn = cpu_fetch_operand(gb, &cpu, (uint8_t)opcode);   \
+        goto dispatch;                                         \
+    }                                                          \
+    do {                                                       \
+        clock_clear(gb);                                       \
+        if (!cpu_fetch_next(gb, &cpu, &insn))                  \
+            goto next;                                         \
+    dispatch:                                                  \
+        DISPATCH_BEGIN(insn)                                   \
+        CPU_OPS(op_x)                                          \
+        DISPATCH_CB_BEGIN(insn)                                \
+        CPU_CB_OPS(cb_x)                                       \
+        DISPATCH_END                                           \
+    next:                                                      \
+        if (gb->intr.pending) {                                \
+            gb->cpu = cpu;                                     \
+            interrupt_step(gb);                                \
+            cpu = gb->cpu;                                     \
+        }                                                      \
+        elapsed += clock_get_step(gb);                         \
+        clock_commit(gb);                                      \
+        if (gb->gpu.frames != frames)                          \
+            break;                                             \
+    } while (elapsed < budget && !(until));                    \
+    gb->cpu = cpu;                                             \
+    return elapsed;
+
+/*
+ * Have GCC inline every handler into the loop, as both expansions below call
+ * them, and with them the registers out of memory.
+ */
+#if defined(__GNUC__)
+#define CPU_LOOP_FLATTEN __attribute__((flatten))
+#else
+#define CPU_LOOP_FLATTEN
+#endif
+
+/*
+ * Run instructions as cpu_execute_loop(). An opcode other than -1 is run
+ * first, its operand fetched from PC.
+ */
+CPU_LOOP_FLATTEN static uint64_t cpu_loop(gb_t *gb, uint64_t budget,
+                                          int opcode)
+{
+    CPU_LOOP(X_OP, X_CB, false)
+}
+
+/*
+ * The second expansion, for gb_set_trace(), so the one above carries no
+ * trace code.
+ */
+static uint64_t cpu_loop_traced(gb_t *gb, uint64_t budget, int opcode)
+{
+    CPU_LOOP(X_OP_TRACED, X_CB_TRACED, false)
+}
+
+#ifdef CPU_JIT
+/*
+ * The third one, for what compiled code leaves to the interpreter: it hands
+ * back once PC is in ROM, unless halted.
+ */
+CPU_LOOP_FLATTEN static uint64_t cpu_loop_jit(gb_t *gb, uint64_t budget,
+                                              int opcode)
+{
+    CPU_LOOP(X_OP, X_CB, !cpu.halt && cpu.reg.pc < 0x8000)
+}
+
+/* Compiled code where there is some, the interpreter elsewhere. */
+static uint64_t cpu_jit_loop(gb_t *gb, uint64_t budget)
+{
+    unsigned int frames = gb->gpu.frames;
+    uint64_t elapsed = 0;
+    do {
+        uint64_t cycles = gb->cpu.halt ? 0 : cpu_jit_run(gb, budget - elapsed);
+        if (cycles == 0)
+            cycles = cpu_loop_jit(gb, budget - elapsed, -1);
+        elapsed += cycles;
+    } while (elapsed < budget && gb->gpu.frames == frames);
+    return elapsed;
+}
+#endif
+
+void cpu_execute(gb_t *gb, uint8_t opcode)
+{
+    cpu_set_f(&gb->cpu, gb->cpu.reg.f);
+    if (gb->trace)
+        cpu_loop_traced(gb, 0, opcode);
+    else
+        cpu_loop(gb, 0, opcode);
+    gb->cpu.reg.f = cpu_get_f(&gb->cpu);
+}
+
+uint64_t cpu_execute_loop(gb_t *gb, uint64_t budget)
 {
-    push(CPU.reg.pc);
-    CPU.reg.pc = 0x0038;
+    if (gb->trace)
+        return cpu_loop_traced(gb, budget, -1);
+#ifdef CPU_JIT
+    if (budget > 0 && cpu_jit_enabled(gb))
+        return cpu_jit_loop(gb, budget);
+#endif
+    return cpu_loop(gb, budget, -1);
 }
@@ -0,0 +1,549 @@
+#ifndef CPU_OPS_H
+#define CPU_OPS_H
+
+/**
+ * The SM83 instruction set, once for the interpreter, the disassemblers and
+ * the assembler. Each opcode is an
+ *
+ *     X(opcode, name, kind, jump, cycles, taken, flags, text)
+ *
+ * with users defining X to take what they need:
+ *
+ * name:   Handler in cpu_opcodes.c and, after op_enc_, encoder in gbas.
+ * kind:   Operand, NONE, N8 for a byte, N16 for a word, E8 for a signed
+ *         byte, CB for the CB opcode that follows, or UD for no instruction.
+ * jump:   1 if it may not fall through, so ends a basic block.
+ * cycles: Taken when a condition fails, or always.
+ * taken:  Taken when the condition holds.
+ * flags:  Z, N, H and C, each set from the result (its letter), set (1),
+ *         reset (0) or left alone (-).
+ * text:   Assembly, with the operand at the '*'.
+ *
+ * The 0xcb row counts the prefix alone, the CB rows whole instructions.
+ */
+
+/* Instruction length by kind. */
+#define CPU_OP_LENGTH_NONE 1
+#define CPU_OP_LENGTH_N8 2
+#define CPU_OP_LENGTH_N16 3
+#define CPU_OP_LENGTH_E8 2
+#define CPU_OP_LENGTH_CB 2
+#define CPU_OP_LENGTH_UD 1
+
+#define CPU_OPS(X)                                                \
+    X(0x00, nop, NONE, 0, 4, 4, "----", "nop")                    \
+    X(0x01, ld_bc_nn, N16, 0, 12, 12, "----", "ld bc, *")         \
+    X(0x02, ld_bcp_a, NONE, 0, 8, 8, "----", "ld (bc), a")        \
+    X(0x03, inc_bc, NONE, 0, 8, 8, "----", "inc bc")              \
+    X(0x04, inc_b, NONE, 0, 4, 4, "Z0H-", "inc b")                \
+    X(0x05, dec_b, NONE, 0, 4, 4, "Z1H-", "dec b")                \
+    X(0x06, ld_b_n, N8, 0, 8, 8, "----", "ld b, *")               \
+    X(0x07, rlca, NONE, 0, 4, 4, "000C", "rlca")                  \
+    X(0x08, ld_nnp_sp, N16, 0, 20, 20, "----", "ld (*), sp")      \
+    X(0x09, add_hl_bc, NONE, 0, 8, 8, "-0HC", "add hl, bc")       \
+    X(0x0a, ld_a_bcp, NONE, 0, 8, 8, "----", "ld a, (bc)")        \
+    X(0x0b, dec_bc, NONE, 0, 8, 8, "----", "dec bc")              \
+    X(0x0c, inc_c, NONE, 0, 4, 4, "Z0H-", "inc c")                \
+    X(0x0d, dec_c, NONE, 0, 4, 4, "Z1H-", "dec c")                \
+    X(0x0e, ld_c_n, N8, 0, 8, 8, "----", "ld c, *")               \
+    X(0x0f, rrca, NONE, 0, 4, 4, "000C", "rrca")                  \
+    X(0x10, stop, NONE, 1, 4, 4, "----", "stop")                  \
+    X(0x11, ld_de_nn, N16, 0, 12, 12, "----", "ld de, *")         \
+    X(0x12, ld_dep_a, NONE, 0, 8, 8, "----", "ld (de), a")        \
+    X(0x13, inc_de, NONE, 0, 8, 8, "----", "inc de")              \
+    X(0x14, inc_d, NONE, 0, 4, 4, "Z0H-", "inc d")                \
+    X(0x15, dec_d, NONE, 0, 4, 4, "Z1H-", "dec d")                \
+    X(0x16, ld_d_n, N8, 0, 8, 8, "----", "ld d, *")               \
+    X(0x17, rla, NONE, 0, 4, 4, "000C", "rla")                    \
+    X(0x18, jr_n, E8, 1, 12, 12, "----", "jr *")                  \
+    X(0x19, add_hl_de, NONE, 0, 8, 8, "-0HC", "add hl, de")       \
+    X(0x1a, ld_a_dep, NONE, 0, 8, 8, "----", "ld a, (de)")        \
+    X(0x1b, dec_de, NONE, 0, 8, 8, "----", "dec de")              \
+    X(0x1c, inc_e, NONE, 0, 4, 4, "Z0H-", "inc e")                \
+    X(0x1d, dec_e, NONE, 0, 4, 4, "Z1H-", "dec e")                \
+    X(0x1e, ld_e_n, N8, 0, 8, 8, "----", "ld e, *")               \
+    X(0x1f, rra, NONE, 0, 4, 4, "000C", "rra")                    \
+    X(0x20, jr_nz_n, E8, 1, 8, 12, "----", "jr nz, *")            \
+    X(0x21, ld_hl_nn, N16, 0, 12, 12, "----", "ld hl, *")         \
+    X(0x22, ldi_hlp_a, NONE, 0, 8, 8, "----", "ldi (hl), a")      \
+    X(0x23, inc_hl, NONE, 0, 8, 8, "----", "inc hl")              \
+    X(0x24, inc_h, NONE, 0, 4, 4, "Z0H-", "inc h")                \
+    X(0x25, dec_h, NONE, 0, 4, 4, "Z1H-", "dec h")                \
+    X(0x26, ld_h_n, N8, 0, 8, 8, "----", "ld h, *")               \
+    X(0x27, daa, NONE, 0, 4, 4, "Z-0C", "daa")                    \
+    X(0x28, jr_z_n, E8, 1, 8, 12, "----", "jr z, *")              \
+    X(0x29, add_hl_hl, NONE, 0, 8, 8, "-0HC", "add hl, hl")       \
+    X(0x2a, ldi_a_hlp, NONE, 0, 8, 8, "----", "ldi a, (hl)")      \
+    X(0x2b, dec_hl, NONE, 0, 8, 8, "----", "dec hl")              \
+    X(0x2c, inc_l, NONE, 0, 4, 4, "Z0H-", "inc l")                \
+    X(0x2d, dec_l, NONE, 0, 4, 4, "Z1H-", "dec l")                \
+    X(0x2e, ld_l_n, N8, 0, 8, 8, "----", "ld l, *")               \
+    X(0x2f, cpl, NONE, 0, 4, 4, "-11-", "cpl")                    \
+    X(0x30, jr_nc_n, E8, 1, 8, 12, "----", "jr nc, *")            \
+    X(0x31, ld_sp_nn, N16, 0, 12, 12, "----", "ld sp, *")         \
+    X(0x32, ldd_hlp_a, NONE, 0, 8, 8, "----", "ldd (hl), a")      \
+    X(0x33, inc_sp, NONE, 0, 8, 8, "----", "inc sp")              \
+    X(0x34, inc_hlp, NONE, 0, 12, 12, "Z0H-", "inc (hl)")         \
+    X(0x35, dec_hlp, NONE, 0, 12, 12, "Z1H-", "dec (hl)")         \
+    X(0x36, ld_hlp_n, N8, 0, 12, 12, "----", "ld (hl), *")        \
+    X(0x37, scf, NONE, 0, 4, 4, "-001", "scf")                    \
+    X(0x38, jr_c_n, E8, 1, 8, 12, "----", "jr c, *")              \
+    X(0x39, add_hl_sp, NONE, 0, 8, 8, "-0HC", "add hl, sp")       \
+    X(0x3a, ldd_a_hlp, NONE, 0, 8, 8, "----", "ldd a, (hl)")      \
+    X(0x3b, dec_sp, NONE, 0, 8, 8, "----", "dec sp")              \
+    X(0x3c, inc_a, NONE, 0, 4, 4, "Z0H-", "inc a")                \
+    X(0x3d, dec_a, NONE, 0, 4, 4, "Z1H-", "dec a")                \
+    X(0x3e, ld_a_n, N8, 0, 8, 8, "----", "ld a, *")               \
+    X(0x3f, ccf, NONE, 0, 4, 4, "-00C", "ccf")                    \
+    X(0x40, ld_b_b, NONE, 0, 4, 4, "----", "ld b, b")             \
+    X(0x41, ld_b_c, NONE, 0, 4, 4, "----", "ld b, c")             \
+    X(0x42, ld_b_d, NONE, 0, 4, 4, "----", "ld b, d")             \
+    X(0x43, ld_b_e, NONE, 0, 4, 4, "----", "ld b, e")             \
+    X(0x44, ld_b_h, NONE, 0, 4, 4, "----", "ld b, h")             \
+    X(0x45, ld_b_l, NONE, 0, 4, 4, "----", "ld b, l")             \
+    X(0x46, ld_b_hlp, NONE, 0, 8, 8, "----", "ld b, (hl)")        \
+    X(0x47, ld_b_a, NONE, 0, 4, 4, "----", "ld b, a")             \
+    X(0x48, ld_c_b, NONE, 0, 4, 4, "----", "ld c, b")             \
+    X(0x49, ld_c_c, NONE, 0, 4, 4, "----", "ld c, c")             \
+    X(0x4a, ld_c_d, NONE, 0, 4, 4, "----", "ld c, d")             \
+    X(0x4b, ld_c_e, NONE, 0, 4, 4, "----", "ld c, e")             \
+    X(0x4c, ld_c_h, NONE, 0, 4, 4, "----", "ld c, h")             \
+    X(0x4d, ld_c_l, NONE, 0, 4, 4, "----", "ld c, l")             \
+    X(0x4e, ld_c_hlp, NONE, 0, 8, 8, "----", "ld c, (hl)")        \
+    X(0x4f, ld_c_a, NONE, 0, 4, 4, "----", "ld c, a")             \
+    X(0x50, ld_d_b, NONE, 0, 4, 4, "----", "ld d, b")             \
+    X(0x51, ld_d_c, NONE, 0, 4, 4, "----", "ld d, c")             \
+    X(0x52, ld_d_d, NONE, 0, 4, 4, "----", "ld d, d")             \
+    X(0x53, ld_d_e, NONE, 0, 4, 4, "----", "ld d, e")             \
+    X(0x54, ld_d_h, NONE, 0, 4, 4, "----", "ld d, h")             \
+    X(0x55, ld_d_l, NONE, 0, 4, 4, "----", "ld d, l")             \
+    X(0x56, ld_d_hlp, NONE, 0, 8, 8, "----", "ld d, (hl)")        \
+    X(0x57, ld_d_a, NONE, 0, 4, 4, "----", "ld d, a")             \
+    X(0x58, ld_e_b, NONE, 0, 4, 4, "----", "ld e, b")             \
+    X(0x59, ld_e_c, NONE, 0, 4, 4, "----", "ld e, c")             \
+    X(0x5a, ld_e_d, NONE, 0, 4, 4, "----", "ld e, d")             \
+    X(0x5b, ld_e_e, NONE, 0, 4, 4, "----", "ld e, e")             \
+    X(0x5c, ld_e_h, NONE, 0, 4, 4, "----", "ld e, h")             \
+    X(0x5d, ld_e_l, NONE, 0, 4, 4, "----", "ld e, l")             \
+    X(0x5e, ld_e_hlp, NONE, 0, 8, 8, "----", "ld e, (hl)")        \
+    X(0x5f, ld_e_a, NONE, 0, 4, 4, "----", "ld e, a")             \
+    X(0x60, ld_h_b, NONE, 0, 4, 4, "----", "ld h, b")             \
+    X(0x61, ld_h_c, NONE, 0, 4, 4, "----", "ld h, c")             \
+    X(0x62, ld_h_d, NONE, 0, 4, 4, "----", "ld h, d")             \
+    X(0x63, ld_h_e, NONE, 0, 4, 4, "----", "ld h, e")             \
+    X(0x64, ld_h_h, NONE, 0, 4, 4, "----", "ld h, h")             \
+    X(0x65, ld_h_l, NONE, 0, 4, 4, "----", "ld h, l")             \
+    X(0x66, ld_h_hlp, NONE, 0, 8, 8, "----", "ld h, (hl)")        \
+    X(0x67, ld_h_a, NONE, 0, 4, 4, "----", "ld h, a")             \
+    X(0x68, ld_l_b, NONE, 0, 4, 4, "----", "ld l, b")             \
+    X(0x69, ld_l_c, NONE, 0, 4, 4, "----", "ld l, c")             \
+    X(0x6a, ld_l_d, NONE, 0, 4, 4, "----", "ld l, d")             \
+    X(0x6b, ld_l_e, NONE, 0, 4, 4, "----", "ld l, e")             \
+    X(0x6c, ld_l_h, NONE, 0, 4, 4, "----", "ld l, h")             \
+    X(0x6d, ld_l_l, NONE, 0, 4, 4, "----", "ld l, l")             \
+    X(0x6e, ld_l_hlp, NONE, 0, 8, 8, "----", "ld l, (hl)")        \
+    X(0x6f, ld_l_a, NONE, 0, 4, 4, "----", "ld l, a")             \
+    X(0x70, ld_hlp_b, NONE, 0, 8, 8, "----", "ld (hl), b")        \
+    X(0x71, ld_hlp_c, NONE, 0, 8, 8, "----", "ld (hl), c")        \
+    X(0x72, ld_hlp_d, NONE, 0, 8, 8, "----", "ld (hl), d")        \
+    X(0x73, ld_hlp_e, NONE, 0, 8, 8, "----", "ld (hl), e")        \
+    X(0x74, ld_hlp_h, NONE, 0, 8, 8, "----", "ld (hl), h")        \
+    X(0x75, ld_hlp_l, NONE, 0, 8, 8, "----", "ld (hl), l")        \
+    X(0x76, halt, NONE, 1, 8, 8, "----", "halt")                  \
+    X(0x77, ld_hlp_a, NONE, 0, 8, 8, "----", "ld (hl), a")        \
+    X(0x78, ld_a_b, NONE, 0, 4, 4, "----", "ld a, b")             \
+    X(0x79, ld_a_c, NONE, 0, 4, 4, "----", "ld a, c")             \
+    X(0x7a, ld_a_d, NONE, 0, 4, 4, "----", "ld a, d")             \
+    X(0x7b, ld_a_e, NONE, 0, 4, 4, "----", "ld a, e")             \
+    X(0x7c, ld_a_h, NONE, 0, 4, 4, "----", "ld a, h")             \
+    X(0x7d, ld_a_l, NONE, 0, 4, 4, "----", "ld a, l")             \
+    X(0x7e, ld_a_hlp, NONE, 0, 8, 8, "----", "ld a, (hl)")        \
+    X(0x7f, ld_a_a, NONE, 0, 4, 4, "----", "ld a, a")             \
+    X(0x80, add_a_b, NONE, 0, 4, 4, "Z0HC", "add a, b")           \
+    X(0x81, add_a_c, NONE, 0, 4, 4, "Z0HC", "add a, c")           \
+    X(0x82, add_a_d, NONE, 0, 4, 4, "Z0HC", "add a, d")           \
+    X(0x83, add_a_e, NONE, 0, 4, 4, "Z0HC", "add a, e")           \
+    X(0x84, add_a_h, NONE, 0, 4, 4, "Z0HC", "add a, h")           \
+    X(0x85, add_a_l, NONE, 0, 4, 4, "Z0HC", "add a, l")           \
+    X(0x86, add_a_hlp, NONE, 0, 8, 8, "Z0HC", "add a, (hl)")      \
+    X(0x87, add_a_a, NONE, 0, 4, 4, "Z0HC", "add a, a")           \
+    X(0x88, adc_b, NONE, 0, 4, 4, "Z0HC", "adc a, b")             \
+    X(0x89, adc_c, NONE, 0, 4, 4, "Z0HC", "adc a, c")             \
+    X(0x8a, adc_d, NONE, 0, 4, 4, "Z0HC", "adc a, d")             \
+    X(0x8b, adc_e, NONE, 0, 4, 4, "Z0HC", "adc a, e")             \
+    X(0x8c, adc_h, NONE, 0, 4, 4, "Z0HC", "adc a, h")             \
+    X(0x8d, adc_l, NONE, 0, 4, 4, "Z0HC", "adc a, l")             \
+    X(0x8e, adc_hlp, NONE, 0, 8, 8, "Z0HC", "adc a, (hl)")        \
+    X(0x8f, adc_a, NONE, 0, 4, 4, "Z0HC", "adc a, a")             \
+    X(0x90, sub_b, NONE, 0, 4, 4, "Z1HC", "sub b")                \
+    X(0x91, sub_c, NONE, 0, 4, 4, "Z1HC", "sub c")                \
+    X(0x92, sub_d, NONE, 0, 4, 4, "Z1HC", "sub d")                \
+    X(0x93, sub_e, NONE, 0, 4, 4, "Z1HC", "sub e")                \
+    X(0x94, sub_h, NONE, 0, 4, 4, "Z1HC", "sub h")                \
+    X(0x95, sub_l, NONE, 0, 4, 4, "Z1HC", "sub l")                \
+    X(0x96, sub_hlp, NONE, 0, 8, 8, "Z1HC", "sub (hl)")           \
+    X(0x97, sub_a, NONE, 0, 4, 4, "Z1HC", "sub a")                \
+    X(0x98, sbc_b, NONE, 0, 4, 4, "Z1HC", "sbc a, b")             \
+    X(0x99, sbc_c, NONE, 0, 4, 4, "Z1HC", "sbc a, c")             \
+    X(0x9a, sbc_d, NONE, 0, 4, 4, "Z1HC", "sbc a, d")             \
+    X(0x9b, sbc_e, NONE, 0, 4, 4, "Z1HC", "sbc a, e")             \
+    X(0x9c, sbc_h, NONE, 0, 4, 4, "Z1HC", "sbc a, h")             \
+    X(0x9d, sbc_l, NONE, 0, 4, 4, "Z1HC", "sbc a, l")             \
+    X(0x9e, sbc_hlp, NONE, 0, 8, 8, "Z1HC", "sbc a, (hl)")        \
+    X(0x9f, sbc_a, NONE, 0, 4, 4, "Z1HC", "sbc a, a")             \
+    X(0xa0, and_b, NONE, 0, 4, 4, "Z010", "and b")                \
+    X(0xa1, and_c, NONE, 0, 4, 4, "Z010", "and c")                \
+    X(0xa2, and_d, NONE, 0, 4, 4, "Z010", "and d")                \
+    X(0xa3, and_e, NONE, 0, 4, 4, "Z010", "and e")                \
+    X(0xa4, and_h, NONE, 0, 4, 4, "Z010", "and h")                \
+    X(0xa5, and_l, NONE, 0, 4, 4, "Z010", "and l")                \
+    X(0xa6, and_hlp, NONE, 0, 8, 8, "Z010", "and (hl)")           \
+    X(0xa7, and_a, NONE, 0, 4, 4, "Z010", "and a")                \
+    X(0xa8, xor_b, NONE, 0, 4, 4, "Z000", "xor b")                \
+    X(0xa9, xor_c, NONE, 0, 4, 4, "Z000", "xor c")                \
+    X(0xaa, xor_d, NONE, 0, 4, 4, "Z000", "xor d")                \
+    X(0xab, xor_e, NONE, 0, 4, 4, "Z000", "xor e")                \
+    X(0xac, xor_h, NONE, 0, 4, 4, "Z000", "xor h")                \
+    X(0xad, xor_l, NONE, 0, 4, 4, "Z000", "xor l")                \
+    X(0xae, xor_hlp, NONE, 0, 8, 8, "Z000", "xor (hl)")           \
+    X(0xaf, xor_a, NONE, 0, 4, 4, "Z000", "xor a")                \
+    X(0xb0, or_b, NONE, 0, 4, 4, "Z000", "or b")                  \
+    X(0xb1, or_c, NONE, 0, 4, 4, "Z000", "or c")                  \
+    X(0xb2, or_d, NONE, 0, 4, 4, "Z000", "or d")                  \
+    X(0xb3, or_e, NONE, 0, 4, 4, "Z000", "or e")                  \
+    X(0xb4, or_h, NONE, 0, 4, 4, "Z000", "or h")                  \
+    X(0xb5, or_l, NONE, 0, 4, 4, "Z000", "or l")                  \
+    X(0xb6, or_hlp, NONE, 0, 8, 8, "Z000", "or (hl)")             \
+    X(0xb7, or_a, NONE, 0, 4, 4, "Z000", "or a")                  \
+    X(0xb8, cp_b, NONE, 0, 4, 4, "Z1HC", "cp a, b")               \
+    X(0xb9, cp_c, NONE, 0, 4, 4, "Z1HC", "cp a, c")               \
+    X(0xba, cp_d, NONE, 0, 4, 4, "Z1HC", "cp a, d")               \
+    X(0xbb, cp_e, NONE, 0, 4, 4, "Z1HC", "cp a, e")               \
+    X(0xbc, cp_h, NONE, 0, 4, 4, "Z1HC", "cp a, h")               \
+    X(0xbd, cp_l, NONE, 0, 4, 4, "Z1HC", "cp a, l")               \
+    X(0xbe, cp_hlp, NONE, 0, 8, 8, "Z1HC", "cp a, (hl)")          \
+    X(0xbf, cp_a, NONE, 0, 4, 4, "Z1HC", "cp a, a")               \
+    X(0xc0, ret_nz, NONE, 1, 8, 20, "----", "ret nz")             \
+    X(0xc1, pop_bc, NONE, 0, 12, 12, "----", "pop bc")            \
+    X(0xc2, jp_nz_nn, N16, 1, 12, 16, "----", "jp nz, *")         \
+    X(0xc3, jp_nn, N16, 1, 16, 16, "----", "jp *")                \
+    X(0xc4, call_nz_nn, N16, 1, 12, 24, "----", "call nz, *")     \
+    X(0xc5, push_bc, NONE, 0, 16, 16, "----", "push bc")          \
+    X(0xc6, add_a_n, N8, 0, 8, 8, "Z0HC", "add a, *")             \
+    X(0xc7, rst_00, NONE, 1, 16, 16, "----", "rst 0x00")          \
+    X(0xc8, ret_z, NONE, 1, 8, 20, "----", "ret z")               \
+    X(0xc9, ret, NONE, 1, 16, 16, "----", "ret")                  \
+    X(0xca, jp_z_nn, N16, 1, 12, 16, "----", "jp z, *")           \
+    X(0xcb, cb_n, CB, 0, 4, 4, "----", "")                        \
+    X(0xcc, call_z_nn, N16, 1, 12, 24, "----", "call z, *")       \
+    X(0xcd, call_nn, N16, 1, 24, 24, "----", "call *")            \
+    X(0xce, adc_n, N8, 0, 8, 8, "Z0HC", "adc a, *")               \
+    X(0xcf, rst_08, NONE, 1, 16, 16, "----", "rst 0x08")          \
+    X(0xd0, ret_nc, NONE, 1, 8, 20, "----", "ret nc")             \
+    X(0xd1, pop_de, NONE, 0, 12, 12, "----", "pop de")            \
+    X(0xd2, jp_nc_nn, N16, 1, 12, 16, "----", "jp nc, *")         \
+    X(0xd3, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xd4, call_nc_nn, N16, 1, 12, 24, "----", "call nc, *")     \
+    X(0xd5, push_de, NONE, 0, 16, 16, "----", "push de")          \
+    X(0xd6, sub_n, N8, 0, 8, 8, "Z1HC", "sub *")                  \
+    X(0xd7, rst_10, NONE, 1, 16, 16, "----", "rst 0x10")          \
+    X(0xd8, ret_c, NONE, 1, 8, 20, "----", "ret c")               \
+    X(0xd9, reti, NONE, 1, 16, 16, "----", "reti")                \
+    X(0xda, jp_c_nn, N16, 1, 12, 16, "----", "jp c, *")           \
+    X(0xdb, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xdc, call_c_nn, N16, 1, 12, 24, "----", "call c, *")       \
+    X(0xdd, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xde, sbc_n, N8, 0, 8, 8, "Z1HC", "sbc a, *")               \
+    X(0xdf, rst_18, NONE, 1, 16, 16, "----", "rst 0x18")          \
+    X(0xe0, ldh_n_a, N8, 0, 12, 12, "----", "ld (0xff00 + *), a") \
+    X(0xe1, pop_hl, NONE, 0, 12, 12, "----", "pop hl")            \
+    X(0xe2, ld_cp_a, NONE, 0, 8, 8, "----", "ld (0xff00 + c), a") \
+    X(0xe3, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xe4, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xe5, push_hl, NONE, 0, 16, 16, "----", "push hl")          \
+    X(0xe6, and_n, N8, 0, 8, 8, "Z010", "and *")                  \
+    X(0xe7, rst_20, NONE, 1, 16, 16, "----", "rst 0x20")          \
+    X(0xe8, add_sp_n, N8, 0, 16, 16, "00HC", "add sp, *")         \
+    X(0xe9, jp_hl, NONE, 1, 4, 4, "----", "jp (hl)")              \
+    X(0xea, ld_nnp_a, N16, 0, 16, 16, "----", "ld (*), a")        \
+    X(0xeb, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xec, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xed, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xee, xor_n, N8, 0, 8, 8, "Z000", "xor *")                  \
+    X(0xef, rst_28, NONE, 1, 16, 16, "----", "rst 0x28")          \
+    X(0xf0, ldh_a_n, N8, 0, 12, 12, "----", "ld a, (0xff00 + *)") \
+    X(0xf1, pop_af, NONE, 0, 12, 12, "ZNHC", "pop af")            \
+    X(0xf2, ld_a_cp, NONE, 0, 8, 8, "----", "ld a, (0xff00 + c)") \
+    X(0xf3, di, NONE, 0, 4, 4, "----", "di")                      \
+    X(0xf4, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xf5, push_af, NONE, 0, 16, 16, "----", "push af")          \
+    X(0xf6, or_n, N8, 0, 8, 8, "Z000", "or *")                    \
+    X(0xf7, rst_30, NONE, 1, 16, 16, "----", "rst 0x30")          \
+    X(0xf8, ldhl_sp_n, E8, 0, 12, 12, "00HC", "ld hl, sp + *")    \
+    X(0xf9, ld_sp_hl, NONE, 0, 8, 8, "----", "ld sp, hl")         \
+    X(0xfa, ld_a_nnp, N16, 0, 16, 16, "----", "ld a, (*)")        \
+    X(0xfb, ei, NONE, 0, 4, 4, "----", "ei")                      \
+    X(0xfc, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xfd, undefined, UD, 1, 4, 4, "----", "")                   \
+    X(0xfe, cp_n, N8, 0, 8, 8, "Z1HC", "cp a, *")                 \
+    X(0xff, rst_38, NONE, 1, 16, 16, "----", "rst 0x38")
+
+#define CPU_CB_OPS(X)                                          \
+    X(0x00, rlc_b, NONE, 0, 8, 8, "Z00C", "rlc b")             \
+    X(0x01, rlc_c, NONE, 0, 8, 8, "Z00C", "rlc c")             \
+    X(0x02, rlc_d, NONE, 0, 8, 8, "Z00C", "rlc d")             \
+    X(0x03, rlc_e, NONE, 0, 8, 8, "Z00C", "rlc e")             \
+    X(0x04, rlc_h, NONE, 0, 8, 8, "Z00C", "rlc h")             \
+    X(0x05, rlc_l, NONE, 0, 8, 8, "Z00C", "rlc l")             \
+    X(0x06, rlc_hlp, NONE, 0, 16, 16, "Z00C", "rlc (hl)")      \
+    X(0x07, rlc_a, NONE, 0, 8, 8, "Z00C", "rlc a")             \
+    X(0x08, rrc_b, NONE, 0, 8, 8, "Z00C", "rrc b")             \
+    X(0x09, rrc_c, NONE, 0, 8, 8, "Z00C", "rrc c")             \
+    X(0x0a, rrc_d, NONE, 0, 8, 8, "Z00C", "rrc d")             \
+    X(0x0b, rrc_e, NONE, 0, 8, 8, "Z00C", "rrc e")             \
+    X(0x0c, rrc_h, NONE, 0, 8, 8, "Z00C", "rrc h")             \
+    X(0x0d, rrc_l, NONE, 0, 8, 8, "Z00C", "rrc l")             \
+    X(0x0e, rrc_hlp, NONE, 0, 16, 16, "Z00C", "rrc (hl)")      \
+    X(0x0f, rrc_a, NONE, 0, 8, 8, "Z00C", "rrc a")             \
+    X(0x10, rl_b, NONE, 0, 8, 8, "Z00C", "rl b")               \
+    X(0x11, rl_c, NONE, 0, 8, 8, "Z00C", "rl c")               \
+    X(0x12, rl_d, NONE, 0, 8, 8, "Z00C", "rl d")               \
+    X(0x13, rl_e, NONE, 0, 8, 8, "Z00C", "rl e")               \
+    X(0x14, rl_h, NONE, 0, 8, 8, "Z00C", "rl h")               \
+    X(0x15, rl_l, NONE, 0, 8, 8, "Z00C", "rl l")               \
+    X(0x16, rl_hlp, NONE, 0, 16, 16, "Z00C", "rl (hl)")        \
+    X(0x17, rl_a, NONE, 0, 8, 8, "Z00C", "rl a")               \
+    X(0x18, rr_b, NONE, 0, 8, 8, "Z00C", "rr b")               \
+    X(0x19, rr_c, NONE, 0, 8, 8, "Z00C", "rr c")               \
+    X(0x1a, rr_d, NONE, 0, 8, 8, "Z00C", "rr d")               \
+    X(0x1b, rr_e, NONE, 0, 8, 8, "Z00C", "rr e")               \
+    X(0x1c, rr_h, NONE, 0, 8, 8, "Z00C", "rr h")               \
+    X(0x1d, rr_l, NONE, 0, 8, 8, "Z00C", "rr l")               \
+    X(0x1e, rr_hlp, NONE, 0, 16, 16, "Z00C", "rr (hl)")        \
+    X(0x1f, rr_a, NONE, 0, 8, 8, "Z00C", "rr a")               \
+    X(0x20, sla_b, NONE, 0, 8, 8, "Z00C", "sla b")             \
+    X(0x21, sla_c, NONE, 0, 8, 8, "Z00C", "sla c")             \
+    X(0x22, sla_d, NONE, 0, 8, 8, "Z00C", "sla d")             \
+    X(0x23, sla_e, NONE, 0, 8, 8, "Z00C", "sla e")             \
+    X(0x24, sla_h, NONE, 0, 8, 8, "Z00C", "sla h")             \
+    X(0x25, sla_l, NONE, 0, 8, 8, "Z00C", "sla l")             \
+    X(0x26, sla_hlp, NONE, 0, 16, 16, "Z00C", "sla (hl)")      \
+    X(0x27, sla_a, NONE, 0, 8, 8, "Z00C", "sla a")             \
+    X(0x28, sra_b, NONE, 0, 8, 8, "Z00C", "sra b")             \
+    X(0x29, sra_c, NONE, 0, 8, 8, "Z00C", "sra c")             \
+    X(0x2a, sra_d, NONE, 0, 8, 8, "Z00C", "sra d")             \
+    X(0x2b, sra_e, NONE, 0, 8, 8, "Z00C", "sra e")             \
+    X(0x2c, sra_h, NONE, 0, 8, 8, "Z00C", "sra h")             \
+    X(0x2d, sra_l, NONE, 0, 8, 8, "Z00C", "sra l")             \
+    X(0x2e, sra_hlp, NONE, 0, 16, 16, "Z00C", "sra (hl)")      \
+    X(0x2f, sra_a, NONE, 0, 8, 8, "Z00C", "sra a")             \
+    X(0x30, swap_b, NONE, 0, 8, 8, "Z000", "swap b")           \
+    X(0x31, swap_c, NONE, 0, 8, 8, "Z000", "swap c")           \
+    X(0x32, swap_d, NONE, 0, 8, 8, "Z000", "swap d")           \
+    X(0x33, swap_e, NONE, 0, 8, 8, "Z000", "swap e")           \
+    X(0x34, swap_h, NONE, 0, 8, 8, "Z000", "swap h")           \
+    X(0x35, swap_l, NONE, 0, 8, 8, "Z000", "swap l")           \
+    X(0x36, swap_hlp, NONE, 0, 16, 16, "Z000", "swap (hl)")    \
+    X(0x37, swap_a, NONE, 0, 8, 8, "Z000", "swap a")           \
+    X(0x38, srl_b, NONE, 0, 8, 8, "Z00C", "srl b")             \
+    X(0x39, srl_c, NONE, 0, 8, 8, "Z00C", "srl c")             \
+    X(0x3a, srl_d, NONE, 0, 8, 8, "Z00C", "srl d")             \
+    X(0x3b, srl_e, NONE, 0, 8, 8, "Z00C", "srl e")             \
+    X(0x3c, srl_h, NONE, 0, 8, 8, "Z00C", "srl h")             \
+    X(0x3d, srl_l, NONE, 0, 8, 8, "Z00C", "srl l")             \
+    X(0x3e, srl_hlp, NONE, 0, 16, 16, "Z00C", "srl (hl)")      \
+    X(0x3f, srl_a, NONE, 0, 8, 8, "Z00C", "srl a")             \
+    X(0x40, bit_0_b, NONE, 0, 8, 8, "Z01-", "bit 0, b")        \
+    X(0x41, bit_0_c, NONE, 0, 8, 8, "Z01-", "bit 0, c")        \
+    X(0x42, bit_0_d, NONE, 0, 8, 8, "Z01-", "bit 0, d")        \
+    X(0x43, bit_0_e, NONE, 0, 8, 8, "Z01-", "bit 0, e")        \
+    X(0x44, bit_0_h, NONE, 0, 8, 8, "Z01-", "bit 0, h")        \
+    X(0x45, bit_0_l, NONE, 0, 8, 8, "Z01-", "bit 0, l")        \
+    X(0x46, bit_0_hlp, NONE, 0, 12, 12, "Z01-", "bit 0, (hl)") \
+    X(0x47, bit_0_a, NONE, 0, 8, 8, "Z01-", "bit 0, a")        \
+    X(0x48, bit_1_b, NONE, 0, 8, 8, "Z01-", "bit 1, b")        \
+    X(0x49, bit_1_c, NONE, 0, 8, 8, "Z01-", "bit 1, c")        \
+    X(0x4a, bit_1_d, NONE, 0, 8, 8, "Z01-", "bit 1, d")        \
+    X(0x4b, bit_1_e, NONE, 0, 8, 8, "Z01-", "bit 1, e")        \
+    X(0x4c, bit_1_h, NONE, 0, 8, 8, "Z01-", "bit 1, h")        \
+    X(0x4d, bit_1_l, NONE, 0, 8, 8, "Z01-", "bit 1, l")        \
+    X(0x4e, bit_1_hlp, NONE, 0, 12, 12, "Z01-", "bit 1, (hl)") \
+    X(0x4f, bit_1_a, NONE, 0, 8, 8, "Z01-", "bit 1, a")        \
+    X(0x50, bit_2_b, NONE, 0, 8, 8, "Z01-", "bit 2, b")        \
+    X(0x51, bit_2_c, NONE, 0, 8, 8, "Z01-", "bit 2, c")        \
+    X(0x52, bit_2_d, NONE, 0, 8, 8, "Z01-", "bit 2, d")        \
+    X(0x53, bit_2_e, NONE, 0, 8, 8, "Z01-", "bit 2, e")        \
+    X(0x54, bit_2_h, NONE, 0, 8, 8, "Z01-", "bit 2, h")        \
+    X(0x55, bit_2_l, NONE, 0, 8, 8, "Z01-", "bit 2, l")        \
+    X(0x56, bit_2_hlp, NONE, 0, 12, 12, "Z01-", "bit 2, (hl)") \
+    X(0x57, bit_2_a, NONE, 0, 8, 8, "Z01-", "bit 2, a")        \
+    X(0x58, bit_3_b, NONE, 0, 8, 8, "Z01-", "bit 3, b")        \
+    X(0x59, bit_3_c, NONE, 0, 8, 8, "Z01-", "bit 3, c")        \
+    X(0x5a, bit_3_d, NONE, 0, 8, 8, "Z01-", "bit 3, d")        \
+    X(0x5b, bit_3_e, NONE, 0, 8, 8, "Z01-", "bit 3, e")        \
+    X(0x5c, bit_3_h, NONE, 0, 8, 8, "Z01-", "bit 3, h")        \
+    X(0x5d, bit_3_l, NONE, 0, 8, 8, "Z01-", "bit 3, l")        \
+    X(0x5e, bit_3_hlp, NONE, 0, 12, 12, "Z01-", "bit 3, (hl)") \
+    X(0x5f, bit_3_a, NONE, 0, 8, 8, "Z01-", "bit 3, a")        \
+    X(0x60, bit_4_b, NONE, 0, 8, 8, "Z01-", "bit 4, b")        \
+    X(0x61, bit_4_c, NONE, 0, 8, 8, "Z01-", "bit 4, c")        \
+    X(0x62, bit_4_d, NONE, 0, 8, 8, "Z01-", "bit 4, d")        \
+    X(0x63, bit_4_e, NONE, 0, 8, 8, "Z01-", "bit 4, e")        \
+    X(0x64, bit_4_h, NONE, 0, 8, 8, "Z01-", "bit 4, h")        \
+    X(0x65, bit_4_l, NONE, 0, 8, 8, "Z01-", "bit 4, l")        \
+    X(0x66, bit_4_hlp, NONE, 0, 12, 12, "Z01-", "bit 4, (hl)") \
+    X(0x67, bit_4_a, NONE, 0, 8, 8, "Z01-", "bit 4, a")        \
+    X(0x68, bit_5_b, NONE, 0, 8, 8, "Z01-", "bit 5, b")        \
+    X(0x69, bit_5_c, NONE, 0, 8, 8, "Z01-", "bit 5, c")        \
+    X(0x6a, bit_5_d, NONE, 0, 8, 8, "Z01-", "bit 5, d")        \
+    X(0x6b, bit_5_e, NONE, 0, 8, 8, "Z01-", "bit 5, e")        \
+    X(0x6c, bit_5_h, NONE, 0, 8, 8, "Z01-", "bit 6, h")        \
+    X(0x6d, bit_5_l, NONE, 0, 8, 8, "Z01-", "bit 6, l")        \
+    X(0x6e, bit_5_hlp, NONE, 0, 12, 12, "Z01-", "bit 5, (hl)") \
+    X(0x6f, bit_5_a, NONE, 0, 8, 8, "Z01-", "bit 5, a")        \
+    X(0x70, bit_6_b, NONE, 0, 8, 8, "Z01-", "bit 6, b")        \
+    X(0x71, bit_6_c, NONE, 0, 8, 8, "Z01-", "bit 6, c")        \
+    X(0x72, bit_6_d, NONE, 0, 8, 8, "Z01-", "bit 6, d")        \
+    X(0x73, bit_6_e, NONE, 0, 8, 8, "Z01-", "bit 6, e")        \
+    X(0x74, bit_6_h, NONE, 0, 8, 8, "Z01-", "bit 6, h")        \
+    X(0x75, bit_6_l, NONE, 0, 8, 8, "Z01-", "bit 6, l")        \
+    X(0x76, bit_6_hlp, NONE, 0, 12, 12, "Z01-", "bit 6, (hl)") \
+    X(0x77, bit_6_a, NONE, 0, 8, 8, "Z01-", "bit 6, a")        \
+    X(0x78, bit_7_b, NONE, 0, 8, 8, "Z01-", "bit 7, b")        \
+    X(0x79, bit_7_c, NONE, 0, 8, 8, "Z01-", "bit 7, c")        \
+    X(0x7a, bit_7_d, NONE, 0, 8, 8, "Z01-", "bit 7, d")        \
+    X(0x7b, bit_7_e, NONE, 0, 8, 8, "Z01-", "bit 7, e")        \
+    X(0x7c, bit_7_h, NONE, 0, 8, 8, "Z01-", "bit 7, h")        \
+    X(0x7d, bit_7_l, NONE, 0, 8, 8, "Z01-", "bit 7, l")        \
+    X(0x7e, bit_7_hlp, NONE, 0, 12, 12, "Z01-", "bit 7, (hl)") \
+    X(0x7f, bit_7_a, NONE, 0, 8, 8, "Z01-", "bit 7, a")        \
+    X(0x80, res_0_b, NONE, 0, 8, 8, "----", "res 0, b")        \
+    X(0x81, res_0_c, NONE, 0, 8, 8, "----", "res 0, c")        \
+    X(0x82, res_0_d, NONE, 0, 8, 8, "----", "res 0, d")        \
+    X(0x83, res_0_e, NONE, 0, 8, 8, "----", "res 0, e")        \
+    X(0x84, res_0_h, NONE, 0, 8, 8, "----", "res 0, h")        \
+    X(0x85, res_0_l, NONE, 0, 8, 8, "----", "res 0, l")        \
+    X(0x86, res_0_hlp, NONE, 0, 16, 16, "----", "res 0, (hl)") \
+    X(0x87, res_0_a, NONE, 0, 8, 8, "----", "res 0, a")        \
+    X(0x88, res_1_b, NONE, 0, 8, 8, "----", "res 1, b")        \
+    X(0x89, res_1_c, NONE, 0, 8, 8, "----", "res 1, c")        \
+    X(0x8a, res_1_d, NONE, 0, 8, 8, "----", "res 1, d")        \
+    X(0x8b, res_1_e, NONE, 0, 8, 8, "----", "res 1, e")        \
+    X(0x8c, res_1_h, NONE, 0, 8, 8, "----", "res 1, h")        \
+    X(0x8d, res_1_l, NONE, 0, 8, 8, "----", "res 1, l")        \
+    X(0x8e, res_1_hlp, NONE, 0, 16, 16, "----", "res 1, (hl)") \
+    X(0x8f, res_1_a, NONE, 0, 8, 8, "----", "res 1, a")        \
+    X(0x90, res_2_b, NONE, 0, 8, 8, "----", "res 2, b")        \
+    X(0x91, res_2_c, NONE, 0, 8, 8, "----", "res 2, c")        \
+    X(0x92, res_2_d, NONE, 0, 8, 8, "----", "res 2, d")        \
+    X(0x93, res_2_e, NONE, 0, 8, 8, "----", "res 2, e")        \
+    X(0x94, res_2_h, NONE, 0, 8, 8, "----", "res 2, h")        \
+    X(0x95, res_2_l, NONE, 0, 8, 8, "----", "res 2, l")        \
+    X(0x96, res_2_hlp, NONE, 0, 16, 16, "----", "res 2, (hl)") \
+    X(0x97, res_2_a, NONE, 0, 8, 8, "----", "res 2, a")        \
+    X(0x98, res_3_b, NONE, 0, 8, 8, "----", "res 3, b")        \
+    X(0x99, res_3_c, NONE, 0, 8, 8, "----", "res 3, c")        \
+    X(0x9a, res_3_d, NONE, 0, 8, 8, "----", "res 3, d")        \
+    X(0x9b, res_3_e, NONE, 0, 8, 8, "----", "res 3, e")        \
+    X(0x9c, res_3_h, NONE, 0, 8, 8, "----", "res 3, h")        \
+    X(0x9d, res_3_l, NONE, 0, 8, 8, "----", "res 3, l")        \
+    X(0x9e, res_3_hlp, NONE, 0, 16, 16, "----", "res 3, (hl)") \
+    X(0x9f, res_3_a, NONE, 0, 8, 8, "----", "res 3, a")        \
+    X(0xa0, res_4_b, NONE, 0, 8, 8, "----", "res 4, b")        \
+    X(0xa1, res_4_c, NONE, 0, 8, 8, "----", "res 4, c")        \
+    X(0xa2, res_4_d, NONE, 0, 8, 8, "----", "res 4, d")        \
+    X(0xa3, res_4_e, NONE, 0, 8, 8, "----", "res 4, e")        \
+    X(0xa4, res_4_h, NONE, 0, 8, 8, "----", "res 4, h")        \
+    X(0xa5, res_4_l, NONE, 0, 8, 8, "----", "res 4, l")        \
+    X(0xa6, res_4_hlp, NONE, 0, 16, 16, "----", "res 4, (hl)") \
+    X(0xa7, res_4_a, NONE, 0, 8, 8, "----", "res 4, a")        \
+    X(0xa8, res_5_b, NONE, 0, 8, 8, "----", "res 5, b")        \
+    X(0xa9, res_5_c, NONE, 0, 8, 8, "----", "res 5, c")        \
+    X(0xaa, res_5_d, NONE, 0, 8, 8, "----", "res 5, d")        \
+    X(0xab, res_5_e, NONE, 0, 8, 8, "----", "res 5, e")        \
+    X(0xac, res_5_h, NONE, 0, 8, 8, "----", "res 5, h")        \
+    X(0xad, res_5_l, NONE, 0, 8, 8, "----", "res 5, l")        \
+    X(0xae, res_5_hlp, NONE, 0, 16, 16, "----", "res 5, (hl)") \
+    X(0xaf, res_5_a, NONE, 0, 8, 8, "----", "res 5, a")        \
+    X(0xb0, res_6_b, NONE, 0, 8, 8, "----", "res 6, b")        \
+    X(0xb1, res_6_c, NONE, 0, 8, 8, "----", "res 6, c")        \
+    X(0xb2, res_6_d, NONE, 0, 8, 8, "----", "res 6, d")        \
+    X(0xb3, res_6_e, NONE, 0, 8, 8, "----", "res 6, e")        \
+    X(0xb4, res_6_h, NONE, 0, 8, 8, "----", "res 6, h")        \
+    X(0xb5, res_6_l, NONE, 0, 8, 8, "----", "res 6, l")        \
+    X(0xb6, res_6_hlp, NONE, 0, 16, 16, "----", "res 6, (hl)") \
+    X(0xb7, res_6_a, NONE, 0, 8, 8, "----", "res 6, a")        \
+    X(0xb8, res_7_b, NONE, 0, 8, 8, "----", "res 7, b")        \
+    X(0xb9, res_7_c, NONE, 0, 8, 8, "----", "res 7, c")        \
+    X(0xba, res_7_d, NONE, 0, 8, 8, "----", "res 7, d")        \
+    X(0xbb, res_7_e, NONE, 0, 8, 8, "----", "res 7, e")        \
+    X(0xbc, res_7_h, NONE, 0, 8, 8, "----", "res 7, h")        \
+    X(0xbd, res_7_l, NONE, 0, 8, 8, "----", "res 7, l")        \
+    X(0xbe, res_7_hlp, NONE, 0, 16, 16, "----", "res 7, (hl)") \
+    X(0xbf, res_7_a, NONE, 0, 8, 8, "----", "res 7, a")        \
+    X(0xc0, set_0_b, NONE, 0, 8, 8, "----", "set 0, b")        \
+    X(0xc1, set_0_c, NONE, 0, 8, 8, "----", "set 0, c")        \
+    X(0xc2, set_0_d, NONE, 0, 8, 8, "----", "set 0, d")        \
+    X(0xc3, set_0_e, NONE, 0, 8, 8, "----", "set 0, e")        \
+    X(0xc4, set_0_h, NONE, 0, 8, 8, "----", "set 0, h")        \
+    X(0xc5, set_0_l, NONE, 0, 8, 8, "----", "set 0, l")        \
+    X(0xc6, set_0_hlp, NONE, 0, 16, 16, "----", "set 0, (hl)") \
+    X(0xc7, set_0_a, NONE, 0, 8, 8, "----", "set 0, a")        \
+    X(0xc8, set_1_b, NONE, 0, 8, 8, "----", "set 1, b")        \
+    X(0xc9, set_1_c, NONE, 0, 8, 8, "----", "set 1, c")        \
+    X(0xca, set_1_d, NONE, 0, 8, 8, "----", "set 1, d")        \
+    X(0xcb, set_1_e, NONE, 0, 8, 8, "----", "set 1, e")        \
+    X(0xcc, set_1_h, NONE, 0, 8, 8, "----", "set 1, h")        \
+    X(0xcd, set_1_l, NONE, 0, 8, 8, "----", "set 1, l")        \
+    X(0xce, set_1_hlp, NONE, 0, 16, 16, "----", "set 1, (hl)") \
+    X(0xcf, set_1_a, NONE, 0, 8, 8, "----", "set 1, a")        \
+    X(0xd0, set_2_b, NONE, 0, 8, 8, "----", "set 2, b")        \
+    X(0xd1, set_2_c, NONE, 0, 8, 8, "----", "set 2, c")        \
+    X(0xd2, set_2_d, NONE, 0, 8, 8, "----", "set 2, d")        \
+    X(0xd3, set_2_e, NONE, 0, 8, 8, "----", "set 2, e")        \
+    X(0xd4, set_2_h, NONE, 0, 8, 8, "----", "set 2, h")        \
+    X(0xd5, set_2_l, NONE, 0, 8, 8, "----", "set 2, l")        \
+    X(0xd6, set_2_hlp, NONE, 0, 16, 16, "----", "set 2, (hl)") \
+    X(0xd7, set_2_a, NONE, 0, 8, 8, "----", "set 2, a")        \
+    X(0xd8, set_3_b, NONE, 0, 8, 8, "----", "set 3, b")        \
+    X(0xd9, set_3_c, NONE, 0, 8, 8, "----", "set 3, c")        \
+    X(0xda, set_3_d, NONE, 0, 8, 8, "----", "set 3, d")        \
+    X(0xdb, set_3_e, NONE, 0, 8, 8, "----", "set 3, e")        \
+    X(0xdc, set_3_h, NONE, 0, 8, 8, "----", "set 3, h")        \
+    X(0xdd, set_3_l, NONE, 0, 8, 8, "----", "set 3, l")        \
+    X(0xde, set_3_hlp, NONE, 0, 16, 16, "----", "set 3, (hl)") \
+    X(0xdf, set_3_a, NONE, 0, 8, 8, "----", "set 3, a")        \
+    X(0xe0, set_4_b, NONE, 0, 8, 8, "----", "set 4, b")        \
+    X(0xe1, set_4_c, NONE, 0, 8, 8, "----", "set 4, c")        \
+    X(0xe2, set_4_d, NONE, 0, 8, 8, "----", "set 4, d")        \
+    X(0xe3, set_4_e, NONE, 0, 8, 8, "----", "set 4, e")        \
+    X(0xe4, set_4_h, NONE, 0, 8, 8, "----", "set 4, h")        \
+    X(0xe5, set_4_l, NONE, 0, 8, 8, "----", "set 4, l")        \
+    X(0xe6, set_4_hlp, NONE, 0, 16, 16, "----", "set 4, (hl)") \
+    X(0xe7, set_4_a, NONE, 0, 8, 8, "----", "set 4, a")        \
+    X(0xe8, set_5_b, NONE, 0, 8, 8, "----", "set 5, b")        \
+    X(0xe9, set_5_c, NONE, 0, 8, 8, "----", "set 5, c")        \
+    X(0xea, set_5_d, NONE, 0, 8, 8, "----", "set 5, d")        \
+    X(0xeb, set_5_e, NONE, 0, 8, 8, "----", "set 5, e")        \
+    X(0xec, set_5_h, NONE, 0, 8, 8, "----", "set 5, h")        \
+    X(0xed, set_5_l, NONE, 0, 8, 8, "----", "set 5, l")        \
+    X(0xee, set_5_hlp, NONE, 0, 16, 16, "----", "set 5, (hl)") \
+    X(0xef, set_5_a, NONE, 0, 8, 8, "----", "set 5, a")        \
+    X(0xf0, set_6_b, NONE, 0, 8, 8, "----", "set 6, b")        \
+    X(0xf1, set_6_c, NONE, 0, 8, 8, "----", "set 6, c")        \
+    X(0xf2, set_6_d, NONE, 0, 8, 8, "----", "set 6, d")        \
+    X(0xf3, set_6_e, NONE, 0, 8, 8, "----", "set 6, e")        \
+    X(0xf4, set_6_h, NONE, 0, 8, 8, "----", "set 6, h")        \
+    X(0xf5, set_6_l, NONE, 0, 8, 8, "----", "set 6, l")        \
+    X(0xf6, set_6_hlp, NONE, 0, 16, 16, "----", "set 6, (hl)") \
+    X(0xf7, set_6_a, NONE, 0, 8, 8, "----", "set 6, a")        \
+    X(0xf8, set_7_b, NONE, 0, 8, 8, "----", "set 7, b")        \
+    X(0xf9, set_7_c, NONE, 0, 8, 8, "----", "set 7, c")        \
+    X(0xfa, set_7_d, NONE, 0, 8, 8, "----", "set 7, d")        \
+    X(0xfb, set_7_e, NONE, 0, 8, 8, "----", "set 7, e")        \
+    X(0xfc, set_7_h, NONE, 0, 8, 8, "----", "set 7, h")        \
+    X(0xfd, set_7_l, NONE, 0, 8, 8, "----", "set 7, l")        \
+    X(0xfe, set_7_hlp, NONE, 0, 16, 16, "----", "set 7, (hl)") \
+    X(0xff, set_7_a, NONE, 0, 8, 8, "----", "set 7, a")
+
+#endif /* CPU_OPS_H */
@@ -27,11 +27,11 @@ enum map_type {
 static int selected_map = MAP_AUTO;
 static char *map_name[] = {"auto", "9800", "9C00"};
 
-static int get_map_offset(void)
+static int get_map_offset(gb_t *gb)
 {
     switch (selected_map) {
         case MAP_AUTO:
-            return (gpu_read_lcdc() & 0x8) ? 0x1c00 : 0x1800;
+            return (gpu_read_lcdc(gb) & 0x8) ? 0x1c00 : 0x1800;
         case MAP_9800:
             return 0x1800;
         case MAP_9C00:
@@ -40,18 +40,18 @@ static int get_map_offset(void)
     return 0;
 }
 
-static void update_framebuffer(void)
+static void update_framebuffer(gb_t *gb)
 {
-    color_t *bg_palette = gpu_get_bg_palette();
-    int mapoffs = get_map_offset();
+    color_t *bg_palette = gpu_get_bg_palette(gb);
+    int mapoffs = get_map_offset(gb);
     /* 32 x 32 tiles */
     for (int my = 0; my < 32; ++my) {
         for (int mx = 0; mx < 32; ++mx) {
-            int tile_id = gpu_get_tile_id(mapoffs);
-            bg_attr_t attr = gpu_get_tile_attributes(mapoffs);
+            int tile_id = gpu_get_tile_id(gb, mapoffs);
+            bg_attr_t attr = gpu_get_tile_attributes(gb, mapoffs);
             /* 8 x 8 pixels */
             for (int ty = 0; ty < 8; ++ty) {
-                tile_line_t line = gpu_get_tile_line(attr, tile_id, ty);
+                tile_line_t line = gpu_get_tile_line(gb, attr, tile_id, ty);
                 for (int tx = 0; tx < 8; ++tx) {
                     int c = gpu_get_tile_color(line, tx, attr.hflip);
                     int i = 256 * 8 * my + 8 * mx + 256 * ty + tx;
@@ -64,10 +64,10 @@ static void update_framebuffer(void)
     }
 }
 
-static void update_scroll(void)
+static void update_scroll(gb_t *gb)
 {
-    int x = gpu_read_scx();
-    int y = gpu_read_scy();
+    int x = gpu_read_scx(gb);
+    int y = gpu_read_scy(gb);
     scroll_rect1.x = x * 2;
     scroll_rect1.y = y * 2;
     scroll_rect2.x = scroll_rect1.x;
@@ -80,7 +80,7 @@ static void update_scroll(void)
     }
 }
 
-int bg_map_window_init(void)
+int bg_map_window_init(gb_t *gb)
 {
     int width = BG_MAP_WIN_WIDTH;
     int height = BG_MAP_WIN_HEIGHT;
@@ -111,8 +111,8 @@ int bg_map_window_init(void)
 
     window_id = SDL_GetWindowID(window);
     selected_map = MAP_AUTO;
-    update_framebuffer();
-    update_scroll();
+    update_framebuffer(gb);
+    update_scroll(gb);
 
     return 0;
 }
@@ -151,14 +151,14 @@ void bg_map_window_render(void)
     SDL_RenderPresent(renderer);
 }
 
-static void select_map_tile(int x, int y)
+static void select_map_tile(gb_t *gb, int x, int y)
 {
     int mx = x / 16;
     int my = y / 16;
-    int mapoffs = get_map_offset() + my * 32 + mx;
-    int tile_id = gpu_get_tile_id(mapoffs);
+    int mapoffs = get_map_offset(gb) + my * 32 + mx;
+    int tile_id = gpu_get_tile_id(gb, mapoffs);
     int tile_addr = 0x8000 + (tile_id << 4);
-    bg_attr_t attr = gpu_get_tile_attributes(mapoffs);
+    bg_attr_t attr = gpu_get_tile_attributes(gb, mapoffs);
     map_tile_rect.x = mx * 16;
     map_tile_rect.y = my * 16;
     map_tile_selected = true;
@@ -168,7 +168,7 @@ static void select_map_tile(int x, int y)
            attr.pal_number, attr.vram_bank, attr.hflip, attr.vflip,
            attr.priority);
     for (int i = 0; i < 8; ++i) {
-        tile_line_t line = gpu_get_tile_line(attr, tile_id, i);
+        tile_line_t line = gpu_get_tile_line(gb, attr, tile_id, i);
         printf("%.2hhx %.2hhx ", line.data_h, line.data_l);
         for (int j = 0; j < 8; ++j) {
             int color_num = gpu_get_tile_color(line, j, attr.hflip);
@@ -178,32 +178,32 @@ static void select_map_tile(int x, int y)
     }
 }
 
-static void change_map(enum map_type type)
+static void change_map(gb_t *gb, enum map_type type)
 {
     selected_map = type;
     map_tile_selected = false;
-    update_framebuffer();
+    update_framebuffer(gb);
     printf("Map selected: %s\n", map_name[type]);
 }
 
-void bg_map_window_handle_events(SDL_Event *e)
+void bg_map_window_handle_events(gb_t *gb, SDL_Event *e)
 {
     switch (e->type) {
         case SDL_MOUSEBUTTONUP:
             if (e->button.windowID == window_id) {
-                select_map_tile(e->button.x, e->button.y);
+                select_map_tile(gb, e->button.x, e->button.y);
             }
             break;
         case SDL_KEYUP:
             switch (e->key.keysym.scancode) {
                 case SDL_SCANCODE_1:
-                    change_map(MAP_AUTO);
+                    change_map(gb, MAP_AUTO);
                     break;
                 case SDL_SCANCODE_2:
-                    change_map(MAP_9800);
+                    change_map(gb, MAP_9800);
                     break;
                 case SDL_SCANCODE_3:
-                    change_map(MAP_9C00);
+                    change_map(gb, MAP_9C00);
                     break;
                 default:
                     break;
@@ -4,9 +4,11 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
-int bg_map_window_init(void);
+typedef struct gb gb_t;
+
+int bg_map_window_init(gb_t *gb);
 void bg_map_window_finish(void);
 void bg_map_window_render(void);
-void bg_map_window_handle_events(SDL_Event *e);
+void bg_map_window_handle_events(gb_t *gb, SDL_Event *e);
 
 #endif /* BG_MAP_WINDOW_H */
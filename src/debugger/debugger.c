@@ -13,7 +13,7 @@ enum debugger_windows {
 static enum debugger_windows windows;
 static TTF_Font *font;
 
-int debugger_init(void)
+int debugger_init(gb_t *gb)
 {
     SDL_DisplayMode dm;
     SDL_GetCurrentDisplayMode(0, &dm);
@@ -28,17 +28,17 @@ int debugger_init(void)
         return -1;
     }
     windows = DEBUGGER_BG_MAP | DEBUGGER_PALETTE | DEBUGGER_TILES;
-    if (bg_map_window_init() != 0) {
+    if (bg_map_window_init(gb) != 0) {
         TTF_CloseFont(font);
         TTF_Quit();
         return -1;
     }
-    if (palette_window_init(&dm, font) != 0) {
+    if (palette_window_init(gb, &dm, font) != 0) {
         TTF_CloseFont(font);
         TTF_Quit();
         return -1;
     }
-    if (tile_window_init(&dm) != 0) {
+    if (tile_window_init(gb, &dm) != 0) {
         TTF_CloseFont(font);
         TTF_Quit();
         return -1;
@@ -68,10 +68,10 @@ void debugger_render(void)
         tile_window_render();
 }
 
-void debugger_handle_events(SDL_Event *e)
+void debugger_handle_events(gb_t *gb, SDL_Event *e)
 {
     if (windows & DEBUGGER_BG_MAP)
-        bg_map_window_handle_events(e);
+        bg_map_window_handle_events(gb, e);
     if (windows & DEBUGGER_TILES)
         tile_window_handle_events(e);
 }
@@ -3,9 +3,11 @@
 
 #include <SDL2/SDL.h>
 
-int debugger_init(void);
+typedef struct gb gb_t;
+
+int debugger_init(gb_t *gb);
 void debugger_finish(void);
 void debugger_render(void);
-void debugger_handle_events(SDL_Event *e);
+void debugger_handle_events(gb_t *gb, SDL_Event *e);
 
 #endif /* DEBUGGER_H */
@@ -14,7 +14,7 @@ static SDL_Color color = {0, 0, 0, 0};
 static text_t *bg_label[8];
 static text_t *obj_label[8];
 
-int palette_window_init(SDL_DisplayMode *dm, TTF_Font *font)
+int palette_window_init(gb_t *gb, SDL_DisplayMode *dm, TTF_Font *font)
 {
     int width = PALETTE_WIN_WIDTH;
     int height = PALETTE_WIN_HEIGHT;
@@ -34,8 +34,8 @@ int palette_window_init(SDL_DisplayMode *dm, TTF_Font *font)
         return -1;
     }
 
-    color_t *bg_palette = gpu_get_bg_palette();
-    color_t *obj_palette = gpu_get_sprite_palette();
+    color_t *bg_palette = gpu_get_bg_palette(gb);
+    color_t *obj_palette = gpu_get_sprite_palette(gb);
 
     for (int i = 0; i < 8; ++i) {
         char str[30];
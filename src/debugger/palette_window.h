@@ -4,7 +4,9 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
-int palette_window_init(SDL_DisplayMode *dm, TTF_Font *font);
+typedef struct gb gb_t;
+
+int palette_window_init(gb_t *gb, SDL_DisplayMode *dm, TTF_Font *font);
 void palette_window_finish(void);
 void palette_window_render(void);
 
@@ -16,38 +16,38 @@ static color_t framebuffer[TEXTURE_WIDTH * TEXTURE_HEIGHT];
 static bool tile_selected = false;
 static SDL_Rect tile_rect = {0, 0, 16, 16};
 
-static int get_map_offset(void)
+static int get_map_offset(gb_t *gb)
 {
-    uint8_t lcdc = gpu_read_lcdc();
+    uint8_t lcdc = gpu_read_lcdc(gb);
     return (lcdc & 0x8) ? 0x1c00 : 0x1800;
 }
 
-static bg_attr_t search_map_for_attr(int tile_id)
+static bg_attr_t search_map_for_attr(gb_t *gb, int tile_id)
 {
     bg_attr_t attr = {0};
-    int mapoffs = get_map_offset();
+    int mapoffs = get_map_offset(gb);
     int end = mapoffs + 32 * 32;
     while (mapoffs < end) {
-        if (tile_id == gpu_get_tile_id(mapoffs))
-            return gpu_get_tile_attributes(mapoffs);
+        if (tile_id == gpu_get_tile_id(gb, mapoffs))
+            return gpu_get_tile_attributes(gb, mapoffs);
         ++mapoffs;
     }
     return attr;
 }
 
-static void update_framebuffer(void)
+static void update_framebuffer(gb_t *gb)
 {
-    color_t *bg_palette = gpu_get_bg_palette();
+    color_t *bg_palette = gpu_get_bg_palette(gb);
     int row = 0, column = 0;
     for (int tile_id = 0; tile_id < 384; ++tile_id) {
-        bg_attr_t attr = search_map_for_attr(tile_id);
+        bg_attr_t attr = search_map_for_attr(gb, tile_id);
         if (column == 16) {
             ++row;
             column = 0;
         }
         for (int ty = 0; ty < 8; ++ty) {
             attr.vram_bank = 0;
-            tile_line_t line = gpu_get_tile_line(attr, tile_id, ty);
+            tile_line_t line = gpu_get_tile_line(gb, attr, tile_id, ty);
             int i = TEXTURE_WIDTH * 8 * row + 8 * column + TEXTURE_WIDTH * ty;
             for (int tx = 0; tx < 8; ++tx) {
                 int c = gpu_get_tile_color(line, tx, attr.hflip);
@@ -55,7 +55,7 @@ static void update_framebuffer(void)
                 framebuffer[i + tx] = bg_palette[pal_idx];
             }
             attr.vram_bank = 1;
-            line = gpu_get_tile_line(attr, tile_id, ty);
+            line = gpu_get_tile_line(gb, attr, tile_id, ty);
             for (int tx = 0; tx < 8; ++tx) {
                 int c = gpu_get_tile_color(line, tx, attr.hflip);
                 int pal_idx = ((int)attr.pal_number << 2) + c;
@@ -66,7 +66,7 @@ static void update_framebuffer(void)
     }
 }
 
-int tile_window_init(SDL_DisplayMode *dm)
+int tile_window_init(gb_t *gb, SDL_DisplayMode *dm)
 {
     int width = TILE_WIN_WIDTH;
     int height = TILE_WIN_HEIGHT;
@@ -96,7 +96,7 @@ int tile_window_init(SDL_DisplayMode *dm)
     }
 
     window_id = SDL_GetWindowID(window);
-    update_framebuffer();
+    update_framebuffer(gb);
 
     return 0;
 }
@@ -3,7 +3,9 @@
 
 #include <SDL2/SDL.h>
 
-int tile_window_init(SDL_DisplayMode *dm);
+typedef struct gb gb_t;
+
+int tile_window_init(gb_t *gb, SDL_DisplayMode *dm);
 void tile_window_finish(void);
 void tile_window_render(void);
 void tile_window_handle_events(SDL_Event *e);
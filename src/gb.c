@@ -0,0 +1,243 @@
+#include "gb.h"
+#include <stdlib.h>
+#include <string.h>
+
+gb_t *gb_create(const char *rom_path)
+{
+    gb_t *gb = calloc(1, sizeof(gb_t));
+    if (gb == NULL)
+        return NULL;
+    if (cpu_init(gb, rom_path) < 0) {
+        free(gb);
+        return NULL;
+    }
+    return gb;
+}
+
+gb_t *gb_create_shared(const gb_t *src)
+{
+    gb_t *gb = calloc(1, sizeof(gb_t));
+    if (gb == NULL)
+        return NULL;
+    if (cpu_init_shared(gb, src) < 0) {
+        free(gb);
+        return NULL;
+    }
+    return gb;
+}
+
+int gb_load_shared(gb_t *gb, const gb_t *src)
+{
+    gb_video_cb_f video_cb = gb->video_cb;
+    void *video_data = gb->video_data;
+    gb_audio_cb_f audio_cb = gb->audio_cb;
+    void *audio_data = gb->audio_data;
+    bool trace = gb->trace;
+    gb_rewind_disable(gb);
+    cpu_finish(gb);
+    memset(gb, 0, sizeof(*gb));
+    gb_set_video_sink(gb, video_cb, video_data);
+    gb_set_audio_sink(gb, audio_cb, audio_data);
+    gb_set_trace(gb, trace);
+    return cpu_init_shared(gb, src);
+}
+
+gb_t *gb_fork(const gb_t *src)
+{
+    gb_t *gb = malloc(sizeof(gb_t));
+    if (gb == NULL)
+        return NULL;
+    *gb = *src;
+    mmu_fork(gb, src);
+    gb->rewind = NULL;
+    gb->movie = NULL;
+    gb_set_video_sink(gb, NULL, NULL);
+    gb_set_audio_sink(gb, NULL, NULL);
+    return gb;
+}
+
+void gb_destroy(gb_t *gb)
+{
+    gb_rewind_disable(gb);
+    cpu_finish(gb);
+    free(gb);
+}
+
+void gb_reset(gb_t *gb)
+{
+    /* Resets the memory and devices too. */
+    cpu_reset(gb);
+}
+
+unsigned int gb_step(gb_t *gb)
+{
+    uint64_t cycles = gb->clock.cycles;
+    cpu_emulate_cycle(gb);
+    return (unsigned int)(gb->clock.cycles - cycles);
+}
+
+uint64_t gb_run_cycles(gb_t *gb, uint64_t cycles)
+{
+    uint64_t elapsed = 0;
+    while (elapsed < cycles)
+        elapsed += cpu_run(gb, cycles - elapsed);
+    return elapsed;
+}
+
+uint64_t gb_run_frames(gb_t *gb, unsigned int frames)
+{
+    uint64_t elapsed = 0;
+    unsigned int target = gb->gpu.frames + frames;
+    while (gb->gpu.frames != target)
+        elapsed += cpu_run(gb, UINT64_MAX);
+    return elapsed;
+}
+
+uint64_t gb_run_ahead(gb_t *gb, unsigned int frames)
+{
+    gb_video_cb_f video_cb = gb->video_cb;
+    if (frames == 0 || video_cb == NULL)
+        return gb_run_frames(gb, 1);
+    gb->video_cb = NULL;
+    uint64_t cycles = gb_run_frames(gb, 1);
+    gb->video_cb = video_cb;
+    gb_t *ahead = gb_fork(gb);
+    if (ahead == NULL) {
+        gpu_render_framebuffer(gb);
+        return cycles;
+    }
+    gb_run_frames(ahead, frames);
+    /* Input from the sink must reach gb, not the fork. */
+    video_cb(gb, gpu_get_framebuffer(ahead), gb->video_data);
+    gb_destroy(ahead);
+    return cycles;
+}
+
+int gb_rewind_enable(gb_t *gb, size_t memory, unsigned int interval)
+{
+    gb_rewind_disable(gb);
+    gb->rewind = rewind_create(gb, memory, interval);
+    return gb->rewind != NULL ? 0 : -1;
+}
+
+void gb_rewind_disable(gb_t *gb)
+{
+    if (gb->rewind != NULL) {
+        rewind_destroy(gb->rewind);
+        gb->rewind = NULL;
+    }
+}
+
+int gb_rewind(gb_t *gb)
+{
+    rewind_t *rw = gb->rewind;
+    if (rw == NULL || rewind_pop(gb) < 0)
+        return -1;
+    gb->rewind = NULL;
+    gb_run_frames(gb, 1);
+    gb->rewind = rw;
+    return 0;
+}
+
+void gb_movie_record(gb_t *gb, movie_t *mv)
+{
+    gb->movie = NULL;
+    gb_reset(gb);
+    movie_record_start(gb, mv);
+    gb->movie = mv;
+}
+
+int gb_movie_play(gb_t *gb, movie_t *mv)
+{
+    gb->movie = NULL;
+    gb_reset(gb);
+    if (movie_play_start(gb, mv) < 0)
+        return -1;
+    gb->movie = mv;
+    return 0;
+}
+
+int gb_movie_seek(gb_t *gb, movie_t *mv, unsigned int frame)
+{
+    if (frame > movie_length(mv))
+        return -1;
+    gb->movie = NULL;
+    int from = movie_seek(gb, mv, frame);
+    if (from < 0)
+        return -1;
+    gb->movie = mv;
+    if ((unsigned int)from == frame)
+        return 0;
+    /* Catch up quietly, then draw the last frame. */
+    gb_video_cb_f video_cb = gb->video_cb;
+    gb_audio_cb_f audio_cb = gb->audio_cb;
+    gb->video_cb = NULL;
+    gb->audio_cb = NULL;
+    gb_run_frames(gb, frame - from - 1);
+    gb->video_cb = video_cb;
+    gb->audio_cb = audio_cb;
+    gb_run_frames(gb, 1);
+    return 0;
+}
+
+void gb_movie_stop(gb_t *gb)
+{
+    gb->movie = NULL;
+}
+
+bool gb_movie_playing(const gb_t *gb)
+{
+    return gb->movie != NULL && movie_playing(gb->movie);
+}
+
+void gb_set_idle_skip(gb_t *gb, bool enable)
+{
+    atomic_store(&gb->cart.rom.image->idle_off, !enable);
+}
+
+unsigned int gb_idle_loops(const gb_t *gb, const cpu_idle_loop_t **loops)
+{
+    *loops = gb->idle.loops;
+    return gb->idle.count;
+}
+
+void gb_set_bulk_copy(gb_t *gb, bool enable)
+{
+    atomic_store(&gb->cart.rom.image->bulk_off, !enable);
+}
+
+void gb_set_jit(gb_t *gb, bool enable)
+{
+    atomic_store(&gb->cart.rom.image->jit_off, !enable);
+}
+
+void gb_set_trace(gb_t *gb, bool enable)
+{
+    gb->trace = enable;
+}
+
+uint64_t gb_frame_hash(const gb_t *gb)
+{
+    /* Hash RGB components in a fixed order, so it is the same on any host. */
+    const color_t *fb = gpu_get_framebuffer(gb);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT; ++i) {
+        const color_t *c = &fb[i];
+        hash = (hash ^ c->r) * 0x100000001b3ull;
+        hash = (hash ^ c->g) * 0x100000001b3ull;
+        hash = (hash ^ c->b) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void gb_set_video_sink(gb_t *gb, gb_video_cb_f cb, void *data)
+{
+    gb->video_cb = cb;
+    gb->video_data = data;
+}
+
+void gb_set_audio_sink(gb_t *gb, gb_audio_cb_f cb, void *data)
+{
+    gb->audio_cb = cb;
+    gb->audio_data = data;
+}
@@ -0,0 +1,200 @@
+#ifndef GB_H
+#define GB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "apu/apu.h"
+#include "cartridge/cart.h"
+#include "clock.h"
+#include "color.h"
+#include "cpu.h"
+#include "cpu_bulk.h"
+#include "cpu_idle.h"
+#include "gpu.h"
+#include "interrupt.h"
+#include "keys.h"
+#include "mmu.h"
+#include "movie.h"
+#include "rewind.h"
+#include "state.h"
+#include "timer.h"
+
+/**
+ * Public API of libgusgb.
+ *
+ * The core has no I/O of its own: frames and audio samples are handed to the
+ * sinks registered by the frontend, and input goes through key_press() and
+ * key_release().
+ */
+
+/* Called at every VBlank with the GB_SCREEN_WIDTH x GB_SCREEN_HEIGHT frame. */
+typedef void (*gb_video_cb_f)(gb_t *gb, const color_t *framebuffer,
+                              void *data);
+
+/* Called with count interleaved stereo samples at AUDIO_SAMPLE_RATE. */
+typedef void (*gb_audio_cb_f)(gb_t *gb, const int16_t *samples, size_t count,
+                              void *data);
+
+/**
+ * Emulator instance.
+ *
+ * Holds the whole state of one Game Boy. Every subsystem receives a pointer to
+ * it instead of keeping file-scope state, so several instances can run in the
+ * same process, each one on its own thread.
+ */
+struct gb {
+    cpu_t cpu;
+    gb_clock_t clock;
+    interrupt_t intr;
+    gb_timer_t timer;
+    keys_t keys;
+    mmu_t mmu;
+    gpu_t gpu;
+    apu_t apu;
+    cart_t cart;
+    cpu_idle_t idle;
+    cpu_bulk_t bulk;
+    rewind_t *rewind; /* NULL unless rewind is enabled. */
+    movie_t *movie;   /* Owned by the caller, NULL unless attached. */
+    bool trace;       /* Print every instruction, see gb_set_trace(). */
+    /* Output sinks, owned by the frontend. */
+    gb_video_cb_f video_cb;
+    void *video_data;
+    gb_audio_cb_f audio_cb;
+    void *audio_data;
+};
+
+/* Create an instance running the ROM at rom_path, NULL on error. */
+gb_t *gb_create(const char *rom_path);
+
+/* Create an instance sharing the ROM already loaded by src. */
+gb_t *gb_create_shared(const gb_t *src);
+
+/**
+ * Power cycle an existing instance with the ROM loaded by src, as if it had
+ * just been returned by gb_create_shared(). Sinks are kept, rewind history
+ * is dropped. On error the instance has no cartridge and may only be
+ * destroyed or loaded again.
+ */
+int gb_load_shared(gb_t *gb, const gb_t *src);
+
+/**
+ * Copy src at its current point of emulation. Memory is shared copy on
+ * write, so forking is cheap and src may keep running. The copy has no
+ * sinks nor rewind history and never saves cartridge RAM. Instances sharing
+ * memory may run on different threads.
+ */
+gb_t *gb_fork(const gb_t *src);
+
+/* Free the instance, saving battery backed RAM if any. */
+void gb_destroy(gb_t *gb);
+
+/* Reset to power on state, keeping the cartridge. */
+void gb_reset(gb_t *gb);
+
+/**
+ * Execute one instruction and tick the devices by the cycles it took.
+ * Returns the number of cycles. A halted CPU idles up to the next device
+ * event in one step.
+ */
+unsigned int gb_step(gb_t *gb);
+
+/**
+ * Run until at least the given number of cycles elapsed, returning the exact
+ * count. Idle cycles are skipped no further than that, so the count may only
+ * overshoot by the last instruction and an interrupt dispatch after it.
+ */
+uint64_t gb_run_cycles(gb_t *gb, uint64_t cycles);
+
+/**
+ * Run until the given number of frames completed, that is, stop right after
+ * the VBlank of the last one. Returns the cycles elapsed.
+ *
+ * Neither call waits for real time: pacing, if any, is up to the sinks.
+ */
+uint64_t gb_run_frames(gb_t *gb, unsigned int frames);
+
+/**
+ * Run one frame, but hand the video sink the picture of frames later,
+ * emulated on a fork with the keys currently held and then dropped. This
+ * hides the input lag of games that react a few frames after a key press.
+ * Audio and the state of gb are those of gb_run_frames(gb, 1).
+ */
+uint64_t gb_run_ahead(gb_t *gb, unsigned int frames);
+
+/**
+ * Record a snapshot every interval frames, using up to memory bytes. Any
+ * previous history is dropped.
+ */
+int gb_rewind_enable(gb_t *gb, size_t memory, unsigned int interval);
+void gb_rewind_disable(gb_t *gb);
+
+/**
+ * Go back to the newest snapshot and run one frame from there, without
+ * recording it, so the sinks get a picture. Each call goes further back.
+ * Returns -1 when the history is exhausted.
+ */
+int gb_rewind(gb_t *gb);
+
+/**
+ * Reset to power on and record the joypad into mv from there on, until
+ * gb_movie_stop(). mv must outlive the recording.
+ */
+void gb_movie_record(gb_t *gb, movie_t *mv);
+
+/**
+ * Reset to power on and replay the joypad from mv until its end or
+ * gb_movie_stop(). Keys must not be touched meanwhile. Returns -1 if mv is
+ * from another game.
+ */
+int gb_movie_play(gb_t *gb, movie_t *mv);
+
+/**
+ * Play mv from the start of frame, as if it had been played from power on,
+ * emulating at most one keyframe interval. Only the last frame reaches the
+ * sinks. Returns -1 if frame is past the end or mv is from another game.
+ */
+int gb_movie_seek(gb_t *gb, movie_t *mv, unsigned int frame);
+
+/* Detach the movie, if any. */
+void gb_movie_stop(gb_t *gb);
+
+/* True while a movie is being played back. */
+bool gb_movie_playing(const gb_t *gb);
+
+/**
+ * Skip idle loops, see cpu_idle.h, on by default. The setting belongs to the
+ * game: it holds for every instance sharing its ROM.
+ */
+void gb_set_idle_skip(gb_t *gb, bool enable);
+
+/* Idle loops skipped since reset, up to CPU_IDLE_LOOPS of them. */
+unsigned int gb_idle_loops(const gb_t *gb, const cpu_idle_loop_t **loops);
+
+/**
+ * Run copy and fill loops in bulk, see cpu_bulk.h, on by default. Like idle
+ * loop skipping, the setting holds for every instance sharing the ROM.
+ */
+void gb_set_bulk_copy(gb_t *gb, bool enable);
+
+/**
+ * Run ROM code compiled to x86-64, see cpu_jit.h, on by default in builds
+ * with CPU_JIT and a no-op in others. The setting holds for every instance
+ * sharing the ROM.
+ */
+void gb_set_jit(gb_t *gb, bool enable);
+
+/**
+ * Print the registers and each instruction to stdout before it runs, off by
+ * default. Builds with CPU_DEBUG turn it on in the frontend.
+ */
+void gb_set_trace(gb_t *gb, bool enable);
+
+/* 64-bit FNV-1a hash of the current framebuffer. */
+uint64_t gb_frame_hash(const gb_t *gb);
+
+void gb_set_video_sink(gb_t *gb, gb_video_cb_f cb, void *data);
+void gb_set_audio_sink(gb_t *gb, gb_audio_cb_f cb, void *data);
+
+#endif /* GB_H */
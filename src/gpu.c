@@ -1,12 +1,15 @@
 #include "gpu.h"
-#include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "cartridge/cart.h"
 #include "debug.h"
+#include "gb.h"
 #include "interrupt.h"
 #include "mmu.h"
+#include "movie.h"
+#include "rewind.h"
 
 typedef enum {
     GPU_MODE_HBLANK = 0,
@@ -32,185 +35,148 @@ typedef struct {
     };
 } sprite_t;
 
-typedef struct {
-    /* 0xff40 (LCDC): LCD Control (R/W) */
-    union {
-        uint8_t lcd_control;
-        struct {
-            uint8_t bg_display : 1;
-            uint8_t obj_enable : 1;
-            uint8_t obj_size : 1;
-            uint8_t bg_tile_map : 1;
-            uint8_t bg_tile_set : 1;
-            uint8_t window_enable : 1;
-            uint8_t window_tile_map : 1;
-            uint8_t lcd_enable : 1;
-        };
-    };
-    /* 0xff41 (STAT): LCDC Status (R/W) */
-    union {
-        uint8_t lcd_status;
-        struct {
-            uint8_t mode_flag : 2;
-            uint8_t coincidence_flag : 1;
-            uint8_t hblank_int : 1;
-            uint8_t vblank_int : 1;
-            uint8_t oam_int : 1;
-            uint8_t coincidence_int : 1;
-            uint8_t unused1 : 1;
-        };
-    };
-    /* 0xff42 (SCY): Scroll Y (R/W) */
-    uint8_t scroll_y;
-    /* 0xff43 (SCX): Scroll X (R/W) */
-    uint8_t scroll_x;
-    /* 0xff44 (LY): LCDC Y-Coordinate (R) */
-    uint8_t scanline;
-    /* 0xff45 (LYC): LY Compare (R/W) */
-    uint8_t lyc;
-    /* 0xff46 (DMA): DMA Transfer and Start Address (R/W) */
-    struct {
-        uint8_t reg;
-        bool enabled;
-        bool started;
-        int byte;
-        int clock;
-    } oam_dma;
-    /* 0xff47 (BGP): BG Palette Data (R/W) - Non CGB */
-    uint8_t bgp;
-    /* 0xff48 (OBP0): Object Palette 0 Data (R/W) - Non CGB */
-    uint8_t obp0;
-    /* 0xff49 (OBP1): Object Palette 1 Data (R/W) - Non CGB */
-    uint8_t obp1;
-    /* 0xff4a (WY): Window Y Position (R/W) */
-    uint8_t window_y;
-    /* 0xff4b (WX): Window X Position minus 7 (R/W) */
-    uint8_t window_x;
-    /* 0xff4f (VBK): VRAM Bank - CGB only */
-    uint8_t vram_bank;
-    /* 0xff68 (BGPI): Background Palette Index - CGB only */
-    uint8_t cgb_bg_pal_idx;
-    /* 0xff69 (BGPD): Background Palette Data - CGB only */
-    uint8_t cgb_bg_pal_data[8 * 8];
-    /* 0xff6a (OBPI): Sprite Palette Index - CGB only */
-    uint8_t cgb_sprite_pal_idx;
-    /* 0xff6b (OBPD): Sprite Palette Data - CGB only*/
-    uint8_t cgb_sprite_pal_data[8 * 8];
-    unsigned int modeclock;
-    uint8_t vram[2][0x2000]; /* Video RAM. */
-    uint8_t oam[0xa0];       /* Sprite info. */
-    color_t framebuffer[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
-    color_t bg_palette[8 * 4];
-    color_t sprite_palette[8 * 4];
-    color_t bg_palette_data[8 * 4];
-    color_t sprite_palette_data[8 * 4];
-    unsigned int speed;
-    bool lcd_disabled_frame_rendered;
-    unsigned int lcd_disabled_clock;
-    int wy_cnt; /* Number of window lines draw. */
-} gpu_t;
-
-typedef struct {
-    render_callback_t cb;
-    SDL_Renderer *ren;
-    SDL_Texture *tex;
-} gpu_gl_t;
-
-static gpu_t GPU;
-static gpu_gl_t GPU_GL;
-
 static const color_t dmg_palette[4] = {
-#if (SDL_BYTE_ORDER == SDL_BIG_ENDIAN)
-    {SDL_ALPHA_OPAQUE, 0xe0, 0xf8, 0xd0}, /* off */
-    {SDL_ALPHA_OPAQUE, 0x88, 0xc0, 0x70}, /* 33% on */
-    {SDL_ALPHA_OPAQUE, 0x34, 0x68, 0x56}, /* 66% on */
-    {SDL_ALPHA_OPAQUE, 0x00, 0x00, 0x00}, /* on */
+#if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    {COLOR_ALPHA_OPAQUE, 0xe0, 0xf8, 0xd0}, /* off */
+    {COLOR_ALPHA_OPAQUE, 0x88, 0xc0, 0x70}, /* 33% on */
+    {COLOR_ALPHA_OPAQUE, 0x34, 0x68, 0x56}, /* 66% on */
+    {COLOR_ALPHA_OPAQUE, 0x00, 0x00, 0x00}, /* on */
 #else
-    {0xd0, 0xf8, 0xe0, SDL_ALPHA_OPAQUE}, /* off */
-    {0x70, 0xc0, 0x88, SDL_ALPHA_OPAQUE}, /* 33% on */
-    {0x56, 0x68, 0x34, SDL_ALPHA_OPAQUE}, /* 66% on */
-    {0x00, 0x00, 0x00, SDL_ALPHA_OPAQUE}, /* on */
+    {0xd0, 0xf8, 0xe0, COLOR_ALPHA_OPAQUE}, /* off */
+    {0x70, 0xc0, 0x88, COLOR_ALPHA_OPAQUE}, /* 33% on */
+    {0x56, 0x68, 0x34, COLOR_ALPHA_OPAQUE}, /* 66% on */
+    {0x00, 0x00, 0x00, COLOR_ALPHA_OPAQUE}, /* on */
 #endif
 };
 
-int gpu_init(SDL_Renderer *ren, SDL_Texture *tex, render_callback_t cb)
+void gpu_init(gb_t *gb)
+{
+    gb->gpu.vram[0] = page_create(GPU_VRAM_BANK_SIZE);
+    gb->gpu.vram[1] = page_create(GPU_VRAM_BANK_SIZE);
+    gb->gpu.framebuffer = page_create(GPU_FRAMEBUFFER_SIZE);
+}
+
+void gpu_fork(gb_t *gb, const gb_t *src)
+{
+    gb->gpu.vram[0] = page_ref(src->gpu.vram[0]);
+    gb->gpu.vram[1] = page_ref(src->gpu.vram[1]);
+    gb->gpu.framebuffer = page_ref(src->gpu.framebuffer);
+}
+
+void gpu_finish(gb_t *gb)
+{
+    page_unref(gb->gpu.vram[0]);
+    page_unref(gb->gpu.vram[1]);
+    page_unref(gb->gpu.framebuffer);
+    gb->gpu.vram[0] = gb->gpu.vram[1] = gb->gpu.framebuffer = NULL;
+}
+
+/* Writable framebuffer, copied first if shared with a fork. */
+static inline color_t *gpu_fb_write(gpu_t *gpu)
+{
+    return (color_t *)page_write(&gpu->framebuffer);
+}
+
+static inline const uint8_t *gpu_vram(gpu_t *gpu, unsigned int bank)
 {
-    gpu_reset();
-    assert(cb != NULL);
-    GPU_GL.cb = cb;
-    GPU_GL.ren = ren;
-    GPU_GL.tex = tex;
-    SDL_SetRenderDrawColor(GPU_GL.ren, 0, 0, 0, SDL_ALPHA_OPAQUE);
-    return 0;
+    return gpu->vram[bank]->bytes;
 }
 
-void gpu_reset(void)
+static void render_scanline_dmg(gb_t *gb);
+static void render_scanline_cgb(gb_t *gb);
+
+void gpu_reset(gb_t *gb)
 {
-    memset(&GPU, 0, sizeof(GPU));
-    GPU.lcd_control = 0x91;
-    GPU.lcd_status = 0x82; /* Initial value for DMG ABC */
-    gpu_write_bgp(0xfc);
-    gpu_write_obp0(0xff);
-    gpu_write_obp1(0xff);
-    if (cart_is_cgb()) {
-        GPU.cgb_bg_pal_idx = 0xc8;
-        GPU.cgb_sprite_pal_idx = 0xd0;
+    gpu_t *gpu = &gb->gpu;
+    page_t *vram0 = gpu->vram[0], *vram1 = gpu->vram[1];
+    page_t *framebuffer = gpu->framebuffer;
+    memset(gpu, 0, sizeof(*gpu));
+    gpu->vram[0] = vram0;
+    gpu->vram[1] = vram1;
+    gpu->framebuffer = framebuffer;
+    page_clear(&gpu->vram[0]);
+    page_clear(&gpu->vram[1]);
+    page_clear(&gpu->framebuffer);
+    gpu->lcd_control = 0x91;
+    gpu->lcd_status = 0x82; /* Initial value for DMG ABC */
+    gpu_write_bgp(gb, 0xfc);
+    gpu_write_obp0(gb, 0xff);
+    gpu_write_obp1(gb, 0xff);
+    if (cart_is_cgb(&gb->cart)) {
+        gpu->render_scanline = render_scanline_cgb;
+        gpu->cgb_bg_pal_idx = 0xc8;
+        gpu->cgb_sprite_pal_idx = 0xd0;
     } else {
+        gpu->render_scanline = render_scanline_dmg;
         for (int i = 0; i < 4; ++i) {
-            GPU.bg_palette_data[i] = dmg_palette[i];
-            GPU.sprite_palette_data[i] = dmg_palette[i];
+            gpu->bg_palette_data[i] = dmg_palette[i];
+            gpu->sprite_palette_data[i] = dmg_palette[i];
         }
     }
-    GPU.speed = 0;
+    gpu->speed = 0;
 }
 
 /* Check if the CPU can access VRAM. */
-static bool gpu_check_vram_io(void)
+static bool gpu_check_vram_io(gb_t *gb)
 {
-    return !GPU.lcd_enable || GPU.mode_flag != GPU_MODE_VRAM;
+    gpu_t *gpu = &gb->gpu;
+    return !gpu->lcd_enable || gpu->mode_flag != GPU_MODE_VRAM;
 }
 
-uint8_t gpu_read_vram(uint16_t addr)
+uint8_t gpu_read_vram(gb_t *gb, uint16_t addr)
 {
-    if (gpu_check_vram_io())
-        return GPU.vram[GPU.vram_bank][addr & 0x1fff];
+    gpu_t *gpu = &gb->gpu;
+    if (gpu_check_vram_io(gb))
+        return gpu_vram(gpu, gpu->vram_bank)[addr & 0x1fff];
     else
         return 0xFF;
 }
 
-void gpu_write_vram(uint16_t addr, uint8_t val)
+void gpu_write_vram(gb_t *gb, uint16_t addr, uint8_t val)
 {
-    if (gpu_check_vram_io())
-        GPU.vram[GPU.vram_bank][addr & 0x1fff] = val;
+    gpu_t *gpu = &gb->gpu;
+    if (gpu_check_vram_io(gb))
+        page_write(&gpu->vram[gpu->vram_bank])[addr & 0x1fff] = val;
+}
+
+uint8_t *gpu_vram_bulk(gb_t *gb, bool write)
+{
+    gpu_t *gpu = &gb->gpu;
+    if (!gpu_check_vram_io(gb))
+        return NULL;
+    if (write)
+        return page_write(&gpu->vram[gpu->vram_bank]);
+    return gpu->vram[gpu->vram_bank]->bytes;
 }
 
 /* Check if the CPU can access OAM. */
-static bool gpu_check_oam_io(void)
+static bool gpu_check_oam_io(gb_t *gb)
 {
-    return (!GPU.lcd_enable || GPU.mode_flag == GPU_MODE_HBLANK ||
-            GPU.mode_flag == GPU_MODE_VBLANK) &&
-           GPU.oam_dma.byte == 0;
+    gpu_t *gpu = &gb->gpu;
+    return (!gpu->lcd_enable || gpu->mode_flag == GPU_MODE_HBLANK ||
+            gpu->mode_flag == GPU_MODE_VBLANK) &&
+           gpu->oam_dma.byte == 0;
 }
 
-uint8_t gpu_read_oam(uint16_t addr)
+uint8_t gpu_read_oam(gb_t *gb, uint16_t addr)
 {
-    if (gpu_check_oam_io()) {
-        return GPU.oam[addr & 0xff];
+    if (gpu_check_oam_io(gb)) {
+        return gb->gpu.oam[addr & 0xff];
     } else {
         return 0xFF;
     }
 }
 
-void gpu_write_oam(uint16_t addr, uint8_t val)
+void gpu_write_oam(gb_t *gb, uint16_t addr, uint8_t val)
 {
-    if (gpu_check_oam_io())
-        GPU.oam[addr & 0xff] = val;
+    if (gpu_check_oam_io(gb))
+        gb->gpu.oam[addr & 0xff] = val;
 }
 
 static void rgb5_to_rgb8(uint16_t rgb555, color_t *color)
 {
     uint8_t c;
-    color->a = SDL_ALPHA_OPAQUE;
+    color->a = COLOR_ALPHA_OPAQUE;
     /* Red */
     c = (rgb555 & 0x1f);
     color->r = (c << 3) | (c >> 2);
@@ -222,144 +188,151 @@ static void rgb5_to_rgb8(uint16_t rgb555, color_t *color)
     color->b = (c << 3) | (c >> 2);
 }
 
-static void gpu_set_cgb_bg_palette(uint8_t value)
+static void gpu_set_cgb_bg_palette(gb_t *gb, uint8_t value)
 {
+    gpu_t *gpu = &gb->gpu;
     uint8_t datah, datal;
-    uint8_t reg = GPU.cgb_bg_pal_idx;
+    uint8_t reg = gpu->cgb_bg_pal_idx;
     unsigned int i = reg & 0x3f;
-    GPU.cgb_bg_pal_data[i] = value;
+    gpu->cgb_bg_pal_data[i] = value;
     if (i & 1) {
         datah = value;
-        datal = GPU.cgb_bg_pal_data[i - 1];
+        datal = gpu->cgb_bg_pal_data[i - 1];
     } else {
-        datah = GPU.cgb_bg_pal_data[i + 1];
+        datah = gpu->cgb_bg_pal_data[i + 1];
         datal = value;
     }
-    rgb5_to_rgb8((datah << 8) | datal, &GPU.bg_palette_data[i >> 1]);
-    GPU.bg_palette[i >> 1] = GPU.bg_palette_data[i >> 1];
+    rgb5_to_rgb8((datah << 8) | datal, &gpu->bg_palette_data[i >> 1]);
+    gpu->bg_palette[i >> 1] = gpu->bg_palette_data[i >> 1];
     /* Auto increment index. */
-    GPU.cgb_bg_pal_idx = (reg & 0x80) | ((i + (reg >> 7)) & 0x3f);
+    gpu->cgb_bg_pal_idx = (reg & 0x80) | ((i + (reg >> 7)) & 0x3f);
 }
 
-static void gpu_set_cgb_sprite_palette(uint8_t value)
+static void gpu_set_cgb_sprite_palette(gb_t *gb, uint8_t value)
 {
+    gpu_t *gpu = &gb->gpu;
     uint8_t datah, datal;
-    uint8_t reg = GPU.cgb_sprite_pal_idx;
+    uint8_t reg = gpu->cgb_sprite_pal_idx;
     unsigned int i = reg & 0x3f;
-    GPU.cgb_sprite_pal_data[i] = value;
+    gpu->cgb_sprite_pal_data[i] = value;
     if (i & 1) {
         datah = value;
-        datal = GPU.cgb_sprite_pal_data[i - 1];
+        datal = gpu->cgb_sprite_pal_data[i - 1];
     } else {
-        datah = GPU.cgb_sprite_pal_data[i + 1];
+        datah = gpu->cgb_sprite_pal_data[i + 1];
         datal = value;
     }
-    rgb5_to_rgb8((datah << 8) | datal, &GPU.sprite_palette_data[i >> 1]);
-    GPU.sprite_palette[i >> 1] = GPU.sprite_palette_data[i >> 1];
+    rgb5_to_rgb8((datah << 8) | datal, &gpu->sprite_palette_data[i >> 1]);
+    gpu->sprite_palette[i >> 1] = gpu->sprite_palette_data[i >> 1];
     /* Auto increment index. */
-    GPU.cgb_sprite_pal_idx = (reg & 0x80) | ((i + (reg >> 7)) & 0x3f);
+    gpu->cgb_sprite_pal_idx = (reg & 0x80) | ((i + (reg >> 7)) & 0x3f);
 }
 
-static void clear_line(int y)
+static void clear_line(gb_t *gb, int y)
 {
+    color_t *fb = gpu_fb_write(&gb->gpu);
     for (int x = 0; x < GB_SCREEN_WIDTH; ++x) {
         int px = y * GB_SCREEN_WIDTH + x;
-        GPU.framebuffer[px] = dmg_palette[0];
+        fb[px] = dmg_palette[0];
     }
 }
 
-static void gpu_clear_screen(void)
+static void gpu_clear_screen(gb_t *gb)
 {
     for (int y = 0; y < GB_SCREEN_HEIGHT; ++y) {
-        clear_line(y);
+        clear_line(gb, y);
     }
 }
 
-uint8_t gpu_read_lcdc(void)
+uint8_t gpu_read_lcdc(gb_t *gb)
 {
-    return GPU.lcd_control;
+    return gb->gpu.lcd_control;
 }
 
-void gpu_write_lcdc(uint8_t val)
+void gpu_write_lcdc(gb_t *gb, uint8_t val)
 {
-    if (GPU.lcd_enable && (val & 0x80) == 0) {
+    gpu_t *gpu = &gb->gpu;
+    if (gpu->lcd_enable && (val & 0x80) == 0) {
         /* If disabling LCD */
-        if (GPU.mode_flag != GPU_MODE_VBLANK)
+        if (gpu->mode_flag != GPU_MODE_VBLANK)
             printf("WARNING: LCD should be disabled only during VBLANK: %d\n",
-                   GPU.mode_flag);
-        gpu_clear_screen();
-        GPU.lcd_disabled_clock = GPU.modeclock;
-        GPU.lcd_disabled_frame_rendered = false;
-        GPU.modeclock = 0;
-        GPU.scanline = 0;
-        GPU.mode_flag = GPU_MODE_OAM;
+                   gpu->mode_flag);
+        gpu_clear_screen(gb);
+        gpu->lcd_disabled_clock = gpu->modeclock;
+        gpu->lcd_disabled_frame_rendered = false;
+        gpu->modeclock = 0;
+        gpu->scanline = 0;
+        gpu->mode_flag = GPU_MODE_OAM;
     }
-    GPU.lcd_control = val;
+    gpu->lcd_control = val;
 }
 
-uint8_t gpu_read_stat(void)
+uint8_t gpu_read_stat(gb_t *gb)
 {
-    return (GPU.lcd_status & 0xfb) | (GPU.scanline == GPU.lyc ? 4u : 0u);
+    gpu_t *gpu = &gb->gpu;
+    return (gpu->lcd_status & 0xfb) | (gpu->scanline == gpu->lyc ? 4u : 0u);
 }
 
-void gpu_write_stat(uint8_t val)
+void gpu_write_stat(gb_t *gb, uint8_t val)
 {
-    GPU.lcd_status = (val & 0x78) | (GPU.lcd_status & 0x87);
+    gpu_t *gpu = &gb->gpu;
+    gpu->lcd_status = (val & 0x78) | (gpu->lcd_status & 0x87);
 }
 
-uint8_t gpu_read_scy(void)
+uint8_t gpu_read_scy(gb_t *gb)
 {
-    return GPU.scroll_y;
+    return gb->gpu.scroll_y;
 }
 
-void gpu_write_scy(uint8_t val)
+void gpu_write_scy(gb_t *gb, uint8_t val)
 {
-    GPU.scroll_y = val;
+    gb->gpu.scroll_y = val;
 }
 
-uint8_t gpu_read_scx(void)
+uint8_t gpu_read_scx(gb_t *gb)
 {
-    return GPU.scroll_x;
+    return gb->gpu.scroll_x;
 }
 
-void gpu_write_scx(uint8_t val)
+void gpu_write_scx(gb_t *gb, uint8_t val)
 {
-    GPU.scroll_x = val;
+    gb->gpu.scroll_x = val;
 }
 
-uint8_t gpu_read_ly(void)
+uint8_t gpu_read_ly(gb_t *gb)
 {
-    return GPU.scanline;
+    return gb->gpu.scanline;
 }
 
-uint8_t gpu_read_lyc(void)
+uint8_t gpu_read_lyc(gb_t *gb)
 {
-    return GPU.lyc;
+    return gb->gpu.lyc;
 }
 
-void gpu_write_lyc(uint8_t val)
+void gpu_write_lyc(gb_t *gb, uint8_t val)
 {
-    GPU.lyc = val;
+    gb->gpu.lyc = val;
 }
 
-uint8_t gpu_read_dma(void)
+uint8_t gpu_read_dma(gb_t *gb)
 {
-    return GPU.oam_dma.reg;
+    return gb->gpu.oam_dma.reg;
 }
 
-void gpu_write_dma(uint8_t val)
+void gpu_write_dma(gb_t *gb, uint8_t val)
 {
-    GPU.oam_dma.reg = val;
-    GPU.oam_dma.enabled = true;
-    if (GPU.oam_dma.byte > 0)
-        GPU.oam_dma.started = false;
-    GPU.oam_dma.byte = 0;
-    GPU.oam_dma.clock = 0;
+    gpu_t *gpu = &gb->gpu;
+    gpu->oam_dma.reg = val;
+    gpu->oam_dma.enabled = true;
+    if (gpu->oam_dma.byte > 0)
+        gpu->oam_dma.started = false;
+    gpu->oam_dma.byte = 0;
+    gpu->oam_dma.clock = 0;
 }
 
-uint8_t gpu_read_bgp(void)
+uint8_t gpu_read_bgp(gb_t *gb)
 {
-    return GPU.bgp;
+    return gb->gpu.bgp;
 }
 
 static void gpu_set_palette(color_t *dest, const color_t *src, uint8_t data)
@@ -370,124 +343,130 @@ static void gpu_set_palette(color_t *dest, const color_t *src, uint8_t data)
     dest[3] = src[data >> 6 & 3];
 }
 
-void gpu_write_bgp(uint8_t val)
+void gpu_write_bgp(gb_t *gb, uint8_t val)
 {
-    GPU.bgp = val;
-    gpu_set_palette(&GPU.bg_palette[0], GPU.bg_palette_data, val);
+    gpu_t *gpu = &gb->gpu;
+    gpu->bgp = val;
+    gpu_set_palette(&gpu->bg_palette[0], gpu->bg_palette_data, val);
 }
 
-uint8_t gpu_read_obp0(void)
+uint8_t gpu_read_obp0(gb_t *gb)
 {
-    return GPU.obp0;
+    return gb->gpu.obp0;
 }
 
-void gpu_write_obp0(uint8_t val)
+void gpu_write_obp0(gb_t *gb, uint8_t val)
 {
-    GPU.obp0 = val;
-    gpu_set_palette(&GPU.sprite_palette[0], GPU.sprite_palette_data, val);
+    gpu_t *gpu = &gb->gpu;
+    gpu->obp0 = val;
+    gpu_set_palette(&gpu->sprite_palette[0], gpu->sprite_palette_data, val);
 }
 
-uint8_t gpu_read_obp1(void)
+uint8_t gpu_read_obp1(gb_t *gb)
 {
-    return GPU.obp1;
+    return gb->gpu.obp1;
 }
 
-void gpu_write_obp1(uint8_t val)
+void gpu_write_obp1(gb_t *gb, uint8_t val)
 {
-    GPU.obp1 = val;
-    gpu_set_palette(&GPU.sprite_palette[4], GPU.sprite_palette_data, val);
+    gpu_t *gpu = &gb->gpu;
+    gpu->obp1 = val;
+    gpu_set_palette(&gpu->sprite_palette[4], gpu->sprite_palette_data, val);
 }
 
-uint8_t gpu_read_wy(void)
+uint8_t gpu_read_wy(gb_t *gb)
 {
-    return GPU.window_y;
+    return gb->gpu.window_y;
 }
 
-void gpu_write_wy(uint8_t val)
+void gpu_write_wy(gb_t *gb, uint8_t val)
 {
-    GPU.window_y = val;
+    gb->gpu.window_y = val;
 }
 
-uint8_t gpu_read_wx(void)
+uint8_t gpu_read_wx(gb_t *gb)
 {
-    return GPU.window_x;
+    return gb->gpu.window_x;
 }
 
-void gpu_write_wx(uint8_t val)
+void gpu_write_wx(gb_t *gb, uint8_t val)
 {
-    GPU.window_x = val;
+    gb->gpu.window_x = val;
 }
 
-uint8_t gpu_read_vbk(void)
+uint8_t gpu_read_vbk(gb_t *gb)
 {
-    if (cart_is_cgb())
-        return 0xfe | GPU.vram_bank;
+    if (cart_is_cgb(&gb->cart))
+        return 0xfe | gb->gpu.vram_bank;
     return 0xff;
 }
 
-void gpu_write_vbk(uint8_t val)
+void gpu_write_vbk(gb_t *gb, uint8_t val)
 {
-    if (cart_is_cgb())
-        GPU.vram_bank = val & 1;
+    if (cart_is_cgb(&gb->cart))
+        gb->gpu.vram_bank = val & 1;
 }
 
-uint8_t gpu_read_bgpi(void)
+uint8_t gpu_read_bgpi(gb_t *gb)
 {
-    if (cart_is_cgb())
-        return GPU.cgb_bg_pal_idx;
+    if (cart_is_cgb(&gb->cart))
+        return gb->gpu.cgb_bg_pal_idx;
     return 0xff;
 }
 
-void gpu_write_bgpi(uint8_t val)
+void gpu_write_bgpi(gb_t *gb, uint8_t val)
 {
-    if (cart_is_cgb())
-        GPU.cgb_bg_pal_idx = val;
+    if (cart_is_cgb(&gb->cart))
+        gb->gpu.cgb_bg_pal_idx = val;
 }
 
-uint8_t gpu_read_bgpd(void)
+uint8_t gpu_read_bgpd(gb_t *gb)
 {
-    if (cart_is_cgb())
-        return GPU.cgb_bg_pal_data[GPU.cgb_bg_pal_idx & 0x3f];
+    gpu_t *gpu = &gb->gpu;
+    if (cart_is_cgb(&gb->cart))
+        return gpu->cgb_bg_pal_data[gpu->cgb_bg_pal_idx & 0x3f];
     return 0xff;
 }
 
-void gpu_write_bgpd(uint8_t val)
+void gpu_write_bgpd(gb_t *gb, uint8_t val)
 {
-    if (cart_is_cgb())
-        gpu_set_cgb_bg_palette(val);
+    if (cart_is_cgb(&gb->cart))
+        gpu_set_cgb_bg_palette(gb, val);
 }
 
-uint8_t gpu_read_obpi(void)
+uint8_t gpu_read_obpi(gb_t *gb)
 {
-    if (cart_is_cgb())
-        return GPU.cgb_sprite_pal_idx;
+    if (cart_is_cgb(&gb->cart))
+        return gb->gpu.cgb_sprite_pal_idx;
     return 0xff;
 }
 
-void gpu_write_obpi(uint8_t val)
+void gpu_write_obpi(gb_t *gb, uint8_t val)
 {
-    if (cart_is_cgb())
-        GPU.cgb_sprite_pal_idx = val;
+    if (cart_is_cgb(&gb->cart))
+        gb->gpu.cgb_sprite_pal_idx = val;
 }
 
-uint8_t gpu_read_obpd(void)
+uint8_t gpu_read_obpd(gb_t *gb)
 {
-    if (cart_is_cgb())
-        return GPU.cgb_sprite_pal_data[GPU.cgb_sprite_pal_idx & 0x3f];
+    gpu_t *gpu = &gb->gpu;
+    if (cart_is_cgb(&gb->cart))
+        return gpu->cgb_sprite_pal_data[gpu->cgb_sprite_pal_idx & 0x3f];
     return 0xff;
 }
 
-void gpu_write_obpd(uint8_t val)
+void gpu_write_obpd(gb_t *gb, uint8_t val)
 {
-    if (cart_is_cgb())
-        gpu_set_cgb_sprite_palette(val);
+    if (cart_is_cgb(&gb->cart))
+        gpu_set_cgb_sprite_palette(gb, val);
 }
 
-inline int gpu_get_tile_id(int mapoffs)
+inline int gpu_get_tile_id(gb_t *gb, int mapoffs)
 {
+    gpu_t *gpu = &gb->gpu;
     /* Unsigned tile region: 0 to 255. */
-    int tile_id = GPU.vram[0][mapoffs];
-    if (!GPU.bg_tile_set) {
+    int tile_id = gpu_vram(gpu, 0)[mapoffs];
+    if (!gpu->bg_tile_set) {
         /* Signed tile region: -128 to 127. */
         /* Adjust id for the 0x8000 - 0x97ff range. */
         tile_id = 256 + (int8_t)tile_id;
@@ -495,8 +474,10 @@ inline int gpu_get_tile_id(int mapoffs)
     return tile_id;
 }
 
-inline tile_line_t gpu_get_tile_line(bg_attr_t attr, int tile_id, int y)
+inline tile_line_t gpu_get_tile_line(gb_t *gb, bg_attr_t attr, int tile_id,
+                                     int y)
 {
+    gpu_t *gpu = &gb->gpu;
     tile_line_t tile_line;
     if (attr.vflip) {
         int ty = y & 7;
@@ -506,27 +487,34 @@ inline tile_line_t gpu_get_tile_line(bg_attr_t attr, int tile_id, int y)
      * long. */
     int tile_line_id = (tile_id << 4) + ((y & 7) << 1);
     /* Get tile line data: Each tile line takes 2 bytes. */
-    tile_line.data_l = GPU.vram[attr.vram_bank][tile_line_id];
-    tile_line.data_h = GPU.vram[attr.vram_bank][tile_line_id + 1];
+    const uint8_t *vram = gpu_vram(gpu, attr.vram_bank);
+    tile_line.data_l = vram[tile_line_id];
+    tile_line.data_h = vram[tile_line_id + 1];
     return tile_line;
 }
 
-inline bg_attr_t gpu_get_tile_attributes(int mapoffs)
+CART_MODEL_INLINE bg_attr_t tile_attributes(gb_t *gb, int mapoffs, bool cgb)
 {
     bg_attr_t bg_attr;
-    if (cart_is_cgb()) {
-        bg_attr.attributes = GPU.vram[1][mapoffs];
+    if (cgb) {
+        bg_attr.attributes = gpu_vram(&gb->gpu, 1)[mapoffs];
     } else {
         bg_attr.attributes = 0;
     }
     return bg_attr;
 }
 
-static inline tile_line_t get_tile_line_sprite(sprite_t *sprite, int sy,
-                                               int ysize, int tile_mask)
+bg_attr_t gpu_get_tile_attributes(gb_t *gb, int mapoffs)
+{
+    return tile_attributes(gb, mapoffs, cart_is_cgb(&gb->cart));
+}
+
+static inline tile_line_t get_tile_line_sprite(gb_t *gb, sprite_t *sprite,
+                                               int sy, int ysize, int tile_mask)
 {
+    gpu_t *gpu = &gb->gpu;
     tile_line_t tile_line;
-    int tile_y = GPU.scanline - sy;
+    int tile_y = gpu->scanline - sy;
     if (sprite->vflip) {
         tile_y = ysize - tile_y - 1;
     }
@@ -534,8 +522,9 @@ static inline tile_line_t get_tile_line_sprite(sprite_t *sprite, int sy,
     int tile_number = tile_mask & sprite->tile;
     int tile_line_id = tile_number * 16 + tile_y * 2;
     /* Get tile line data: Each tile line takes 2 bytes. */
-    tile_line.data_l = GPU.vram[sprite->cgb_vram_bank][tile_line_id];
-    tile_line.data_h = GPU.vram[sprite->cgb_vram_bank][tile_line_id + 1];
+    const uint8_t *vram = gpu_vram(gpu, sprite->cgb_vram_bank);
+    tile_line.data_l = vram[tile_line_id];
+    tile_line.data_h = vram[tile_line_id + 1];
     return tile_line;
 }
 
@@ -555,23 +544,25 @@ struct scanline {
     bool bg_priority;
 };
 
-static void update_fb_bg(struct scanline *line)
+CART_MODEL_INLINE void update_fb_bg(gb_t *gb, struct scanline *line, bool cgb)
 {
-    int bg_x = GPU.scroll_x;
-    int bg_y = (GPU.scanline + GPU.scroll_y) & 0xff;
+    gpu_t *gpu = &gb->gpu;
+    color_t *fb = gpu_fb_write(gpu);
+    int bg_x = gpu->scroll_x;
+    int bg_y = (gpu->scanline + gpu->scroll_y) & 0xff;
     int map_x = (bg_x >> 3);
-    int mapoffs = (GPU.bg_tile_map) ? 0x1c00 : 0x1800;
-    int pixeloffs = GPU.scanline * GB_SCREEN_WIDTH;
+    int mapoffs = (gpu->bg_tile_map) ? 0x1c00 : 0x1800;
+    int pixeloffs = gpu->scanline * GB_SCREEN_WIDTH;
     /* Map row offset: (bg_y / 8) * 32. */
     mapoffs += ((bg_y >> 3) << 5);
     for (int screen_x = 0; screen_x < GB_SCREEN_WIDTH; ++map_x) {
         map_x &= 0x1f;
         int mapoffs_tmp = mapoffs + map_x;
         /* Get tile index adjusted for the 0x8000 - 0x97ff range. */
-        int tile_id = gpu_get_tile_id(mapoffs_tmp);
-        bg_attr_t attr = gpu_get_tile_attributes(mapoffs_tmp);
+        int tile_id = gpu_get_tile_id(gb, mapoffs_tmp);
+        bg_attr_t attr = tile_attributes(gb, mapoffs_tmp, cgb);
         /* Get tile line data. */
-        tile_line_t tile_line = gpu_get_tile_line(attr, tile_id, bg_y);
+        tile_line_t tile_line = gpu_get_tile_line(gb, attr, tile_id, bg_y);
         /* Iterate over remaining pixels of the tile. */
         for (int tile_x = bg_x & 0x7; tile_x < 8 && screen_x < GB_SCREEN_WIDTH;
              ++tile_x) {
@@ -580,73 +571,83 @@ static void update_fb_bg(struct scanline *line)
             line[screen_x].color = (uint8_t)color;
             line[screen_x].bg_priority = attr.priority;
             /* Copy color to frame buffer. */
-            GPU.framebuffer[pixeloffs + screen_x] =
-                GPU.bg_palette[((int)attr.pal_number << 2) + color];
+            fb[pixeloffs + screen_x] =
+                gpu->bg_palette[((int)attr.pal_number << 2) + color];
             ++screen_x;
             ++bg_x;
         }
     }
 }
 
-static void update_fb_window(struct scanline *line)
+CART_MODEL_INLINE void update_fb_window(gb_t *gb, struct scanline *line,
+                                        bool cgb)
 {
+    gpu_t *gpu = &gb->gpu;
+    color_t *fb = gpu_fb_write(gpu);
     int bg_x = 0;
-    int screen_x = GPU.window_x - 7;
-    int mapoffs = (GPU.window_tile_map) ? 0x1c00 : 0x1800;
-    int pixeloffs = GPU.scanline * GB_SCREEN_WIDTH;
-    mapoffs += ((GPU.wy_cnt >> 3) << 5);
+    int screen_x = gpu->window_x - 7;
+    int mapoffs = (gpu->window_tile_map) ? 0x1c00 : 0x1800;
+    int pixeloffs = gpu->scanline * GB_SCREEN_WIDTH;
+    mapoffs += ((gpu->wy_cnt >> 3) << 5);
     if (screen_x < 0) {
         screen_x = 0;
-        bg_x = 7 - GPU.window_x;
+        bg_x = 7 - gpu->window_x;
     }
     while (screen_x < GB_SCREEN_WIDTH) {
-        int tile_id = gpu_get_tile_id(mapoffs);
-        bg_attr_t attr = gpu_get_tile_attributes(mapoffs);
-        tile_line_t tile_line = gpu_get_tile_line(attr, tile_id, GPU.wy_cnt);
+        int tile_id = gpu_get_tile_id(gb, mapoffs);
+        bg_attr_t attr = tile_attributes(gb, mapoffs, cgb);
+        tile_line_t tile_line =
+            gpu_get_tile_line(gb, attr, tile_id, gpu->wy_cnt);
         for (int tile_x = bg_x & 7; tile_x < 8 && screen_x < GB_SCREEN_WIDTH;
              ++tile_x) {
             int color = gpu_get_tile_color(tile_line, tile_x, attr.hflip);
             line[screen_x].color = (uint8_t)color;
             line[screen_x].bg_priority = attr.priority;
-            GPU.framebuffer[pixeloffs + screen_x] =
-                GPU.bg_palette[((int)attr.pal_number << 2) + color];
+            fb[pixeloffs + screen_x] =
+                gpu->bg_palette[((int)attr.pal_number << 2) + color];
             ++screen_x;
             ++bg_x;
         }
         ++mapoffs;
     }
-    ++GPU.wy_cnt;
+    ++gpu->wy_cnt;
 }
 
-static color_t *get_sprite_pal(sprite_t *sprite)
+CART_MODEL_INLINE color_t *get_sprite_pal(gb_t *gb, sprite_t *sprite,
+                                         bool cgb)
 {
+    gpu_t *gpu = &gb->gpu;
     color_t *pal;
-    if (cart_is_cgb()) {
-        pal = &GPU.sprite_palette[sprite->cgb_palette * 4];
+    if (cgb) {
+        pal = &gpu->sprite_palette[sprite->cgb_palette * 4];
     } else {
-        pal = &GPU.sprite_palette[sprite->palette * 4];
+        pal = &gpu->sprite_palette[sprite->palette * 4];
     }
     return pal;
 }
 
-static int get_lowest_prio_sprite(void)
+static int get_lowest_prio_sprite(gb_t *gb)
 {
-    int ysize = GPU.obj_size ? 16 : 8;
+    gpu_t *gpu = &gb->gpu;
+    int ysize = gpu->obj_size ? 16 : 8;
     int sprites = 0, i;
     for (i = 0; i < 40 && sprites < 10; ++i) {
-        sprite_t sprite = ((sprite_t *)GPU.oam)[i];
+        sprite_t sprite = ((sprite_t *)gpu->oam)[i];
         int sy = sprite.y - 16;
-        if (sy <= GPU.scanline && (sy + ysize) > GPU.scanline) {
+        if (sy <= gpu->scanline && (sy + ysize) > gpu->scanline) {
             ++sprites;
         }
     }
     return i - 1;
 }
 
-static void update_fb_sprite(struct scanline *line)
+CART_MODEL_INLINE void update_fb_sprite(gb_t *gb, struct scanline *line,
+                                        bool cgb)
 {
+    gpu_t *gpu = &gb->gpu;
+    color_t *fb = gpu_fb_write(gpu);
     int ysize, tile_mask;
-    if (GPU.obj_size) {
+    if (gpu->obj_size) {
         ysize = 16;
         tile_mask = 0xfffffffe;
     } else {
@@ -654,34 +655,34 @@ static void update_fb_sprite(struct scanline *line)
         tile_mask = 0xffffffff;
     }
     /* Iterate over the first 10 sprites on the scanline. */
-    for (int i = get_lowest_prio_sprite(); i >= 0; --i) {
-        sprite_t sprite = ((sprite_t *)GPU.oam)[i];
+    for (int i = get_lowest_prio_sprite(gb); i >= 0; --i) {
+        sprite_t sprite = ((sprite_t *)gpu->oam)[i];
         int sx = sprite.x - 8;
         int sy = sprite.y - 16;
         /* If sprite is on scanline. */
-        if (sy <= GPU.scanline && (sy + ysize) > GPU.scanline) {
+        if (sy <= gpu->scanline && (sy + ysize) > gpu->scanline) {
             /* Get palette for this sprite. */
-            color_t *pal = get_sprite_pal(&sprite);
+            color_t *pal = get_sprite_pal(gb, &sprite, cgb);
             /* Get frame buffer pixel offset. */
             tile_line_t tile_line =
-                get_tile_line_sprite(&sprite, sy, ysize, tile_mask);
+                get_tile_line_sprite(gb, &sprite, sy, ysize, tile_mask);
             /* Iterate over all tile pixels in the X-axis. */
             for (int tile_x = 0; tile_x < 8; tile_x++) {
                 /* Calculate pixel x coordinate. */
                 int px = sx + tile_x;
                 /* Calculate frame buffer pixel offset. */
-                int pixeloffs = GPU.scanline * GB_SCREEN_WIDTH + px;
+                int pixeloffs = gpu->scanline * GB_SCREEN_WIDTH + px;
                 /* If pixel is on screen. */
                 if (px >= 0 && px < GB_SCREEN_WIDTH) {
                     /* Check if pixel is hidden. */
-                    if (GPU.bg_display && line[px].color != 0 &&
+                    if (gpu->bg_display && line[px].color != 0 &&
                         (line[px].bg_priority || sprite.priority == 1))
                         continue;
                     int color =
                         gpu_get_tile_color(tile_line, tile_x, sprite.hflip);
                     if (color != 0) {
                         /* Only show sprite of color not 0. */
-                        GPU.framebuffer[pixeloffs] = pal[color];
+                        fb[pixeloffs] = pal[color];
                     }
                 }
             }
@@ -689,67 +690,75 @@ static void update_fb_sprite(struct scanline *line)
     }
 }
 
-static void render_scanline(void)
+CART_MODEL_INLINE void render_scanline(gb_t *gb, bool cgb)
 {
+    gpu_t *gpu = &gb->gpu;
     struct scanline line[GB_SCREEN_WIDTH];
-    if (cart_is_cgb()) {
+    if (cgb) {
         /* In CGB mode when Bit 0 is cleared, the background and window
          * lose their priority. */
-        update_fb_bg(line);
-        if (GPU.window_enable && GPU.window_x < GB_SCREEN_WIDTH + 7 &&
-            GPU.window_y <= GPU.scanline)
-            update_fb_window(line);
+        update_fb_bg(gb, line, cgb);
+    } else if (gpu->bg_display) {
+        update_fb_bg(gb, line, cgb);
     } else {
-        if (GPU.bg_display) {
-            update_fb_bg(line);
-        } else {
-            clear_line(GPU.scanline);
-        }
-        if (GPU.window_enable && GPU.window_x < GB_SCREEN_WIDTH + 7 &&
-            GPU.window_y <= GPU.scanline)
-            update_fb_window(line);
-    }
-    if (GPU.obj_enable)
-        update_fb_sprite(line);
-}
-
-void gpu_render_framebuffer(void)
-{
-    SDL_RenderClear(GPU_GL.ren);
-    SDL_UpdateTexture(GPU_GL.tex, NULL, GPU.framebuffer, GB_SCREEN_WIDTH * 4);
-    SDL_RenderCopy(GPU_GL.ren, GPU_GL.tex, NULL, NULL);
-    SDL_RenderPresent(GPU_GL.ren);
-    GPU_GL.cb();
-#ifdef FPS
-    static uint32_t frames;
-    static uint32_t last_time;
-    ++frames;
-    uint32_t time = SDL_GetTicks();
-    if (time >= last_time + 1000) {
-        printf("%u fps\n", frames);
-        frames = 0;
-        last_time = time;
+        clear_line(gb, gpu->scanline);
     }
-#endif
+    if (gpu->window_enable && gpu->window_x < GB_SCREEN_WIDTH + 7 &&
+        gpu->window_y <= gpu->scanline)
+        update_fb_window(gb, line, cgb);
+    if (gpu->obj_enable)
+        update_fb_sprite(gb, line, cgb);
 }
 
-static void gpu_change_mode(gpu_mode_e new_mode)
+static void render_scanline_dmg(gb_t *gb)
 {
-    GPU.mode_flag = new_mode;
+    render_scanline(gb, false);
+}
+
+static void render_scanline_cgb(gb_t *gb)
+{
+    render_scanline(gb, true);
+}
+
+void gpu_present_frame(gb_t *gb)
+{
+    /* Before the sink, whose input belongs to the next frame. */
+    if (gb->movie != NULL)
+        movie_frame(gb);
+    gpu_render_framebuffer(gb);
+    if (gb->rewind != NULL)
+        rewind_frame(gb);
+}
+
+void gpu_render_framebuffer(gb_t *gb)
+{
+    if (gb->video_cb != NULL)
+        gb->video_cb(gb, gpu_get_framebuffer(gb), gb->video_data);
+}
+
+const color_t *gpu_get_framebuffer(const gb_t *gb)
+{
+    return (const color_t *)gb->gpu.framebuffer->bytes;
+}
+
+static void gpu_change_mode(gb_t *gb, gpu_mode_e new_mode)
+{
+    gpu_t *gpu = &gb->gpu;
+    gpu->mode_flag = new_mode;
     switch (new_mode) {
         case GPU_MODE_HBLANK:
-            if (GPU.hblank_int)
-                interrupt_raise(INTERRUPTS_LCDSTAT);
+            if (gpu->hblank_int)
+                interrupt_raise(gb, INTERRUPTS_LCDSTAT);
             break;
         case GPU_MODE_VBLANK:
-            if (interrupt_is_enable(INTERRUPTS_VBLANK))
-                interrupt_raise(INTERRUPTS_VBLANK);
-            if (GPU.vblank_int)
-                interrupt_raise(INTERRUPTS_LCDSTAT);
+            if (interrupt_is_enable(gb, INTERRUPTS_VBLANK))
+                interrupt_raise(gb, INTERRUPTS_VBLANK);
+            if (gpu->vblank_int)
+                interrupt_raise(gb, INTERRUPTS_LCDSTAT);
             break;
         case GPU_MODE_OAM:
-            if (GPU.oam_int)
-                interrupt_raise(INTERRUPTS_LCDSTAT);
+            if (gpu->oam_int)
+                interrupt_raise(gb, INTERRUPTS_LCDSTAT);
             break;
         case GPU_MODE_VRAM:
             break;
@@ -761,143 +770,179 @@ static unsigned int mode_switch_clocks[2][4] = {
     {408, 912, 164, 344},
 };
 
-static void gpu_tick_lcd_enabled(unsigned int clock_step)
+/* Count the frame, at the start of VBlank, see gpu_present_frame(). */
+static void gpu_end_frame(gb_t *gb)
 {
-    GPU.modeclock += clock_step;
-    unsigned int switch_clock = mode_switch_clocks[GPU.speed][GPU.mode_flag];
-    switch (GPU.mode_flag) {
+    ++gb->gpu.frames;
+}
+
+/* Enter the mode after the one that just took its clocks. */
+static void gpu_next_mode(gb_t *gb)
+{
+    gpu_t *gpu = &gb->gpu;
+    switch (gpu->mode_flag) {
         case GPU_MODE_OAM:
             /* Mode 2 takes between 77 and 83 clocks. */
-            if (GPU.modeclock >= switch_clock) {
-                GPU.modeclock -= switch_clock;
-                gpu_change_mode(GPU_MODE_VRAM);
-            }
+            gpu_change_mode(gb, GPU_MODE_VRAM);
             break;
         case GPU_MODE_VRAM:
             /* Mode 3 takes between 169 and 175 clocks. */
-            if (GPU.modeclock >= switch_clock) {
-                GPU.modeclock -= switch_clock;
-                gpu_change_mode(GPU_MODE_HBLANK);
-                /* End of scanline. Write a scanline to framebuffer. */
-                render_scanline();
-            }
+            gpu_change_mode(gb, GPU_MODE_HBLANK);
+            /* End of scanline. Write a scanline to framebuffer. */
+            gpu->render_scanline(gb);
             break;
         case GPU_MODE_HBLANK:
             /* Mode 0 takes between 201 and 207 clocks. */
-            if (GPU.modeclock >= switch_clock) {
-                GPU.modeclock -= switch_clock;
-                GPU.scanline++;
-                if (GPU.coincidence_int && GPU.scanline == GPU.lyc) {
-                    interrupt_raise(INTERRUPTS_LCDSTAT);
-                }
-                if (GPU.scanline == GB_SCREEN_HEIGHT) {
-                    gpu_change_mode(GPU_MODE_VBLANK);
-                    gpu_render_framebuffer();
-                } else {
-                    gpu_change_mode(GPU_MODE_OAM);
-                }
+            gpu->scanline++;
+            if (gpu->coincidence_int && gpu->scanline == gpu->lyc) {
+                interrupt_raise(gb, INTERRUPTS_LCDSTAT);
+            }
+            if (gpu->scanline == GB_SCREEN_HEIGHT) {
+                gpu_change_mode(gb, GPU_MODE_VBLANK);
+                gpu_end_frame(gb);
+            } else {
+                gpu_change_mode(gb, GPU_MODE_OAM);
             }
             break;
         case GPU_MODE_VBLANK:
             /* Mode 1 takes between 4560 clocks. */
-            if (GPU.modeclock >= switch_clock) {
-                GPU.modeclock -= switch_clock;
-                if (GPU.scanline > 153) {
-                    GPU.scanline = 0;
-                    GPU.wy_cnt = 0;
-                    if (GPU.coincidence_int && GPU.scanline == GPU.lyc) {
-                        interrupt_raise(INTERRUPTS_LCDSTAT);
-                    }
-                    gpu_change_mode(GPU_MODE_OAM);
-                } else {
-                    GPU.scanline++;
-                    if (GPU.coincidence_int && GPU.scanline == GPU.lyc) {
-                        interrupt_raise(INTERRUPTS_LCDSTAT);
-                    }
+            if (gpu->scanline > 153) {
+                gpu->scanline = 0;
+                gpu->wy_cnt = 0;
+                if (gpu->coincidence_int && gpu->scanline == gpu->lyc) {
+                    interrupt_raise(gb, INTERRUPTS_LCDSTAT);
+                }
+                gpu_change_mode(gb, GPU_MODE_OAM);
+            } else {
+                gpu->scanline++;
+                if (gpu->coincidence_int && gpu->scanline == gpu->lyc) {
+                    interrupt_raise(gb, INTERRUPTS_LCDSTAT);
                 }
             }
             break;
     }
 }
 
-/* Render blank screen if LCD is disabled */
-static void gpu_tick_lcd_disabled(unsigned int clock_step)
+/* Go through every mode the step reaches, however many. */
+static void gpu_tick_lcd_enabled(gb_t *gb, unsigned int clock_step)
 {
-    GPU.lcd_disabled_clock += clock_step;
-    if (!GPU.lcd_disabled_frame_rendered) {
-        if (GPU.lcd_disabled_clock >= 144 * (456u << GPU.speed)) {
-            GPU.lcd_disabled_frame_rendered = true;
-            gpu_render_framebuffer();
-        }
-    } else {
-        if (GPU.lcd_disabled_clock >= (144 + 10) * (456u << GPU.speed)) {
-            GPU.lcd_disabled_frame_rendered = false;
-            GPU.lcd_disabled_clock -= (144 + 10) * (456u << GPU.speed);
+    gpu_t *gpu = &gb->gpu;
+    gpu->modeclock += clock_step;
+    for (;;) {
+        unsigned int switch_clock =
+            mode_switch_clocks[gpu->speed][gpu->mode_flag];
+        if (gpu->modeclock < switch_clock)
+            break;
+        gpu->modeclock -= switch_clock;
+        gpu_next_mode(gb);
+    }
+}
+
+/* Render blank screen if LCD is disabled */
+static void gpu_tick_lcd_disabled(gb_t *gb, unsigned int clock_step)
+{
+    gpu_t *gpu = &gb->gpu;
+    unsigned int line = 456u << gpu->speed;
+    gpu->lcd_disabled_clock += clock_step;
+    for (;;) {
+        if (!gpu->lcd_disabled_frame_rendered) {
+            if (gpu->lcd_disabled_clock < 144 * line)
+                break;
+            gpu->lcd_disabled_frame_rendered = true;
+            gpu_end_frame(gb);
+        } else {
+            if (gpu->lcd_disabled_clock < (144 + 10) * line)
+                break;
+            gpu->lcd_disabled_frame_rendered = false;
+            gpu->lcd_disabled_clock -= (144 + 10) * line;
         }
     }
 }
 
-static void gpu_dma_transfer(unsigned int clock_step)
+static void gpu_dma_transfer(gb_t *gb, unsigned int clock_step)
 {
-    if (!GPU.oam_dma.started) {
+    gpu_t *gpu = &gb->gpu;
+    if (!gpu->oam_dma.started) {
         /* Ignore instruction that enabled DMA. */
-        GPU.oam_dma.started = true;
+        gpu->oam_dma.started = true;
         return;
     }
-    GPU.oam_dma.clock += clock_step;
-    while (GPU.oam_dma.clock >= 4) {
-        int i = GPU.oam_dma.byte++;
-        GPU.oam[i] = mmu_read_byte_dma((GPU.oam_dma.reg << 8) + i);
-        GPU.oam_dma.clock -= 4;
-        if (GPU.oam_dma.byte == 40 * 4) {
-            GPU.oam_dma.enabled = false;
-            GPU.oam_dma.byte = 0;
-            GPU.oam_dma.clock = 0;
+    gpu->oam_dma.clock += clock_step;
+    while (gpu->oam_dma.clock >= 4) {
+        int i = gpu->oam_dma.byte++;
+        gpu->oam[i] = mmu_read_byte_dma(gb, (gpu->oam_dma.reg << 8) + i);
+        gpu->oam_dma.clock -= 4;
+        if (gpu->oam_dma.byte == 40 * 4) {
+            gpu->oam_dma.enabled = false;
+            gpu->oam_dma.byte = 0;
+            gpu->oam_dma.clock = 0;
             break;
         }
     }
 }
 
-void gpu_tick(unsigned int clock_step)
+void gpu_tick(gb_t *gb, unsigned int clock_step)
 {
-    if (GPU.oam_dma.enabled) {
-        gpu_dma_transfer(clock_step);
+    gpu_t *gpu = &gb->gpu;
+    if (gpu->oam_dma.enabled) {
+        gpu_dma_transfer(gb, clock_step);
     }
-    if (GPU.lcd_enable)
-        gpu_tick_lcd_enabled(clock_step);
+    if (gpu->lcd_enable)
+        gpu_tick_lcd_enabled(gb, clock_step);
     else
-        gpu_tick_lcd_disabled(clock_step);
+        gpu_tick_lcd_disabled(gb, clock_step);
+}
+
+unsigned int gpu_next_event(gb_t *gb)
+{
+    gpu_t *gpu = &gb->gpu;
+    unsigned int clock, switch_clock;
+    if (gpu->lcd_enable) {
+        clock = gpu->modeclock;
+        switch_clock = mode_switch_clocks[gpu->speed][gpu->mode_flag];
+    } else {
+        clock = gpu->lcd_disabled_clock;
+        switch_clock = (gpu->lcd_disabled_frame_rendered ? 144 + 10 : 144) *
+                       (456u << gpu->speed);
+    }
+    return clock < switch_clock ? switch_clock - clock : 0;
+}
+
+unsigned int gpu_oam_dma_next_event(gb_t *gb)
+{
+    return gb->gpu.oam_dma.enabled ? 0 : UINT_MAX;
 }
 
-void gpu_change_speed(unsigned int speed)
+void gpu_change_speed(gb_t *gb, unsigned int speed)
 {
-    GPU.speed = speed;
+    gb->gpu.speed = speed;
 }
 
-void gpu_dump(void)
+void gpu_dump(gb_t *gb)
 {
+    gpu_t *gpu = &gb->gpu;
     printf("GPU dump:\n");
-    printf("[$ff40] lcd_control=0x%hhx:\n", GPU.lcd_control);
-    printf("  bg_display=%hhu\n", GPU.bg_display);
-    printf("  obj_enable=%hhu\n", GPU.obj_enable);
-    printf("  obj_size=%hhu\n", GPU.obj_size);
-    printf("  bg_tile_map=%hhu\n", GPU.bg_tile_map);
-    printf("  bg_tile_set=%hhu\n", GPU.bg_tile_set);
-    printf("  window_enable=%hhu\n", GPU.window_enable);
-    printf("  window_tile_map=%hhu\n", GPU.window_tile_map);
-    printf("  lcd_enable=%hhu\n", GPU.lcd_enable);
-    printf("[$ff41] lcd_status=0x%hhx:\n", GPU.lcd_status);
-    printf("[$ff42] scroll_y=%hhu\n", GPU.scroll_y);
-    printf("[$ff43] scroll_x=%hhu\n", GPU.scroll_x);
-    printf("[$ff44] scanline=%hhu\n", GPU.scanline);
-    printf("[$ff45] lyc=%hhu\n", GPU.lyc);
-    printf("[$ff4a] window_y=%hhu\n", GPU.window_y);
-    printf("[$ff4b] window_x=%hhu\n", GPU.window_x);
+    printf("[$ff40] lcd_control=0x%hhx:\n", gpu->lcd_control);
+    printf("  bg_display=%hhu\n", gpu->bg_display);
+    printf("  obj_enable=%hhu\n", gpu->obj_enable);
+    printf("  obj_size=%hhu\n", gpu->obj_size);
+    printf("  bg_tile_map=%hhu\n", gpu->bg_tile_map);
+    printf("  bg_tile_set=%hhu\n", gpu->bg_tile_set);
+    printf("  window_enable=%hhu\n", gpu->window_enable);
+    printf("  window_tile_map=%hhu\n", gpu->window_tile_map);
+    printf("  lcd_enable=%hhu\n", gpu->lcd_enable);
+    printf("[$ff41] lcd_status=0x%hhx:\n", gpu->lcd_status);
+    printf("[$ff42] scroll_y=%hhu\n", gpu->scroll_y);
+    printf("[$ff43] scroll_x=%hhu\n", gpu->scroll_x);
+    printf("[$ff44] scanline=%hhu\n", gpu->scanline);
+    printf("[$ff45] lyc=%hhu\n", gpu->lyc);
+    printf("[$ff4a] window_y=%hhu\n", gpu->window_y);
+    printf("[$ff4b] window_x=%hhu\n", gpu->window_x);
     printf("BG palettes:\n");
     for (int i = 0; i < 8; ++i) {
         printf("BG %d: ", i);
         for (int j = 0; j < 4; ++j) {
-            color_t *pal = &GPU.bg_palette[i * 4 + j];
+            color_t *pal = &gpu->bg_palette[i * 4 + j];
             printf("(%u, %u, %u, %u)", pal->a, pal->r, pal->g, pal->b);
         }
         printf("\n");
@@ -905,7 +950,7 @@ void gpu_dump(void)
     /* Dump OAM. */
     printf("OAM dump:\n");
     for (int i = 0; i < 40; i++) {
-        sprite_t s = ((sprite_t *)GPU.oam)[i];
+        sprite_t s = ((sprite_t *)gpu->oam)[i];
         printf("[$%.4x] ", 0xfe00 + i * 4);
         printf("sprite %2u: ", i);
         printf("%.2hhx %.2hhx %.2hhx %.2hhx: ", s.y, s.x, s.tile, s.options);
@@ -918,13 +963,13 @@ void gpu_dump(void)
 }
 
 #ifdef DEBUGGER
-color_t *gpu_get_bg_palette(void)
+color_t *gpu_get_bg_palette(gb_t *gb)
 {
-    return GPU.bg_palette;
+    return gb->gpu.bg_palette;
 }
 
-color_t *gpu_get_sprite_palette(void)
+color_t *gpu_get_sprite_palette(gb_t *gb)
 {
-    return GPU.sprite_palette;
+    return gb->gpu.sprite_palette;
 }
 #endif /* DEBUGGER */
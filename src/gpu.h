@@ -1,14 +1,20 @@
 #ifndef GPU_H
 #define GPU_H
 
-#include <SDL2/SDL.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "color.h"
+#include "page.h"
+
+typedef struct gb gb_t;
 
 #define GB_SCREEN_WIDTH 160
 #define GB_SCREEN_HEIGHT 144
 
+#define GPU_VRAM_BANK_SIZE 0x2000
+#define GPU_FRAMEBUFFER_SIZE \
+    (GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT * sizeof(color_t))
+
 typedef struct {
     uint8_t data_h;
     uint8_t data_l;
@@ -28,63 +34,160 @@ typedef struct {
     };
 } bg_attr_t;
 
-typedef void (*render_callback_t)(void);
+typedef struct {
+    /* 0xff40 (LCDC): LCD Control (R/W) */
+    union {
+        uint8_t lcd_control;
+        struct {
+            uint8_t bg_display : 1;
+            uint8_t obj_enable : 1;
+            uint8_t obj_size : 1;
+            uint8_t bg_tile_map : 1;
+            uint8_t bg_tile_set : 1;
+            uint8_t window_enable : 1;
+            uint8_t window_tile_map : 1;
+            uint8_t lcd_enable : 1;
+        };
+    };
+    /* 0xff41 (STAT): LCDC Status (R/W) */
+    union {
+        uint8_t lcd_status;
+        struct {
+            uint8_t mode_flag : 2;
+            uint8_t coincidence_flag : 1;
+            uint8_t hblank_int : 1;
+            uint8_t vblank_int : 1;
+            uint8_t oam_int : 1;
+            uint8_t coincidence_int : 1;
+            uint8_t unused1 : 1;
+        };
+    };
+    /* 0xff42 (SCY): Scroll Y (R/W) */
+    uint8_t scroll_y;
+    /* 0xff43 (SCX): Scroll X (R/W) */
+    uint8_t scroll_x;
+    /* 0xff44 (LY): LCDC Y-Coordinate (R) */
+    uint8_t scanline;
+    /* 0xff45 (LYC): LY Compare (R/W) */
+    uint8_t lyc;
+    /* 0xff46 (DMA): DMA Transfer and Start Address (R/W) */
+    struct {
+        uint8_t reg;
+        bool enabled;
+        bool started;
+        int byte;
+        int clock;
+    } oam_dma;
+    /* 0xff47 (BGP): BG Palette Data (R/W) - Non CGB */
+    uint8_t bgp;
+    /* 0xff48 (OBP0): Object Palette 0 Data (R/W) - Non CGB */
+    uint8_t obp0;
+    /* 0xff49 (OBP1): Object Palette 1 Data (R/W) - Non CGB */
+    uint8_t obp1;
+    /* 0xff4a (WY): Window Y Position (R/W) */
+    uint8_t window_y;
+    /* 0xff4b (WX): Window X Position minus 7 (R/W) */
+    uint8_t window_x;
+    /* 0xff4f (VBK): VRAM Bank - CGB only */
+    uint8_t vram_bank;
+    /* 0xff68 (BGPI): Background Palette Index - CGB only */
+    uint8_t cgb_bg_pal_idx;
+    /* 0xff69 (BGPD): Background Palette Data - CGB only */
+    uint8_t cgb_bg_pal_data[8 * 8];
+    /* 0xff6a (OBPI): Sprite Palette Index - CGB only */
+    uint8_t cgb_sprite_pal_idx;
+    /* 0xff6b (OBPD): Sprite Palette Data - CGB only*/
+    uint8_t cgb_sprite_pal_data[8 * 8];
+    unsigned int modeclock;
+    page_t *vram[2];     /* Video RAM, one page per bank. */
+    uint8_t oam[0xa0];   /* Sprite info. */
+    page_t *framebuffer; /* GB_SCREEN_WIDTH x GB_SCREEN_HEIGHT color_t. */
+    color_t bg_palette[8 * 4];
+    color_t sprite_palette[8 * 4];
+    color_t bg_palette_data[8 * 4];
+    color_t sprite_palette_data[8 * 4];
+    unsigned int speed;
+    bool lcd_disabled_frame_rendered;
+    unsigned int lcd_disabled_clock;
+    int wy_cnt; /* Number of window lines draw. */
+    unsigned int frames; /* Frames completed since reset. */
+    /* Scanline renderer for the cartridge model, set by gpu_reset(). */
+    void (*render_scanline)(gb_t *gb);
+} gpu_t;
 
-int gpu_init(SDL_Renderer *ren, SDL_Texture *tex, render_callback_t cb);
-void gpu_reset(void);
+/* Allocate video memory, gpu_fork() shares the one of src instead. */
+void gpu_init(gb_t *gb);
+void gpu_fork(gb_t *gb, const gb_t *src);
+void gpu_finish(gb_t *gb);
+void gpu_reset(gb_t *gb);
 
-uint8_t gpu_read_lcdc(void);
-uint8_t gpu_read_stat(void);
-uint8_t gpu_read_scy(void);
-uint8_t gpu_read_scx(void);
-uint8_t gpu_read_ly(void);
-uint8_t gpu_read_lyc(void);
-uint8_t gpu_read_dma(void);
-uint8_t gpu_read_bgp(void);
-uint8_t gpu_read_obp0(void);
-uint8_t gpu_read_obp1(void);
-uint8_t gpu_read_wy(void);
-uint8_t gpu_read_wx(void);
-uint8_t gpu_read_vbk(void);
-uint8_t gpu_read_bgpi(void);
-uint8_t gpu_read_bgpd(void);
-uint8_t gpu_read_obpi(void);
-uint8_t gpu_read_obpd(void);
+uint8_t gpu_read_lcdc(gb_t *gb);
+uint8_t gpu_read_stat(gb_t *gb);
+uint8_t gpu_read_scy(gb_t *gb);
+uint8_t gpu_read_scx(gb_t *gb);
+uint8_t gpu_read_ly(gb_t *gb);
+uint8_t gpu_read_lyc(gb_t *gb);
+uint8_t gpu_read_dma(gb_t *gb);
+uint8_t gpu_read_bgp(gb_t *gb);
+uint8_t gpu_read_obp0(gb_t *gb);
+uint8_t gpu_read_obp1(gb_t *gb);
+uint8_t gpu_read_wy(gb_t *gb);
+uint8_t gpu_read_wx(gb_t *gb);
+uint8_t gpu_read_vbk(gb_t *gb);
+uint8_t gpu_read_bgpi(gb_t *gb);
+uint8_t gpu_read_bgpd(gb_t *gb);
+uint8_t gpu_read_obpi(gb_t *gb);
+uint8_t gpu_read_obpd(gb_t *gb);
 
-void gpu_write_lcdc(uint8_t val);
-void gpu_write_stat(uint8_t val);
-void gpu_write_scy(uint8_t val);
-void gpu_write_scx(uint8_t val);
-void gpu_write_lyc(uint8_t val);
-void gpu_write_dma(uint8_t val);
-void gpu_write_bgp(uint8_t val);
-void gpu_write_obp0(uint8_t val);
-void gpu_write_obp1(uint8_t val);
-void gpu_write_wy(uint8_t val);
-void gpu_write_wx(uint8_t val);
-void gpu_write_vbk(uint8_t val);
-void gpu_write_bgpi(uint8_t val);
-void gpu_write_bgpd(uint8_t val);
-void gpu_write_obpi(uint8_t val);
-void gpu_write_obpd(uint8_t val);
+void gpu_write_lcdc(gb_t *gb, uint8_t val);
+void gpu_write_stat(gb_t *gb, uint8_t val);
+void gpu_write_scy(gb_t *gb, uint8_t val);
+void gpu_write_scx(gb_t *gb, uint8_t val);
+void gpu_write_lyc(gb_t *gb, uint8_t val);
+void gpu_write_dma(gb_t *gb, uint8_t val);
+void gpu_write_bgp(gb_t *gb, uint8_t val);
+void gpu_write_obp0(gb_t *gb, uint8_t val);
+void gpu_write_obp1(gb_t *gb, uint8_t val);
+void gpu_write_wy(gb_t *gb, uint8_t val);
+void gpu_write_wx(gb_t *gb, uint8_t val);
+void gpu_write_vbk(gb_t *gb, uint8_t val);
+void gpu_write_bgpi(gb_t *gb, uint8_t val);
+void gpu_write_bgpd(gb_t *gb, uint8_t val);
+void gpu_write_obpi(gb_t *gb, uint8_t val);
+void gpu_write_obpd(gb_t *gb, uint8_t val);
 
-uint8_t gpu_read_vram(uint16_t addr);
-void gpu_write_vram(uint16_t addr, uint8_t val);
-uint8_t gpu_read_oam(uint16_t addr);
-void gpu_write_oam(uint16_t addr, uint8_t val);
-void gpu_tick(unsigned int clock_step);
-void gpu_render_framebuffer(void);
-void gpu_change_speed(unsigned int speed);
-void gpu_dump(void);
+uint8_t gpu_read_vram(gb_t *gb, uint16_t addr);
+void gpu_write_vram(gb_t *gb, uint16_t addr, uint8_t val);
+/* The VRAM bank mapped, NULL while the PPU keeps the CPU out of it. */
+uint8_t *gpu_vram_bulk(gb_t *gb, bool write);
+uint8_t gpu_read_oam(gb_t *gb, uint16_t addr);
+void gpu_write_oam(gb_t *gb, uint16_t addr, uint8_t val);
+/* Any number of cycles, rendering the lines and raising the interrupts met. */
+void gpu_tick(gb_t *gb, unsigned int clock_step);
+/* Cycles until the next mode or line change. */
+unsigned int gpu_next_event(gb_t *gb);
+/* 0 while OAM DMA runs, as the CPU sees its progress, else UINT_MAX. */
+unsigned int gpu_oam_dma_next_event(gb_t *gb);
+/**
+ * Hand the frame that just ended to the movie, the video sink and rewind.
+ * The CPU calls it once the instruction it ended in is done, as they may
+ * save the state.
+ */
+void gpu_present_frame(gb_t *gb);
+void gpu_render_framebuffer(gb_t *gb);
+const color_t *gpu_get_framebuffer(const gb_t *gb);
+void gpu_change_speed(gb_t *gb, unsigned int speed);
+void gpu_dump(gb_t *gb);
 
-extern int gpu_get_tile_id(int mapoffs);
-extern bg_attr_t gpu_get_tile_attributes(int tile_id);
-extern tile_line_t gpu_get_tile_line(bg_attr_t attr, int tile_id, int y);
+extern int gpu_get_tile_id(gb_t *gb, int mapoffs);
+extern bg_attr_t gpu_get_tile_attributes(gb_t *gb, int tile_id);
+extern tile_line_t gpu_get_tile_line(gb_t *gb, bg_attr_t attr, int tile_id,
+                                     int y);
 extern int gpu_get_tile_color(tile_line_t tile_line, int tile_x, bool hflip);
 
 #ifdef DEBUGGER
-color_t *gpu_get_bg_palette(void);
-color_t *gpu_get_sprite_palette(void);
+color_t *gpu_get_bg_palette(gb_t *gb);
+color_t *gpu_get_sprite_palette(gb_t *gb);
 #endif /* DEBUGGER */
 
 #endif /* GPU_H */
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "apu/apu.h"
 #include "cpu.h"
+#include "gb.h"
 #include "gpu.h"
 #include "keys.h"
 
@@ -16,10 +17,15 @@ struct gusgb {
     int height;
     bool running;
     bool paused;
+    bool rewinding;
     bool fullscreen;
     SDL_Window *window;
     SDL_Renderer *ren;
     SDL_Texture *tex;
+    gb_t *gb;
+    unsigned int run_ahead; /* Frames shown ahead of the emulation. */
+    movie_t *movie;
+    const char *movie_path; /* Written on exit when recording. */
 };
 
 static struct gusgb GB;
@@ -36,43 +42,60 @@ static void toggle_fullscreen(void)
     }
 }
 
-static void gb_key_press(const SDL_Keysym *keysym)
+/* The joypad belongs to the movie while one plays. */
+static void pad_press(gb_t *gb, key_e key)
+{
+    if (!gb_movie_playing(gb))
+        key_press(gb, key);
+}
+
+static void pad_release(gb_t *gb, key_e key)
+{
+    if (!gb_movie_playing(gb))
+        key_release(gb, key);
+}
+
+static void gb_key_press(gb_t *gb, const SDL_Keysym *keysym)
 {
     switch (keysym->scancode) {
         case SDL_SCANCODE_A:
-            key_press(KEY_A);
+            pad_press(gb, KEY_A);
             break;
         case SDL_SCANCODE_S:
-            key_press(KEY_B);
+            pad_press(gb, KEY_B);
             break;
         case SDL_SCANCODE_RETURN:
             if (keysym->mod & KMOD_ALT) {
                 toggle_fullscreen();
             } else {
-                key_press(KEY_START);
+                pad_press(gb, KEY_START);
             }
             break;
         case SDL_SCANCODE_LSHIFT:
-            key_press(KEY_SELECT);
+            pad_press(gb, KEY_SELECT);
             break;
         case SDL_SCANCODE_UP:
-            key_press(KEY_UP);
+            pad_press(gb, KEY_UP);
             break;
         case SDL_SCANCODE_DOWN:
-            key_press(KEY_DOWN);
+            pad_press(gb, KEY_DOWN);
             break;
         case SDL_SCANCODE_LEFT:
-            key_press(KEY_LEFT);
+            pad_press(gb, KEY_LEFT);
             break;
         case SDL_SCANCODE_RIGHT:
-            key_press(KEY_RIGHT);
+            pad_press(gb, KEY_RIGHT);
+            break;
+        case SDL_SCANCODE_BACKSPACE:
+            /* Rewinding would break a movie being recorded or played. */
+            GB.rewinding = gb->movie == NULL;
             break;
 #ifdef DEBUGGER
         case SDL_SCANCODE_P:
             /* Pause emulation. */
             GB.paused = !GB.paused;
             if (GB.paused) {
-                debugger_init();
+                debugger_init(gb);
             } else {
                 SDL_RaiseWindow(GB.window);
                 debugger_finish();
@@ -80,7 +103,7 @@ static void gb_key_press(const SDL_Keysym *keysym)
             break;
         case SDL_SCANCODE_O:
             /* Debug CPU. */
-            cpu_dump();
+            cpu_dump(gb);
             break;
 #endif
         case SDL_SCANCODE_ESCAPE:
@@ -93,48 +116,51 @@ static void gb_key_press(const SDL_Keysym *keysym)
     }
 }
 
-static void gb_key_release(const SDL_Keysym *keysym)
+static void gb_key_release(gb_t *gb, const SDL_Keysym *keysym)
 {
     switch (keysym->scancode) {
         case SDL_SCANCODE_A:
-            key_release(KEY_A);
+            pad_release(gb, KEY_A);
             break;
         case SDL_SCANCODE_S:
-            key_release(KEY_B);
+            pad_release(gb, KEY_B);
             break;
         case SDL_SCANCODE_RETURN:
-            key_release(KEY_START);
+            pad_release(gb, KEY_START);
             break;
         case SDL_SCANCODE_LSHIFT:
-            key_release(KEY_SELECT);
+            pad_release(gb, KEY_SELECT);
             break;
         case SDL_SCANCODE_UP:
-            key_release(KEY_UP);
+            pad_release(gb, KEY_UP);
             break;
         case SDL_SCANCODE_DOWN:
-            key_release(KEY_DOWN);
+            pad_release(gb, KEY_DOWN);
             break;
         case SDL_SCANCODE_LEFT:
-            key_release(KEY_LEFT);
+            pad_release(gb, KEY_LEFT);
             break;
         case SDL_SCANCODE_RIGHT:
-            key_release(KEY_RIGHT);
+            pad_release(gb, KEY_RIGHT);
+            break;
+        case SDL_SCANCODE_BACKSPACE:
+            GB.rewinding = false;
             break;
         default:
             break;
     }
 }
 
-static void handle_events(void)
+static void handle_events(gb_t *gb)
 {
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         switch (e.type) {
             case SDL_KEYDOWN:
-                gb_key_press(&e.key.keysym);
+                gb_key_press(gb, &e.key.keysym);
                 break;
             case SDL_KEYUP:
-                gb_key_release(&e.key.keysym);
+                gb_key_release(gb, &e.key.keysym);
                 break;
             case SDL_QUIT:
                 GB.running = false;
@@ -142,11 +168,44 @@ static void handle_events(void)
                 break;
         }
 #ifdef DEBUGGER
-        debugger_handle_events(&e);
+        debugger_handle_events(gb, &e);
 #endif
     }
 }
 
+static void gb_video_output(gb_t *gb, const color_t *framebuffer, void *data)
+{
+    (void)data;
+    SDL_RenderClear(GB.ren);
+    SDL_UpdateTexture(GB.tex, NULL, framebuffer, GB_SCREEN_WIDTH * 4);
+    SDL_RenderCopy(GB.ren, GB.tex, NULL, NULL);
+    SDL_RenderPresent(GB.ren);
+    handle_events(gb);
+#ifdef FPS
+    static uint32_t frames;
+    static uint32_t last_time;
+    ++frames;
+    uint32_t time = SDL_GetTicks();
+    if (time >= last_time + 1000) {
+        printf("%u fps\n", frames);
+        frames = 0;
+        last_time = time;
+    }
+#endif
+}
+
+static void gb_audio_output(gb_t *gb, const int16_t *samples, size_t count,
+                            void *data)
+{
+    (void)gb;
+    (void)data;
+    /* Delay while there are samples in the audio queue */
+    while (SDL_GetQueuedAudioSize(1) > count * sizeof(int16_t)) {
+        SDL_Delay(1);
+    }
+    SDL_QueueAudio(1, samples, count * sizeof(int16_t));
+}
+
 static int sdl_init(const char *name, int width, int height, bool fullscreen)
 {
     SDL_AudioSpec desired;
@@ -172,6 +231,7 @@ static int sdl_init(const char *name, int width, int height, bool fullscreen)
         GB.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (GB.ren == NULL)
         return -1;
+    SDL_SetRenderDrawColor(GB.ren, 0, 0, 0, SDL_ALPHA_OPAQUE);
 
     /* Set device independent resolution for rendering */
     SDL_RenderSetLogicalSize(GB.ren, GB_SCREEN_WIDTH, GB_SCREEN_HEIGHT);
@@ -201,6 +261,7 @@ int gusgb_init(int scale, const char *rom_path, bool fullscreen)
     GB.height = GB_SCREEN_HEIGHT * scale;
     GB.running = true;
     GB.paused = false;
+    GB.rewinding = false;
     GB.fullscreen = fullscreen;
     /* Initialize SDL. */
     if (sdl_init("gusgb", GB.width, GB.height, GB.fullscreen) != 0) {
@@ -208,19 +269,51 @@ int gusgb_init(int scale, const char *rom_path, bool fullscreen)
         return -1;
     }
     /* Initialize emulation. */
-    if (cpu_init(rom_path) < 0) {
+    GB.gb = gb_create(rom_path);
+    if (GB.gb == NULL) {
         fprintf(stderr, "ERROR: Could not load rom: %s\n", rom_path);
         return -1;
     }
-    if (gpu_init(GB.ren, GB.tex, handle_events) < 0) {
-        fprintf(stderr, "ERROR: %s\n", SDL_GetError());
+    gb_set_video_sink(GB.gb, gb_video_output, NULL);
+    gb_set_audio_sink(GB.gb, gb_audio_output, NULL);
+#ifdef CPU_DEBUG
+    gb_set_trace(GB.gb, true);
+#endif
+    /* Snapshot every frame, a minute of play takes a few MB. */
+    if (gb_rewind_enable(GB.gb, 16 << 20, 1) < 0)
+        fprintf(stderr, "WARNING: Could not enable rewind\n");
+    return 0;
+}
+
+int gusgb_movie(const char *path, bool record, unsigned int start)
+{
+    if (record) {
+        GB.movie = movie_create();
+        if (GB.movie == NULL)
+            return -1;
+        GB.movie_path = path;
+        /* A keyframe every 10 seconds, about 50KB each. */
+        movie_set_keyframes(GB.movie, 600);
+        gb_movie_record(GB.gb, GB.movie);
+        return 0;
     }
+    GB.movie = movie_load(path);
+    if (GB.movie == NULL || gb_movie_seek(GB.gb, GB.movie, start) < 0)
+        return -1;
     return 0;
 }
 
+void gusgb_set_run_ahead(unsigned int frames)
+{
+    GB.run_ahead = frames;
+}
+
 void gusgb_finish(void)
 {
-    cpu_finish();
+    gb_destroy(GB.gb);
+    if (GB.movie_path != NULL)
+        movie_save(GB.movie, GB.movie_path);
+    movie_destroy(GB.movie);
     SDL_PauseAudio(1);
     SDL_DestroyTexture(GB.tex);
     SDL_DestroyRenderer(GB.ren);
@@ -229,15 +322,26 @@ void gusgb_finish(void)
     exit(EXIT_SUCCESS);
 }
 
+static void run_frame(void)
+{
+    if (GB.rewinding) {
+        /* Stay on the oldest frame once the history runs out. */
+        if (gb_rewind(GB.gb) < 0)
+            gpu_render_framebuffer(GB.gb);
+    } else {
+        gb_run_ahead(GB.gb, GB.run_ahead);
+    }
+}
+
 void gusgb_main(void)
 {
     for (;;) {
 #ifdef DEBUGGER
         if (GB.paused) {
-            gpu_render_framebuffer();
+            gpu_render_framebuffer(GB.gb);
             debugger_render();
         } else
 #endif
-            cpu_emulate_cycle();
+            run_frame();
     }
 }
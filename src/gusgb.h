@@ -4,6 +4,13 @@
 #include <stdbool.h>
 
 int gusgb_init(int scale, const char *rom_path, bool fullscreen);
+/**
+ * Record a joypad movie to path, saved on exit, or play one back from the
+ * start frame.
+ */
+int gusgb_movie(const char *path, bool record, unsigned int start);
+/* Show frames ahead of the emulation to cut input lag, 0 to disable. */
+void gusgb_set_run_ahead(unsigned int frames);
 void gusgb_finish(void);
 void gusgb_main(void);
 
@@ -3,110 +3,151 @@
 #include "clock.h"
 #include "cpu.h"
 #include "cpu_opcodes.h"
+#include "gb.h"
+#include "keys.h"
+#include "timer.h"
 
-extern cpu_t CPU;
+/* Recompute INTERRUPT_PENDING_FIRE after a change to IE or IF. */
+static inline void interrupt_update(gb_t *gb)
+{
+    if (gb->intr.enable & gb->intr.flag)
+        gb->intr.pending |= INTERRUPT_PENDING_FIRE;
+    else
+        gb->intr.pending &= (uint8_t)~INTERRUPT_PENDING_FIRE;
+}
 
-static bool ime;             /* Interrupt master enable: IE, DI */
-static unsigned int ime_cnt; /* IE takes efect after next instr. */
-static unsigned int enable;  /* Interrupt enable: 0xffff register */
-static unsigned int flag;    /* Interrupt flag: 0xff0f register */
+void interrupt_reset(gb_t *gb)
+{
+    gb->intr.ime = true;
+    gb->intr.ime_at = clock_now(gb) + 4;
+    gb->intr.enable = 0;
+    gb->intr.flag = 1;
+    /* The timer is checked until the clock schedules it. */
+    gb->intr.pending = INTERRUPT_PENDING_TIMER;
+}
 
-void interrupt_reset(void)
+void interrupt_set_master(gb_t *gb, bool value)
 {
-    ime = true;
-    ime_cnt = 0;
-    enable = 0;
-    flag = 1;
+    /* Called at the end of EI or RETI: enabled after the next instruction,
+     * which ends at least 4 cycles later. */
+    if (!gb->intr.ime)
+        gb->intr.ime_at = clock_now(gb) + 4;
+    gb->intr.ime = value;
 }
 
-void interrupt_set_master(bool value)
+void interrupt_pending(gb_t *gb, uint8_t bit, bool value)
 {
-    if (!ime)
-        ime_cnt = 0;
-    ime = value;
+    if (value)
+        gb->intr.pending |= bit;
+    else
+        gb->intr.pending &= (uint8_t)~bit;
 }
 
-uint8_t interrupt_is_enable(uint8_t bit)
+uint8_t interrupt_is_enable(gb_t *gb, uint8_t bit)
 {
-    return enable & bit;
+    return gb->intr.enable & bit;
 }
 
-uint8_t interrupt_get_enable(void)
+uint8_t interrupt_get_enable(gb_t *gb)
 {
-    return enable;
+    return gb->intr.enable;
 }
 
-void interrupt_set_enable(uint8_t value)
+void interrupt_set_enable(gb_t *gb, uint8_t value)
 {
-    enable = value;
+    gb->intr.enable = value;
+    interrupt_update(gb);
 }
 
-uint8_t interrupt_get_flag(void)
+uint8_t interrupt_get_flag(gb_t *gb)
 {
-    return 0xe0 | flag;
+    timer_sync(gb);
+    return 0xe0 | gb->intr.flag;
 }
 
-void interrupt_set_flag(uint8_t value)
+void interrupt_set_flag(gb_t *gb, uint8_t value)
 {
-    flag = 0x1f & value;
+    timer_sync(gb);
+    gb->intr.flag = 0x1f & value;
+    interrupt_update(gb);
 }
 
-void interrupt_raise(uint8_t bit)
+void interrupt_raise(gb_t *gb, uint8_t bit)
 {
-    flag |= bit;
+    gb->intr.flag |= bit;
+    interrupt_update(gb);
 }
 
-static inline void interrupt_clear_flag_bit(uint8_t bit)
+static inline void interrupt_clear_flag_bit(gb_t *gb, uint8_t bit)
 {
-    flag = (uint8_t)(flag & ~bit);
+    gb->intr.flag = (uint8_t)(gb->intr.flag & ~bit);
+    interrupt_update(gb);
 }
 
-void interrupt_step(void)
+void interrupt_step(gb_t *gb)
 {
-    unsigned char fire = enable & flag;
-    ++ime_cnt;
+    /* The timer may have overflowed during the instruction. */
+    if (clock_now(gb) >= gb->clock.at[CLOCK_EVENT_TIMER])
+        timer_sync(gb);
+    unsigned char fire = gb->intr.enable & gb->intr.flag;
+    if (gb->cpu.stop) {
+        if (!keys_get_held(gb))
+            return;
+        interrupt_pending(gb, INTERRUPT_PENDING_STOP, false);
+        gb->cpu.stop = false;
+        gb->cpu.halt = false;
+        gb->cpu.reg.pc++;
+    }
     if (fire) {
-        if (CPU.halt && !CPU.halt_bug) {
-            CPU.halt = false;
-            CPU.reg.pc++;
+        if (gb->cpu.halt && !gb->cpu.halt_bug) {
+            gb->cpu.halt = false;
+            gb->cpu.reg.pc++;
         }
-        if (!ime || ime_cnt < 2)
+        if (!gb->intr.ime || clock_now(gb) < gb->intr.ime_at)
             return;
-        ime = false;
-        push(CPU.reg.pc);
-        clock_step(12);
+        gb->intr.ime = false;
+        cpu_idle_forget(&gb->idle);
+        push(gb, gb->cpu.reg.pc);
+        clock_step(gb, 12);
         if (fire & INTERRUPTS_VBLANK) {
-            interrupt_clear_flag_bit(INTERRUPTS_VBLANK);
-            CPU.reg.pc = 0x40;
+            interrupt_clear_flag_bit(gb, INTERRUPTS_VBLANK);
+            gb->cpu.reg.pc = 0x40;
             return;
         }
         if (fire & INTERRUPTS_LCDSTAT) {
-            interrupt_clear_flag_bit(INTERRUPTS_LCDSTAT);
-            CPU.reg.pc = 0x48;
+            interrupt_clear_flag_bit(gb, INTERRUPTS_LCDSTAT);
+            gb->cpu.reg.pc = 0x48;
             return;
         }
         if (fire & INTERRUPTS_TIMER) {
-            interrupt_clear_flag_bit(INTERRUPTS_TIMER);
-            CPU.reg.pc = 0x50;
+            interrupt_clear_flag_bit(gb, INTERRUPTS_TIMER);
+            gb->cpu.reg.pc = 0x50;
             return;
         }
         if (fire & INTERRUPTS_SERIAL) {
-            interrupt_clear_flag_bit(INTERRUPTS_SERIAL);
-            CPU.reg.pc = 0x58;
+            interrupt_clear_flag_bit(gb, INTERRUPTS_SERIAL);
+            gb->cpu.reg.pc = 0x58;
             return;
         }
         if (fire & INTERRUPTS_JOYPAD) {
-            interrupt_clear_flag_bit(INTERRUPTS_JOYPAD);
-            CPU.reg.pc = 0x60;
+            interrupt_clear_flag_bit(gb, INTERRUPTS_JOYPAD);
+            gb->cpu.reg.pc = 0x60;
             return;
         }
     }
 }
 
-void interrupt_dump(void)
+bool interrupt_wake_pending(gb_t *gb)
+{
+    if (gb->cpu.stop)
+        return keys_get_held(gb) != 0;
+    return gb->intr.enable & gb->intr.flag;
+}
+
+void interrupt_dump(gb_t *gb)
 {
     printf("Interrupts:\n");
-    printf("ime=%d\n", ime);
-    printf("ie=0x%.2x\n", enable);
-    printf("if=0x%.2x\n", flag);
+    printf("ime=%d\n", gb->intr.ime);
+    printf("ie=0x%.2x\n", gb->intr.enable);
+    printf("if=0x%.2x\n", gb->intr.flag);
 }
@@ -10,19 +10,40 @@
 #define INTERRUPTS_SERIAL (1 << 3)
 #define INTERRUPTS_JOYPAD (1 << 4)
 
-void interrupt_reset(void);
+/* Why interrupt_step() may have work after an instruction. */
+#define INTERRUPT_PENDING_FIRE (1 << 0)  /* IE & IF. */
+#define INTERRUPT_PENDING_TIMER (1 << 1) /* TIMA may overflow by then. */
+#define INTERRUPT_PENDING_STOP (1 << 2)  /* STOP waits for a key. */
 
-void interrupt_set_master(bool value);
+typedef struct gb gb_t;
 
-uint8_t interrupt_is_enable(uint8_t bit);
-uint8_t interrupt_get_enable(void);
-void interrupt_set_enable(uint8_t value);
+typedef struct {
+    bool ime;            /* Interrupt master enable: IE, DI */
+    uint64_t ime_at;     /* Clock cycle EI takes effect from. */
+    unsigned int enable; /* Interrupt enable: 0xffff register */
+    unsigned int flag;   /* Interrupt flag: 0xff0f register */
+    uint8_t pending;     /* INTERRUPT_PENDING_* bits. */
+} interrupt_t;
 
-uint8_t interrupt_get_flag(void);
-void interrupt_set_flag(uint8_t value);
-void interrupt_raise(uint8_t bit);
+void interrupt_reset(gb_t *gb);
 
-void interrupt_step(void);
-void interrupt_dump(void);
+void interrupt_set_master(gb_t *gb, bool value);
+
+uint8_t interrupt_is_enable(gb_t *gb, uint8_t bit);
+uint8_t interrupt_get_enable(gb_t *gb);
+void interrupt_set_enable(gb_t *gb, uint8_t value);
+
+uint8_t interrupt_get_flag(gb_t *gb);
+void interrupt_set_flag(gb_t *gb, uint8_t value);
+void interrupt_raise(gb_t *gb, uint8_t bit);
+
+/* Set or clear INTERRUPT_PENDING_TIMER or _STOP. */
+void interrupt_pending(gb_t *gb, uint8_t bit, bool value);
+
+/* Run after an instruction, needed only if pending is not 0. */
+void interrupt_step(gb_t *gb);
+/* True if a halted or stopped CPU wakes at the next interrupt_step(). */
+bool interrupt_wake_pending(gb_t *gb);
+void interrupt_dump(gb_t *gb);
 
 #endif /* INTERRUPT_H */
@@ -5,137 +5,136 @@
 
 #include "cartridge/cart.h"
 #include "debug.h"
+#include "gb.h"
 #include "interrupt.h"
+#include "movie.h"
 
-typedef struct {
-    uint8_t rows[2];
-    uint8_t column;
-} keys_t;
-
-static keys_t KEY;
-
-void keys_reset(void)
+void keys_reset(gb_t *gb)
 {
-    if (cart_is_cgb()) {
-        KEY.rows[0] = 0xff;
-        KEY.rows[1] = 0xff;
+    if (cart_is_cgb(&gb->cart)) {
+        gb->keys.rows[0] = 0xff;
+        gb->keys.rows[1] = 0xff;
     } else {
-        KEY.rows[0] = 0xcf;
-        KEY.rows[1] = 0xcf;
+        gb->keys.rows[0] = 0xcf;
+        gb->keys.rows[1] = 0xcf;
     }
-    KEY.column = 0x10;
+    gb->keys.column = 0x10;
 }
 
-uint8_t keys_read(void)
+uint8_t keys_read(gb_t *gb)
 {
-    switch (KEY.column) {
+    switch (gb->keys.column) {
         case 0x10:
-            return KEY.rows[0];
+            return gb->keys.rows[0];
         case 0x20:
-            return KEY.rows[1];
+            return gb->keys.rows[1];
         default:
             return 0xc0;
     }
 }
 
-void keys_write(uint8_t value)
+void keys_write(gb_t *gb, uint8_t value)
 {
-    KEY.column = value & 0x30;
+    gb->keys.column = value & 0x30;
 }
 
-void key_press(key_e key)
+void key_press(gb_t *gb, key_e key)
 {
     switch (key) {
         case KEY_START:
-            KEY.rows[0] &= 0xc7;
+            gb->keys.rows[0] &= 0xc7;
             break;
         case KEY_SELECT:
-            KEY.rows[0] &= 0xcb;
+            gb->keys.rows[0] &= 0xcb;
             break;
         case KEY_B:
-            KEY.rows[0] &= 0xcd;
+            gb->keys.rows[0] &= 0xcd;
             break;
         case KEY_A:
-            KEY.rows[0] &= 0xce;
+            gb->keys.rows[0] &= 0xce;
             break;
         case KEY_DOWN:
-            KEY.rows[1] &= 0xc7;
+            gb->keys.rows[1] &= 0xc7;
             break;
         case KEY_UP:
-            KEY.rows[1] &= 0xcb;
+            gb->keys.rows[1] &= 0xcb;
             break;
         case KEY_LEFT:
-            KEY.rows[1] &= 0xcd;
+            gb->keys.rows[1] &= 0xcd;
             break;
         case KEY_RIGHT:
-            KEY.rows[1] &= 0xce;
+            gb->keys.rows[1] &= 0xce;
             break;
         default:
             error("unknown key: %d", key);
     }
-    interrupt_raise(INTERRUPTS_JOYPAD);
+    interrupt_raise(gb, INTERRUPTS_JOYPAD);
+    if (gb->movie != NULL)
+        movie_input(gb);
 }
 
-void key_release(key_e key)
+void key_release(gb_t *gb, key_e key)
 {
     switch (key) {
         case KEY_START:
-            KEY.rows[0] |= 0x8;
+            gb->keys.rows[0] |= 0x8;
             break;
         case KEY_SELECT:
-            KEY.rows[0] |= 0x4;
+            gb->keys.rows[0] |= 0x4;
             break;
         case KEY_B:
-            KEY.rows[0] |= 0x2;
+            gb->keys.rows[0] |= 0x2;
             break;
         case KEY_A:
-            KEY.rows[0] |= 0x1;
+            gb->keys.rows[0] |= 0x1;
             break;
         case KEY_DOWN:
-            KEY.rows[1] |= 0x8;
+            gb->keys.rows[1] |= 0x8;
             break;
         case KEY_UP:
-            KEY.rows[1] |= 0x4;
+            gb->keys.rows[1] |= 0x4;
             break;
         case KEY_LEFT:
-            KEY.rows[1] |= 0x2;
+            gb->keys.rows[1] |= 0x2;
             break;
         case KEY_RIGHT:
-            KEY.rows[1] |= 0x1;
+            gb->keys.rows[1] |= 0x1;
             break;
         default:
             error("unknown key: %d", key);
     }
-    interrupt_raise(INTERRUPTS_JOYPAD);
+    interrupt_raise(gb, INTERRUPTS_JOYPAD);
+    if (gb->movie != NULL)
+        movie_input(gb);
 }
 
-bool key_check_pressed(key_e key)
+bool key_check_pressed(gb_t *gb, key_e key)
 {
     uint8_t val;
     switch (key) {
         case KEY_START:
-            val = KEY.rows[0] & 0x8;
+            val = gb->keys.rows[0] & 0x8;
             break;
         case KEY_SELECT:
-            val = KEY.rows[0] & 0x4;
+            val = gb->keys.rows[0] & 0x4;
             break;
         case KEY_B:
-            val = KEY.rows[0] & 0x2;
+            val = gb->keys.rows[0] & 0x2;
             break;
         case KEY_A:
-            val = KEY.rows[0] & 0x1;
+            val = gb->keys.rows[0] & 0x1;
             break;
         case KEY_DOWN:
-            val = KEY.rows[1] & 0x8;
+            val = gb->keys.rows[1] & 0x8;
             break;
         case KEY_UP:
-            val = KEY.rows[1] & 0x4;
+            val = gb->keys.rows[1] & 0x4;
             break;
         case KEY_LEFT:
-            val = KEY.rows[1] & 0x2;
+            val = gb->keys.rows[1] & 0x2;
             break;
         case KEY_RIGHT:
-            val = KEY.rows[1] & 0x1;
+            val = gb->keys.rows[1] & 0x1;
             break;
         default:
             error("unknown key: %d", key);
@@ -143,6 +142,29 @@ bool key_check_pressed(key_e key)
     return !val;
 }
 
+uint8_t keys_get_held(gb_t *gb)
+{
+    uint8_t keys = 0;
+    for (int k = 0; k < KEY_MAX; ++k) {
+        if (key_check_pressed(gb, k))
+            keys |= 1 << k;
+    }
+    return keys;
+}
+
+void keys_set_held(gb_t *gb, uint8_t keys)
+{
+    uint8_t changed = keys_get_held(gb) ^ keys;
+    for (int k = 0; k < KEY_MAX; ++k) {
+        if (!(changed & (1 << k)))
+            continue;
+        if (keys & (1 << k))
+            key_press(gb, k);
+        else
+            key_release(gb, k);
+    }
+}
+
 const char *keys_str[] = {"Start", "Select", "B",    "A",
                           "Down",  "Up",     "Left", "Right"};
 
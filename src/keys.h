@@ -16,12 +16,22 @@ typedef enum {
     KEY_MAX
 } key_e;
 
-void keys_reset(void);
-uint8_t keys_read(void);
-void keys_write(uint8_t value);
-void key_press(key_e key);
-void key_release(key_e key);
-bool key_check_pressed(key_e key);
+typedef struct gb gb_t;
+
+typedef struct {
+    uint8_t rows[2];
+    uint8_t column;
+} keys_t;
+
+void keys_reset(gb_t *gb);
+uint8_t keys_read(gb_t *gb);
+void keys_write(gb_t *gb, uint8_t value);
+void key_press(gb_t *gb, key_e key);
+void key_release(gb_t *gb, key_e key);
+bool key_check_pressed(gb_t *gb, key_e key);
+/* Keys held as a mask, bit n set when key_e n is pressed. */
+uint8_t keys_get_held(gb_t *gb);
+void keys_set_held(gb_t *gb, uint8_t keys);
 const char *key_str(key_e key);
 
 #endif /* KEY_H */
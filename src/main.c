@@ -6,11 +6,15 @@
 static int scale = 4;
 static char *romfile = NULL;
 static bool fullscreen = false;
+static char *movie_path = NULL;
+static bool movie_record = false;
+static unsigned int movie_start = 0;
+static unsigned int run_ahead = 0;
 
 static int parse_args(int argc, char **argv)
 {
     int opt;
-    while ((opt = getopt(argc, argv, "s:fch")) != -1) {
+    while ((opt = getopt(argc, argv, "s:a:fp:r:t:ch")) != -1) {
         switch (opt) {
             case 's':
                 scale = strtol(optarg, NULL, 10);
@@ -19,15 +23,32 @@ static int parse_args(int argc, char **argv)
                     return -1;
                 }
                 break;
+            case 'a':
+                run_ahead = strtoul(optarg, NULL, 10);
+                if (run_ahead > 8) {
+                    fprintf(stderr, "Invalid run-ahead: %u\n", run_ahead);
+                    return -1;
+                }
+                break;
             case 'f':
                 fullscreen = true;
                 break;
+            case 'p':
+            case 'r':
+                movie_path = optarg;
+                movie_record = opt == 'r';
+                break;
+            case 't':
+                /* Seconds of 60 frames. */
+                movie_start = strtoul(optarg, NULL, 10) * 60;
+                break;
             case 'c':
                 printf(
                     "%s:\n"
                     "Controls:\n"
                     "P:\t\tPause emulation\n"
                     "O:\t\tDump emulator debugs\n"
+                    "Backspace:\tRewind while held\n"
                     "ESC, Q:\t\tQuit program\n"
                     "Alt + Enter:\tToggle fullscreen mode\n"
                     "\n"
@@ -58,10 +79,14 @@ static void print_help(char **argv)
     fprintf(stderr,
             "Usage: %s [options] romfile\n"
             "Options:\n"
+            "  -a <frames>\tRun ahead to hide input lag (0-8)\n"
             "  -c\t\tPrint keyboard controls\n"
             "  -f\t\tStart in fullscreen mode\n"
             "  -h\t\tPrint help and exit\n"
-            "  -s <scale>\tScale video output\n",
+            "  -p <movie>\tPlay back a joypad movie\n"
+            "  -r <movie>\tRecord a joypad movie, written on exit\n"
+            "  -s <scale>\tScale video output\n"
+            "  -t <seconds>\tStart movie playback at the given time\n",
             argv[0]);
 }
 
@@ -75,6 +100,11 @@ int main(int argc, char *argv[])
     if (ret < 0) {
         exit(EXIT_FAILURE);
     }
+    gusgb_set_run_ahead(run_ahead);
+    if (movie_path != NULL &&
+        gusgb_movie(movie_path, movie_record, movie_start) < 0) {
+        exit(EXIT_FAILURE);
+    }
     gusgb_main();
     gusgb_finish();
     return 0;
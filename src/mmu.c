@@ -6,64 +6,106 @@
 #include "apu/apu.h"
 #include "cartridge/cart.h"
 #include "clock.h"
+#include "gb.h"
 #include "gpu.h"
 #include "interrupt.h"
 #include "keys.h"
 #include "timer.h"
 
-static mmu_t MMU;
+static void mmu_alloc(gb_t *gb)
+{
+    for (int i = 0; i < 8; ++i)
+        gb->mmu.wram[i] = page_create(MMU_WRAM_BANK_SIZE);
+    gpu_init(gb);
+}
+
+int mmu_init(gb_t *gb, const char *rom_path)
+{
+    int ret = cart_load(&gb->cart, rom_path);
+    if (ret < 0) {
+        return -1;
+    }
+    mmu_alloc(gb);
+    mmu_reset(gb);
+    return 0;
+}
 
-int mmu_init(const char *rom_path)
+int mmu_init_shared(gb_t *gb, const gb_t *src)
 {
-    int ret = cart_load(rom_path);
+    int ret = cart_load_shared(&gb->cart, &src->cart);
     if (ret < 0) {
         return -1;
     }
-    mmu_reset();
+    mmu_alloc(gb);
+    mmu_reset(gb);
     return 0;
 }
 
-void mmu_finish(void)
+void mmu_fork(gb_t *gb, const gb_t *src)
 {
-    cart_unload();
+    cart_fork(&gb->cart, &src->cart);
+    for (int i = 0; i < 8; ++i)
+        gb->mmu.wram[i] = page_ref(src->mmu.wram[i]);
+    gpu_fork(gb, src);
 }
 
-void mmu_reset(void)
+void mmu_finish(gb_t *gb)
 {
-    memset(MMU.wram, 0, sizeof(MMU.wram));
-    memset(MMU.zram, 0, sizeof(MMU.zram));
-    if (cart_is_cgb()) {
-        MMU.speed_switch = 0x7e;
-        MMU.undoc_reg[0] = 0xfe;
-        MMU.undoc_reg[1] = 0x00;
-        MMU.undoc_reg[2] = 0x00;
-        MMU.undoc_reg[3] = 0x00;
-        MMU.undoc_reg[4] = 0x00;
+    for (int i = 0; i < 8; ++i) {
+        page_unref(gb->mmu.wram[i]);
+        gb->mmu.wram[i] = NULL;
+    }
+    gpu_finish(gb);
+    cart_unload(&gb->cart);
+}
+
+static uint8_t mmu_read_reg_dmg(gb_t *gb, uint16_t addr);
+static uint8_t mmu_read_reg_cgb(gb_t *gb, uint16_t addr);
+static void mmu_write_reg_dmg(gb_t *gb, uint16_t addr, uint8_t value);
+static void mmu_write_reg_cgb(gb_t *gb, uint16_t addr, uint8_t value);
+
+void mmu_reset(gb_t *gb)
+{
+    for (int i = 0; i < 8; ++i)
+        page_clear(&gb->mmu.wram[i]);
+    memset(gb->mmu.zram, 0, sizeof(gb->mmu.zram));
+    if (cart_is_cgb(&gb->cart)) {
+        gb->mmu.read_reg = mmu_read_reg_cgb;
+        gb->mmu.write_reg = mmu_write_reg_cgb;
+        gb->mmu.speed_switch = 0x7e;
+        gb->mmu.undoc_reg[0] = 0xfe;
+        gb->mmu.undoc_reg[1] = 0x00;
+        gb->mmu.undoc_reg[2] = 0x00;
+        gb->mmu.undoc_reg[3] = 0x00;
+        gb->mmu.undoc_reg[4] = 0x00;
     } else {
-        MMU.speed_switch = 0xff;
-        MMU.hdma1 = 0xff;
-        MMU.hdma2 = 0xff;
-        MMU.hdma3 = 0xff;
-        MMU.hdma4 = 0xff;
-        MMU.hdma5 = 0xff;
-        MMU.ir = 0xff;
-        MMU.undoc_reg[0] = 0xff;
-        MMU.undoc_reg[1] = 0xff;
-        MMU.undoc_reg[2] = 0xff;
-        MMU.undoc_reg[3] = 0xff;
-        MMU.undoc_reg[4] = 0xff;
+        gb->mmu.read_reg = mmu_read_reg_dmg;
+        gb->mmu.write_reg = mmu_write_reg_dmg;
+        gb->mmu.speed_switch = 0xff;
+        gb->mmu.hdma1 = 0xff;
+        gb->mmu.hdma2 = 0xff;
+        gb->mmu.hdma3 = 0xff;
+        gb->mmu.hdma4 = 0xff;
+        gb->mmu.hdma5 = 0xff;
+        gb->mmu.ir = 0xff;
+        gb->mmu.undoc_reg[0] = 0xff;
+        gb->mmu.undoc_reg[1] = 0xff;
+        gb->mmu.undoc_reg[2] = 0xff;
+        gb->mmu.undoc_reg[3] = 0xff;
+        gb->mmu.undoc_reg[4] = 0xff;
     }
-    MMU.wram_bank = 0;
-    interrupt_reset();
-    keys_reset();
-    apu_reset();
-    gpu_reset();
+    gb->mmu.wram_bank = 0;
+    cart_reset(&gb->cart);
+    interrupt_reset(gb);
+    keys_reset(gb);
+    apu_reset(gb);
+    gpu_reset(gb);
 }
 
-static void mmu_dma_start(uint8_t mode)
+static void mmu_dma_start(gb_t *gb, uint8_t mode)
 {
-    uint16_t src = ((MMU.hdma1 << 8) | MMU.hdma2) & 0xfff0;
-    uint16_t dest = 0x8000 | (((MMU.hdma3 << 8) | MMU.hdma4) & 0x1ff0);
+    uint16_t src = ((gb->mmu.hdma1 << 8) | gb->mmu.hdma2) & 0xfff0;
+    uint16_t dest = 0x8000 | (((gb->mmu.hdma3 << 8) | gb->mmu.hdma4) & 0x1ff0);
     if (mode & 0x80) {
         /* H-Blank DMA */
         printf("%s: not implemented\n", __func__);
@@ -72,19 +114,19 @@ static void mmu_dma_start(uint8_t mode)
         unsigned int length = (mode & 0x7f) + 1;
         for (unsigned int i = 0; i < length; ++i) {
             for (unsigned int j = 0; j < 16; ++j) {
-                mmu_write_byte_dma(dest++, mmu_read_byte_dma(src++));
+                mmu_write_byte_dma(gb, dest++, mmu_read_byte_dma(gb, src++));
             }
-            clock_step(32 << MMU.clock_speed);
+            clock_step(gb, 32 << gb->mmu.clock_speed);
         }
-        MMU.hdma5 = 0xff;
+        gb->mmu.hdma5 = 0xff;
     }
 }
 
-static uint8_t mmu_read_reg(uint16_t addr)
+CART_MODEL_INLINE uint8_t mmu_read_reg(gb_t *gb, uint16_t addr, bool cgb)
 {
     switch (addr & 0x007f) {
         case 0x00:
-            return keys_read();
+            return keys_read(gb);
         case 0x01:
             /* TODO: SB Serial transfer data */
             return 0;
@@ -92,61 +134,61 @@ static uint8_t mmu_read_reg(uint16_t addr)
             /* TODO: SIO control */
             return 0x7e;
         case 0x04:
-            return timer_read_div();
+            return timer_read_div(gb);
         case 0x05:
-            return timer_read_tima();
+            return timer_read_tima(gb);
         case 0x06:
-            return timer_read_tma();
+            return timer_read_tma(gb);
         case 0x07:
-            return timer_read_tac();
+            return timer_read_tac(gb);
         case 0x0f:
-            return interrupt_get_flag();
+            return interrupt_get_flag(gb);
         case 0x10:
-            return apu_read_nr10();
+            return apu_read_nr10(gb);
         case 0x11:
-            return apu_read_nr11();
+            return apu_read_nr11(gb);
         case 0x12:
-            return apu_read_nr12();
+            return apu_read_nr12(gb);
         case 0x13:
-            return apu_read_nr13();
+            return apu_read_nr13(gb);
         case 0x14:
-            return apu_read_nr14();
+            return apu_read_nr14(gb);
         case 0x15:
             return 0xff;
         case 0x16:
-            return apu_read_nr21();
+            return apu_read_nr21(gb);
         case 0x17:
-            return apu_read_nr22();
+            return apu_read_nr22(gb);
         case 0x18:
-            return apu_read_nr23();
+            return apu_read_nr23(gb);
         case 0x19:
-            return apu_read_nr24();
+            return apu_read_nr24(gb);
         case 0x1a:
-            return apu_read_nr30();
+            return apu_read_nr30(gb);
         case 0x1b:
-            return apu_read_nr31();
+            return apu_read_nr31(gb);
         case 0x1c:
-            return apu_read_nr32();
+            return apu_read_nr32(gb);
         case 0x1d:
-            return apu_read_nr33();
+            return apu_read_nr33(gb);
         case 0x1e:
-            return apu_read_nr34();
+            return apu_read_nr34(gb);
         case 0x1f:
             return 0xff;
         case 0x20:
-            return apu_read_nr41();
+            return apu_read_nr41(gb);
         case 0x21:
-            return apu_read_nr42();
+            return apu_read_nr42(gb);
         case 0x22:
-            return apu_read_nr43();
+            return apu_read_nr43(gb);
         case 0x23:
-            return apu_read_nr44();
+            return apu_read_nr44(gb);
         case 0x24:
-            return apu_read_nr50();
+            return apu_read_nr50(gb);
         case 0x25:
-            return apu_read_nr51();
+            return apu_read_nr51(gb);
         case 0x26:
-            return apu_read_nr52();
+            return apu_read_nr52(gb);
         case 0x27:
         case 0x28:
         case 0x29:
@@ -173,73 +215,73 @@ static uint8_t mmu_read_reg(uint16_t addr)
         case 0x3d:
         case 0x3e:
         case 0x3f:
-            return apu_read_wave(addr & 0xf);
+            return apu_read_wave(gb, addr & 0xf);
         case 0x40:
-            return gpu_read_lcdc();
+            return gpu_read_lcdc(gb);
         case 0x41:
-            return gpu_read_stat();
+            return gpu_read_stat(gb);
         case 0x42:
-            return gpu_read_scy();
+            return gpu_read_scy(gb);
         case 0x43:
-            return gpu_read_scx();
+            return gpu_read_scx(gb);
         case 0x44:
-            return gpu_read_ly();
+            return gpu_read_ly(gb);
         case 0x45:
-            return gpu_read_lyc();
+            return gpu_read_lyc(gb);
         case 0x46:
-            return gpu_read_dma();
+            return gpu_read_dma(gb);
         case 0x47:
-            return gpu_read_bgp();
+            return gpu_read_bgp(gb);
         case 0x48:
-            return gpu_read_obp0();
+            return gpu_read_obp0(gb);
         case 0x49:
-            return gpu_read_obp1();
+            return gpu_read_obp1(gb);
         case 0x4a:
-            return gpu_read_wy();
+            return gpu_read_wy(gb);
         case 0x4b:
-            return gpu_read_wx();
+            return gpu_read_wx(gb);
         case 0x4d:
-            return MMU.speed_switch;
+            return gb->mmu.speed_switch;
         case 0x4f:
-            return gpu_read_vbk();
+            return gpu_read_vbk(gb);
         case 0x50:
             return 0xff;
         case 0x51:
-            return MMU.hdma1;
+            return gb->mmu.hdma1;
         case 0x52:
-            return MMU.hdma2;
+            return gb->mmu.hdma2;
         case 0x53:
-            return MMU.hdma3;
+            return gb->mmu.hdma3;
         case 0x54:
-            return MMU.hdma4;
+            return gb->mmu.hdma4;
         case 0x55:
-            return MMU.hdma5;
+            return gb->mmu.hdma5;
         case 0x56:
-            return MMU.ir;
+            return gb->mmu.ir;
         case 0x68:
-            return gpu_read_bgpi();
+            return gpu_read_bgpi(gb);
         case 0x69:
-            return gpu_read_bgpd();
+            return gpu_read_bgpd(gb);
         case 0x6a:
-            return gpu_read_obpi();
+            return gpu_read_obpi(gb);
         case 0x6b:
-            return gpu_read_obpd();
+            return gpu_read_obpd(gb);
         case 0x70:
-            if (cart_is_cgb())
-                return MMU.wram_bank;
+            if (cgb)
+                return gb->mmu.wram_bank;
             return 0xff;
         case 0x72:
-            return MMU.undoc_reg[1];
+            return gb->mmu.undoc_reg[1];
         case 0x73:
-            return MMU.undoc_reg[2];
+            return gb->mmu.undoc_reg[2];
         case 0x75:
-            return MMU.undoc_reg[4] | 0x8f;
+            return gb->mmu.undoc_reg[4] | 0x8f;
         case 0x76:
-            if (cart_is_cgb())
+            if (cgb)
                 return 0x00;
             return 0xff;
         case 0x77:
-            if (cart_is_cgb())
+            if (cgb)
                 return 0x00;
             return 0xff;
         default:
@@ -247,11 +289,12 @@ static uint8_t mmu_read_reg(uint16_t addr)
     }
 }
 
-static void mmu_write_reg(uint16_t addr, uint8_t value)
+CART_MODEL_INLINE void mmu_write_reg(gb_t *gb, uint16_t addr, uint8_t value,
+                                     bool cgb)
 {
     switch (addr & 0x007f) {
         case 0x00:
-            keys_write(value);
+            keys_write(gb, value);
             break;
         case 0x01:
             /* TODO: SB Serial transfer data */
@@ -260,86 +303,86 @@ static void mmu_write_reg(uint16_t addr, uint8_t value)
             /* TODO: SIO control */
             break;
         case 0x04:
-            timer_write_div();
+            timer_write_div(gb);
             break;
         case 0x05:
-            timer_write_tima(value);
+            timer_write_tima(gb, value);
             break;
         case 0x06:
-            timer_write_tma(value);
+            timer_write_tma(gb, value);
             break;
         case 0x07:
-            timer_write_tac(value);
+            timer_write_tac(gb, value);
             break;
         case 0x0f:
-            interrupt_set_flag(value);
+            interrupt_set_flag(gb, value);
             break;
         case 0x10:
-            apu_write_nr10(value);
+            apu_write_nr10(gb, value);
             break;
         case 0x11:
-            apu_write_nr11(value);
+            apu_write_nr11(gb, value);
             break;
         case 0x12:
-            apu_write_nr12(value);
+            apu_write_nr12(gb, value);
             break;
         case 0x13:
-            apu_write_nr13(value);
+            apu_write_nr13(gb, value);
             break;
         case 0x14:
-            apu_write_nr14(value);
+            apu_write_nr14(gb, value);
             break;
         case 0x15:
             break;
         case 0x16:
-            apu_write_nr21(value);
+            apu_write_nr21(gb, value);
             break;
         case 0x17:
-            apu_write_nr22(value);
+            apu_write_nr22(gb, value);
             break;
         case 0x18:
-            apu_write_nr23(value);
+            apu_write_nr23(gb, value);
             break;
         case 0x19:
-            apu_write_nr24(value);
+            apu_write_nr24(gb, value);
             break;
         case 0x1a:
-            apu_write_nr30(value);
+            apu_write_nr30(gb, value);
             break;
         case 0x1b:
-            apu_write_nr31(value);
+            apu_write_nr31(gb, value);
             break;
         case 0x1c:
-            apu_write_nr32(value);
+            apu_write_nr32(gb, value);
             break;
         case 0x1d:
-            apu_write_nr33(value);
+            apu_write_nr33(gb, value);
             break;
         case 0x1e:
-            apu_write_nr34(value);
+            apu_write_nr34(gb, value);
             break;
         case 0x1f:
             break;
         case 0x20:
-            apu_write_nr41(value);
+            apu_write_nr41(gb, value);
             break;
         case 0x21:
-            apu_write_nr42(value);
+            apu_write_nr42(gb, value);
             break;
         case 0x22:
-            apu_write_nr43(value);
+            apu_write_nr43(gb, value);
             break;
         case 0x23:
-            apu_write_nr44(value);
+            apu_write_nr44(gb, value);
             break;
         case 0x24:
-            apu_write_nr50(value);
+            apu_write_nr50(gb, value);
             break;
         case 0x25:
-            apu_write_nr51(value);
+            apu_write_nr51(gb, value);
             break;
         case 0x26:
-            apu_write_nr52(value);
+            apu_write_nr52(gb, value);
             break;
         case 0x27:
         case 0x28:
@@ -367,236 +410,293 @@ static void mmu_write_reg(uint16_t addr, uint8_t value)
         case 0x3d:
         case 0x3e:
         case 0x3f:
-            apu_write_wave(addr & 0xf, value);
+            apu_write_wave(gb, addr & 0xf, value);
             break;
         case 0x40:
-            gpu_write_lcdc(value);
+            gpu_write_lcdc(gb, value);
             break;
         case 0x41:
-            gpu_write_stat(value);
+            gpu_write_stat(gb, value);
             break;
         case 0x42:
-            gpu_write_scy(value);
+            gpu_write_scy(gb, value);
             break;
         case 0x43:
-            gpu_write_scx(value);
+            gpu_write_scx(gb, value);
             break;
         case 0x44:
             break;
         case 0x45:
-            gpu_write_lyc(value);
+            gpu_write_lyc(gb, value);
             break;
         case 0x46:
-            gpu_write_dma(value);
+            gpu_write_dma(gb, value);
             break;
         case 0x47:
-            gpu_write_bgp(value);
+            gpu_write_bgp(gb, value);
             break;
         case 0x48:
-            gpu_write_obp0(value);
+            gpu_write_obp0(gb, value);
             break;
         case 0x49:
-            gpu_write_obp1(value);
+            gpu_write_obp1(gb, value);
             break;
         case 0x4a:
-            gpu_write_wy(value);
+            gpu_write_wy(gb, value);
             break;
         case 0x4b:
-            gpu_write_wx(value);
+            gpu_write_wx(gb, value);
             break;
         case 0x4d:
-            if (cart_is_cgb())
-                MMU.speed_switch = (MMU.speed_switch & 0xfe) | (value & 1);
+            if (cgb)
+                gb->mmu.speed_switch =
+                    (gb->mmu.speed_switch & 0xfe) | (value & 1);
             break;
         case 0x4f:
-            gpu_write_vbk(value);
+            gpu_write_vbk(gb, value);
             break;
         case 0x50:
             /* Disable internal ROM. */
             break;
         case 0x51:
-            if (cart_is_cgb())
-                MMU.hdma1 = value;
+            if (cgb)
+                gb->mmu.hdma1 = value;
             break;
         case 0x52:
-            if (cart_is_cgb())
-                MMU.hdma2 = value;
+            if (cgb)
+                gb->mmu.hdma2 = value;
             break;
         case 0x53:
-            if (cart_is_cgb())
-                MMU.hdma3 = value;
+            if (cgb)
+                gb->mmu.hdma3 = value;
             break;
         case 0x54:
-            if (cart_is_cgb())
-                MMU.hdma4 = value;
+            if (cgb)
+                gb->mmu.hdma4 = value;
             break;
         case 0x55:
-            if (cart_is_cgb()) {
-                mmu_dma_start(value);
+            if (cgb) {
+                mmu_dma_start(gb, value);
             }
             break;
         case 0x56:
-            if (cart_is_cgb())
-                MMU.ir = value;
+            if (cgb)
+                gb->mmu.ir = value;
             break;
         case 0x68:
-            gpu_write_bgpi(value);
+            gpu_write_bgpi(gb, value);
             break;
         case 0x69:
-            gpu_write_bgpd(value);
+            gpu_write_bgpd(gb, value);
             break;
         case 0x6a:
-            gpu_write_obpi(value);
+            gpu_write_obpi(gb, value);
             break;
         case 0x6b:
-            gpu_write_obpd(value);
+            gpu_write_obpd(gb, value);
             break;
         case 0x70:
-            if (cart_is_cgb())
-                MMU.wram_bank = value & 7;
+            if (cgb)
+                gb->mmu.wram_bank = value & 7;
             break;
         case 0x72:
-            if (cart_is_cgb())
-                MMU.undoc_reg[1] = value;
+            if (cgb)
+                gb->mmu.undoc_reg[1] = value;
             break;
         case 0x73:
-            if (cart_is_cgb())
-                MMU.undoc_reg[2] = value;
+            if (cgb)
+                gb->mmu.undoc_reg[2] = value;
             break;
         case 0x75:
-            if (cart_is_cgb())
-                MMU.undoc_reg[4] = 0x70 & value;
+            if (cgb)
+                gb->mmu.undoc_reg[4] = 0x70 & value;
             break;
         default:
             break;
     }
 }
 
-static uint8_t wram_get_bank(void)
+static uint8_t mmu_read_reg_dmg(gb_t *gb, uint16_t addr)
+{
+    return mmu_read_reg(gb, addr, false);
+}
+
+static uint8_t mmu_read_reg_cgb(gb_t *gb, uint16_t addr)
 {
-    if (MMU.wram_bank == 0)
+    return mmu_read_reg(gb, addr, true);
+}
+
+static void mmu_write_reg_dmg(gb_t *gb, uint16_t addr, uint8_t value)
+{
+    mmu_write_reg(gb, addr, value, false);
+}
+
+static void mmu_write_reg_cgb(gb_t *gb, uint16_t addr, uint8_t value)
+{
+    mmu_write_reg(gb, addr, value, true);
+}
+
+static uint8_t wram_get_bank(gb_t *gb)
+{
+    if (gb->mmu.wram_bank == 0)
         return 1;
-    return MMU.wram_bank;
+    return gb->mmu.wram_bank;
 }
 
-uint8_t mmu_read_byte_dma(uint16_t addr)
+uint8_t mmu_read_byte_dma(gb_t *gb, uint16_t addr)
 {
     if (addr < 0x4000) {
         /* 16kB ROM bank 0. */
-        return cart_read_rom0(addr);
+        return cart_read_rom0(&gb->cart, addr);
     } else if (addr < 0x8000) {
         /* 16kB switchable ROM bank. */
-        return cart_read_rom1(addr);
+        return cart_read_rom1(&gb->cart, addr);
     } else if (addr < 0xa000) {
         /* 8kB Video RAM. */
-        return gpu_read_vram(addr);
+        return gpu_read_vram(gb, addr);
     } else if (addr < 0xc000) {
         /* 8kB Switchable RAM bank. */
-        return cart_read_ram(addr);
+        return cart_read_ram(&gb->cart, addr);
     } else if (addr < 0xd000) {
         /* 4KB Work RAM Bank 0 (WRAM). */
-        return MMU.wram[0][addr & 0x0fff];
+        return gb->mmu.wram[0]->bytes[addr & 0x0fff];
     } else if (addr < 0xe000) {
         /* 4KB Work RAM Bank 1 (Switchable WRAM). */
-        return MMU.wram[wram_get_bank()][addr & 0x0fff];
+        return gb->mmu.wram[wram_get_bank(gb)]->bytes[addr & 0x0fff];
     } else if (addr < 0xfe00) {
         /* Echo of 8kB Internal RAM. */
-        return MMU.wram[0][addr & 0x1fff];
+        return gb->mmu.wram[(addr >> 12) & 1]->bytes[addr & 0x0fff];
     } else if (addr < 0xff00) {
         /* Sprite Attrib Memory (OAM). */
         if (addr < 0xfea0) {
-            return gpu_read_oam(addr);
+            return gpu_read_oam(gb, addr);
         } else if (addr < 0xff00) {
             /* Empty. */
             return 0;
         }
     } else if (addr < 0xff80) {
         /* I/O Registers. */
-        return mmu_read_reg(addr);
+        return gb->mmu.read_reg(gb, addr);
     } else if (addr < 0xffff) {
         /* Internal RAM. */
-        return MMU.zram[addr & 0x007f];
+        return gb->mmu.zram[addr & 0x007f];
     } else {
         /* Interrupt Enable Register. */
-        return interrupt_get_enable();
+        return interrupt_get_enable(gb);
     }
     abort();
 }
 
-uint8_t mmu_read_byte(uint16_t addr)
+uint8_t mmu_read_byte(gb_t *gb, uint16_t addr)
 {
-    clock_step(4);
-    return mmu_read_byte_dma(addr);
+    clock_step(gb, 4);
+    if (addr >= 0xff00 && addr < 0xff80)
+        clock_sync(gb);
+    return mmu_read_byte_dma(gb, addr);
 }
 
-uint16_t mmu_read_word(uint16_t addr)
+uint16_t mmu_read_word(gb_t *gb, uint16_t addr)
 {
     uint16_t addrh = (uint16_t)(addr + 1);
-    return (uint16_t)(mmu_read_byte(addrh) << 8 | mmu_read_byte(addr));
+    return (uint16_t)(mmu_read_byte(gb, addrh) << 8 | mmu_read_byte(gb, addr));
 }
 
-void mmu_write_byte_dma(uint16_t addr, uint8_t value)
+void mmu_write_byte_dma(gb_t *gb, uint16_t addr, uint8_t value)
 {
     if (addr < 0x8000) {
         /* 16kB ROM bank 0 and 16kB switchable ROM bank. */
-        cart_write_mbc(addr, value);
+        cart_write_mbc(&gb->cart, addr, value);
     } else if (addr < 0xa000) {
         /* 8kB Video RAM. */
-        gpu_write_vram(addr, value);
+        gpu_write_vram(gb, addr, value);
     } else if (addr < 0xc000) {
         /* 8kB Switchable RAM bank. */
-        cart_write_ram(addr, value);
+        cart_write_ram(&gb->cart, addr, value);
     } else if (addr < 0xd000) {
         /* 4KB Work RAM Bank 0 (WRAM). */
-        MMU.wram[0][addr & 0x0fff] = value;
+        page_write(&gb->mmu.wram[0])[addr & 0x0fff] = value;
     } else if (addr < 0xe000) {
         /* 4KB Work RAM Bank 1 (Switchable WRAM). */
-        MMU.wram[wram_get_bank()][addr & 0x0fff] = value;
+        page_write(&gb->mmu.wram[wram_get_bank(gb)])[addr & 0x0fff] = value;
     } else if (addr < 0xfe00) {
         /* 4KB Work RAM Bank 0 (WRAM). */
-        MMU.wram[0][addr & 0x1fff] = value;
+        page_write(&gb->mmu.wram[(addr >> 12) & 1])[addr & 0x0fff] = value;
     } else if (addr < 0xff00) {
         /* Sprite Attrib Memory (OAM). */
         if (addr < 0xfea0) {
-            gpu_write_oam(addr, value);
+            gpu_write_oam(gb, addr, value);
         }
         /* Don't change 0xfea0 - 0xfeff. */
     } else if (addr < 0xff80) {
         /* I/O Registers. */
-        mmu_write_reg(addr, value);
+        gb->mmu.write_reg(gb, addr, value);
     } else if (addr < 0xffff) {
         /* Internal RAM. */
-        MMU.zram[addr & 0x007f] = value;
+        gb->mmu.zram[addr & 0x007f] = value;
     } else {
         /* Interrupt Enable Register. */
-        interrupt_set_enable(value);
+        interrupt_set_enable(gb, value);
+    }
+}
+
+uint8_t *mmu_bulk(gb_t *gb, uint16_t addr, bool write, uint16_t *lo,
+                  uint16_t *hi)
+{
+    uint8_t *bytes;
+    if (addr < 0x8000) {
+        /* ROM, where writes go to the MBC. */
+        if (write)
+            return NULL;
+        *lo = addr & 0x4000;
+        *hi = *lo | 0x3fff;
+        bytes = gb->cart.rom.bytes;
+        return addr < 0x4000 ? bytes : bytes + gb->cart.rom.offset;
+    } else if (addr < 0xa000) {
+        *lo = 0x8000;
+        *hi = 0x9fff;
+        return gpu_vram_bulk(gb, write);
+    } else if (addr >= 0xc000 && addr < 0xe000) {
+        page_t **page = &gb->mmu.wram[addr < 0xd000 ? 0 : wram_get_bank(gb)];
+        *lo = addr & 0xf000;
+        *hi = *lo | 0x0fff;
+        return write ? page_write(page) : (*page)->bytes;
+    } else if (addr >= 0xff80 && addr < 0xffff) {
+        *lo = 0xff80;
+        *hi = 0xfffe;
+        return gb->mmu.zram;
     }
+    /* Cartridge RAM, echo RAM, OAM and I/O. */
+    return NULL;
 }
 
-void mmu_write_byte(uint16_t addr, uint8_t value)
+void mmu_write_byte(gb_t *gb, uint16_t addr, uint8_t value)
 {
-    clock_step(4);
-    mmu_write_byte_dma(addr, value);
+    clock_step(gb, 4);
+    if (addr >= 0xff00 && addr < 0xff80)
+        clock_sync(gb);
+    mmu_write_byte_dma(gb, addr, value);
 }
 
-void mmu_write_word(uint16_t addr, uint16_t value)
+void mmu_write_word(gb_t *gb, uint16_t addr, uint16_t value)
 {
     uint16_t addrh = (uint16_t)(addr + 1);
-    mmu_write_byte(addr, (uint8_t)(value & 0x00ff));
-    mmu_write_byte(addrh, (uint8_t)((value & 0xff00) >> 8));
+    mmu_write_byte(gb, addr, (uint8_t)(value & 0x00ff));
+    mmu_write_byte(gb, addrh, (uint8_t)((value & 0xff00) >> 8));
 }
 
-void mmu_stop(void)
+bool mmu_stop(gb_t *gb)
 {
-    if (cart_is_cgb() && MMU.speed_switch & 1) {
-        MMU.speed_switch = ((~MMU.speed_switch) & 0x80) | 0x7e;
-        MMU.clock_speed = MMU.speed_switch >> 7;
-        gpu_change_speed(MMU.clock_speed);
-        apu_change_speed(MMU.clock_speed);
-    }
+    if (!cart_is_cgb(&gb->cart) || !(gb->mmu.speed_switch & 1))
+        return false;
+    clock_sync(gb);
+    gb->mmu.speed_switch = ((~gb->mmu.speed_switch) & 0x80) | 0x7e;
+    gb->mmu.clock_speed = gb->mmu.speed_switch >> 7;
+    gpu_change_speed(gb, gb->mmu.clock_speed);
+    apu_change_speed(gb, gb->mmu.clock_speed);
+    return true;
 }
 
-void mmu_dump(uint16_t addr, uint16_t offset)
+void mmu_dump(gb_t *gb, uint16_t addr, uint16_t offset)
 {
     addr = addr - (addr % 16);
     uint16_t end = addr + offset;
@@ -605,7 +705,7 @@ void mmu_dump(uint16_t addr, uint16_t offset)
         if (addr % 16 == 0) {
             printf("\n%.2hx: ", addr);
         }
-        printf("%.2hhx ", mmu_read_byte(addr++));
+        printf("%.2hhx ", mmu_read_byte(gb, addr++));
     }
     printf("\n");
 }
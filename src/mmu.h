@@ -3,11 +3,16 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "page.h"
+
+typedef struct gb gb_t;
+
+#define MMU_WRAM_BANK_SIZE 0x1000
 
 typedef void (*switch_ext_rom_cb_t)(void);
 
 typedef struct {
-    uint8_t wram[8][0x1000]; /* Working RAM. */
+    page_t *wram[8];         /* Working RAM, one page per bank. */
     uint8_t zram[0x80];      /* Zero-page RAM. */
     uint8_t speed_switch;    /* 0xff4d (KEY1): Prepare Speed Switch */
     uint8_t hdma1;           /* 0xff51 (HDMA1): DMA data src high */
@@ -19,39 +24,55 @@ typedef struct {
     uint8_t wram_bank;       /* 0xff70 (SVBK): WRAM Bank */
     uint8_t clock_speed;     /* 0: normal speed; 1: double speed */
     uint8_t undoc_reg[5];
+    /* I/O register access for the cartridge model, set by mmu_reset(). */
+    uint8_t (*read_reg)(gb_t *gb, uint16_t addr);
+    void (*write_reg)(gb_t *gb, uint16_t addr, uint8_t value);
 } mmu_t;
 
 /* Init MMU subsystem. */
-int mmu_init(const char *rom_path);
+int mmu_init(gb_t *gb, const char *rom_path);
 
+/* Init MMU subsystem sharing the cartridge ROM already loaded by src. */
+int mmu_init_shared(gb_t *gb, const gb_t *src);
+
+/* Init MMU subsystem as a copy of src, sharing all its memory pages. */
+void mmu_fork(gb_t *gb, const gb_t *src);
 /* Free cartridge memory. */
-void mmu_finish(void);
+void mmu_finish(gb_t *gb);
 
 /* Reset MMU keeping cartridge ROM memory. */
-void mmu_reset(void);
+void mmu_reset(gb_t *gb);
 
 /* Read byte from a given address withoud accounting for time delay. */
-uint8_t mmu_read_byte_dma(uint16_t addr);
+uint8_t mmu_read_byte_dma(gb_t *gb, uint16_t addr);
 
 /* Read byte from a given address. */
-uint8_t mmu_read_byte(uint16_t addr);
+uint8_t mmu_read_byte(gb_t *gb, uint16_t addr);
 
 /* Read word from a given address. */
-uint16_t mmu_read_word(uint16_t addr);
+uint16_t mmu_read_word(gb_t *gb, uint16_t addr);
 
 /* Write byte to a given address without accounting for time delay. */
-void mmu_write_byte_dma(uint16_t addr, uint8_t value);
+void mmu_write_byte_dma(gb_t *gb, uint16_t addr, uint8_t value);
 
 /* Write byte to a given address. */
-void mmu_write_byte(uint16_t addr, uint8_t value);
+void mmu_write_byte(gb_t *gb, uint16_t addr, uint8_t value);
 
 /* Write word to a given address. */
-void mmu_write_word(uint16_t addr, uint16_t value);
+void mmu_write_word(gb_t *gb, uint16_t addr, uint16_t value);
+
+/**
+ * Plain memory at addr for a bulk read or write: the bytes of the region from
+ * lo to hi holding it, indexed from lo. NULL where accesses have side effects
+ * or the PPU keeps the CPU out.
+ */
+uint8_t *mmu_bulk(gb_t *gb, uint16_t addr, bool write, uint16_t *lo,
+                  uint16_t *hi);
 
-/* Stop MMU, and change speed if requested. */
-void mmu_stop(void);
+/* STOP: perform an armed CGB speed switch, returning true if there was one. */
+bool mmu_stop(gb_t *gb);
 
 /* Debug MMU. */
-void mmu_dump(uint16_t addr, uint16_t offset);
+void mmu_dump(gb_t *gb, uint16_t addr, uint16_t offset);
 
 #endif /* MMU_H */
@@ -0,0 +1,513 @@
+#include "movie.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+
+#define MOVIE_MAGIC "GBMV"
+#define MOVIE_VERSION 2
+#define MOVIE_HEADER_SIZE 16
+#define MOVIE_INDEX_MAGIC "GBKI"
+#define MOVIE_INDEX_ENTRY_SIZE 16
+#define MOVIE_FOOTER_SIZE 16
+
+/* The first frame after a keyframe redraws the picture. */
+#define MOVIE_STATE (GB_STATE_ALL & ~GB_STATE_FRAME)
+
+typedef struct {
+    uint32_t frames;
+    uint8_t keys;
+} movie_run_t;
+
+typedef struct {
+    unsigned int frame;
+    uint32_t size;
+    uint64_t offset; /* In the file, when data is NULL. */
+    uint8_t *data;
+} movie_keyframe_t;
+
+struct movie {
+    movie_run_t *runs;
+    size_t count;
+    size_t capacity;
+    unsigned int length; /* Sum of the frames of all runs. */
+    uint16_t checksum;
+    uint32_t ram_hash;
+    bool recording;
+    /* Playback position: frame, and run holding it. */
+    unsigned int frame;
+    size_t run;
+    uint32_t run_frame;
+    unsigned int interval; /* Frames between keyframes, 0 for none. */
+    movie_keyframe_t *keyframes;
+    size_t keyframe_count;
+    size_t keyframe_capacity;
+    FILE *file; /* Keyframes of a loaded movie are read when needed. */
+};
+
+movie_t *movie_create(void)
+{
+    return calloc(1, sizeof(movie_t));
+}
+
+static void movie_clear_keyframes(movie_t *mv)
+{
+    for (size_t i = 0; i < mv->keyframe_count; ++i)
+        free(mv->keyframes[i].data);
+    mv->keyframe_count = 0;
+    if (mv->file != NULL) {
+        fclose(mv->file);
+        mv->file = NULL;
+    }
+}
+
+void movie_destroy(movie_t *mv)
+{
+    if (mv == NULL)
+        return;
+    movie_clear_keyframes(mv);
+    free(mv->keyframes);
+    free(mv->runs);
+    free(mv);
+}
+
+void movie_set_keyframes(movie_t *mv, unsigned int interval)
+{
+    mv->interval = interval;
+}
+
+size_t movie_keyframes(const movie_t *mv)
+{
+    return mv->keyframe_count;
+}
+
+unsigned int movie_length(const movie_t *mv)
+{
+    return mv->length;
+}
+
+bool movie_playing(const movie_t *mv)
+{
+    return !mv->recording;
+}
+
+static int movie_push(movie_t *mv, uint32_t frames, uint8_t keys)
+{
+    if (mv->count == mv->capacity) {
+        size_t capacity = mv->capacity ? mv->capacity * 2 : 64;
+        movie_run_t *runs = realloc(mv->runs, capacity * sizeof(*runs));
+        if (runs == NULL)
+            return -1;
+        mv->runs = runs;
+        mv->capacity = capacity;
+    }
+    mv->runs[mv->count].frames = frames;
+    mv->runs[mv->count].keys = keys;
+    mv->count++;
+    mv->length += frames;
+    return 0;
+}
+
+/* Add a frame holding keys. */
+static void movie_append(movie_t *mv, uint8_t keys)
+{
+    movie_run_t *last = mv->count ? &mv->runs[mv->count - 1] : NULL;
+    if (last != NULL && last->keys == keys && last->frames < UINT32_MAX) {
+        last->frames++;
+        mv->length++;
+    } else if (movie_push(mv, 1, keys) < 0) {
+        fprintf(stderr, "ERROR: out of memory, movie input lost\n");
+    }
+}
+
+/* Change the keys of the newest frame. */
+static void movie_amend(movie_t *mv, uint8_t keys)
+{
+    movie_run_t *last = &mv->runs[mv->count - 1];
+    if (last->keys == keys)
+        return;
+    if (last->frames > 1) {
+        last->frames--;
+        mv->length--;
+        movie_append(mv, keys);
+        return;
+    }
+    last->keys = keys;
+    if (mv->count > 1 && last[-1].keys == keys &&
+        last[-1].frames < UINT32_MAX) {
+        last[-1].frames++;
+        mv->count--;
+    }
+}
+
+static uint16_t movie_checksum(const gb_t *gb)
+{
+    const cart_header_t *h = gb->cart.rom.header;
+    return (uint16_t)(h->checksum_h << 8 | h->checksum_l);
+}
+
+/* FNV-1a of the cartridge RAM, battery backed RAM is part of power on. */
+static uint32_t movie_ram_hash(const gb_t *gb)
+{
+    uint32_t hash = 0x811c9dc5u;
+    for (unsigned int i = 0; i < CART_RAM_MAX_BANKS; ++i) {
+        size_t size = cart_ram_bank_size(&gb->cart, i);
+        for (size_t j = 0; j < size; ++j)
+            hash = (hash ^ gb->cart.ram.banks[i]->bytes[j]) * 0x01000193u;
+    }
+    return hash;
+}
+
+static int movie_add_keyframe(movie_t *mv, unsigned int frame, uint32_t size,
+                              uint64_t offset, uint8_t *data)
+{
+    if (mv->keyframe_count == mv->keyframe_capacity) {
+        size_t capacity = mv->keyframe_capacity * 2 + 16;
+        movie_keyframe_t *kf = realloc(mv->keyframes, capacity * sizeof(*kf));
+        if (kf == NULL)
+            return -1;
+        mv->keyframes = kf;
+        mv->keyframe_capacity = capacity;
+    }
+    movie_keyframe_t *kf = &mv->keyframes[mv->keyframe_count++];
+    kf->frame = frame;
+    kf->size = size;
+    kf->offset = offset;
+    kf->data = data;
+    return 0;
+}
+
+/* Save the state at the start of frame. */
+static void movie_record_keyframe(gb_t *gb, movie_t *mv, unsigned int frame)
+{
+    size_t size = gb_state_size(gb, MOVIE_STATE);
+    uint8_t *data = malloc(size);
+    if (data == NULL || gb_state_save(gb, data, size, MOVIE_STATE) == 0 ||
+        movie_add_keyframe(mv, frame, (uint32_t)size, 0, data) < 0) {
+        fprintf(stderr, "ERROR: could not save movie keyframe\n");
+        free(data);
+    }
+}
+
+void movie_record_start(gb_t *gb, movie_t *mv)
+{
+    movie_clear_keyframes(mv);
+    mv->count = 0;
+    mv->length = 0;
+    mv->checksum = movie_checksum(gb);
+    mv->ram_hash = movie_ram_hash(gb);
+    mv->recording = true;
+    movie_append(mv, keys_get_held(gb));
+}
+
+int movie_play_start(gb_t *gb, movie_t *mv)
+{
+    if (mv->checksum != movie_checksum(gb)) {
+        fprintf(stderr, "ERROR: movie is from another game\n");
+        return -1;
+    }
+    if (mv->ram_hash != movie_ram_hash(gb))
+        fprintf(stderr, "WARNING: cartridge RAM differs from the movie's, "
+                        "playback may desync\n");
+    mv->recording = false;
+    mv->frame = 0;
+    mv->run = 0;
+    mv->run_frame = 0;
+    keys_set_held(gb, mv->count ? mv->runs[0].keys : 0);
+    return 0;
+}
+
+/* Move the playback position to the start of frame and set its keys. */
+static void movie_locate(gb_t *gb, movie_t *mv, unsigned int frame)
+{
+    unsigned int left = frame;
+    size_t run = 0;
+    while (run + 1 < mv->count && left >= mv->runs[run].frames)
+        left -= mv->runs[run++].frames;
+    mv->frame = frame;
+    mv->run = run;
+    mv->run_frame = left;
+    keys_set_held(gb, mv->count ? mv->runs[run].keys : 0);
+}
+
+static int movie_load_keyframe(gb_t *gb, movie_t *mv,
+                               const movie_keyframe_t *kf)
+{
+    if (kf->data != NULL)
+        return gb_state_load(gb, kf->data, kf->size, MOVIE_STATE);
+    uint8_t *data = malloc(kf->size);
+    int ret = -1;
+    if (data != NULL && fseeko(mv->file, (off_t)kf->offset, SEEK_SET) == 0 &&
+        fread(data, 1, kf->size, mv->file) == kf->size)
+        ret = gb_state_load(gb, data, kf->size, MOVIE_STATE);
+    free(data);
+    return ret;
+}
+
+int movie_seek(gb_t *gb, movie_t *mv, unsigned int frame)
+{
+    gb_reset(gb);
+    if (movie_play_start(gb, mv) < 0)
+        return -1;
+    /* Strictly before frame, so at least one frame is drawn. */
+    size_t k = mv->keyframe_count;
+    while (k > 0 && mv->keyframes[k - 1].frame >= frame)
+        --k;
+    for (; k > 0; --k) {
+        const movie_keyframe_t *kf = &mv->keyframes[k - 1];
+        if (movie_load_keyframe(gb, mv, kf) == 0) {
+            movie_locate(gb, mv, kf->frame);
+            return (int)kf->frame;
+        }
+        fprintf(stderr, "WARNING: unusable movie keyframe at frame %u\n",
+                kf->frame);
+    }
+    /* Failed loads change nothing, replay from power on. */
+    return 0;
+}
+
+void movie_frame(gb_t *gb)
+{
+    movie_t *mv = gb->movie;
+    if (mv->recording) {
+        movie_append(mv, keys_get_held(gb));
+        /* Before the sink changes the keys, movie_seek() sets them. */
+        unsigned int frame = mv->length - 1;
+        if (mv->interval != 0 && frame % mv->interval == 0)
+            movie_record_keyframe(gb, mv, frame);
+        return;
+    }
+    if (++mv->frame >= mv->length) {
+        /* Done, input is the frontend's again. */
+        gb->movie = NULL;
+        return;
+    }
+    if (++mv->run_frame == mv->runs[mv->run].frames) {
+        mv->run++;
+        mv->run_frame = 0;
+        keys_set_held(gb, mv->runs[mv->run].keys);
+    }
+}
+
+void movie_input(gb_t *gb)
+{
+    movie_t *mv = gb->movie;
+    if (mv->recording)
+        movie_amend(mv, keys_get_held(gb));
+}
+
+static void movie_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void movie_put32(uint8_t *p, uint32_t v)
+{
+    movie_put16(p, (uint16_t)v);
+    movie_put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t movie_get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t movie_get32(const uint8_t *p)
+{
+    return movie_get16(p) | (uint32_t)movie_get16(p + 2) << 16;
+}
+
+static void movie_put64(uint8_t *p, uint64_t v)
+{
+    movie_put32(p, (uint32_t)v);
+    movie_put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint64_t movie_get64(const uint8_t *p)
+{
+    return movie_get32(p) | (uint64_t)movie_get32(p + 4) << 32;
+}
+
+static int movie_write_keyframes(const movie_t *mv, FILE *f)
+{
+    uint64_t *offsets = calloc(mv->keyframe_count + 1, sizeof(uint64_t));
+    if (offsets == NULL)
+        return -1;
+    int ret = 0;
+    for (size_t i = 0; i < mv->keyframe_count && ret == 0; ++i) {
+        const movie_keyframe_t *kf = &mv->keyframes[i];
+        uint8_t *data = kf->data;
+        offsets[i] = (uint64_t)ftello(f);
+        if (data == NULL) {
+            data = malloc(kf->size);
+            if (data == NULL ||
+                fseeko(mv->file, (off_t)kf->offset, SEEK_SET) != 0 ||
+                fread(data, 1, kf->size, mv->file) != kf->size)
+                ret = -1;
+        }
+        if (ret == 0 && fwrite(data, 1, kf->size, f) != kf->size)
+            ret = -1;
+        if (data != kf->data)
+            free(data);
+    }
+    uint64_t index = (uint64_t)ftello(f);
+    for (size_t i = 0; i < mv->keyframe_count && ret == 0; ++i) {
+        uint8_t entry[MOVIE_INDEX_ENTRY_SIZE];
+        movie_put32(entry, mv->keyframes[i].frame);
+        movie_put32(entry + 4, mv->keyframes[i].size);
+        movie_put64(entry + 8, offsets[i]);
+        fwrite(entry, 1, sizeof(entry), f);
+    }
+    uint8_t footer[MOVIE_FOOTER_SIZE];
+    movie_put64(footer, index);
+    movie_put32(footer + 8, (uint32_t)mv->keyframe_count);
+    memcpy(footer + 12, MOVIE_INDEX_MAGIC, 4);
+    fwrite(footer, 1, sizeof(footer), f);
+    free(offsets);
+    return ret;
+}
+
+static int movie_write(const movie_t *mv, FILE *f)
+{
+    uint8_t header[MOVIE_HEADER_SIZE];
+    memcpy(header, MOVIE_MAGIC, 4);
+    movie_put16(header + 4, MOVIE_VERSION);
+    movie_put16(header + 6, mv->checksum);
+    movie_put32(header + 8, mv->ram_hash);
+    movie_put32(header + 12, mv->length);
+    fwrite(header, 1, sizeof(header), f);
+    for (size_t i = 0; i < mv->count; ++i) {
+        uint32_t frames = mv->runs[i].frames;
+        while (frames >= 0x80) {
+            fputc((int)(frames & 0x7f) | 0x80, f);
+            frames >>= 7;
+        }
+        fputc((int)frames, f);
+        fputc(mv->runs[i].keys, f);
+    }
+    return movie_write_keyframes(mv, f);
+}
+
+int movie_save(const movie_t *mv, const char *path)
+{
+    /* Keyframes may still be read from path, the new file replaces it once
+     * written. */
+    size_t len = strlen(path) + sizeof(".tmp");
+    char *tmp = malloc(len);
+    if (tmp == NULL)
+        return -1;
+    snprintf(tmp, len, "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s\n", tmp);
+        free(tmp);
+        return -1;
+    }
+    int ret = movie_write(mv, f);
+    if (ferror(f) | fclose(f) || ret < 0 || rename(tmp, path) != 0) {
+        fprintf(stderr, "ERROR: could not write %s\n", path);
+        remove(tmp);
+        free(tmp);
+        return -1;
+    }
+    free(tmp);
+    return 0;
+}
+
+/* Returns -1 on a truncated or too long number. */
+static int movie_read_varint(FILE *f, uint32_t *value)
+{
+    uint64_t v = 0;
+    for (unsigned int shift = 0; shift < 35; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF)
+            return -1;
+        v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *value = (uint32_t)v;
+            return v <= UINT32_MAX ? 0 : -1;
+        }
+    }
+    return -1;
+}
+
+/* Read the keyframe index at the end of the file. */
+static int movie_read_index(movie_t *mv, FILE *f)
+{
+    uint64_t start = (uint64_t)ftello(f);
+    uint8_t footer[MOVIE_FOOTER_SIZE];
+    if (fseeko(f, -MOVIE_FOOTER_SIZE, SEEK_END) != 0)
+        return -1;
+    uint64_t end = (uint64_t)ftello(f);
+    if (end < start || fread(footer, 1, sizeof(footer), f) != sizeof(footer) ||
+        memcmp(footer + 12, MOVIE_INDEX_MAGIC, 4) != 0)
+        return -1;
+    uint64_t index = movie_get64(footer);
+    uint32_t count = movie_get32(footer + 8);
+    if (index < start || index > end ||
+        (end - index) != (uint64_t)count * MOVIE_INDEX_ENTRY_SIZE ||
+        fseeko(f, (off_t)index, SEEK_SET) != 0)
+        return -1;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t entry[MOVIE_INDEX_ENTRY_SIZE];
+        if (fread(entry, 1, sizeof(entry), f) != sizeof(entry))
+            return -1;
+        unsigned int frame = movie_get32(entry);
+        uint32_t size = movie_get32(entry + 4);
+        uint64_t offset = movie_get64(entry + 8);
+        if (frame >= mv->length || offset < start || offset > index ||
+            size > index - offset ||
+            (i > 0 && frame <= mv->keyframes[i - 1].frame) ||
+            movie_add_keyframe(mv, frame, size, offset, NULL) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int movie_read(movie_t *mv, FILE *f)
+{
+    uint8_t header[MOVIE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) ||
+        memcmp(header, MOVIE_MAGIC, 4) != 0)
+        return -1;
+    uint16_t version = movie_get16(header + 4);
+    if (version < 1 || version > MOVIE_VERSION)
+        return -1;
+    mv->checksum = movie_get16(header + 6);
+    mv->ram_hash = movie_get32(header + 8);
+    uint32_t length = movie_get32(header + 12);
+    while (mv->length < length) {
+        uint32_t frames;
+        int keys;
+        if (movie_read_varint(f, &frames) < 0 || (keys = fgetc(f)) == EOF ||
+            frames == 0 || frames > length - mv->length ||
+            movie_push(mv, frames, (uint8_t)keys) < 0)
+            return -1;
+    }
+    /* Version 1 files end with the runs. */
+    if (version == 1)
+        return fgetc(f) == EOF ? 0 : -1;
+    return movie_read_index(mv, f);
+}
+
+movie_t *movie_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s\n", path);
+        return NULL;
+    }
+    movie_t *mv = movie_create();
+    if (mv == NULL || movie_read(mv, f) < 0) {
+        fprintf(stderr, "ERROR: invalid movie file: %s\n", path);
+        movie_destroy(mv);
+        fclose(f);
+        return NULL;
+    }
+    if (mv->keyframe_count > 0)
+        mv->file = f;
+    else
+        fclose(f);
+    return mv;
+}
@@ -0,0 +1,76 @@
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct gb gb_t;
+
+/**
+ * Joypad movie.
+ *
+ * The keys held during every frame since power on, as runs of frames with
+ * the same keys. Since the core is deterministic, playing the movie back
+ * from power on reproduces the recorded session exactly, at any speed.
+ *
+ * Keys are sampled at frame granularity: a change is credited to the frame
+ * in progress, so it should be made at a frame boundary, from the video
+ * sink or between gb_run_frames() calls. Movies of carts with a real time
+ * clock only replay if the game does not read it.
+ *
+ * A movie may also hold keyframes: save states taken every few frames while
+ * recording, so playback can start anywhere after emulating at most one
+ * interval. They are tied to the build, like save states, a movie whose
+ * keyframes do not load still replays from power on.
+ *
+ * File format, little endian:
+ *
+ *     "GBMV" version:u16 checksum:u16 ram_hash:u32 frames:u32
+ *     { frames:varint keys:u8 } ...
+ *     { state } ...
+ *     { frame:u32 size:u32 offset:u64 } ...      keyframe index
+ *     index_offset:u64 keyframes:u32 "GBKI"
+ *
+ * checksum is the global checksum of the cartridge header and ram_hash a
+ * hash of the cartridge RAM at power on. Version 1 files end with the runs.
+ * Keyframes of a loaded movie stay in the file until needed.
+ */
+typedef struct movie movie_t;
+
+movie_t *movie_create(void);
+void movie_destroy(movie_t *mv);
+
+/* Read or write a movie file. Return NULL or -1 on error. */
+movie_t *movie_load(const char *path);
+int movie_save(const movie_t *mv, const char *path);
+
+/* Number of frames recorded. */
+unsigned int movie_length(const movie_t *mv);
+
+/* Take a keyframe every interval frames of the next recording, 0 for none. */
+void movie_set_keyframes(movie_t *mv, unsigned int interval);
+
+/* Number of keyframes held. */
+size_t movie_keyframes(const movie_t *mv);
+
+/* Start recording, dropping what the movie held, or playing back. */
+void movie_record_start(gb_t *gb, movie_t *mv);
+int movie_play_start(gb_t *gb, movie_t *mv);
+
+/**
+ * Start playing at the newest keyframe before frame, or at power on.
+ * Returns the frame reached, -1 if mv is from another game.
+ */
+int movie_seek(gb_t *gb, movie_t *mv, unsigned int frame);
+
+/* Called at every VBlank while a movie is attached. */
+void movie_frame(gb_t *gb);
+
+/* Called on every key change while a movie is attached. */
+void movie_input(gb_t *gb);
+
+/* True while attached in playback mode. */
+bool movie_playing(const movie_t *mv);
+
+#endif /* MOVIE_H */
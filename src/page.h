@@ -0,0 +1,90 @@
+#ifndef PAGE_H
+#define PAGE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Reference counted block of emulated memory.
+ *
+ * Forked instances share their pages until one of them writes: page_write()
+ * then gives the writer its own copy. Reads need no check at all.
+ */
+typedef struct {
+    atomic_uint refs;
+    size_t size;
+    uint8_t bytes[];
+} page_t;
+
+/* New zeroed page. */
+static inline page_t *page_create(size_t size)
+{
+    page_t *p = calloc(1, sizeof(page_t) + size);
+    if (p == NULL) {
+        fprintf(stderr, "ERROR: out of memory\n");
+        abort();
+    }
+    atomic_init(&p->refs, 1);
+    p->size = size;
+    return p;
+}
+
+static inline page_t *page_ref(page_t *p)
+{
+    atomic_fetch_add_explicit(&p->refs, 1, memory_order_relaxed);
+    return p;
+}
+
+static inline void page_unref(page_t *p)
+{
+    if (p != NULL &&
+        atomic_fetch_sub_explicit(&p->refs, 1, memory_order_acq_rel) == 1)
+        free(p);
+}
+
+static inline bool page_shared(const page_t *p)
+{
+    return atomic_load_explicit(&p->refs, memory_order_acquire) != 1;
+}
+
+/* Replace a shared page by a private one, copying its contents if asked. */
+static inline page_t *page_unshare(page_t **pp, bool copy)
+{
+    page_t *old = *pp;
+    page_t *p = page_create(old->size);
+    if (copy)
+        memcpy(p->bytes, old->bytes, old->size);
+    page_unref(old);
+    *pp = p;
+    return p;
+}
+
+/* Bytes of the page, made private first if it is shared. */
+static inline uint8_t *page_write(page_t **pp)
+{
+    page_t *p = *pp;
+    if (__builtin_expect(page_shared(p), 0))
+        p = page_unshare(pp, true);
+    return p->bytes;
+}
+
+/* Like page_write(), when all the bytes are about to be overwritten. */
+static inline uint8_t *page_overwrite(page_t **pp)
+{
+    page_t *p = *pp;
+    if (page_shared(p))
+        p = page_unshare(pp, false);
+    return p->bytes;
+}
+
+static inline void page_clear(page_t **pp)
+{
+    memset(page_overwrite(pp), 0, (*pp)->size);
+}
+
+#endif /* PAGE_H */
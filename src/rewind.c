@@ -0,0 +1,251 @@
+#include "rewind.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+
+/* The framebuffer is redrawn by running a frame, no need to keep it. */
+#define REWIND_SECTIONS (GB_STATE_ALL & ~GB_STATE_FRAME)
+
+/* Unchanged bytes needed to end a literal run. */
+#define REWIND_MIN_ZEROES 8
+
+typedef struct {
+    size_t offset;
+    size_t size;
+} rewind_entry_t;
+
+struct rewind {
+    uint8_t *ring; /* Encoded deltas. */
+    size_t ring_size;
+    size_t used;
+    rewind_entry_t *entries; /* Deltas in the ring, oldest first. */
+    size_t max_entries;
+    size_t first;
+    size_t count;
+    bool has_state;
+    uint8_t *state;   /* Newest snapshot, valid if has_state. */
+    uint8_t *scratch; /* Snapshot being taken. */
+    uint8_t *delta;   /* Delta being encoded. */
+    size_t state_size;
+    unsigned int interval;
+    unsigned int countdown;
+};
+
+rewind_t *rewind_create(const gb_t *gb, size_t memory, unsigned int interval)
+{
+    rewind_t *rw = calloc(1, sizeof(rewind_t));
+    if (rw == NULL)
+        return NULL;
+    rw->state_size = gb_state_size(gb, REWIND_SECTIONS);
+    rw->ring_size = memory;
+    rw->ring = malloc(memory);
+    /* A delta of an idle frame takes a few bytes, but not less than 16. */
+    rw->max_entries = memory / 16 + 1;
+    rw->has_state = false;
+    rw->entries = malloc(rw->max_entries * sizeof(rewind_entry_t));
+    rw->state = malloc(rw->state_size);
+    rw->scratch = malloc(rw->state_size);
+    rw->delta = malloc(2 * rw->state_size + 32);
+    rw->interval = interval ? interval : 1;
+    rw->countdown = rw->interval;
+    if (rw->ring == NULL || rw->entries == NULL || rw->state == NULL ||
+        rw->scratch == NULL || rw->delta == NULL) {
+        rewind_destroy(rw);
+        return NULL;
+    }
+    return rw;
+}
+
+void rewind_destroy(rewind_t *rw)
+{
+    free(rw->ring);
+    free(rw->entries);
+    free(rw->state);
+    free(rw->scratch);
+    free(rw->delta);
+    free(rw);
+}
+
+static inline rewind_entry_t *rewind_entry(rewind_t *rw, size_t i)
+{
+    return &rw->entries[(rw->first + i) % rw->max_entries];
+}
+
+static void rewind_drop_oldest(rewind_t *rw)
+{
+    rw->used -= rewind_entry(rw, 0)->size;
+    rw->first = (rw->first + 1) % rw->max_entries;
+    rw->count--;
+}
+
+static uint8_t *rewind_put_varint(uint8_t *p, size_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static const uint8_t *rewind_get_varint(const uint8_t *p, size_t *v)
+{
+    unsigned int shift = 0;
+    *v = 0;
+    do {
+        *v |= (size_t)(*p & 0x7f) << shift;
+        shift += 7;
+    } while (*p++ & 0x80);
+    return p;
+}
+
+static inline uint64_t rewind_load64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*
+ * Encode a XOR b as (unchanged count, changed count, changed bytes) runs.
+ * Returns the encoded size.
+ */
+static size_t rewind_encode(const uint8_t *a, const uint8_t *b, size_t n,
+                            uint8_t *out)
+{
+    uint8_t *p = out;
+    size_t i = 0;
+    while (i < n) {
+        size_t start = i;
+        while (i + 8 <= n && rewind_load64(a + i) == rewind_load64(b + i))
+            i += 8;
+        while (i < n && a[i] == b[i])
+            ++i;
+        p = rewind_put_varint(p, i - start);
+        start = i;
+        while (i < n) {
+            if (a[i] != b[i]) {
+                ++i;
+                continue;
+            }
+            size_t j = i;
+            while (j < n && j - i < REWIND_MIN_ZEROES && a[j] == b[j])
+                ++j;
+            if (j == n || j - i == REWIND_MIN_ZEROES)
+                break;
+            i = j;
+        }
+        p = rewind_put_varint(p, i - start);
+        for (size_t k = start; k < i; ++k)
+            *p++ = a[k] ^ b[k];
+    }
+    return (size_t)(p - out);
+}
+
+static void rewind_decode(uint8_t *state, const uint8_t *in, size_t size)
+{
+    const uint8_t *end = in + size;
+    size_t i = 0;
+    while (in < end) {
+        size_t zeroes, changed;
+        in = rewind_get_varint(in, &zeroes);
+        in = rewind_get_varint(in, &changed);
+        i += zeroes;
+        for (size_t k = 0; k < changed; ++k)
+            state[i++] ^= *in++;
+    }
+}
+
+/* Make room for size bytes after the newest delta, wrapping if needed. */
+static size_t rewind_reserve(rewind_t *rw, size_t size)
+{
+    size_t head = 0;
+    if (rw->count > 0) {
+        rewind_entry_t *newest = rewind_entry(rw, rw->count - 1);
+        head = newest->offset + newest->size;
+    }
+    if (head + size > rw->ring_size) {
+        /* Deltas past head are older than the ones before it. */
+        while (rw->count > 0 && rewind_entry(rw, 0)->offset >= head)
+            rewind_drop_oldest(rw);
+        head = 0;
+    }
+    while (rw->count > 0) {
+        rewind_entry_t *oldest = rewind_entry(rw, 0);
+        if (oldest->offset >= head + size ||
+            oldest->offset + oldest->size <= head)
+            break;
+        rewind_drop_oldest(rw);
+    }
+    return head;
+}
+
+static void rewind_push(gb_t *gb, rewind_t *rw)
+{
+    if (!rw->has_state) {
+        gb_state_save(gb, rw->state, rw->state_size, REWIND_SECTIONS);
+        rw->has_state = true;
+        return;
+    }
+    gb_state_save(gb, rw->scratch, rw->state_size, REWIND_SECTIONS);
+    /* Never empty: it has at least the two run lengths. */
+    size_t size =
+        rewind_encode(rw->scratch, rw->state, rw->state_size, rw->delta);
+    uint8_t *tmp = rw->state;
+    rw->state = rw->scratch;
+    rw->scratch = tmp;
+    if (size > rw->ring_size) {
+        /* Does not fit at all, history starts over from this snapshot. */
+        while (rw->count > 0)
+            rewind_drop_oldest(rw);
+        return;
+    }
+    if (rw->count == rw->max_entries)
+        rewind_drop_oldest(rw);
+    size_t offset = rewind_reserve(rw, size);
+    memcpy(rw->ring + offset, rw->delta, size);
+    rewind_entry_t *e = rewind_entry(rw, rw->count++);
+    e->offset = offset;
+    e->size = size;
+    rw->used += size;
+}
+
+void rewind_frame(gb_t *gb)
+{
+    rewind_t *rw = gb->rewind;
+    if (--rw->countdown > 0)
+        return;
+    rw->countdown = rw->interval;
+    rewind_push(gb, rw);
+}
+
+int rewind_pop(gb_t *gb)
+{
+    rewind_t *rw = gb->rewind;
+    if (!rw->has_state)
+        return -1;
+    if (gb_state_load(gb, rw->state, rw->state_size, REWIND_SECTIONS) < 0)
+        return -1;
+    if (rw->count > 0) {
+        /* Step back to the snapshot before. */
+        rewind_entry_t *newest = rewind_entry(rw, rw->count - 1);
+        rewind_decode(rw->state, rw->ring + newest->offset, newest->size);
+        rw->used -= newest->size;
+        rw->count--;
+    } else {
+        rw->has_state = false;
+    }
+    rw->countdown = rw->interval;
+    return 0;
+}
+
+size_t rewind_count(const rewind_t *rw)
+{
+    return rw->has_state ? rw->count + 1 : 0;
+}
+
+size_t rewind_used(const rewind_t *rw)
+{
+    return rw->used;
+}
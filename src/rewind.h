@@ -0,0 +1,37 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct gb gb_t;
+
+/**
+ * Rewind history.
+ *
+ * Every interval frames, at the start of VBlank, the state is saved and
+ * XOR'ed with the previous snapshot. The delta, mostly zeroes since WRAM,
+ * VRAM and cartridge RAM change little between frames, is run length encoded
+ * into a ring of fixed size. The newest snapshot is also kept unencoded, so
+ * going back only takes decoding one delta at a time. When the ring is full
+ * the oldest snapshots are dropped.
+ */
+typedef struct rewind rewind_t;
+
+/* Keep snapshots every interval frames in about memory bytes. */
+rewind_t *rewind_create(const gb_t *gb, size_t memory, unsigned int interval);
+void rewind_destroy(rewind_t *rw);
+
+/* Called at every VBlank while rewind is enabled. */
+void rewind_frame(gb_t *gb);
+
+/* Load the newest snapshot and forget it. Returns -1 if there is none. */
+int rewind_pop(gb_t *gb);
+
+/* Number of snapshots held. */
+size_t rewind_count(const rewind_t *rw);
+
+/* Bytes used by the encoded deltas. */
+size_t rewind_used(const rewind_t *rw);
+
+#endif /* REWIND_H */
@@ -0,0 +1,228 @@
+#include "state.h"
+#include <stdio.h>
+#include <string.h>
+#include "gb.h"
+
+#define STATE_MAGIC 0x54534247 /* "GBST" on little endian hosts. */
+#define STATE_SECTIONS 7
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sections;  /* Mask of the sections that follow. */
+    uint16_t checksum;  /* Global checksum of the cartridge header. */
+    uint16_t reserved;
+} state_header_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t size;
+} state_section_t;
+
+/* Range of struct gb copied as is, or array of pages copied in order. */
+typedef struct {
+    size_t offset;
+    size_t size;
+    size_t pages; /* Number of page_t pointers at offset, 0 for plain data. */
+} state_chunk_t;
+
+#define FIELD_SIZE(f) sizeof(((gb_t *)0)->f)
+#define CHUNK(f) {offsetof(gb_t, f), FIELD_SIZE(f), 0}
+/* Array of pages f, each holding page_size bytes. */
+#define PAGES(f, page_size)                                         \
+    {offsetof(gb_t, f), FIELD_SIZE(f) / sizeof(page_t *) * (page_size), \
+     FIELD_SIZE(f) / sizeof(page_t *)}
+/* Fields first to last, inclusive. */
+#define CHUNK_SPAN(first, last)                               \
+    {offsetof(gb_t, first),                                   \
+     offsetof(gb_t, last) + FIELD_SIZE(last) - offsetof(gb_t, first), 0}
+
+static const state_chunk_t cpu_chunks[] = {
+    CHUNK(cpu),   CHUNK(clock), CHUNK(intr),
+    CHUNK(timer), CHUNK(keys),  CHUNK_SPAN(mmu.speed_switch, mmu.undoc_reg),
+};
+static const state_chunk_t wram_chunks[] = {
+    PAGES(mmu.wram, MMU_WRAM_BANK_SIZE),
+    CHUNK(mmu.zram),
+};
+static const state_chunk_t vram_chunks[] = {
+    PAGES(gpu.vram, GPU_VRAM_BANK_SIZE),
+    CHUNK(gpu.oam),
+};
+static const state_chunk_t gpu_chunks[] = {
+    CHUNK_SPAN(gpu.lcd_control, gpu.modeclock),
+    CHUNK_SPAN(gpu.bg_palette, gpu.frames),
+};
+static const state_chunk_t apu_chunks[] = {
+    CHUNK(apu),
+};
+/* Cartridge RAM follows, its size is given by the ROM header. */
+static const state_chunk_t cart_chunks[] = {
+    CHUNK_SPAN(cart.mbc.rom_bank, cart.mbc.rtc),
+    CHUNK(cart.rom.offset),
+    CHUNK(cart.ram.offset),
+    CHUNK(cart.ram.enabled),
+};
+static const state_chunk_t frame_chunks[] = {
+    {offsetof(gb_t, gpu.framebuffer), GPU_FRAMEBUFFER_SIZE, 1},
+};
+
+static const struct {
+    const state_chunk_t *chunks;
+    size_t count;
+} sections[STATE_SECTIONS] = {
+#define SECTION(chunks) {chunks, sizeof(chunks) / sizeof(chunks[0])}
+    SECTION(cpu_chunks),  SECTION(wram_chunks), SECTION(vram_chunks),
+    SECTION(gpu_chunks),  SECTION(apu_chunks),  SECTION(cart_chunks),
+    SECTION(frame_chunks),
+#undef SECTION
+};
+
+static size_t state_section_size(const gb_t *gb, unsigned int id)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < sections[id].count; ++i)
+        size += sections[id].chunks[i].size;
+    if ((1u << id) == GB_STATE_CART)
+        size += gb->cart.ram.size;
+    return size;
+}
+
+static uint16_t state_checksum(const gb_t *gb)
+{
+    const cart_header_t *h = gb->cart.rom.header;
+    return (uint16_t)(h->checksum_h << 8 | h->checksum_l);
+}
+
+size_t gb_state_size(const gb_t *gb, unsigned int mask)
+{
+    size_t size = sizeof(state_header_t);
+    for (unsigned int id = 0; id < STATE_SECTIONS; ++id) {
+        if (mask & (1u << id))
+            size += sizeof(state_section_t) + state_section_size(gb, id);
+    }
+    return size;
+}
+
+size_t gb_state_save(const gb_t *gb, void *buf, size_t size,
+                     unsigned int mask)
+{
+    mask &= GB_STATE_ALL;
+    if (size < gb_state_size(gb, mask))
+        return 0;
+    uint8_t *p = buf;
+    state_header_t header = {
+        .magic = STATE_MAGIC,
+        .version = GB_STATE_VERSION,
+        .sections = (uint16_t)mask,
+        .checksum = state_checksum(gb),
+    };
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    const uint8_t *base = (const uint8_t *)gb;
+    for (unsigned int id = 0; id < STATE_SECTIONS; ++id) {
+        if (!(mask & (1u << id)))
+            continue;
+        state_section_t sec = {id, (uint32_t)state_section_size(gb, id)};
+        memcpy(p, &sec, sizeof(sec));
+        p += sizeof(sec);
+        for (size_t i = 0; i < sections[id].count; ++i) {
+            const state_chunk_t *c = &sections[id].chunks[i];
+            if (c->pages == 0) {
+                memcpy(p, base + c->offset, c->size);
+                p += c->size;
+                continue;
+            }
+            page_t *const *pages = (page_t *const *)(base + c->offset);
+            for (size_t j = 0; j < c->pages; ++j) {
+                memcpy(p, pages[j]->bytes, c->size / c->pages);
+                p += c->size / c->pages;
+            }
+        }
+        if ((1u << id) == GB_STATE_CART) {
+            for (unsigned int j = 0; j < CART_RAM_MAX_BANKS; ++j) {
+                size_t n = cart_ram_bank_size(&gb->cart, j);
+                if (n > 0)
+                    memcpy(p, gb->cart.ram.banks[j]->bytes, n);
+                p += n;
+            }
+        }
+    }
+    return (size_t)(p - (uint8_t *)buf);
+}
+
+int gb_state_load(gb_t *gb, const void *buf, size_t size,
+                  unsigned int mask)
+{
+    const uint8_t *p = buf, *end = p + size;
+    const uint8_t *found[STATE_SECTIONS] = {NULL};
+    unsigned int found_mask = 0;
+    state_header_t header;
+    if (size < sizeof(header))
+        return -1;
+    memcpy(&header, p, sizeof(header));
+    p += sizeof(header);
+    if (header.magic != STATE_MAGIC || header.version != GB_STATE_VERSION) {
+        fprintf(stderr, "ERROR: unsupported save state\n");
+        return -1;
+    }
+    if (header.checksum != state_checksum(gb)) {
+        fprintf(stderr, "ERROR: save state is from another game\n");
+        return -1;
+    }
+    /* Check every section before changing anything. */
+    while (p < end) {
+        state_section_t sec;
+        if ((size_t)(end - p) < sizeof(sec))
+            return -1;
+        memcpy(&sec, p, sizeof(sec));
+        p += sizeof(sec);
+        if (sec.id >= STATE_SECTIONS ||
+            sec.size != state_section_size(gb, sec.id) ||
+            (size_t)(end - p) < sec.size)
+            return -1;
+        found[sec.id] = p;
+        found_mask |= 1u << sec.id;
+        p += sec.size;
+    }
+    mask &= GB_STATE_ALL;
+    if (found_mask != header.sections || (mask & ~found_mask) != 0)
+        return -1;
+    /* Host pointers are not part of the state, keep the live ones. */
+    apu_timer_cb_f fs_cb = gb->apu.frame_sequencer.cb;
+    apu_timer_cb_f out_cb = gb->apu.output_timer.cb;
+    uint8_t *base = (uint8_t *)gb;
+    for (unsigned int id = 0; id < STATE_SECTIONS; ++id) {
+        if (!(mask & (1u << id)))
+            continue;
+        p = found[id];
+        for (size_t i = 0; i < sections[id].count; ++i) {
+            const state_chunk_t *c = &sections[id].chunks[i];
+            if (c->pages == 0) {
+                memcpy(base + c->offset, p, c->size);
+                p += c->size;
+                continue;
+            }
+            /* Pages shared with a fork are replaced, not written through. */
+            page_t **pages = (page_t **)(base + c->offset);
+            for (size_t j = 0; j < c->pages; ++j) {
+                memcpy(page_overwrite(&pages[j]), p, c->size / c->pages);
+                p += c->size / c->pages;
+            }
+        }
+        if ((1u << id) == GB_STATE_CART) {
+            for (unsigned int j = 0; j < CART_RAM_MAX_BANKS; ++j) {
+                size_t n = cart_ram_bank_size(&gb->cart, j);
+                if (n > 0)
+                    memcpy(page_write(&gb->cart.ram.banks[j]), p, n);
+                p += n;
+            }
+        }
+    }
+    gb->apu.frame_sequencer.cb = fs_cb;
+    gb->apu.output_timer.cb = out_cb;
+    cpu_idle_forget(&gb->idle);
+    /* The events are due as the loaded devices say, not as saved. */
+    clock_flush(gb);
+    return 0;
+}
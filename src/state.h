@@ -0,0 +1,49 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct gb gb_t;
+
+/**
+ * Save state sections. A blob holds any subset of them and each one can be
+ * loaded on its own, e.g. only GB_STATE_VRAM to inspect another frame's tiles.
+ */
+typedef enum {
+    GB_STATE_CPU = 1 << 0,   /* CPU, interrupts, timer, joypad, MMU regs. */
+    GB_STATE_WRAM = 1 << 1,  /* Work RAM and HRAM. */
+    GB_STATE_VRAM = 1 << 2,  /* Video RAM and OAM. */
+    GB_STATE_GPU = 1 << 3,   /* PPU registers, palettes and timing. */
+    GB_STATE_APU = 1 << 4,   /* Sound registers, channels and sample buffer. */
+    GB_STATE_CART = 1 << 5,  /* MBC registers, RTC and cartridge RAM. */
+    GB_STATE_FRAME = 1 << 6, /* Framebuffer, as of the last rendered line. */
+    GB_STATE_ALL = (1 << 7) - 1,
+} gb_state_section_e;
+
+/**
+ * Bumped whenever a section layout changes. States are raw copies of the
+ * emulator structs, so they only load into a build with the same version,
+ * struct layout and byte order; anything else is rejected.
+ */
+#define GB_STATE_VERSION 9
+
+/* Size of a blob holding the given sections. */
+size_t gb_state_size(const gb_t *gb, unsigned int sections);
+
+/**
+ * Write the given sections to buf. Returns the size written, or 0 if buf is
+ * smaller than gb_state_size().
+ */
+size_t gb_state_save(const gb_t *gb, void *buf, size_t size,
+                     unsigned int sections);
+
+/**
+ * Load the given sections from buf, ignoring the others. Fails without
+ * touching the instance if the blob is malformed, from another version or
+ * another game, or lacks one of the sections asked for.
+ */
+int gb_state_load(gb_t *gb, const void *buf, size_t size,
+                  unsigned int sections);
+
+#endif /* STATE_H */
@@ -1,101 +1,142 @@
 #include "timer.h"
 
+#include <limits.h>
 #include <stdio.h>
 
 #include "cartridge/cart.h"
+#include "clock.h"
 #include "debug.h"
+#include "gb.h"
 #include "interrupt.h"
 
 #define TIMER_ENABLE (1 << 2)
 
-/* TIMA states. */
-typedef enum {
-    TIMA_STATE_COUNTING = 0, /* Normal operation */
-    TIMA_STATE_OVERFLOW,     /* Overflow happened. */
-    TIMA_STATE_RELOADING,    /* TIMA is being reloaded. */
-} tima_state_t;
-
-static unsigned int clk_sys;    /* Internal timer clock. */
-static uint8_t tima;            /* [$ff05] Timer counter (R/W) */
-static uint8_t tma;             /* [$ff06] Timer Modulo (R/W) */
-static uint8_t tac;             /* [$ff07] Timer Control (R/W) */
-static tima_state_t tima_state; /* TIMA operation states. */
-static unsigned int delay_bit;  /* Falling edge detector delay bit. */
 static const unsigned int masks[4] = {0x200, 0x8, 0x20, 0x80};
-static unsigned int timer_enabled;
-static unsigned int timer_mask;
 
-void timer_reset(void)
+void timer_reset(gb_t *gb)
 {
-    tima = 0;
-    tma = 0;
-    tac = 0;
-    timer_enabled = 0;
-    timer_mask = masks[0];
-    if (cart_is_cgb())
-        clk_sys = 0x2674; /* Initial value for CGB ABCDE */
+    gb->timer.tima = 0;
+    gb->timer.tma = 0;
+    gb->timer.tac = 0;
+    gb->timer.timer_enabled = 0;
+    gb->timer.timer_mask = masks[0];
+    if (cart_is_cgb(&gb->cart))
+        gb->timer.clk_sys = 0x2674; /* Initial value for CGB ABCDE */
     else
-        clk_sys = 0xabca; /* Initial value for DMG ABC */
-    tima_state = TIMA_STATE_COUNTING;
-    delay_bit = 0;
+        gb->timer.clk_sys = 0xabca; /* Initial value for DMG ABC */
+    gb->timer.tima_state = TIMA_STATE_COUNTING;
+    gb->timer.delay_bit = 0;
+    gb->timer.synced = clock_now(gb);
 }
 
-void timer_step(unsigned int clock_step)
+/* One 4 cycle step, as the CPU makes them. */
+static void timer_tick(gb_t *gb)
 {
-    clk_sys += clock_step;
+    gb->timer.clk_sys += 4;
     /* Check whether a step needs to be made in the timer. */
-    switch (tima_state) {
+    switch (gb->timer.tima_state) {
         case TIMA_STATE_COUNTING:
             break;
         case TIMA_STATE_OVERFLOW:
             /* After one cycle, TIMA should be reloaded and the interrupt
              * flag set.
              */
-            tima = tma;
-            interrupt_raise(INTERRUPTS_TIMER);
-            tima_state = TIMA_STATE_RELOADING;
+            gb->timer.tima = gb->timer.tma;
+            interrupt_raise(gb, INTERRUPTS_TIMER);
+            gb->timer.tima_state = TIMA_STATE_RELOADING;
             break;
         case TIMA_STATE_RELOADING:
-            tima_state = TIMA_STATE_COUNTING;
+            gb->timer.tima_state = TIMA_STATE_COUNTING;
             break;
     }
     /* Falling edge detector. */
-    unsigned int bit = (clk_sys & timer_mask) && timer_enabled;
-    if (delay_bit & ~bit) {
-        if (++tima == 0) {
+    unsigned int bit = (gb->timer.clk_sys & gb->timer.timer_mask) &&
+                       gb->timer.timer_enabled;
+    if (gb->timer.delay_bit & ~bit) {
+        if (++gb->timer.tima == 0) {
             /* When TIMA overflows, it contains zero for 1 cycle. */
-            tima_state = TIMA_STATE_OVERFLOW;
+            gb->timer.tima_state = TIMA_STATE_OVERFLOW;
         }
     }
-    delay_bit = bit;
+    gb->timer.delay_bit = bit;
 }
 
-uint8_t timer_read_div(void)
+unsigned int timer_next_event(gb_t *gb)
 {
-    return clk_sys >> 8;
+    gb_timer_t *t = &gb->timer;
+    unsigned int bit = (t->clk_sys & t->timer_mask) && t->timer_enabled;
+    if (t->tima_state != TIMA_STATE_COUNTING || t->delay_bit != bit)
+        return 0;
+    if (!t->timer_enabled)
+        return UINT_MAX;
+    /* TIMA counts when clk_sys crosses a multiple of twice the mask. */
+    unsigned int period = t->timer_mask << 1;
+    unsigned int edge = period - (t->clk_sys & (period - 1));
+    return edge + (0xffu - t->tima) * period;
 }
 
-void timer_write_div(void)
+/* Advance by fewer cycles than timer_next_event(), in one go. */
+static void timer_skip(gb_t *gb, unsigned int cycles)
 {
-    clk_sys = 0;
+    gb_timer_t *t = &gb->timer;
+    if (t->timer_enabled) {
+        unsigned int period = t->timer_mask << 1;
+        t->tima += ((t->clk_sys & (period - 1)) + cycles) / period;
+    }
+    t->clk_sys += cycles;
+    t->delay_bit = (t->clk_sys & t->timer_mask) && t->timer_enabled;
+}
+
+void timer_sync(gb_t *gb)
+{
+    gb_timer_t *t = &gb->timer;
+    uint64_t now = clock_now(gb);
+    while (t->synced < now) {
+        /* Whole steps up to the one seeing an overflow, then that one. */
+        unsigned int next = timer_next_event(gb);
+        uint64_t cycles = next > 0 ? (next - 1) & ~3u : 0;
+        if (cycles > now - t->synced)
+            cycles = now - t->synced;
+        if (cycles > 0) {
+            timer_skip(gb, (unsigned int)cycles);
+            t->synced += cycles;
+        } else {
+            timer_tick(gb);
+            t->synced += 4;
+        }
+    }
+}
+
+uint8_t timer_read_div(gb_t *gb)
+{
+    timer_sync(gb);
+    return gb->timer.clk_sys >> 8;
+}
+
+void timer_write_div(gb_t *gb)
+{
+    timer_sync(gb);
+    gb->timer.clk_sys = 0;
 }
 
-uint8_t timer_read_tima(void)
+uint8_t timer_read_tima(gb_t *gb)
 {
-    return tima;
+    timer_sync(gb);
+    return gb->timer.tima;
 }
 
-void timer_write_tima(uint8_t val)
+void timer_write_tima(gb_t *gb, uint8_t val)
 {
-    switch (tima_state) {
+    timer_sync(gb);
+    switch (gb->timer.tima_state) {
         case TIMA_STATE_COUNTING:
             /* Normal operation. */
-            tima = val;
+            gb->timer.tima = val;
             break;
         case TIMA_STATE_OVERFLOW:
             /* Prevent reload if writing to it during overflow cycle. */
-            tima = val;
-            tima_state = TIMA_STATE_COUNTING;
+            gb->timer.tima = val;
+            gb->timer.tima_state = TIMA_STATE_COUNTING;
             break;
         case TIMA_STATE_RELOADING:
             /* Ignore writes if TIMA was just reloaded. */
@@ -103,38 +144,42 @@ void timer_write_tima(uint8_t val)
     }
 }
 
-uint8_t timer_read_tma(void)
+uint8_t timer_read_tma(gb_t *gb)
 {
-    return tma;
+    timer_sync(gb);
+    return gb->timer.tma;
 }
 
-void timer_write_tma(uint8_t val)
+void timer_write_tma(gb_t *gb, uint8_t val)
 {
-    tma = val;
-    if (tima_state == TIMA_STATE_RELOADING) {
+    timer_sync(gb);
+    gb->timer.tma = val;
+    if (gb->timer.tima_state == TIMA_STATE_RELOADING) {
         /* If TMA is written in the same cycle that TIMA is reloaded,
          * write the value to TIMA as well. */
-        tima = tma;
+        gb->timer.tima = gb->timer.tma;
     }
 }
 
-uint8_t timer_read_tac(void)
+uint8_t timer_read_tac(gb_t *gb)
 {
-    return 0xf8 | tac;
+    timer_sync(gb);
+    return 0xf8 | gb->timer.tac;
 }
 
-void timer_write_tac(uint8_t val)
+void timer_write_tac(gb_t *gb, uint8_t val)
 {
-    tac = 7 & val;
-    timer_enabled = tac >> 2;
-    timer_mask = masks[tac & 3];
+    timer_sync(gb);
+    gb->timer.tac = 7 & val;
+    gb->timer.timer_enabled = gb->timer.tac >> 2;
+    gb->timer.timer_mask = masks[gb->timer.tac & 3];
 }
 
-void timer_dump(void)
+void timer_dump(gb_t *gb)
 {
     printf("Timer dump:\n");
-    printf("[$ff04] div=0x%.2x\n", timer_read_div());
-    printf("[$ff05] tima=0x%.2x\n", timer_read_tima());
-    printf("[$ff06] tma=0x%.2x\n", timer_read_tma());
-    printf("[$ff07] tac=0x%.2x\n", timer_read_tac());
+    printf("[$ff04] div=0x%.2x\n", timer_read_div(gb));
+    printf("[$ff05] tima=0x%.2x\n", timer_read_tima(gb));
+    printf("[$ff06] tma=0x%.2x\n", timer_read_tma(gb));
+    printf("[$ff07] tac=0x%.2x\n", timer_read_tac(gb));
 }
@@ -3,20 +3,52 @@
 
 #include <stdint.h>
 
-void timer_reset(void);
-void timer_step(unsigned int clock_step);
+typedef struct gb gb_t;
 
-uint8_t timer_read_div(void);
-uint8_t timer_read_tima(void);
-uint8_t timer_read_tma(void);
-uint8_t timer_read_tac(void);
+/* TIMA states. */
+typedef enum {
+    TIMA_STATE_COUNTING = 0, /* Normal operation */
+    TIMA_STATE_OVERFLOW,     /* Overflow happened. */
+    TIMA_STATE_RELOADING,    /* TIMA is being reloaded. */
+} tima_state_t;
 
-void timer_write_div(void);
-void timer_write_tima(uint8_t val);
-void timer_write_tma(uint8_t val);
-void timer_write_tac(uint8_t val);
+typedef struct {
+    unsigned int clk_sys;    /* Internal timer clock. */
+    uint8_t tima;            /* [$ff05] Timer counter (R/W) */
+    uint8_t tma;             /* [$ff06] Timer Modulo (R/W) */
+    uint8_t tac;             /* [$ff07] Timer Control (R/W) */
+    tima_state_t tima_state; /* TIMA operation states. */
+    unsigned int delay_bit;  /* Falling edge detector delay bit. */
+    unsigned int timer_enabled;
+    unsigned int timer_mask;
+    uint64_t synced; /* Clock cycle the timer has been brought up to. */
+} gb_timer_t;
 
-void timer_write_byte(uint16_t addr, uint8_t val);
-void timer_dump(void);
+void timer_reset(gb_t *gb);
+/**
+ * Bring the timer up to the clock, 4 cycles at a time as the CPU steps, in
+ * one go between overflows. Done before any access, and by the clock when an
+ * overflow may be due.
+ */
+void timer_sync(gb_t *gb);
+
+/**
+ * Cycles until TIMA overflows, UINT_MAX if it does not count, 0 if it is
+ * busy with an overflow or a TAC change.
+ */
+unsigned int timer_next_event(gb_t *gb);
+
+uint8_t timer_read_div(gb_t *gb);
+uint8_t timer_read_tima(gb_t *gb);
+uint8_t timer_read_tma(gb_t *gb);
+uint8_t timer_read_tac(gb_t *gb);
+
+void timer_write_div(gb_t *gb);
+void timer_write_tima(gb_t *gb, uint8_t val);
+void timer_write_tma(gb_t *gb, uint8_t val);
+void timer_write_tac(gb_t *gb, uint8_t val);
+
+void timer_write_byte(gb_t *gb, uint16_t addr, uint8_t val);
+void timer_dump(gb_t *gb);
 
 #endif /* TIMER_H */
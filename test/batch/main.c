@@ -0,0 +1,12 @@
+#include "ut.h"
+
+struct ut unit_test;
+
+extern void pool_test(void);
+
+int main(void)
+{
+    pool_test();
+    ut_result();
+    return 0;
+}
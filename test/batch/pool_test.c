@@ -0,0 +1,64 @@
+#include <unistd.h>
+#include "batch/pool.h"
+#include "ut.h"
+
+void pool_test(void);
+
+#define JOBS 1000
+
+static unsigned int runs[JOBS];
+
+static void count_job(unsigned int worker, size_t job, void *data)
+{
+    (void)worker;
+    (void)data;
+    __atomic_add_fetch(&runs[job], 1, __ATOMIC_RELAXED);
+    /* Make the first slice slow, so the other workers have to steal it. */
+    if (job < JOBS / 8)
+        usleep(100);
+}
+
+static int run_once(unsigned int threads, size_t jobs)
+{
+    for (size_t i = 0; i < JOBS; ++i)
+        runs[i] = 0;
+    ASSERT_EQ(0, pool_run(threads, jobs, count_job, NULL));
+    for (size_t i = 0; i < JOBS; ++i)
+        ASSERT_EQ(i < jobs ? 1 : 0, runs[i]);
+    return 0;
+}
+
+static int every_job_once_test(void)
+{
+    ASSERT_EQ(0, run_once(1, JOBS));
+    ASSERT_EQ(0, run_once(4, JOBS));
+    ASSERT_EQ(0, run_once(8, 3));
+    ASSERT_EQ(0, run_once(3, 0));
+    return 0;
+}
+
+static void record_worker(unsigned int worker, size_t job, void *data)
+{
+    unsigned int *owner = data;
+    owner[job] = worker;
+    if (job < JOBS / 2)
+        usleep(100);
+}
+
+static int steal_test(void)
+{
+    static unsigned int owner[JOBS];
+    ASSERT_EQ(0, pool_run(2, JOBS, record_worker, owner));
+    /* Worker 1 is done with its half long before worker 0. */
+    unsigned int stolen = 0;
+    for (size_t i = 0; i < JOBS / 2; ++i)
+        stolen += owner[i] == 1;
+    ASSERT(stolen > 0);
+    return 0;
+}
+
+void pool_test(void)
+{
+    ut_run(every_job_once_test);
+    ut_run(steal_test);
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "gb.h"
+#include "gb/rom.h"
+
+/**
+ * Headless throughput of the core on small ROMs, in emulated cycles per
+ * second of CPU time. Each ROM runs a few times and the best run counts,
+ * which makes the numbers stable enough to compare two builds.
+ *
+ * Usage: gb_bench [frames]
+ */
+
+#define GB_CYCLES_PER_SECOND 4194304.0
+#define RUNS 5
+
+typedef struct {
+    const char *name;
+    const uint8_t *code;
+    size_t len;
+} bench_rom_t;
+
+/* Arithmetic, logic and CB operations on registers and (HL), in a loop. */
+static const uint8_t alu[] = {
+    0x3e, 0xe4,       /* ld a, $e4 */
+    0xe0, 0x47,       /* ldh ($47), a */
+    0x21, 0x00, 0xc0, /* loop: ld hl, $c000 */
+    0x06, 0x40,       /* ld b, $40 */
+    0x7e,             /* inner: ld a, (hl) */
+    0x80,             /* add a, b */
+    0xa9,             /* xor c */
+    0xcb, 0x37,       /* swap a */
+    0xcb, 0x11,       /* rl c */
+    0xcb, 0x5f,       /* bit 3, a */
+    0x22,             /* ld (hl+), a */
+    0x0c,             /* inc c */
+    0x05,             /* dec b */
+    0x20, 0xf2,       /* jr nz, inner */
+    0xc3, 0x04, 0x01, /* jp loop */
+};
+
+/* Wait for VBlank in HALT, as most games do once their frame is done. */
+static const uint8_t halt[] = {
+    0xf3,             /* di */
+    0x3e, 0xe4,       /* ld a, $e4 */
+    0xe0, 0x47,       /* ldh ($47), a */
+    0x3e, 0x01,       /* ld a, $01 */
+    0xe0, 0xff,       /* ldh ($ff), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xaf,             /* loop: xor a */
+    0xe0, 0x0f,       /* ldh ($0f), a */
+    0x76,             /* halt */
+    0x34,             /* inc (hl) */
+    0x18, 0xf9,       /* jr loop */
+};
+
+/* Same polling LY, as games that never halt do. */
+static const uint8_t poll[] = {
+    0xf3,             /* di */
+    0x3e, 0xe4,       /* ld a, $e4 */
+    0xe0, 0x47,       /* ldh ($47), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xf0, 0x44,       /* wait: ldh a, ($44) */
+    0xfe, 0x90,       /* cp $90 */
+    0x20, 0xfa,       /* jr nz, wait */
+    0x34,             /* inc (hl) */
+    0xf0, 0x44,       /* leave: ldh a, ($44) */
+    0xfe, 0x90,       /* cp $90 */
+    0x28, 0xfa,       /* jr z, leave */
+    0x18, 0xf1,       /* jr wait */
+};
+
+/* Copy 2KB of ROM to WRAM over and over, as games copy their data. */
+static const uint8_t copy[] = {
+    0x21, 0x00, 0x00, /* loop: ld hl, $0000 */
+    0x11, 0x00, 0xc0, /* ld de, $c000 */
+    0x01, 0x00, 0x08, /* ld bc, $0800 */
+    0x2a,             /* copy: ld a, (hl+) */
+    0x12,             /* ld (de), a */
+    0x13,             /* inc de */
+    0x0b,             /* dec bc */
+    0x78,             /* ld a, b */
+    0xb1,             /* or c */
+    0x20, 0xf8,       /* jr nz, copy */
+    0x18, 0xed,       /* jr loop */
+};
+
+static const bench_rom_t roms[] = {
+    {"alu", alu, sizeof(alu)},
+    {"halt", halt, sizeof(halt)},
+    {"poll", poll, sizeof(poll)},
+    {"copy", copy, sizeof(copy)},
+};
+
+static double cpu_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int bench(const bench_rom_t *rom, unsigned int frames)
+{
+    char path[] = "/tmp/gb_benchXXXXXX.gb";
+    int fd = mkstemps(path, 3);
+    if (fd < 0 || rom_create(path, rom->code, rom->len) != 0) {
+        fprintf(stderr, "ERROR: could not create %s rom\n", rom->name);
+        return -1;
+    }
+    close(fd);
+    gb_t *gb = gb_create(path);
+    unlink(path);
+    if (gb == NULL)
+        return -1;
+    double best = 0;
+    for (int i = 0; i < RUNS; ++i) {
+        double start = cpu_time();
+        uint64_t cycles = gb_run_frames(gb, frames);
+        double rate = (double)cycles / (cpu_time() - start);
+        if (rate > best)
+            best = rate;
+    }
+    printf("%-10s %8.1f Mcycles/s %8.1fx real time\n", rom->name,
+           best / 1e6, best / GB_CYCLES_PER_SECOND);
+    gb_destroy(gb);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int frames = argc > 1 ? (unsigned int)atoi(argv[1]) : 600;
+#ifdef CPU_EAGER_FLAGS
+    printf("eager flags\n");
+#else
+    printf("lazy flags\n");
+#endif
+    for (size_t i = 0; i < sizeof(roms) / sizeof(roms[0]); ++i) {
+        if (bench(&roms[i], frames) < 0)
+            return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -3,12 +3,14 @@
 #include "asm.h"
 #include "clock.h"
 #include "cpu.h"
+#include "gb.h"
 #include "ut.h"
 
 static uint8_t memory[0x10];
 static int mem_pos;
 
-extern cpu_t CPU;
+static gb_t gb_ctx;
+static gb_t *gb = &gb_ctx;
 
 void cpu_test(void);
 
@@ -16,29 +18,29 @@ static int get_cpu_reg(reg_t reg)
 {
     switch (reg) {
         case REG_A:
-            return CPU.reg.a;
+            return gb->cpu.reg.a;
         case REG_F:
-            return CPU.reg.f;
+            return gb->cpu.reg.f;
         case REG_B:
-            return CPU.reg.b;
+            return gb->cpu.reg.b;
         case REG_C:
-            return CPU.reg.c;
+            return gb->cpu.reg.c;
         case REG_D:
-            return CPU.reg.d;
+            return gb->cpu.reg.d;
         case REG_E:
-            return CPU.reg.e;
+            return gb->cpu.reg.e;
         case REG_H:
-            return CPU.reg.h;
+            return gb->cpu.reg.h;
         case REG_L:
-            return CPU.reg.l;
+            return gb->cpu.reg.l;
         case REG_AF:
-            return CPU.reg.af;
+            return gb->cpu.reg.af;
         case REG_BC:
-            return CPU.reg.bc;
+            return gb->cpu.reg.bc;
         case REG_DE:
-            return CPU.reg.de;
+            return gb->cpu.reg.de;
         case REG_HL:
-            return CPU.reg.hl;
+            return gb->cpu.reg.hl;
         default:
             return -1;
     }
@@ -48,9 +50,9 @@ static int test_reg(const char *src, int reg, int val, int flags)
 {
     mem_pos = 0;
     ASSERT(asm_to_opcode(src, memory, sizeof(memory)) == 0);
-    cpu_execute(memory[0]);
+    cpu_execute(gb, memory[0]);
     ASSERT_EQ(val, get_cpu_reg(reg));
-    ASSERT_EQ(flags, (int)CPU.reg.f);
+    ASSERT_EQ(flags, (int)gb->cpu.reg.f);
     return 0;
 }
 
@@ -63,10 +65,10 @@ static int adc_test(void)
 
 void cpu_test(void)
 {
-    cpu_init(NULL);
-    CPU.reg.af = 0;
-    CPU.reg.bc = 0x00ff;
-    CPU.reg.de = 0xff00;
-    CPU.reg.hl = 0xffff;
+    cpu_init(gb, NULL);
+    gb->cpu.reg.af = 0;
+    gb->cpu.reg.bc = 0x00ff;
+    gb->cpu.reg.de = 0xff00;
+    gb->cpu.reg.hl = 0xffff;
     ut_run(adc_test);
 }
@@ -1,88 +1,162 @@
 #include "apu/apu.h"
-#include "cartridge/cart.h"
+#include "cpu_bulk.h"
+#include "cpu_idle.h"
 #include "gpu.h"
+#include "keys.h"
 #include "mmu.h"
 
-int mmu_init(const char *rom_path)
+int mmu_init(gb_t *gb, const char *rom_path)
 {
+    (void)gb;
     (void)rom_path;
     return 0;
 }
 
-void mmu_finish(void)
+int mmu_init_shared(gb_t *gb, const gb_t *src)
 {
+    (void)gb;
+    (void)src;
+    return 0;
 }
 
-void mmu_reset(void)
+void mmu_finish(gb_t *gb)
 {
+    (void)gb;
 }
 
-uint8_t mmu_read_byte_dma(uint16_t addr)
+void mmu_reset(gb_t *gb)
 {
+    (void)gb;
+}
+
+uint8_t mmu_read_byte_dma(gb_t *gb, uint16_t addr)
+{
+    (void)gb;
     (void)addr;
     return 0;
 }
 
-uint8_t mmu_read_byte(uint16_t addr)
+uint8_t mmu_read_byte(gb_t *gb, uint16_t addr)
 {
+    (void)gb;
     (void)addr;
     return 0;
 }
 
-uint16_t mmu_read_word(uint16_t addr)
+uint16_t mmu_read_word(gb_t *gb, uint16_t addr)
 {
+    (void)gb;
     (void)addr;
     return 0;
 }
 
-void mmu_write_byte_dma(uint16_t addr, uint8_t value)
+void mmu_write_byte_dma(gb_t *gb, uint16_t addr, uint8_t value)
 {
+    (void)gb;
     (void)addr;
     (void)value;
 }
 
-void mmu_write_byte(uint16_t addr, uint8_t value)
+void mmu_write_byte(gb_t *gb, uint16_t addr, uint8_t value)
 {
+    (void)gb;
     (void)addr;
     (void)value;
 }
 
-void mmu_write_word(uint16_t addr, uint16_t value)
+void mmu_write_word(gb_t *gb, uint16_t addr, uint16_t value)
 {
+    (void)gb;
     (void)addr;
     (void)value;
 }
 
-void mmu_stop(void)
+bool mmu_stop(gb_t *gb)
 {
+    (void)gb;
+    return false;
 }
 
-void mmu_dump(uint16_t addr, uint16_t offset)
+void mmu_dump(gb_t *gb, uint16_t addr, uint16_t offset)
 {
+    (void)gb;
     (void)addr;
     (void)offset;
 }
 
-/* cart */
+/* gpu */
 
-bool cart_is_cgb(void)
+void gpu_tick(gb_t *gb, unsigned int clock_step)
 {
-    return true;
+    (void)gb;
+    (void)clock_step;
 }
 
-/* gpu */
+unsigned int gpu_next_event(gb_t *gb)
+{
+    (void)gb;
+    return 0;
+}
 
-void gpu_tick(unsigned int clock_step)
+unsigned int gpu_oam_dma_next_event(gb_t *gb)
 {
-    (void)clock_step;
+    (void)gb;
+    return 0;
+}
+
+void gpu_present_frame(gb_t *gb)
+{
+    (void)gb;
 }
 
-void gpu_dump(void)
+void gpu_dump(gb_t *gb)
 {
+    (void)gb;
 }
 
 /* apu */
-void apu_tick(unsigned int clock_step)
+void apu_tick(gb_t *gb, unsigned int clock_step)
 {
+    (void)gb;
     (void)clock_step;
 }
+
+/* keys */
+
+uint8_t keys_get_held(gb_t *gb)
+{
+    (void)gb;
+    return 0;
+}
+
+/* cpu_bulk */
+
+void cpu_bulk_reset(gb_t *gb)
+{
+    (void)gb;
+}
+
+bool cpu_bulk_loop(gb_t *gb, uint16_t end)
+{
+    (void)gb;
+    (void)end;
+    return false;
+}
+
+/* cpu_idle */
+
+void cpu_idle_reset(gb_t *gb)
+{
+    (void)gb;
+}
+
+void cpu_idle_loop(gb_t *gb, uint16_t end)
+{
+    (void)gb;
+    (void)end;
+}
+
+void cpu_idle_dump(gb_t *gb)
+{
+    (void)gb;
+}
@@ -0,0 +1,141 @@
+#include <string.h>
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void bulk_test(void);
+
+/* Copy ROM to VRAM and VRAM to WRAM, then fill HRAM, forever. */
+static const uint8_t copy_fill[] = {
+    0x21, 0x00, 0x00, /* loop: ld hl, $0000 */
+    0x11, 0x00, 0x80, /* ld de, $8000 */
+    0x01, 0x00, 0x08, /* ld bc, $0800 */
+    0x2a,             /* vram: ld a, (hl+) */
+    0x12,             /* ld (de), a */
+    0x13,             /* inc de */
+    0x0b,             /* dec bc */
+    0x78,             /* ld a, b */
+    0xb1,             /* or c */
+    0x20, 0xf8,       /* jr nz, vram */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0x11, 0x00, 0x80, /* ld de, $8000 */
+    0x01, 0x00, 0x04, /* ld bc, $0400 */
+    0x1a,             /* wram: ld a, (de) */
+    0x22,             /* ld (hl+), a */
+    0x13,             /* inc de */
+    0x0b,             /* dec bc */
+    0x78,             /* ld a, b */
+    0xb1,             /* or c */
+    0x20, 0xf8,       /* jr nz, wram */
+    0x21, 0xfe, 0xff, /* ld hl, $fffe */
+    0x06, 0x70,       /* ld b, $70 */
+    0xfa, 0x10, 0xc0, /* ld a, ($c010) */
+    0x32,             /* hram: ld (hl-), a */
+    0x05,             /* dec b */
+    0x20, 0xfc,       /* jr nz, hram */
+    0x18, 0xd0,       /* jr loop */
+};
+
+/* Copy to OAM, which the PPU may hold, forever. */
+static const uint8_t copy_oam[] = {
+    0x21, 0x00, 0xfe, /* loop: ld hl, $fe00 */
+    0x11, 0x00, 0x00, /* ld de, $0000 */
+    0x06, 0xa0,       /* ld b, $a0 */
+    0x1a,             /* oam: ld a, (de) */
+    0x22,             /* ld (hl+), a */
+    0x13,             /* inc de */
+    0x05,             /* dec b */
+    0x20, 0xfa,       /* jr nz, oam */
+    0x18, 0xf0,       /* jr loop */
+};
+
+/* Smear a counter over WRAM with an overlapping copy, forever. */
+static const uint8_t smear[] = {
+    0x21, 0x00, 0xc0, /* loop: ld hl, $c000 */
+    0x34,             /* inc (hl) */
+    0x11, 0x01, 0xc0, /* ld de, $c001 */
+    0x01, 0xff, 0x0f, /* ld bc, $0fff */
+    0x2a,             /* copy: ld a, (hl+) */
+    0x12,             /* ld (de), a */
+    0x13,             /* inc de */
+    0x0b,             /* dec bc */
+    0x78,             /* ld a, b */
+    0xb1,             /* or c */
+    0x20, 0xf8,       /* jr nz, copy */
+    0x18, 0xec,       /* jr loop */
+};
+
+/* Bulk copies cannot be told apart from running the loop byte by byte. */
+static int copied(const uint8_t *code, size_t len, bool bulk)
+{
+    gb_t *gb, *ref;
+    ASSERT_EQ(0, rom_same(code, len, gb_set_bulk_copy, &gb, &ref));
+    ASSERT_EQ(0, ref->bulk.bytes);
+    ASSERT_EQ(bulk, gb->bulk.bytes > 0);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int copy_fill_test(void)
+{
+    return copied(copy_fill, sizeof(copy_fill), true);
+}
+
+static int copy_oam_test(void)
+{
+    return copied(copy_oam, sizeof(copy_oam), false);
+}
+
+/* Same once forked mid-copy, when the pages copied from are shared. */
+static int forked(const uint8_t *code, size_t len)
+{
+    gb_t *gb = rom_gb(code, len);
+    gb_t *ref = rom_gb(code, len);
+    ASSERT(gb != NULL && ref != NULL);
+    gb_set_bulk_copy(ref, false);
+    gb_run_frames(gb, 5);
+    gb_run_frames(ref, 5);
+    gb_t *child = gb_fork(gb);
+    ASSERT(child != NULL);
+    uint64_t bytes = child->bulk.bytes;
+    for (int i = 0; i < 10; ++i) {
+        gb_run_frames(gb, 1);
+        gb_run_frames(child, 1);
+        gb_run_frames(ref, 1);
+        const gb_t *run[] = {gb, child};
+        for (int k = 0; k < 2; ++k) {
+            ASSERT(memcmp(&run[k]->cpu.reg, &ref->cpu.reg,
+                          sizeof(ref->cpu.reg)) == 0);
+            ASSERT(memcmp(run[k]->mmu.wram[0]->bytes, ref->mmu.wram[0]->bytes,
+                          0x1000) == 0);
+            ASSERT(memcmp(run[k]->gpu.vram[0]->bytes, ref->gpu.vram[0]->bytes,
+                          0x2000) == 0);
+        }
+    }
+    ASSERT(child->bulk.bytes > bytes);
+    gb_destroy(child);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int fork_copy_fill_test(void)
+{
+    return forked(copy_fill, sizeof(copy_fill));
+}
+
+static int fork_smear_test(void)
+{
+    return forked(smear, sizeof(smear));
+}
+
+void bulk_test(void)
+{
+    rom_open(__func__);
+    ut_run(copy_fill_test);
+    ut_run(copy_oam_test);
+    ut_run(fork_copy_fill_test);
+    ut_run(fork_smear_test);
+    rom_close();
+}
@@ -0,0 +1,57 @@
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void decode_test(void);
+
+static const char *rom_path;
+
+/* Call the same address in banks 1, 2 and 3, forever. */
+static const uint8_t code[] = {
+    0x3e, 0x01,       /* loop: ld a, 1 */
+    0xea, 0x00, 0x20, /* ld ($2000), a */
+    0xcd, 0x00, 0x40, /* call $4000 */
+    0x3e, 0x02,       /* ld a, 2 */
+    0xea, 0x00, 0x20, /* ld ($2000), a */
+    0xcd, 0x00, 0x40, /* call $4000 */
+    0x3e, 0x03,       /* ld a, 3 */
+    0xea, 0x00, 0x20, /* ld ($2000), a */
+    0xcd, 0x00, 0x40, /* call $4000 */
+    0x18, 0xe6,       /* jr loop */
+};
+
+/* Bank n stores n at $c000 + n. Same instructions, other operands. */
+static const uint8_t bank1[] = {0x3e, 0x01, 0xea, 0x01, 0xc0, 0xc9};
+static const uint8_t bank2[] = {0x3e, 0x02, 0xea, 0x02, 0xc0, 0xc9};
+static const uint8_t bank3[] = {0x3e, 0x03, 0xea, 0x03, 0xc0, 0xc9};
+
+static int decode_bank_test(void)
+{
+    const uint8_t *const banks[3] = {bank1, bank2, bank3};
+    ASSERT_EQ(0, rom_create_mbc1(rom_path, code, sizeof(code), banks,
+                                 sizeof(bank1)));
+    gb_t *gb = gb_create(rom_path);
+    ASSERT(gb != NULL);
+    gb_run_frames(gb, 1);
+    /* Each bank ran its own code, not the one first decoded at $4000. */
+    for (int n = 1; n <= 3; ++n)
+        ASSERT_EQ(n, gb->mmu.wram[0]->bytes[n]);
+    /* Instances sharing the ROM share what was decoded. */
+    gb_t *shared = gb_create_shared(gb);
+    ASSERT(shared != NULL);
+    ASSERT(shared->cart.rom.image->code == gb->cart.rom.image->code);
+    gb_run_frames(shared, 1);
+    ASSERT_EQ(gb_frame_hash(gb), gb_frame_hash(shared));
+    for (int n = 1; n <= 3; ++n)
+        ASSERT_EQ(n, shared->mmu.wram[0]->bytes[n]);
+    gb_destroy(shared);
+    gb_destroy(gb);
+    return 0;
+}
+
+void decode_test(void)
+{
+    rom_path = rom_open(__func__);
+    ut_run(decode_bank_test);
+    rom_close();
+}
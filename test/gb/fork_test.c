@@ -0,0 +1,96 @@
+#include <string.h>
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void fork_test(void);
+
+static int fork_same_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    gb_run_frames(gb, 10);
+    gb_t *child = gb_fork(gb);
+    ASSERT(child != NULL);
+    /* Nothing is copied until written. */
+    ASSERT(child->mmu.wram[0] == gb->mmu.wram[0]);
+    ASSERT(child->gpu.framebuffer == gb->gpu.framebuffer);
+    gb_run_frames(gb, 10);
+    gb_run_frames(child, 10);
+    ASSERT(gb_frame_hash(gb) == gb_frame_hash(child));
+    ASSERT_EQ(gb->mmu.wram[0]->bytes[0], child->mmu.wram[0]->bytes[0]);
+    ASSERT(child->mmu.wram[0] != gb->mmu.wram[0]);
+    /* The counter ROM never touches the other banks. */
+    ASSERT(child->mmu.wram[1] == gb->mmu.wram[1]);
+    ASSERT(child->gpu.vram[1] == gb->gpu.vram[1]);
+    gb_destroy(gb);
+    gb_run_frames(child, 1);
+    gb_destroy(child);
+    return 0;
+}
+
+static int fork_diverge_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    gb_run_frames(gb, 1);
+    gb_t *child = gb_fork(gb);
+    ASSERT(child != NULL);
+    uint8_t counter = gb->mmu.wram[0]->bytes[0];
+    mmu_write_byte_dma(child, 0xc000, counter + 100);
+    mmu_write_byte_dma(child, 0xd000, 0x55);
+    ASSERT_EQ(counter, mmu_read_byte_dma(gb, 0xc000));
+    ASSERT_EQ(0, mmu_read_byte_dma(gb, 0xd000));
+    ASSERT_EQ(0x55, mmu_read_byte_dma(child, 0xd000));
+    gb_run_frames(gb, 1);
+    gb_run_frames(child, 1);
+    ASSERT_EQ((uint8_t)(mmu_read_byte_dma(gb, 0xc000) + 100),
+              mmu_read_byte_dma(child, 0xc000));
+    gb_destroy(child);
+    gb_destroy(gb);
+    return 0;
+}
+
+static color_t shown[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
+static gb_t *shown_gb;
+
+static void capture(gb_t *gb, const color_t *framebuffer, void *data)
+{
+    (void)data;
+    shown_gb = gb;
+    memcpy(shown, framebuffer, sizeof(shown));
+}
+
+static int run_ahead_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    gb_t *ref = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL && ref != NULL);
+    gb_set_video_sink(gb, capture, NULL);
+    gb_run_frames(ref, 3);
+    for (int i = 0; i < 10; ++i) {
+        gb_run_ahead(gb, 2);
+        ASSERT(shown_gb == gb);
+        ASSERT(memcmp(shown, gpu_get_framebuffer(ref), sizeof(shown)) == 0);
+        gb_run_frames(ref, 1);
+    }
+    /* Running ahead leaves no trace on gb. */
+    gb_t *plain = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(plain != NULL);
+    gb_run_frames(plain, 10);
+    ASSERT(gb_frame_hash(gb) == gb_frame_hash(plain));
+    ASSERT_EQ(plain->mmu.wram[0]->bytes[0], gb->mmu.wram[0]->bytes[0]);
+    gb_destroy(plain);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+void fork_test(void)
+{
+    rom_open(__func__);
+    ut_run(fork_same_test);
+    ut_run(fork_diverge_test);
+    ut_run(run_ahead_test);
+    rom_close();
+}
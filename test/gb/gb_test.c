@@ -0,0 +1,302 @@
+#include <string.h>
+#include "gb.h"
+#include "gpu.h"
+#include "mmu.h"
+#include "rom.h"
+#include "ut.h"
+
+void gb_test(void);
+
+static const char *rom_path;
+
+/* jr -2: spin forever at the entry point. */
+static const uint8_t spin[] = {0x18, 0xfe};
+
+/* Log LY, STAT and NR52 to WRAM and toggle the LCD between delays, forever. */
+static const uint8_t poll_io[] = {
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xf0, 0x44,       /* loop: ldh a, ($44) */
+    0x22,             /* ld (hl+), a */
+    0xf0, 0x41,       /* ldh a, ($41) */
+    0x22,             /* ld (hl+), a */
+    0xf0, 0x26,       /* ldh a, ($26) */
+    0x22,             /* ld (hl+), a */
+    0xcb, 0xa4,       /* res 4, h */
+    0xf0, 0x40,       /* ldh a, ($40) */
+    0xee, 0x80,       /* xor $80 */
+    0xe0, 0x40,       /* ldh ($40), a */
+    0x06, 0x20,       /* ld b, $20 */
+    0x05,             /* delay: dec b */
+    0x20, 0xfd,       /* jr nz, delay */
+    0x18, 0xe8,       /* jr loop */
+};
+
+/* Count timer overflows seen in IF, every 4096 cycles, in WRAM forever. */
+static const uint8_t poll_timer[] = {
+    0xf3,             /* di */
+    0x3e, 0x05,       /* ld a, $05 */
+    0xe0, 0x07,       /* ldh ($07), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xf0, 0x0f,       /* loop: ldh a, ($0f) */
+    0xe6, 0x04,       /* and $04 */
+    0x28, 0xfa,       /* jr z, loop */
+    0x34,             /* inc (hl) */
+    0xaf,             /* xor a */
+    0xe0, 0x0f,       /* ldh ($0f), a */
+    0x18, 0xf4,       /* jr loop */
+};
+
+static int run_cycles_test(void)
+{
+    gb_t *gb = rom_gb(spin, sizeof(spin));
+    ASSERT(gb != NULL);
+    /* One instruction per step, the spin loop would be skipped as idle. */
+    gb_set_idle_skip(gb, false);
+    uint64_t cycles = gb_run_cycles(gb, 1000);
+    ASSERT(cycles >= 1000 && cycles < 1000 + 12);
+    ASSERT_EQ(cycles, gb->clock.cycles);
+    cycles = gb_run_cycles(gb, 1);
+    ASSERT_EQ(12, cycles);
+    /* The count goes on across runs and steps. */
+    cycles = gb->clock.cycles;
+    cycles += gb_step(gb);
+    ASSERT_EQ(cycles, gb->clock.cycles);
+    /* Skipping the loop stops short of the end of the run. */
+    gb_set_idle_skip(gb, true);
+    for (int i = 0; i < 100; ++i) {
+        cycles = gb_run_cycles(gb, 1000);
+        ASSERT(cycles >= 1000 && cycles < 1000 + 12);
+    }
+    const cpu_idle_loop_t *loops;
+    ASSERT(gb_idle_loops(gb, &loops) > 0);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int run_frames_test(void)
+{
+    gb_t *gb = rom_gb(spin, sizeof(spin));
+    ASSERT(gb != NULL);
+    /* The first VBlank comes after the 144 visible lines. */
+    uint64_t cycles = gb_run_frames(gb, 1);
+    ASSERT(cycles >= 144 * 456 && cycles < 144 * 456 + 12);
+    ASSERT_EQ(1, gb->gpu.frames);
+    /* The spin loop is in phase with the PPU, so every frame is as long. */
+    uint64_t frame = gb_run_frames(gb, 1);
+    ASSERT(frame > 150 * 456 && frame < 160 * 456);
+    cycles = gb_run_frames(gb, 10);
+    ASSERT_EQ(10 * frame, cycles);
+    ASSERT_EQ(12, gb->gpu.frames);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int run_batch_test(void)
+{
+    gb_t *gb = rom_gb(poll_io, sizeof(poll_io));
+    gb_t *ref = rom_gb(poll_io, sizeof(poll_io));
+    ASSERT(gb != NULL && ref != NULL);
+    /* Devices ticked after each instruction or in batches read the same. */
+    for (int i = 0; i < 300; ++i) {
+        uint64_t cycles = gb_run_cycles(gb, 997);
+        uint64_t steps = 0;
+        while (steps < cycles)
+            steps += gb_step(ref);
+        ASSERT_EQ(cycles, steps);
+        ASSERT(memcmp(&gb->cpu.reg, &ref->cpu.reg, sizeof(gb->cpu.reg)) == 0);
+        ASSERT_EQ(ref->gpu.modeclock, gb->gpu.modeclock);
+        ASSERT_EQ(ref->gpu.scanline, gb->gpu.scanline);
+    }
+    ASSERT(memcmp(gb->mmu.wram[0]->bytes, ref->mmu.wram[0]->bytes, 0x1000) ==
+           0);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int shared_test(void)
+{
+    gb_t *gb1 = rom_gb(spin, sizeof(spin));
+    ASSERT(gb1 != NULL);
+    gb_t *gb2 = gb_create_shared(gb1);
+    ASSERT(gb2 != NULL);
+    ASSERT(gb1->cart.rom.bytes == gb2->cart.rom.bytes);
+    gb_run_frames(gb1, 2);
+    ASSERT_EQ(2, gb1->gpu.frames);
+    ASSERT_EQ(0, gb2->gpu.frames);
+    /* The ROM outlives the instance that loaded it. */
+    gb_destroy(gb1);
+    gb_run_frames(gb2, 1);
+    ASSERT_EQ(0x18, gb2->cart.rom.bytes[0x100]);
+    gb_destroy(gb2);
+    return 0;
+}
+
+static int load_shared_test(void)
+{
+    gb_t *src = rom_gb(spin, sizeof(spin));
+    ASSERT(src != NULL);
+    gb_t *fresh = gb_create_shared(src);
+    gb_t *reused = gb_create_shared(src);
+    ASSERT(fresh != NULL && reused != NULL);
+    key_press(reused, KEY_START);
+    gb_run_frames(reused, 3);
+    /* A reloaded instance behaves exactly like a new one. */
+    ASSERT_EQ(0, gb_load_shared(reused, src));
+    ASSERT_EQ(0, reused->gpu.frames);
+    ASSERT(!key_check_pressed(reused, KEY_START));
+    uint64_t cycles = gb_run_frames(fresh, 5);
+    ASSERT(cycles == gb_run_frames(reused, 5));
+    ASSERT(gb_frame_hash(fresh) == gb_frame_hash(reused));
+    gb_destroy(reused);
+    gb_destroy(fresh);
+    gb_destroy(src);
+    return 0;
+}
+
+/* CGB registers are only there on a CGB cartridge. */
+static int model_test(void)
+{
+    gb_t *dmg = rom_gb(spin, sizeof(spin));
+    ASSERT_EQ(0, rom_create_cgb(rom_path, spin, sizeof(spin)));
+    gb_t *cgb = gb_create(rom_path);
+    ASSERT(cgb != NULL && dmg != NULL);
+    mmu_write_byte(dmg, 0xff70, 0x02);
+    mmu_write_byte(cgb, 0xff70, 0x02);
+    ASSERT_EQ(0xff, mmu_read_byte(dmg, 0xff70));
+    ASSERT_EQ(0x02, mmu_read_byte(cgb, 0xff70));
+    mmu_write_byte(dmg, 0xd000, 0x12);
+    mmu_write_byte(cgb, 0xd000, 0x34);
+    ASSERT_EQ(0x12, dmg->mmu.wram[1]->bytes[0]);
+    ASSERT_EQ(0x34, cgb->mmu.wram[2]->bytes[0]);
+    ASSERT_EQ(0xff, mmu_read_byte(dmg, 0xff4d));
+    ASSERT_EQ(0x7e, mmu_read_byte(cgb, 0xff4d));
+    gb_destroy(dmg);
+    gb_destroy(cgb);
+    return 0;
+}
+
+/* The timer, brought up to date on demand, overflows on time. */
+static int timer_test(void)
+{
+    gb_t *gb, *ref;
+    ASSERT_EQ(0, rom_same(poll_timer, sizeof(poll_timer), gb_set_idle_skip,
+                          &gb, &ref));
+    /* One overflow every 256 * 16 cycles from the TAC write. */
+    uint64_t cycles = gb->clock.cycles - 32;
+    unsigned int count = (unsigned int)(cycles / 4096) & 0xff;
+    ASSERT_EQ(count, gb->mmu.wram[0]->bytes[0]);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+/* Tick the PPU of gb at once and that of ref 4 cycles at a time. */
+static int gpu_ticks(gb_t *gb, gb_t *ref)
+{
+    for (unsigned int step = 4; step < 4 * 70224; step *= 3) {
+        gpu_tick(gb, step);
+        for (unsigned int c = 0; c < step; c += 4)
+            gpu_tick(ref, 4);
+        ASSERT_EQ(ref->gpu.frames, gb->gpu.frames);
+        ASSERT_EQ(ref->gpu.scanline, gb->gpu.scanline);
+        ASSERT_EQ(ref->gpu.mode_flag, gb->gpu.mode_flag);
+        ASSERT_EQ(ref->gpu.modeclock, gb->gpu.modeclock);
+        ASSERT_EQ(ref->gpu.lcd_disabled_clock, gb->gpu.lcd_disabled_clock);
+        ASSERT_EQ(ref->intr.flag, gb->intr.flag);
+        gb->intr.flag = ref->intr.flag = 0;
+    }
+    return 0;
+}
+
+/* A PPU step of any length goes through every mode and line. */
+static int gpu_tick_test(void)
+{
+    gb_t *gb = rom_gb(spin, sizeof(spin));
+    gb_t *ref = rom_gb(spin, sizeof(spin));
+    ASSERT(gb != NULL && ref != NULL);
+    /* Every STAT interrupt, on line 3. */
+    gb->intr.enable = ref->intr.enable = 0x1f;
+    gpu_write_stat(gb, 0x78);
+    gpu_write_stat(ref, 0x78);
+    gpu_write_lyc(gb, 3);
+    gpu_write_lyc(ref, 3);
+    ASSERT_EQ(0, gpu_ticks(gb, ref));
+    ASSERT(gb->gpu.frames > 2);
+    ASSERT(memcmp(gpu_get_framebuffer(gb), gpu_get_framebuffer(ref),
+                  GPU_FRAMEBUFFER_SIZE) == 0);
+    /* Same with the LCD off, turned off in VBlank. */
+    while (gb->gpu.mode_flag != 1) {
+        gpu_tick(gb, 4);
+        gpu_tick(ref, 4);
+    }
+    gpu_write_lcdc(gb, 0x11);
+    gpu_write_lcdc(ref, 0x11);
+    unsigned int frames = gb->gpu.frames;
+    ASSERT_EQ(0, gpu_ticks(gb, ref));
+    ASSERT(gb->gpu.frames > frames + 2);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+/* Sound on every channel, with envelopes and sweep running. */
+static void apu_play(gb_t *gb)
+{
+    apu_write_nr10(gb, 0x16);
+    apu_write_nr12(gb, 0xf1);
+    apu_write_nr14(gb, 0x86);
+    apu_write_nr22(gb, 0x8a);
+    apu_write_nr24(gb, 0xc7);
+    apu_write_nr30(gb, 0x80);
+    apu_write_nr32(gb, 0x20);
+    apu_write_nr34(gb, 0x85);
+    apu_write_nr42(gb, 0xf2);
+    apu_write_nr43(gb, 0x31);
+    apu_write_nr44(gb, 0x80);
+    apu_write_nr51(gb, 0xff);
+}
+
+/* An APU step of any length takes every sample and sequencer step. */
+static int apu_tick_test(void)
+{
+    gb_t *gb = rom_gb(spin, sizeof(spin));
+    gb_t *ref = rom_gb(spin, sizeof(spin));
+    ASSERT(gb != NULL && ref != NULL);
+    apu_play(gb);
+    apu_play(ref);
+    for (unsigned int step = 4; step < 4 * 70224; step *= 3) {
+        apu_tick(gb, step);
+        for (unsigned int c = 0; c < step; c += 4)
+            apu_tick(ref, 4);
+        apu_t *a = &gb->apu, *b = &ref->apu;
+        ASSERT(memcmp(a->out_buf, b->out_buf, sizeof(a->out_buf)) == 0);
+        ASSERT_EQ(b->output_timer.out_clock, a->output_timer.out_clock);
+        ASSERT_EQ(b->frame_sequencer.in_clock, a->frame_sequencer.in_clock);
+        ASSERT_EQ(b->frame_sequencer.out_clock, a->frame_sequencer.out_clock);
+        ASSERT_EQ(b->channel1.timer, a->channel1.timer);
+        ASSERT_EQ(b->channel1.frequency, a->channel1.frequency);
+        ASSERT_EQ(b->channel2.env.volume, a->channel2.env.volume);
+        ASSERT_EQ(b->channel3.position, a->channel3.position);
+        ASSERT_EQ(b->channel4.lfsr, a->channel4.lfsr);
+        ASSERT_EQ(apu_read_nr52(ref), apu_read_nr52(gb));
+    }
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+void gb_test(void)
+{
+    rom_path = rom_open(__func__);
+    ut_run(run_cycles_test);
+    ut_run(run_frames_test);
+    ut_run(run_batch_test);
+    ut_run(shared_test);
+    ut_run(load_shared_test);
+    ut_run(model_test);
+    ut_run(timer_test);
+    ut_run(gpu_tick_test);
+    ut_run(apu_tick_test);
+    rom_close();
+}
@@ -0,0 +1,139 @@
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void halt_test(void);
+
+/* Wait for VBlank in HALT with interrupts off, counting wake ups. */
+static const uint8_t halt_vblank[] = {
+    0xf3,             /* di */
+    0x3e, 0x01,       /* ld a, $01 */
+    0xe0, 0xff,       /* ldh ($ff), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xaf,             /* loop: xor a */
+    0xe0, 0x0f,       /* ldh ($0f), a */
+    0x76,             /* halt */
+    0x34,             /* inc (hl) */
+    0x18, 0xf9,       /* jr loop */
+};
+
+/* Same for the timer, which overflows every 4096 cycles. */
+static const uint8_t halt_timer[] = {
+    0xf3,             /* di */
+    0x3e, 0x04,       /* ld a, $04 */
+    0xe0, 0xff,       /* ldh ($ff), a */
+    0x3e, 0x05,       /* ld a, $05 */
+    0xe0, 0x07,       /* ldh ($07), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0xaf,             /* loop: xor a */
+    0xe0, 0x0f,       /* ldh ($0f), a */
+    0x76,             /* halt */
+    0x34,             /* inc (hl) */
+    0x18, 0xf9,       /* jr loop */
+};
+
+/* Count in STOP, which only a button press ends. */
+static const uint8_t stop_keys[] = {
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0x10, 0x00,       /* loop: stop */
+    0x34,             /* inc (hl) */
+    0x18, 0xfb,       /* jr loop */
+};
+
+/* Raise VBlank with interrupts off, then enable them. */
+static const uint8_t ei_delay[] = {
+    0xf3,       /* di */
+    0x3e, 0x01, /* ld a, $01 */
+    0xe0, 0xff, /* ldh ($ff), a */
+    0xe0, 0x0f, /* ldh ($0f), a */
+    0x06, 0x00, /* ld b, $00 */
+    0xfb,       /* ei */
+    0x04,       /* inc b */
+    0x04,       /* inc b */
+    0x18, 0xfe, /* jr -2 */
+};
+
+static int halt_vblank_test(void)
+{
+    gb_t *gb = rom_gb(halt_vblank, sizeof(halt_vblank));
+    ASSERT(gb != NULL);
+    /* Frames are as long as when HALT ran 4 cycles at a time. */
+    uint64_t cycles = gb_run_frames(gb, 11);
+    ASSERT_EQ(144 * 456 + 10 * 70680, cycles);
+    ASSERT_EQ(10, gb->mmu.wram[0]->bytes[0]);
+    /* Nor do they go past the end of a run. */
+    for (int i = 0; i < 100; ++i) {
+        cycles = gb_run_cycles(gb, 1000);
+        ASSERT(cycles >= 1000 && cycles < 1000 + CLOCK_STEP_MAX);
+    }
+    gb_destroy(gb);
+    return 0;
+}
+
+static int halt_timer_test(void)
+{
+    gb_t *gb = rom_gb(halt_timer, sizeof(halt_timer));
+    ASSERT(gb != NULL);
+    /* Idle cycles go by several steps at a time. */
+    unsigned int steps = 0;
+    while (gb->gpu.frames == 0) {
+        gb_step(gb);
+        ++steps;
+    }
+    ASSERT(steps < 144 * 456 / 16);
+    /* No overflow is missed or early. */
+    gb_run_frames(gb, 10);
+    ASSERT_EQ(188, gb->mmu.wram[0]->bytes[0]);
+    ASSERT_EQ(148, gb->timer.tima);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int stop_test(void)
+{
+    gb_t *gb = rom_gb(stop_keys, sizeof(stop_keys));
+    ASSERT(gb != NULL);
+    /* The screen keeps running. */
+    gb_run_frames(gb, 2);
+    ASSERT_EQ(2, gb->gpu.frames);
+    ASSERT_EQ(0, gb->mmu.wram[0]->bytes[0]);
+    key_press(gb, KEY_START);
+    gb_run_frames(gb, 1);
+    key_release(gb, KEY_START);
+    gb_run_frames(gb, 1);
+    uint8_t count = gb->mmu.wram[0]->bytes[0];
+    ASSERT(count > 0);
+    gb_run_frames(gb, 2);
+    ASSERT_EQ(count, gb->mmu.wram[0]->bytes[0]);
+    gb_destroy(gb);
+    return 0;
+}
+
+/* EI takes effect after the next instruction. */
+static int ei_test(void)
+{
+    gb_t *gb = rom_gb(ei_delay, sizeof(ei_delay));
+    ASSERT(gb != NULL);
+    for (int i = 0; i < 6; ++i)
+        gb_step(gb);
+    ASSERT_EQ(0x10a, gb->cpu.reg.pc);
+    ASSERT(gb->intr.ime);
+    /* INC B, then the dispatch. */
+    ASSERT_EQ(4 + 24, gb_step(gb));
+    ASSERT_EQ(0x40, gb->cpu.reg.pc);
+    ASSERT_EQ(1, gb->cpu.reg.b);
+    ASSERT(!gb->intr.ime);
+    ASSERT_EQ(0, gb->intr.pending & INTERRUPT_PENDING_FIRE);
+    gb_destroy(gb);
+    return 0;
+}
+
+void halt_test(void)
+{
+    rom_open(__func__);
+    ut_run(halt_vblank_test);
+    ut_run(halt_timer_test);
+    ut_run(stop_test);
+    ut_run(ei_test);
+    rom_close();
+}
@@ -0,0 +1,69 @@
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void idle_test(void);
+
+/* Count the frames by polling LY, with interrupts off. */
+static const uint8_t poll_ly[] = {
+    0xf3,             /* di */
+    0xf0, 0x44,       /* wait: ldh a, ($44) */
+    0xfe, 0x90,       /* cp $90 */
+    0x20, 0xfa,       /* jr nz, wait */
+    0xfa, 0x00, 0xc0, /* ld a, ($c000) */
+    0x3c,             /* inc a */
+    0xea, 0x00, 0xc0, /* ld ($c000), a */
+    0xf0, 0x44,       /* leave: ldh a, ($44) */
+    0xfe, 0x90,       /* cp $90 */
+    0x28, 0xfa,       /* jr z, leave */
+    0x18, 0xeb,       /* jr wait */
+};
+
+/* Write VRAM once per line, polling the STAT mode through HL. */
+static const uint8_t poll_stat[] = {
+    0x21, 0x41, 0xff, /* ld hl, $ff41 */
+    0x01, 0x00, 0x80, /* ld bc, $8000 */
+    0xcb, 0x46,       /* wait: bit 0, (hl) */
+    0x28, 0xfc,       /* jr z, wait */
+    0x0a,             /* ld a, (bc) */
+    0x3c,             /* inc a */
+    0x02,             /* ld (bc), a */
+    0xf0, 0x41,       /* hblank: ldh a, ($41) */
+    0xe6, 0x03,       /* and $03 */
+    0x20, 0xfa,       /* jr nz, hblank */
+    0x18, 0xf1,       /* jr wait */
+};
+
+/* Skipping finds the loop at pc and cannot be told apart from running it. */
+static int skipped(const uint8_t *code, size_t len, uint16_t pc)
+{
+    gb_t *gb, *ref;
+    ASSERT_EQ(0, rom_same(code, len, gb_set_idle_skip, &gb, &ref));
+    const cpu_idle_loop_t *loops;
+    ASSERT(gb_idle_loops(ref, &loops) == 0);
+    ASSERT(gb_idle_loops(gb, &loops) > 0);
+    ASSERT_EQ(0, loops[0].bank);
+    ASSERT_EQ(pc, loops[0].pc);
+    ASSERT(loops[0].cycles > 0);
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int poll_ly_test(void)
+{
+    return skipped(poll_ly, sizeof(poll_ly), 0x101);
+}
+
+static int poll_stat_test(void)
+{
+    return skipped(poll_stat, sizeof(poll_stat), 0x106);
+}
+
+void idle_test(void)
+{
+    rom_open(__func__);
+    ut_run(poll_ly_test);
+    ut_run(poll_stat_test);
+    rom_close();
+}
@@ -0,0 +1,364 @@
+#include <string.h>
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void jit_test(void);
+
+/* Compiled code cannot be told apart from the interpreter. */
+static int same(const char *path, const uint8_t *code, size_t len)
+{
+    gb_t *gb, *ref;
+    if (path == NULL)
+        ASSERT_EQ(0, rom_same(code, len, gb_set_jit, &gb, &ref));
+    else
+        ASSERT_EQ(0, rom_same_file(path, gb_set_jit, &gb, &ref));
+    ASSERT_EQ(gb_frame_hash(ref), gb_frame_hash(gb));
+    gb_destroy(ref);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int counter_test(void)
+{
+    return same(NULL, rom_counter, rom_counter_len);
+}
+
+static int joypad_test(void)
+{
+    return same(NULL, rom_joypad, rom_joypad_len);
+}
+
+/*
+ * Random code in the three switchable banks of an MBC1 image, each switching
+ * to the next in the middle of the ROM area. The VBlank interrupt is on, its
+ * vector slides down to the entry point and starts over.
+ */
+static const uint8_t start[] = {
+    0x31, 0xf0, 0xdf, /* ld sp, $dff0 */
+    0x21, 0x00, 0xc1, /* ld hl, $c100 */
+    0x36, 0x3c,       /* ld (hl), $3c: inc a */
+    0x2c,             /* inc l */
+    0x36, 0xc9,       /* ld (hl), $c9: ret */
+    0x3e, 0x01,       /* ld a, $01 */
+    0xea, 0x00, 0x20, /* ld ($2000), a */
+    0xe0, 0xff,       /* ldh ($ff), a */
+    0xfb,             /* ei */
+    0xc3, 0x00, 0x40, /* jp $4000 */
+};
+
+#define BANK_SIZE 0x4000
+#define BODY_END 0x0b00 /* Random code up to there. */
+#define SWITCH 0x0c00   /* ld a, next bank; ld ($2000), a; jp $4000 */
+#define SUB 0x0d00      /* Random code called from the body. */
+#define SUB_END 0x0f00
+
+typedef struct {
+    uint8_t *bytes;
+    unsigned int pos;
+    uint32_t seed;
+} gen_t;
+
+static unsigned int gen_rand(gen_t *g, unsigned int n)
+{
+    g->seed ^= g->seed << 13;
+    g->seed ^= g->seed >> 17;
+    g->seed ^= g->seed << 5;
+    return g->seed % n;
+}
+
+static void gen_byte(gen_t *g, unsigned int b)
+{
+    g->bytes[g->pos++] = (uint8_t)b;
+}
+
+static void gen_word(gen_t *g, unsigned int w)
+{
+    gen_byte(g, w & 0xff);
+    gen_byte(g, w >> 8);
+}
+
+/* An address of WRAM clear of the code at $c100 and the stack. */
+static unsigned int gen_wram(gen_t *g)
+{
+    return 0xc200 + gen_rand(g, 0x1b00);
+}
+
+/* B, C, D, E or A, numbered as in opcodes. */
+static unsigned int gen_reg(gen_t *g)
+{
+    static const unsigned int regs[] = {0, 1, 2, 3, 7};
+    return regs[gen_rand(g, 5)];
+}
+
+/* Any register but (HL). */
+static unsigned int gen_src(gen_t *g)
+{
+    unsigned int r = gen_rand(g, 7);
+    return r == 6 ? 7 : r;
+}
+
+static void gen_unit(gen_t *g, bool sub, bool nested);
+
+/* An instruction accessing (HL), HL set first. */
+static void gen_hl(gen_t *g)
+{
+    static const uint8_t ops[] = {0x34, 0x35, 0x36, 0x22, 0x2a, 0x32, 0x3a};
+    gen_byte(g, 0x21);
+    gen_word(g, gen_wram(g));
+    switch (gen_rand(g, 5)) {
+        case 0:
+            gen_byte(g, 0x46 | gen_reg(g) << 3);
+            break;
+        case 1:
+            gen_byte(g, 0x70 | gen_src(g));
+            break;
+        case 2:
+            gen_byte(g, 0x86 | gen_rand(g, 8) << 3);
+            break;
+        case 3:
+            gen_byte(g, 0xcb);
+            gen_byte(g, 0x06 | gen_rand(g, 32) << 3);
+            break;
+        default: {
+            uint8_t op = ops[gen_rand(g, sizeof(ops))];
+            gen_byte(g, op);
+            if (op == 0x36)
+                gen_byte(g, gen_rand(g, 256));
+            break;
+        }
+    }
+}
+
+/* A short loop on B, with ALU operations that leave B alone. */
+static void gen_loop(gen_t *g)
+{
+    gen_byte(g, 0x06);
+    gen_byte(g, 1 + gen_rand(g, 8));
+    unsigned int loop = g->pos;
+    for (unsigned int i = 1 + gen_rand(g, 3); i > 0; --i) {
+        if (gen_rand(g, 2)) {
+            gen_byte(g, 0xc6 | gen_rand(g, 8) << 3);
+            gen_byte(g, gen_rand(g, 256));
+        } else {
+            gen_byte(g, 0x81 | gen_rand(g, 8) << 3);
+        }
+    }
+    gen_byte(g, 0x05);
+    gen_byte(g, 0x20);
+    gen_byte(g, (loop - (g->pos + 1)) & 0xff);
+}
+
+/* A conditional jump, call or return, with what it may skip. */
+static void gen_branch(gen_t *g, bool sub)
+{
+    unsigned int cc = gen_rand(g, 4) << 3;
+    unsigned int at;
+    switch (gen_rand(g, sub ? 5 : 4)) {
+        case 0:
+            gen_byte(g, 0x20 | cc);
+            at = g->pos;
+            gen_byte(g, 0);
+            gen_unit(g, sub, true);
+            g->bytes[at] = (uint8_t)(g->pos - at - 1);
+            break;
+        case 1:
+            gen_byte(g, 0xc2 | cc);
+            at = g->pos;
+            gen_word(g, 0);
+            gen_unit(g, sub, true);
+            g->bytes[at] = (uint8_t)(0x4000 + g->pos);
+            g->bytes[at + 1] = (uint8_t)((0x4000 + g->pos) >> 8);
+            break;
+        case 2:
+            /* jp (hl) to the next unit. */
+            gen_byte(g, 0x21);
+            at = g->pos;
+            gen_word(g, 0);
+            gen_byte(g, 0xe9);
+            g->bytes[at] = (uint8_t)(0x4000 + g->pos);
+            g->bytes[at + 1] = (uint8_t)((0x4000 + g->pos) >> 8);
+            break;
+        case 3:
+            if (sub) {
+                gen_byte(g, 0xc0 | cc);
+            } else {
+                gen_byte(g, gen_rand(g, 2) ? 0xcd : 0xc4 | cc);
+                gen_word(g, 0x4000 + SUB);
+            }
+            break;
+        default:
+            gen_byte(g, 0xc0 | cc);
+            break;
+    }
+}
+
+static void gen_unit(gen_t *g, bool sub, bool nested)
+{
+    static const uint8_t misc[] = {0x07, 0x0f, 0x17, 0x1f, 0x27,
+                                   0x2f, 0x37, 0x3f, 0x00, 0xf3};
+    static const uint8_t io[] = {0x04, 0x05, 0x0f, 0x40, 0x41, 0x44};
+    unsigned int r;
+    switch (gen_rand(g, nested ? 14 : 17)) {
+        case 0:
+            gen_byte(g, 0x40 | gen_reg(g) << 3 | gen_src(g));
+            break;
+        case 1:
+            gen_byte(g, 0x80 | gen_rand(g, 8) << 3 | gen_src(g));
+            break;
+        case 2:
+            gen_byte(g, 0xc6 | gen_rand(g, 8) << 3);
+            gen_byte(g, gen_rand(g, 256));
+            break;
+        case 3:
+            gen_hl(g);
+            break;
+        case 4:
+            r = gen_rand(g, 2) << 4;
+            gen_byte(g, 0x01 | r);
+            gen_word(g, gen_wram(g));
+            gen_byte(g, (gen_rand(g, 2) ? 0x02 : 0x0a) | r);
+            break;
+        case 5:
+            r = gen_src(g);
+            switch (gen_rand(g, 4)) {
+                case 0:
+                    gen_byte(g, 0x04 | r << 3);
+                    break;
+                case 1:
+                    gen_byte(g, 0x05 | r << 3);
+                    break;
+                case 2:
+                    gen_byte(g, 0x06 | r << 3);
+                    gen_byte(g, gen_rand(g, 256));
+                    break;
+                default:
+                    gen_byte(g, 0x03 | gen_rand(g, 3) << 4 |
+                                    gen_rand(g, 2) << 3);
+                    break;
+            }
+            break;
+        case 6:
+            gen_byte(g, misc[gen_rand(g, sizeof(misc))]);
+            break;
+        case 7:
+            gen_byte(g, 0xcb);
+            gen_byte(g, gen_rand(g, 32) << 3 | gen_src(g));
+            break;
+        case 8:
+            gen_byte(g, 0x09 | gen_rand(g, 4) << 4);
+            break;
+        case 9:
+            gen_byte(g, 0xc5 | gen_rand(g, 4) << 4);
+            gen_byte(g, 0xc1 | gen_rand(g, 4) << 4);
+            break;
+        case 10:
+            r = gen_rand(g, 3);
+            if (r == 2) {
+                gen_byte(g, 0x0e);
+                gen_byte(g, 0x80 + gen_rand(g, 0x7f));
+                gen_byte(g, gen_rand(g, 2) ? 0xe2 : 0xf2);
+            } else {
+                gen_byte(g, r ? 0xe0 : 0xf0);
+                gen_byte(g, 0x80 + gen_rand(g, 0x7f));
+            }
+            break;
+        case 11:
+            gen_byte(g, 0xf0);
+            gen_byte(g, io[gen_rand(g, sizeof(io))]);
+            break;
+        case 12:
+            r = gen_rand(g, 3);
+            gen_byte(g, r == 0 ? 0xea : 0xfa);
+            if (r == 2)
+                gen_word(g, gen_rand(g, 0x8000));
+            else if (gen_rand(g, 4) == 0)
+                gen_word(g, 0x8000 + gen_rand(g, 0x2000));
+            else
+                gen_word(g, gen_wram(g));
+            break;
+        case 13:
+            r = gen_rand(g, 256);
+            switch (gen_rand(g, 3)) {
+                case 0:
+                    gen_byte(g, 0x08);
+                    gen_word(g, gen_wram(g));
+                    break;
+                case 1:
+                    gen_byte(g, 0xe8);
+                    gen_byte(g, r);
+                    gen_byte(g, 0xe8);
+                    gen_byte(g, -r);
+                    break;
+                default:
+                    gen_byte(g, 0xf8);
+                    gen_byte(g, r);
+                    break;
+            }
+            break;
+        case 14:
+            gen_branch(g, sub);
+            break;
+        case 15:
+            gen_loop(g);
+            break;
+        default:
+            if (sub) {
+                gen_byte(g, 0xf3);
+                gen_byte(g, 0xfb);
+            } else {
+                /* Call code in WRAM, changing it each time. */
+                static const uint8_t smc[] = {
+                    0x21, 0x00, 0xc1, /* ld hl, $c100 */
+                    0x7e,             /* ld a, (hl) */
+                    0xee, 0x01,       /* xor $01: inc a <-> dec a */
+                    0x77,             /* ld (hl), a */
+                    0xcd, 0x00, 0xc1, /* call $c100 */
+                };
+                memcpy(&g->bytes[g->pos], smc, sizeof(smc));
+                g->pos += sizeof(smc);
+            }
+            break;
+    }
+}
+
+static int random_test(void)
+{
+    static uint8_t banks[3][BANK_SIZE];
+    const uint8_t *const bank_ptrs[3] = {banks[0], banks[1], banks[2]};
+    for (uint32_t seed = 1; seed <= 4; ++seed) {
+        memset(banks, 0, sizeof(banks));
+        for (unsigned int i = 0; i < 3; ++i) {
+            gen_t g = {banks[i], 0, seed * 2654435761u + i};
+            while (g.pos < BODY_END)
+                gen_unit(&g, false, false);
+            g.pos = SWITCH;
+            gen_byte(&g, 0x3e);
+            gen_byte(&g, 1 + (i + 1) % 3);
+            gen_byte(&g, 0xea);
+            gen_word(&g, 0x2000);
+            gen_byte(&g, 0xc3);
+            gen_word(&g, 0x4000);
+            g.pos = SUB;
+            while (g.pos < SUB_END)
+                gen_unit(&g, true, false);
+            gen_byte(&g, gen_rand(&g, 2) ? 0xc9 : 0xd9);
+        }
+        const char *path = rom_open(__func__);
+        ASSERT_EQ(0, rom_create_mbc1(path, start, sizeof(start), bank_ptrs,
+                                     BANK_SIZE));
+        int rv = same(path, NULL, 0);
+        rom_close();
+        ASSERT_EQ(0, rv);
+    }
+    return 0;
+}
+
+void jit_test(void)
+{
+    rom_open(__func__);
+    ut_run(counter_test);
+    ut_run(joypad_test);
+    rom_close();
+    ut_run(random_test);
+}
@@ -0,0 +1,32 @@
+#include "ut.h"
+
+struct ut unit_test;
+
+extern void gb_test(void);
+extern void state_test(void);
+extern void rewind_test(void);
+extern void fork_test(void);
+extern void movie_test(void);
+extern void decode_test(void);
+extern void halt_test(void);
+extern void idle_test(void);
+extern void bulk_test(void);
+extern void ops_test(void);
+extern void jit_test(void);
+
+int main(void)
+{
+    gb_test();
+    state_test();
+    rewind_test();
+    fork_test();
+    movie_test();
+    decode_test();
+    halt_test();
+    idle_test();
+    bulk_test();
+    ops_test();
+    jit_test();
+    ut_result();
+    return 0;
+}
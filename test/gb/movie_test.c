@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void movie_test(void);
+
+#define FRAMES 120
+
+static char movie_path[] = "/tmp/movie_testXXXXXX.gbm";
+
+/* Press and release a few buttons, on frame boundaries. */
+static void play(gb_t *gb)
+{
+    for (unsigned int i = 0; i < FRAMES; ++i) {
+        if (i == 10)
+            key_press(gb, KEY_A);
+        if (i == 25)
+            key_press(gb, KEY_B);
+        if (i == 30)
+            key_release(gb, KEY_A);
+        if (i == 60)
+            key_release(gb, KEY_B);
+        if (i == 90)
+            key_press(gb, KEY_START);
+        gb_run_frames(gb, 1);
+    }
+}
+
+static int movie_same_state(gb_t *a, gb_t *b)
+{
+    unsigned int mask = GB_STATE_ALL;
+    size_t size = gb_state_size(a, mask);
+    uint8_t *sa = malloc(size), *sb = malloc(size);
+    ASSERT_EQ(size, gb_state_save(a, sa, size, mask));
+    ASSERT_EQ(size, gb_state_save(b, sb, size, mask));
+    int same = memcmp(sa, sb, size) == 0;
+    free(sa);
+    free(sb);
+    return same;
+}
+
+static int movie_replay_test(void)
+{
+    gb_t *gb = rom_gb(rom_joypad, rom_joypad_len);
+    ASSERT(gb != NULL);
+    /* Recording starts from power on, whatever ran before. */
+    gb_run_frames(gb, 50);
+    movie_t *mv = movie_create();
+    gb_movie_record(gb, mv);
+    play(gb);
+    ASSERT_EQ(FRAMES + 1, movie_length(mv));
+    gb_movie_stop(gb);
+    ASSERT_EQ(0, movie_save(mv, movie_path));
+    movie_destroy(mv);
+
+    gb_t *other = rom_gb(rom_joypad, rom_joypad_len);
+    ASSERT(other != NULL);
+    mv = movie_load(movie_path);
+    ASSERT(mv != NULL);
+    ASSERT_EQ(FRAMES + 1, movie_length(mv));
+    ASSERT_EQ(0, gb_movie_play(other, mv));
+    gb_run_frames(other, FRAMES);
+    ASSERT(movie_same_state(gb, other));
+    ASSERT(gb_movie_playing(other));
+    gb_run_frames(other, 1);
+    ASSERT(!gb_movie_playing(other));
+
+    /* Without the movie the game takes another path. */
+    gb_reset(other);
+    gb_run_frames(other, FRAMES);
+    ASSERT(!movie_same_state(gb, other));
+    movie_destroy(mv);
+    gb_destroy(other);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int movie_seek_test(void)
+{
+    gb_t *gb = rom_gb(rom_joypad, rom_joypad_len);
+    ASSERT(gb != NULL);
+    movie_t *mv = movie_create();
+    movie_set_keyframes(mv, 100);
+    gb_movie_record(gb, mv);
+    for (unsigned int i = 0; i < 600; ++i) {
+        if (i % 37 == 0)
+            key_press(gb, KEY_A);
+        if (i % 37 == 20)
+            key_release(gb, KEY_A);
+        gb_run_frames(gb, 1);
+    }
+    gb_movie_stop(gb);
+    ASSERT_EQ(6, movie_keyframes(mv));
+    ASSERT_EQ(0, movie_save(mv, movie_path));
+    movie_destroy(mv);
+    mv = movie_load(movie_path);
+    ASSERT(mv != NULL);
+    ASSERT_EQ(6, movie_keyframes(mv));
+    /* Saved over the file its keyframes are still in. */
+    ASSERT_EQ(0, movie_save(mv, movie_path));
+    movie_destroy(mv);
+    mv = movie_load(movie_path);
+    ASSERT(mv != NULL);
+    ASSERT_EQ(6, movie_keyframes(mv));
+    ASSERT_EQ(500, movie_seek(gb, mv, 550));
+
+    /* Same state as a replay from power on, forwards and backwards. */
+    static const unsigned int frames[] = {450, 100, 0, 301, 601, 1};
+    gb_t *other = rom_gb(rom_joypad, rom_joypad_len);
+    ASSERT(other != NULL);
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i) {
+        ASSERT_EQ(0, gb_movie_seek(gb, mv, frames[i]));
+        ASSERT_EQ(0, gb_movie_play(other, mv));
+        gb_run_frames(other, frames[i]);
+        ASSERT(movie_same_state(gb, other));
+    }
+    ASSERT_EQ(-1, gb_movie_seek(gb, mv, 602));
+    movie_destroy(mv);
+    gb_destroy(other);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int movie_file_test(void)
+{
+    gb_t *gb = rom_gb(rom_joypad, rom_joypad_len);
+    ASSERT(gb != NULL);
+    movie_t *mv = movie_create();
+    gb_movie_record(gb, mv);
+    play(gb);
+    gb_movie_stop(gb);
+    ASSERT_EQ(0, movie_save(mv, movie_path));
+    movie_destroy(mv);
+    gb_destroy(gb);
+    /* Six runs of two bytes between header and empty keyframe index. */
+    FILE *f = fopen(movie_path, "rb");
+    ASSERT(f != NULL);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    ASSERT_EQ(16 + 6 * 2 + 16, size);
+    ASSERT_EQ(0, truncate(movie_path, size - 1));
+    ASSERT(movie_load(movie_path) == NULL);
+    return 0;
+}
+
+void movie_test(void)
+{
+    rom_open(__func__);
+    int fd = mkstemps(movie_path, 4);
+    if (fd < 0) {
+        printf("%s: could not create test movie\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    ut_run(movie_replay_test);
+    ut_run(movie_seek_test);
+    ut_run(movie_file_test);
+    unlink(movie_path);
+    rom_close();
+}
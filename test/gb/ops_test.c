@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "cpu_ops.h"
+#include "gb.h"
+#include "mmu.h"
+#include "rom.h"
+#include "ut.h"
+
+void ops_test(void);
+
+/* jr -2: spin forever at the entry point. */
+static const uint8_t spin[] = {0x18, 0xfe};
+
+typedef struct {
+    const char *text;
+    uint8_t length;
+    uint8_t cycles;
+    uint8_t taken;
+} op_t;
+
+#define X(op, name, kind, jump, cycles, taken, flags, text) \
+    [op] = {text, CPU_OP_LENGTH_##kind, cycles, taken},
+static const op_t ops[256] = {CPU_OPS(X)};
+static const op_t cb_ops[256] = {CPU_CB_OPS(X)};
+#undef X
+
+/* Run the instruction at $c000 with flags f, returning its cycles. */
+static unsigned int run(gb_t *gb, const uint8_t *code, uint8_t f)
+{
+    for (unsigned int i = 0; i < 3; ++i)
+        mmu_write_byte(gb, (uint16_t)(0xc000 + i), code[i]);
+    cpu_set_f(&gb->cpu, f);
+    gb->cpu.reg.pc = 0xc000;
+    gb->cpu.reg.sp = 0xdff0;
+    return gb_step(gb);
+}
+
+/* Every instruction takes the cycles listed, both ways if conditional. */
+static int cycles_test(void)
+{
+    gb_t *gb = rom_gb(spin, sizeof(spin));
+    ASSERT(gb != NULL);
+    gb_set_idle_skip(gb, false);
+    gb_set_bulk_copy(gb, false);
+    for (unsigned int i = 0; i < 0x200; ++i) {
+        uint8_t op = (uint8_t)i;
+        const op_t *info = i < 0x100 ? &ops[op] : &cb_ops[op];
+        uint8_t code[3] = {op, 0x00, 0x00};
+        if (i >= 0x100) {
+            code[0] = 0xcb;
+            code[1] = op;
+        } else if (info->text[0] == '\0' || op == 0x10 || op == 0x76) {
+            /* No instruction, CB, STOP and HALT. */
+            continue;
+        }
+        unsigned int clear = run(gb, code, 0x00);
+        unsigned int set = run(gb, code, 0xf0);
+        if (info->cycles == info->taken) {
+            ASSERT_EQ(info->cycles, clear);
+            ASSERT_EQ(info->cycles, set);
+        } else {
+            ASSERT(clear != set);
+            ASSERT(clear == info->cycles || clear == info->taken);
+            ASSERT(set == info->cycles || set == info->taken);
+        }
+    }
+    gb_destroy(gb);
+    return 0;
+}
+
+/* Lengths agree with where the operand goes. */
+static int text_test(void)
+{
+    for (unsigned int op = 0; op < 0x100; ++op) {
+        const char *text = ops[op].text;
+        bool star = false;
+        for (const char *c = text; *c != '\0'; ++c)
+            star |= *c == '*';
+        ASSERT_EQ(ops[op].length > 1 && text[0] != '\0', star);
+        ASSERT(cb_ops[op].text[0] != '\0');
+        ASSERT_EQ(1, cb_ops[op].length);
+    }
+    return 0;
+}
+
+/* Run steps instructions of gb with stdout going to log. */
+static void traced(gb_t *gb, unsigned int steps, FILE *log)
+{
+    fflush(stdout);
+    int out = dup(STDOUT_FILENO);
+    dup2(fileno(log), STDOUT_FILENO);
+    gb_set_trace(gb, true);
+    for (unsigned int i = 0; i < steps; ++i)
+        gb_step(gb);
+    gb_set_trace(gb, false);
+    fflush(stdout);
+    dup2(out, STDOUT_FILENO);
+    close(out);
+}
+
+/* The trace shows each instruction with its operand, where it starts. */
+static int trace_test(void)
+{
+    static const uint8_t code[] = {
+        0x3e, 0x42, /* ld a, $42 */
+        0xcb, 0x37, /* swap a */
+        0x18, 0xfe, /* jr -2 */
+    };
+    gb_t *gb = rom_gb(code, sizeof(code));
+    ASSERT(gb != NULL);
+    FILE *log = tmpfile();
+    ASSERT(log != NULL);
+    traced(gb, 4, log);
+    char text[512] = {0};
+    rewind(log);
+    size_t len = fread(text, 1, sizeof(text) - 1, log);
+    fclose(log);
+    ASSERT(len > 0);
+    ASSERT(strstr(text, "PC:0x0100 ") != NULL);
+    ASSERT(strstr(text, ": 0x3e:   ld a, $42\n") != NULL);
+    ASSERT(strstr(text, "PC:0x0102 ") != NULL);
+    ASSERT(strstr(text, "AF:0x42") != NULL);
+    ASSERT(strstr(text, ": 0xcb37: swap a\n") != NULL);
+    ASSERT(strstr(text, "PC:0x0104 ") != NULL);
+    ASSERT(strstr(text, "AF:0x24") != NULL);
+    ASSERT(strstr(text, ": 0x18:   jr $fe\n") != NULL);
+    ASSERT_EQ(0x24, gb->cpu.reg.a);
+    gb_destroy(gb);
+    return 0;
+}
+
+void ops_test(void)
+{
+    rom_open(__func__);
+    ut_run(cycles_test);
+    ut_run(text_test);
+    ut_run(trace_test);
+    rom_close();
+}
@@ -0,0 +1,71 @@
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void rewind_test(void);
+
+#define FRAMES 100
+
+static uint64_t hashes[FRAMES + 1];
+static uint8_t counters[FRAMES + 1];
+
+static void record(gb_t *gb)
+{
+    for (unsigned int i = 1; i <= FRAMES; ++i) {
+        gb_run_frames(gb, 1);
+        hashes[i] = gb_frame_hash(gb);
+        counters[i] = gb->mmu.wram[0]->bytes[0];
+    }
+}
+
+static int rewind_back_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    ASSERT_EQ(-1, gb_rewind(gb));
+    ASSERT_EQ(0, gb_rewind_enable(gb, 1 << 20, 1));
+    record(gb);
+    ASSERT_EQ(FRAMES, rewind_count(gb->rewind));
+    /* The first call redraws the frame after the newest snapshot. */
+    ASSERT_EQ(0, gb_rewind(gb));
+    for (unsigned int i = FRAMES; i > 1; --i) {
+        ASSERT_EQ(0, gb_rewind(gb));
+        ASSERT(hashes[i] == gb_frame_hash(gb));
+        ASSERT_EQ(counters[i], gb->mmu.wram[0]->bytes[0]);
+    }
+    ASSERT_EQ(-1, gb_rewind(gb));
+    /* Recording goes on from where rewinding stopped. */
+    gb_run_frames(gb, 1);
+    ASSERT(hashes[3] == gb_frame_hash(gb));
+    ASSERT_EQ(1, rewind_count(gb->rewind));
+    gb_destroy(gb);
+    return 0;
+}
+
+static int rewind_limit_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    ASSERT_EQ(0, gb_rewind_enable(gb, 4096, 2));
+    record(gb);
+    size_t count = rewind_count(gb->rewind);
+    ASSERT(count > 2 && count < FRAMES / 2);
+    ASSERT(rewind_used(gb->rewind) <= 4096);
+    /* Only the newest snapshots, every other frame, are left. */
+    ASSERT_EQ(0, gb_rewind(gb));
+    for (size_t i = 1; i < count; ++i) {
+        ASSERT_EQ(0, gb_rewind(gb));
+        ASSERT(hashes[FRAMES - 2 * i + 1] == gb_frame_hash(gb));
+    }
+    ASSERT_EQ(-1, gb_rewind(gb));
+    gb_destroy(gb);
+    return 0;
+}
+
+void rewind_test(void)
+{
+    rom_open(__func__);
+    ut_run(rewind_back_test);
+    ut_run(rewind_limit_test);
+    rom_close();
+}
@@ -0,0 +1,144 @@
+#include "rom.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ut.h"
+
+#define ROM_SIZE 0x8000
+#define ROM_ENTRY 0x100
+#define ROM_TITLE 0x134
+#define ROM_CGB 0x143
+#define ROM_TYPE 0x147
+#define ROM_BANK_SIZE 0x4000
+
+static char rom_path[64];
+
+const uint8_t rom_counter[] = {
+    0x3e, 0xe4,       /* ld a, $e4 */
+    0xe0, 0x47,       /* ldh ($47), a */
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0x34,             /* loop: inc (hl) */
+    0x7e,             /* ld a, (hl) */
+    0xea, 0x00, 0x80, /* ld ($8000), a */
+    0x18, 0xf9,       /* jr loop */
+};
+const size_t rom_counter_len = sizeof(rom_counter);
+
+const uint8_t rom_joypad[] = {
+    0x21, 0x00, 0xc0, /* ld hl, $c000 */
+    0x3e, 0x10,       /* loop: ld a, $10 */
+    0xe0, 0x00,       /* ldh ($00), a */
+    0xf0, 0x00,       /* ldh a, ($00) */
+    0x86,             /* add a, (hl) */
+    0x77,             /* ld (hl), a */
+    0x18, 0xf6,       /* jr loop */
+};
+const size_t rom_joypad_len = sizeof(rom_joypad);
+
+static int rom_write(const char *path, const uint8_t *rom, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+    size_t rv = fwrite(rom, 1, size, f);
+    fclose(f);
+    return rv == size ? 0 : -1;
+}
+
+static int rom_create_model(const char *path, const uint8_t *code, size_t len,
+                            uint8_t cgb)
+{
+    static uint8_t rom[ROM_SIZE];
+    if (len > ROM_TITLE - ROM_ENTRY)
+        return -1;
+    memset(rom, 0, sizeof(rom));
+    memcpy(&rom[ROM_ENTRY], code, len);
+    memcpy(&rom[ROM_TITLE], "GBTEST", 6);
+    rom[ROM_CGB] = cgb;
+    return rom_write(path, rom, sizeof(rom));
+}
+
+int rom_create(const char *path, const uint8_t *code, size_t len)
+{
+    return rom_create_model(path, code, len, 0x00);
+}
+
+int rom_create_cgb(const char *path, const uint8_t *code, size_t len)
+{
+    return rom_create_model(path, code, len, 0x80);
+}
+
+int rom_create_mbc1(const char *path, const uint8_t *code, size_t len,
+                    const uint8_t *const banks[3], size_t bank_len)
+{
+    static uint8_t rom[4 * ROM_BANK_SIZE];
+    if (len > ROM_TITLE - ROM_ENTRY || bank_len > ROM_BANK_SIZE)
+        return -1;
+    memset(rom, 0, sizeof(rom));
+    memcpy(&rom[ROM_ENTRY], code, len);
+    memcpy(&rom[ROM_TITLE], "GBTEST", 6);
+    rom[ROM_TYPE] = 0x01;     /* MBC1 */
+    rom[ROM_TYPE + 1] = 0x01; /* 64KB */
+    for (int i = 0; i < 3; ++i)
+        memcpy(&rom[(i + 1) * ROM_BANK_SIZE], banks[i], bank_len);
+    return rom_write(path, rom, sizeof(rom));
+}
+
+const char *rom_open(const char *suite)
+{
+    snprintf(rom_path, sizeof(rom_path), "/tmp/%sXXXXXX.gb", suite);
+    int fd = mkstemps(rom_path, 3);
+    if (fd < 0) {
+        printf("%s: could not create test rom\n", suite);
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    return rom_path;
+}
+
+void rom_close(void)
+{
+    unlink(rom_path);
+}
+
+gb_t *rom_gb(const uint8_t *code, size_t len)
+{
+    if (rom_create(rom_path, code, len) != 0)
+        return NULL;
+    return gb_create(rom_path);
+}
+
+int rom_same(const uint8_t *code, size_t len, rom_toggle_f toggle, gb_t **on,
+             gb_t **off)
+{
+    ASSERT_EQ(0, rom_create(rom_path, code, len));
+    return rom_same_file(rom_path, toggle, on, off);
+}
+
+int rom_same_file(const char *path, rom_toggle_f toggle, gb_t **on,
+                  gb_t **off)
+{
+    gb_t *gb = gb_create(path);
+    gb_t *ref = gb_create(path);
+    ASSERT(gb != NULL && ref != NULL);
+    toggle(ref, false);
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_EQ(gb_run_frames(ref, 1), gb_run_frames(gb, 1));
+        ASSERT(memcmp(&gb->cpu.reg, &ref->cpu.reg, sizeof(gb->cpu.reg)) == 0);
+        ASSERT_EQ(cpu_get_f(&ref->cpu), cpu_get_f(&gb->cpu));
+        ASSERT_EQ(ref->timer.clk_sys, gb->timer.clk_sys);
+        ASSERT_EQ(ref->timer.tima, gb->timer.tima);
+        ASSERT_EQ(ref->gpu.modeclock, gb->gpu.modeclock);
+        ASSERT(memcmp(gb->mmu.wram[0]->bytes, ref->mmu.wram[0]->bytes,
+                      0x1000) == 0);
+        ASSERT(memcmp(gb->gpu.vram[0]->bytes, ref->gpu.vram[0]->bytes,
+                      0x2000) == 0);
+        ASSERT(memcmp(gb->mmu.zram, ref->mmu.zram, sizeof(gb->mmu.zram)) ==
+               0);
+        ASSERT(memcmp(gb->gpu.oam, ref->gpu.oam, sizeof(gb->gpu.oam)) == 0);
+    }
+    *on = gb;
+    *off = ref;
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef TEST_ROM_H
+#define TEST_ROM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gb.h"
+
+/**
+ * Write a 32KB ROM ONLY image to path with code placed at the 0x100 entry
+ * point. Returns 0 on success.
+ */
+int rom_create(const char *path, const uint8_t *code, size_t len);
+
+/* Same with the CGB flag set in the header. */
+int rom_create_cgb(const char *path, const uint8_t *code, size_t len);
+
+/**
+ * Same for a 64KB MBC1 image, with banks[n - 1] at the start of bank n, for
+ * the switchable area.
+ */
+int rom_create_mbc1(const char *path, const uint8_t *code, size_t len,
+                    const uint8_t *const banks[3], size_t bank_len);
+
+/**
+ * Make the temporary ROM file of the named suite, or exit, and return its
+ * path. rom_close() removes it.
+ */
+const char *rom_open(const char *suite);
+void rom_close(void);
+
+/* Write code to the ROM file and create a DMG running it, NULL on failure. */
+gb_t *rom_gb(const uint8_t *code, size_t len);
+
+/* A setting that must not change what the game sees, like gb_set_idle_skip. */
+typedef void (*rom_toggle_f)(gb_t *gb, bool enable);
+
+/**
+ * Run code for 30 frames with the toggle on and off, asserting the two runs
+ * cannot be told apart, and hand them back in on and off for the caller's
+ * own checks. Returns 0 on success.
+ */
+int rom_same(const uint8_t *code, size_t len, rom_toggle_f toggle, gb_t **on,
+             gb_t **off);
+
+/* Same for the ROM at path. */
+int rom_same_file(const char *path, rom_toggle_f toggle, gb_t **on,
+                  gb_t **off);
+
+/**
+ * Count in WRAM and copy the counter to the first tile, forever. The tile
+ * fills the background, so every frame looks different.
+ */
+extern const uint8_t rom_counter[];
+extern const size_t rom_counter_len;
+
+/* Add up the button row of the joypad in WRAM, forever. */
+extern const uint8_t rom_joypad[];
+extern const size_t rom_joypad_len;
+
+#endif /* TEST_ROM_H */
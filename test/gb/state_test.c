@@ -0,0 +1,105 @@
+#include <string.h>
+#include "gb.h"
+#include "rom.h"
+#include "ut.h"
+
+void state_test(void);
+
+static uint8_t state[1 << 18];
+
+static int roundtrip_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    gb_run_cycles(gb, 123457);
+    size_t size = gb_state_save(gb, state, sizeof(state), GB_STATE_ALL);
+    ASSERT(size > 0 && size == gb_state_size(gb, GB_STATE_ALL));
+    uint64_t cycles = gb_run_frames(gb, 5);
+    uint64_t hash = gb_frame_hash(gb);
+    uint8_t wram = gb->mmu.wram[0]->bytes[0];
+    /* Loading into another instance replays the same 5 frames. */
+    gb_t *other = gb_create_shared(gb);
+    ASSERT(other != NULL);
+    ASSERT_EQ(0, gb_state_load(other, state, size, GB_STATE_ALL));
+    ASSERT(cycles == gb_run_frames(other, 5));
+    ASSERT(hash == gb_frame_hash(other));
+    ASSERT_EQ(wram, other->mmu.wram[0]->bytes[0]);
+    gb_destroy(other);
+    gb_destroy(gb);
+    return 0;
+}
+
+static int section_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    gb_run_frames(gb, 2);
+    size_t size = gb_state_save(gb, state, sizeof(state), GB_STATE_VRAM);
+    ASSERT(size > 0);
+    ASSERT(size < gb_state_size(gb, GB_STATE_VRAM | GB_STATE_WRAM));
+    uint8_t tile = gb->gpu.vram[0]->bytes[0];
+    gb_run_frames(gb, 1);
+    uint8_t wram = gb->mmu.wram[0]->bytes[0];
+    ASSERT(tile != gb->gpu.vram[0]->bytes[0]);
+    /* Only VRAM goes back. */
+    ASSERT_EQ(0, gb_state_load(gb, state, size, GB_STATE_VRAM));
+    ASSERT_EQ(tile, gb->gpu.vram[0]->bytes[0]);
+    ASSERT_EQ(wram, gb->mmu.wram[0]->bytes[0]);
+    /* The blob has no WRAM section to load. */
+    ASSERT_EQ(-1, gb_state_load(gb, state, size, GB_STATE_WRAM));
+    gb_destroy(gb);
+    return 0;
+}
+
+static int reject_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    size_t size = gb_state_save(gb, state, sizeof(state), GB_STATE_ALL);
+    ASSERT(size > 0);
+    ASSERT_EQ(0, gb_state_save(gb, state, size - 1, GB_STATE_ALL));
+    ASSERT_EQ(-1, gb_state_load(gb, state, size - 1, GB_STATE_ALL));
+    uint16_t version;
+    memcpy(&version, state + 4, sizeof(version));
+    version++;
+    memcpy(state + 4, &version, sizeof(version));
+    ASSERT_EQ(-1, gb_state_load(gb, state, size, GB_STATE_ALL));
+    gb_destroy(gb);
+    return 0;
+}
+
+/* The events are found again from the state loaded, not taken from it. */
+static int timer_test(void)
+{
+    gb_t *gb = rom_gb(rom_counter, rom_counter_len);
+    ASSERT(gb != NULL);
+    timer_write_tac(gb, 0x05);
+    gb_run_cycles(gb, 1000);
+    /* Set from outside the CPU, the clock still expects the old overflow. */
+    timer_write_tima(gb, 0xf0);
+    size_t size = gb_state_save(gb, state, sizeof(state), GB_STATE_CPU);
+    ASSERT(size > 0);
+    uint64_t due = gb->clock.cycles + timer_next_event(gb);
+    gb_t *other = gb_create_shared(gb);
+    ASSERT(other != NULL);
+    ASSERT_EQ(0, gb_state_load(other, state, size, GB_STATE_CPU));
+    ASSERT(other->clock.at[CLOCK_EVENT_TIMER] == due);
+    /* The interrupt is raised right after the overflow. */
+    gb_run_cycles(other, due - 8 - other->clock.cycles);
+    ASSERT_EQ(0, other->intr.flag & INTERRUPTS_TIMER);
+    gb_run_cycles(other, 16);
+    ASSERT_EQ(INTERRUPTS_TIMER, other->intr.flag & INTERRUPTS_TIMER);
+    gb_destroy(other);
+    gb_destroy(gb);
+    return 0;
+}
+
+void state_test(void)
+{
+    rom_open(__func__);
+    ut_run(roundtrip_test);
+    ut_run(section_test);
+    ut_run(reject_test);
+    ut_run(timer_test);
+    rom_close();
+}